@@ -267,6 +267,9 @@ mesh.add('partition', doc, None, iint('numPart'), ivectorsize('elementTags', 'st
 doc = '''Unpartition the mesh of the current model.'''
 mesh.add('unpartition', doc, None)
 
+doc = '''Read the mesh in the MSH4 file `fileName' (in format version 4.1, without partitions) in the current model, cooperatively on all the MPI processes: each process reads a contiguous share of the nodes and of the elements in the file, and the elements are then redistributed along a Hilbert curve through their barycenters, so that each process only stores a compact part of the mesh (with the nodes it uses), and no process ever holds the full mesh. If Gmsh is not compiled with MPI support or runs on a single process, read the full mesh.'''
+mesh.add('readDistributed', doc, None, istring('fileName'))
+
 doc = '''Optimize the mesh of the current model using `method' (empty for default tetrahedral mesh optimizer, "Netgen" for Netgen optimizer, "HighOrder" for direct high-order mesh optimizer, "HighOrderElastic" for high-order elastic smoother, "HighOrderFastCurving" for fast curving algorithm, "Laplace2D" for Laplace smoothing, "Relocate2D" and "Relocate3D" for node relocation, "QuadQuasiStructured" for quad mesh optimization, "UntangleMeshGeometry" for untangling). If `force' is set apply the optimization also to discrete entities. If `dimTags' (given as a vector of (dim, tag) pairs) is given, only apply the optimizer to the given entities.'''
 mesh.add('optimize', doc, None, istring('method', '""'), ibool('force', 'false', 'False'), iint('niter', '1'), ivectorpair('dimTags', 'gmsh::vectorpair()', '[]', '[]'))
 
@@ -507,6 +510,9 @@ mesh.add('removeConstraints', doc, None, ivectorpair('dimTags', 'gmsh::vectorpai
 doc = '''Embed the model entities of dimension `dim' and tags `tags' in the (`inDim', `inTag') model entity. The dimension `dim' can 0, 1 or 2 and must be strictly smaller than `inDim', which must be either 2 or 3. The embedded entities should not intersect each other or be part of the boundary of the entity `inTag', whose mesh will conform to the mesh of the embedded entities. With the OpenCASCADE kernel, if the `fragment' operation is applied to entities of different dimensions, the lower dimensional entities will be automatically embedded in the higher dimensional entities if they are not on their boundary.'''
 mesh.add('embed', doc, None, iint('dim'), ivectorint('tags'), iint('inDim'), iint('inTag'))
 
+doc = '''Mark the mesh of the model entities `dimTags', given as a vector of (dim, tag) pairs, as outdated, so that it is regenerated (together with the mesh of the entities that depend on it) by the next incremental mesh generation, i.e. when the `Mesh.Incremental' option is set. This is e.g. useful after changing a mesh size field. If `dimTags' is empty, mark all the entities in the model.'''
+mesh.add('setOutdated', doc, None, ivectorpair('dimTags', 'gmsh::vectorpair()', '[]', '[]'))
+
 doc = '''Remove embedded entities from the model entities `dimTags', given as a vector of (dim, tag) pairs. if `dim' is >= 0, only remove embedded entities of the given dimension (e.g. embedded points if `dim' == 0).'''
 mesh.add('removeEmbedded', doc, None, ivectorpair('dimTags'), iint('dim', '-1'))
 
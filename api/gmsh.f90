@@ -522,6 +522,8 @@ module gmsh
         gmshModelMeshPartition
     procedure, nopass :: unpartition => &
         gmshModelMeshUnpartition
+    procedure, nopass :: readDistributed => &
+        gmshModelMeshReadDistributed
     procedure, nopass :: optimize => &
         gmshModelMeshOptimize
     procedure, nopass :: recombine => &
@@ -682,6 +684,8 @@ module gmsh
         gmshModelMeshRemoveConstraints
     procedure, nopass :: embed => &
         gmshModelMeshEmbed
+    procedure, nopass :: setOutdated => &
+        gmshModelMeshSetOutdated
     procedure, nopass :: removeEmbedded => &
         gmshModelMeshRemoveEmbedded
     procedure, nopass :: getEmbedded => &
@@ -3165,6 +3169,31 @@ module gmsh
     call C_API(ierr_=ierr)
   end subroutine gmshModelMeshUnpartition
 
+  !> Read the mesh in the MSH4 file `fileName' (in format version 4.1, without
+  !! partitions) in the current model, cooperatively on all the MPI processes:
+  !! each process reads a contiguous share of the nodes and of the elements in
+  !! the file, and the elements are then redistributed along a Hilbert curve
+  !! through their barycenters, so that each process only stores a compact part
+  !! of the mesh (with the nodes it uses), and no process ever holds the full
+  !! mesh. If Gmsh is not compiled with MPI support or runs on a single process,
+  !! read the full mesh.
+  subroutine gmshModelMeshReadDistributed(fileName, &
+                                          ierr)
+    interface
+    subroutine C_API(fileName, &
+                     ierr_) &
+      bind(C, name="gmshModelMeshReadDistributed")
+      use, intrinsic :: iso_c_binding
+      character(len=1, kind=c_char), dimension(*), intent(in) :: fileName
+      integer(c_int), intent(out), optional :: ierr_
+    end subroutine C_API
+    end interface
+    character(len=*), intent(in) :: fileName
+    integer(c_int), intent(out), optional :: ierr
+    call C_API(fileName=istring_(fileName), &
+         ierr_=ierr)
+  end subroutine gmshModelMeshReadDistributed
+
   !> Optimize the mesh of the current model using `method' (empty for default
   !! tetrahedral mesh optimizer, "Netgen" for Netgen optimizer, "HighOrder" for
   !! direct high-order mesh optimizer, "HighOrderElastic" for high-order elastic
@@ -6529,6 +6558,32 @@ module gmsh
          ierr_=ierr)
   end subroutine gmshModelMeshEmbed
 
+  !> Mark the mesh of the model entities `dimTags', given as a vector of (dim,
+  !! tag) pairs, as outdated, so that it is regenerated (together with the mesh
+  !! of the entities that depend on it) by the next incremental mesh generation,
+  !! i.e. when the `Mesh.Incremental' option is set. This is e.g. useful after
+  !! changing a mesh size field. If `dimTags' is empty, mark all the entities in
+  !! the model.
+  subroutine gmshModelMeshSetOutdated(dimTags, &
+                                      ierr)
+    interface
+    subroutine C_API(api_dimTags_, &
+                     api_dimTags_n_, &
+                     ierr_) &
+      bind(C, name="gmshModelMeshSetOutdated")
+      use, intrinsic :: iso_c_binding
+      integer(c_int), dimension(*), optional :: api_dimTags_
+      integer(c_size_t), value, intent(in) :: api_dimTags_n_
+      integer(c_int), intent(out), optional :: ierr_
+    end subroutine C_API
+    end interface
+    integer(c_int), dimension(:,:), intent(in), optional :: dimTags
+    integer(c_int), intent(out), optional :: ierr
+    call C_API(api_dimTags_=dimTags, &
+         api_dimTags_n_=size_gmsh_pair(dimTags), &
+         ierr_=ierr)
+  end subroutine gmshModelMeshSetOutdated
+
   !> Remove embedded entities from the model entities `dimTags', given as a
   !! vector of (dim, tag) pairs. if `dim' is >= 0, only remove embedded entities
   !! of the given dimension (e.g. embedded points if `dim' == 0).
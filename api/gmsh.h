@@ -682,6 +682,18 @@ namespace gmsh { // Top-level functions
       // Unpartition the mesh of the current model.
       GMSH_API void unpartition();
 
+      // gmsh::model::mesh::readDistributed
+      //
+      // Read the mesh in the MSH4 file `fileName' (in format version 4.1, without
+      // partitions) in the current model, cooperatively on all the MPI processes:
+      // each process reads a contiguous share of the nodes and of the elements in
+      // the file, and the elements are then redistributed along a Hilbert curve
+      // through their barycenters, so that each process only stores a compact part
+      // of the mesh (with the nodes it uses), and no process ever holds the full
+      // mesh. If Gmsh is not compiled with MPI support or runs on a single
+      // process, read the full mesh.
+      GMSH_API void readDistributed(const std::string & fileName);
+
       // gmsh::model::mesh::optimize
       //
       // Optimize the mesh of the current model using `method' (empty for default
@@ -1609,6 +1621,16 @@ namespace gmsh { // Top-level functions
                           const int inDim,
                           const int inTag);
 
+      // gmsh::model::mesh::setOutdated
+      //
+      // Mark the mesh of the model entities `dimTags', given as a vector of (dim,
+      // tag) pairs, as outdated, so that it is regenerated (together with the mesh
+      // of the entities that depend on it) by the next incremental mesh
+      // generation, i.e. when the `Mesh.Incremental' option is set. This is e.g.
+      // useful after changing a mesh size field. If `dimTags' is empty, mark all
+      // the entities in the model.
+      GMSH_API void setOutdated(const gmsh::vectorpair & dimTags = gmsh::vectorpair());
+
       // gmsh::model::mesh::removeEmbedded
       //
       // Remove embedded entities from the model entities `dimTags', given as a
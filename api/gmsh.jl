@@ -1755,6 +1755,30 @@ function unpartition()
     return nothing
 end
 
+"""
+    gmsh.model.mesh.readDistributed(fileName)
+
+Read the mesh in the MSH4 file `fileName` (in format version 4.1, without
+partitions) in the current model, cooperatively on all the MPI processes: each
+process reads a contiguous share of the nodes and of the elements in the file,
+and the elements are then redistributed along a Hilbert curve through their
+barycenters, so that each process only stores a compact part of the mesh (with
+the nodes it uses), and no process ever holds the full mesh. If Gmsh is not
+compiled with MPI support or runs on a single process, read the full mesh.
+
+Types:
+ - `fileName`: string
+"""
+function readDistributed(fileName)
+    ierr = Ref{Cint}()
+    ccall((:gmshModelMeshReadDistributed, gmsh.lib), Cvoid,
+          (Ptr{Cchar}, Ptr{Cint}),
+          fileName, ierr)
+    ierr[] != 0 && error(gmsh.logger.getLastError())
+    return nothing
+end
+const read_distributed = readDistributed
+
 """
     gmsh.model.mesh.optimize(method = "", force = false, niter = 1, dimTags = Tuple{Cint,Cint}[])
 
@@ -3876,6 +3900,30 @@ function embed(dim, tags, inDim, inTag)
     return nothing
 end
 
+"""
+    gmsh.model.mesh.setOutdated(dimTags = Tuple{Cint,Cint}[])
+
+Mark the mesh of the model entities `dimTags`, given as a vector of (dim, tag)
+pairs, as outdated, so that it is regenerated (together with the mesh of the
+entities that depend on it) by the next incremental mesh generation, i.e. when
+the `Mesh.Incremental` option is set. This is e.g. useful after changing a mesh
+size field. If `dimTags` is empty, mark all the entities in the model.
+
+Types:
+ - `dimTags`: vector of pairs of integers
+"""
+function setOutdated(dimTags = Tuple{Cint,Cint}[])
+    api_dimTags_ = collect(Cint, Iterators.flatten(dimTags))
+    api_dimTags_n_ = length(api_dimTags_)
+    ierr = Ref{Cint}()
+    ccall((:gmshModelMeshSetOutdated, gmsh.lib), Cvoid,
+          (Ptr{Cint}, Csize_t, Ptr{Cint}),
+          api_dimTags_, api_dimTags_n_, ierr)
+    ierr[] != 0 && error(gmsh.logger.getLastError())
+    return nothing
+end
+const set_outdated = setOutdated
+
 """
     gmsh.model.mesh.removeEmbedded(dimTags, dim = -1)
 
@@ -2097,6 +2097,31 @@ class model:
             if ierr.value != 0:
                 raise Exception(logger.getLastError())
 
+        @staticmethod
+        def readDistributed(fileName):
+            """
+            gmsh.model.mesh.readDistributed(fileName)
+
+            Read the mesh in the MSH4 file `fileName' (in format version 4.1, without
+            partitions) in the current model, cooperatively on all the MPI processes:
+            each process reads a contiguous share of the nodes and of the elements in
+            the file, and the elements are then redistributed along a Hilbert curve
+            through their barycenters, so that each process only stores a compact part
+            of the mesh (with the nodes it uses), and no process ever holds the full
+            mesh. If Gmsh is not compiled with MPI support or runs on a single process,
+            read the full mesh.
+
+            Types:
+            - `fileName': string
+            """
+            ierr = c_int()
+            lib.gmshModelMeshReadDistributed(
+                c_char_p(fileName.encode()),
+                byref(ierr))
+            if ierr.value != 0:
+                raise Exception(logger.getLastError())
+        read_distributed = readDistributed
+
         @staticmethod
         def optimize(method="", force=False, niter=1, dimTags=[]):
             """
@@ -4431,6 +4456,30 @@ class model:
             if ierr.value != 0:
                 raise Exception(logger.getLastError())
 
+        @staticmethod
+        def setOutdated(dimTags=[]):
+            """
+            gmsh.model.mesh.setOutdated(dimTags=[])
+
+            Mark the mesh of the model entities `dimTags', given as a vector of (dim,
+            tag) pairs, as outdated, so that it is regenerated (together with the mesh
+            of the entities that depend on it) by the next incremental mesh generation,
+            i.e. when the `Mesh.Incremental' option is set. This is e.g. useful after
+            changing a mesh size field. If `dimTags' is empty, mark all the entities in
+            the model.
+
+            Types:
+            - `dimTags': vector of pairs of integers
+            """
+            api_dimTags_, api_dimTags_n_ = _ivectorpair(dimTags)
+            ierr = c_int()
+            lib.gmshModelMeshSetOutdated(
+                api_dimTags_, api_dimTags_n_,
+                byref(ierr))
+            if ierr.value != 0:
+                raise Exception(logger.getLastError())
+        set_outdated = setOutdated
+
         @staticmethod
         def removeEmbedded(dimTags, dim=-1):
             """
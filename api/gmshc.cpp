@@ -985,6 +985,17 @@ GMSH_API void gmshModelMeshUnpartition(int * ierr)
   }
 }
 
+GMSH_API void gmshModelMeshReadDistributed(const char * fileName, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    gmsh::model::mesh::readDistributed(fileName);
+  }
+  catch(...){
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmshModelMeshOptimize(const char * method, const int force, const int niter, const int * dimTags, const size_t dimTags_n, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -2081,6 +2092,22 @@ GMSH_API void gmshModelMeshEmbed(const int dim, const int * tags, const size_t t
   }
 }
 
+GMSH_API void gmshModelMeshSetOutdated(const int * dimTags, const size_t dimTags_n, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    gmsh::vectorpair api_dimTags_(dimTags_n/2);
+    for(size_t i = 0; i < dimTags_n/2; ++i){
+      api_dimTags_[i].first = dimTags[i * 2 + 0];
+      api_dimTags_[i].second = dimTags[i * 2 + 1];
+    }
+    gmsh::model::mesh::setOutdated(api_dimTags_);
+  }
+  catch(...){
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmshModelMeshRemoveEmbedded(const int * dimTags, const size_t dimTags_n, const int dim, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -586,6 +586,17 @@ GMSH_API void gmshModelMeshPartition(const int numPart,
 /* Unpartition the mesh of the current model. */
 GMSH_API void gmshModelMeshUnpartition(int * ierr);
 
+/* Read the mesh in the MSH4 file `fileName' (in format version 4.1, without
+ * partitions) in the current model, cooperatively on all the MPI processes:
+ * each process reads a contiguous share of the nodes and of the elements in
+ * the file, and the elements are then redistributed along a Hilbert curve
+ * through their barycenters, so that each process only stores a compact part
+ * of the mesh (with the nodes it uses), and no process ever holds the full
+ * mesh. If Gmsh is not compiled with MPI support or runs on a single process,
+ * read the full mesh. */
+GMSH_API void gmshModelMeshReadDistributed(const char * fileName,
+                                           int * ierr);
+
 /* Optimize the mesh of the current model using `method' (empty for default
  * tetrahedral mesh optimizer, "Netgen" for Netgen optimizer, "HighOrder" for
  * direct high-order mesh optimizer, "HighOrderElastic" for high-order elastic
@@ -1423,6 +1434,15 @@ GMSH_API void gmshModelMeshEmbed(const int dim,
                                  const int inTag,
                                  int * ierr);
 
+/* Mark the mesh of the model entities `dimTags', given as a vector of (dim,
+ * tag) pairs, as outdated, so that it is regenerated (together with the mesh
+ * of the entities that depend on it) by the next incremental mesh generation,
+ * i.e. when the `Mesh.Incremental' option is set. This is e.g. useful after
+ * changing a mesh size field. If `dimTags' is empty, mark all the entities in
+ * the model. */
+GMSH_API void gmshModelMeshSetOutdated(const int * dimTags, const size_t dimTags_n,
+                                       int * ierr);
+
 /* Remove embedded entities from the model entities `dimTags', given as a
  * vector of (dim, tag) pairs. if `dim' is >= 0, only remove embedded entities
  * of the given dimension (e.g. embedded points if `dim' == 0). */
@@ -25,6 +25,7 @@
 // Contributors: Thomas Toulorge, Jonathan Lambrechts
 
 #include <stdio.h>
+#include <algorithm>
 #include <sstream>
 #include <iterator>
 #include <limits>
@@ -425,6 +426,63 @@ namespace {
     mvprintList(9, -8, _patchHistory, 2);
   }
 
+  void updateObjFunctionRange(
+    MeshOpt &opt, std::vector<std::pair<double, double> > &newObjFunctionRange,
+    std::vector<std::string> &objFunctionNames)
+  {
+    if(newObjFunctionRange.size() == 0) {
+      newObjFunctionRange = opt.objFunction()->minMax();
+      objFunctionNames = opt.objFunction()->names();
+    }
+    else {
+      for(std::size_t i = 0; i < newObjFunctionRange.size(); i++) {
+        newObjFunctionRange[i].first = std::min(
+          newObjFunctionRange[i].first, opt.objFunction()->minMax()[i].first);
+        newObjFunctionRange[i].second = std::max(
+          newObjFunctionRange[i].second, opt.objFunction()->minMax()[i].second);
+      }
+    }
+  }
+
+  // Color the patches so that patches of the same color do not share any
+  // vertex (including the fixed ones): they can then be optimized concurrently,
+  // and the result does not depend on the order in which they are treated.
+  // Patches are colored greedily in the given order.
+  void colorPatches(const std::vector<const elSet *> &patchElts,
+                    const std::vector<const vertSet *> &patchFixed,
+                    std::vector<std::vector<int> > &colors)
+  {
+    std::vector<std::vector<MVertex *> > patchVerts(patchElts.size());
+    std::map<MVertex *, std::vector<int> > vertex2patches;
+    for(std::size_t iP = 0; iP < patchElts.size(); ++iP) {
+      vertSet verts(patchFixed[iP]->begin(), patchFixed[iP]->end());
+      for(auto itEl = patchElts[iP]->begin(); itEl != patchElts[iP]->end();
+          ++itEl)
+        for(std::size_t i = 0; i < (*itEl)->getNumVertices(); ++i)
+          verts.insert((*itEl)->getVertex(i));
+      patchVerts[iP].assign(verts.begin(), verts.end());
+      for(auto itV = verts.begin(); itV != verts.end(); ++itV)
+        vertex2patches[*itV].push_back(iP);
+    }
+
+    colors.clear();
+    std::vector<int> color(patchElts.size(), -1);
+    for(std::size_t iP = 0; iP < patchElts.size(); ++iP) {
+      std::set<int> used;
+      for(auto itV = patchVerts[iP].begin(); itV != patchVerts[iP].end();
+          ++itV) {
+        const std::vector<int> &neighbours = vertex2patches[*itV];
+        for(std::size_t k = 0; k < neighbours.size(); ++k)
+          if(color[neighbours[k]] >= 0) used.insert(color[neighbours[k]]);
+      }
+      int c = 0;
+      while(used.count(c)) c++;
+      color[iP] = c;
+      if(c >= (int)colors.size()) colors.resize(c + 1);
+      colors[c].push_back(iP);
+    }
+  }
+
   void optimizeDisjointPatches(const vertElVecMap &vertex2elements,
                                const elEntMap &element2entity,
                                const elElMap &el2BndEl,
@@ -456,76 +514,82 @@ namespace {
     }
     if(par.nCurses) displayResultTable(nbPatchSuccess, toOptimize.size());
 
-  int nthreads = CTX::instance()->numThreads;
-  if(!nthreads) nthreads = Msg::GetMaxThreads();
+    // Disjoint patches do not share any element, but they can share vertices
+    // (the fixed vertices of a patch can be moved by another one): process
+    // them by colors, the patches of each color being optimized concurrently
+    std::vector<const elSet *> patchElts(toOptimize.size());
+    std::vector<const vertSet *> patchFixed(toOptimize.size());
+    for(std::size_t iPatch = 0; iPatch < toOptimize.size(); ++iPatch) {
+      patchElts[iPatch] = &toOptimize[iPatch].first;
+      patchFixed[iPatch] = &toOptimize[iPatch].second;
+    }
+    std::vector<std::vector<int> > colors;
+    colorPatches(patchElts, patchFixed, colors);
+    if(par.verbose > 1)
+      Msg::Info("Optimizing %i patches in %i groups of independent patches",
+                (int)toOptimize.size(), (int)colors.size());
+
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+    if(par.nCurses) nthreads = 1;
+    for(std::size_t iC = 0; iC < colors.size(); ++iC) {
 #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-    for(int iPatch = 0; iPatch < toOptimize.size(); ++iPatch) {
-      // Initialize optimization and output if asked
-      if(par.nCurses) {
-        mvbold(true);
-        mvprintCenter(10, " PATCH %5i ", iPatch);
-        mvbold(false);
-      }
-      if(par.verbose > 1)
-        Msg::Info("Optimizing patch %i/%i composed of %i elements, "
-                  "%i boundary elements",
-                  iPatch, toOptimize.size() - 1,
-                  toOptimize[iPatch].first.size(), bndElts[iPatch].size());
-      MeshOpt opt(e2eOpt, bndEl2Ent, toOptimize[iPatch].first,
-                  toOptimize[iPatch].second, bndElts[iPatch], par);
-      if(par.verbose > 3) {
-        std::ostringstream ossI1;
-        ossI1 << "initial_patch-" << iPatch << ".msh";
-        opt.patch.writeMSH(ossI1.str().c_str());
-      }
+      for(std::size_t k = 0; k < colors[iC].size(); ++k) {
+        const int iPatch = colors[iC][k];
+        // Initialize optimization and output if asked
+        if(par.nCurses) {
+          mvbold(true);
+          mvprintCenter(10, " PATCH %5i ", iPatch);
+          mvbold(false);
+        }
+        if(par.verbose > 1)
+          Msg::Info("Optimizing patch %i/%i composed of %i elements, "
+                    "%i boundary elements",
+                    iPatch, (int)toOptimize.size() - 1,
+                    (int)toOptimize[iPatch].first.size(),
+                    (int)bndElts[iPatch].size());
+        MeshOpt opt(e2eOpt, bndEl2Ent, toOptimize[iPatch].first,
+                    toOptimize[iPatch].second, bndElts[iPatch], par);
+        if(par.verbose > 3) {
+          std::ostringstream ossI1;
+          ossI1 << "initial_patch-" << iPatch << ".msh";
+          opt.patch.writeMSH(ossI1.str().c_str());
+        }
 
-      // Optimize patch
-      int success = -1;
-      if(opt.patch.nPC() > 0)
-        success = opt.optimize(par);
-      else if(par.verbose > 1)
-        Msg::Info("Patch %i has no degree of freedom, skipping", iPatch);
-
-      if(par.verbose > 3) {
-        std::ostringstream ossI2;
-        ossI2 << "final_patch-" << iPatch << ".msh";
-        opt.patch.writeMSH(ossI2.str().c_str());
-      }
+        // Optimize patch
+        int success = -1;
+        if(opt.patch.nPC() > 0)
+          success = opt.optimize(par);
+        else if(par.verbose > 1)
+          Msg::Info("Patch %i has no degree of freedom, skipping", iPatch);
 
-      // Evaluate mesh and update it if (partial) success
-      opt.updateResults();
+        if(par.verbose > 3) {
+          std::ostringstream ossI2;
+          ossI2 << "final_patch-" << iPatch << ".msh";
+          opt.patch.writeMSH(ossI2.str().c_str());
+        }
 
+        // Evaluate mesh and update it if (partial) success
 #pragma omp critical(optimizeDisjointPatches1)
-      {
-        if(newObjFunctionRange.size() == 0) {
-          newObjFunctionRange = opt.objFunction()->minMax();
-          objFunctionNames = opt.objFunction()->names();
-        }
-        else {
-          for(int i = 0; i < newObjFunctionRange.size(); i++) {
-            newObjFunctionRange[i].first =
-              std::min(newObjFunctionRange[i].first,
-                       opt.objFunction()->minMax()[i].first);
-            newObjFunctionRange[i].second =
-              std::max(newObjFunctionRange[i].second,
-                       opt.objFunction()->minMax()[i].second);
-          }
+        {
+          opt.updateResults();
+          updateObjFunctionRange(opt, newObjFunctionRange, objFunctionNames);
         }
-      }
 
-      if(success >= 0) opt.patch.updateGEntityPositions();
+        if(success >= 0) opt.patch.updateGEntityPositions();
 
 #pragma omp critical(optimizeDisjointPatches2)
-      {
-        par.success = std::min(par.success, success);
-        nbPatchSuccess[success + 1]++;
-      }
+        {
+          par.success = std::min(par.success, success);
+          nbPatchSuccess[success + 1]++;
+        }
 
-      if(par.nCurses) {
-        displayMinMaxVal(nbPatchSuccess, objFunctionNames, newObjFunctionRange);
-        displayResultTable(nbPatchSuccess, toOptimize.size());
-        updateDisplayPatchHistory(_patchHistory, opt.objFunction()->minMaxStr(),
-                                  iPatch, -1);
+        if(par.nCurses) {
+          displayMinMaxVal(nbPatchSuccess, objFunctionNames, newObjFunctionRange);
+          displayResultTable(nbPatchSuccess, toOptimize.size());
+          updateDisplayPatchHistory(_patchHistory, opt.objFunction()->minMaxStr(),
+                                    iPatch, -1);
+        }
       }
     }
 
@@ -535,6 +599,17 @@ namespace {
     }
   }
 
+  double getElBadness(MElement *el, const elEntMap &element2entity,
+                      const MeshOptParameters &par)
+  {
+    GEntity *gEnt = nullptr;
+    if(!element2entity.empty()) {
+      auto itEl2Ent = element2entity.find(el);
+      if(itEl2Ent != element2entity.end()) gEnt = itEl2Ent->second;
+    }
+    return par.patchDef->elBadness(el, gEnt);
+  }
+
   MElement *getWorstElement(elSet &badElts, const elEntMap &element2entity,
                             const MeshOptParameters &par)
   {
@@ -542,12 +617,7 @@ namespace {
     MElement *worstEl = nullptr;
 
     for(auto it = badElts.begin(); it != badElts.end(); it++) {
-      GEntity *gEnt = nullptr;
-      if(!element2entity.empty()) {
-        auto itEl2Ent = element2entity.find(*it);
-        if(itEl2Ent != element2entity.end()) gEnt = itEl2Ent->second;
-      }
-      const double val = par.patchDef->elBadness(*it, gEnt);
+      const double val = getElBadness(*it, element2entity, par);
       if(val < worst) {
         worst = val;
         worstEl = *it;
@@ -557,6 +627,105 @@ namespace {
     return worstEl;
   }
 
+  // First step of the "one by one" strategy in parallel: the patches around
+  // all the bad elements are built with their initial size, and colored (worst
+  // elements first) so that patches of the same color can be optimized
+  // concurrently. The colors are processed one after the other, in the order
+  // in which they would be processed sequentially. Patches that need to be
+  // adapted are left in badElts, to be treated sequentially afterwards.
+  void optimizeColoredPatches(
+    const vertElVecMap &vertex2elements, const elEntMap &e2ePatch,
+    const elEntMap &e2eOpt, const elElMap &el2BndEl, const elEntMap &bndEl2Ent,
+    elSet &badElts, int nbPatchSuccess[3],
+    std::vector<std::pair<double, double> > &newObjFunctionRange,
+    std::vector<std::string> &objFunctionNames, MeshOptParameters &par,
+    int nthreads)
+  {
+    // Sort bad elements, worst first
+    std::vector<std::pair<double, MElement *> > sorted;
+    sorted.reserve(badElts.size());
+    for(auto it = badElts.begin(); it != badElts.end(); ++it)
+      sorted.push_back(std::make_pair(getElBadness(*it, e2ePatch, par), *it));
+    std::sort(sorted.begin(), sorted.end(),
+              [](const std::pair<double, MElement *> &a,
+                 const std::pair<double, MElement *> &b) {
+                if(a.first != b.first) return a.first < b.first;
+                return a.second->getNum() < b.second->getNum();
+              });
+
+    // Build patches with their initial size and color them
+    elElSetMap element2elements;
+    std::vector<elSet> prim(sorted.size());
+    std::vector<vertSet> toFix(sorted.size());
+    std::vector<const elSet *> patchElts(sorted.size());
+    std::vector<const vertSet *> patchFixed(sorted.size());
+    for(std::size_t i = 0; i < sorted.size(); ++i) {
+      MElement *el = sorted[i].second;
+      prim[i] = getSurroundingPatch(el, par.patchDef,
+                                    par.patchDef->maxDistance(el),
+                                    par.patchDef->maxLayers, vertex2elements,
+                                    element2elements, e2ePatch);
+      toFix[i] = getAllBndVertices(prim[i], vertex2elements);
+      patchElts[i] = &prim[i];
+      patchFixed[i] = &toFix[i];
+    }
+    std::vector<std::vector<int> > colors;
+    colorPatches(patchElts, patchFixed, colors);
+    if(par.verbose > 0)
+      Msg::Info("Optimizing %d patches in %d groups of independent patches",
+                (int)sorted.size(), (int)colors.size());
+
+    for(std::size_t iC = 0; iC < colors.size(); ++iC) {
+      // The elements of the current color are not considered as bad anymore
+      // when building the patches
+      for(std::size_t k = 0; k < colors[iC].size(); ++k)
+        badElts.erase(sorted[colors[iC][k]].second);
+      std::vector<char> toAdapt(colors[iC].size(), 0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(std::size_t k = 0; k < colors[iC].size(); ++k) {
+        const int iBadEl = colors[iC][k];
+        elSet toOptimize;
+        std::set_difference(prim[iBadEl].begin(), prim[iBadEl].end(),
+                            badElts.begin(), badElts.end(),
+                            std::inserter(toOptimize, toOptimize.end()));
+        elSet bndElts;
+        if(!el2BndEl.empty())
+          getAdjacentBndElts(el2BndEl, bndEl2Ent, toOptimize, bndElts, par);
+        if(par.verbose > 1)
+          Msg::Info("Optimizing patch %i composed of %4d elements", iBadEl,
+                    (int)toOptimize.size());
+        MeshOpt opt(e2eOpt, bndEl2Ent, toOptimize, toFix[iBadEl], bndElts,
+                    par);
+        if(par.verbose > 3) {
+          std::ostringstream ossI1;
+          ossI1 << "initial_patch-" << iBadEl << ".msh";
+          opt.patch.writeMSH(ossI1.str().c_str());
+        }
+        int success = -1;
+        if(opt.patch.nPC() > 0) success = opt.optimize(par);
+        if(par.verbose > 3) {
+          std::ostringstream ossI2;
+          ossI2 << "final_patch-" << iBadEl << "_adapt-0.msh";
+          opt.patch.writeMSH(ossI2.str().c_str());
+        }
+        if((success <= 0) && (par.patchDef->maxPatchAdapt > 1)) {
+          toAdapt[k] = 1;
+          continue;
+        }
+#pragma omp critical(optimizeColoredPatches)
+        {
+          opt.updateResults();
+          updateObjFunctionRange(opt, newObjFunctionRange, objFunctionNames);
+          nbPatchSuccess[success + 1]++;
+          par.success = std::min(par.success, success);
+        }
+        if(success >= 0) opt.patch.updateGEntityPositions();
+      }
+      for(std::size_t k = 0; k < colors[iC].size(); ++k)
+        if(toAdapt[k]) badElts.insert(sorted[colors[iC][k]].second);
+    }
+  }
+
   void optimizeOneByOne(const vertElVecMap &vertex2elements,
                         const elEntMap &element2entity, const elElMap &el2BndEl,
                         const elEntMap &bndEl2Ent, elSet badElts,
@@ -578,6 +747,18 @@ namespace {
     if(par.verbose > 0)
       Msg::Info("%d bad elements, starting to iterate...", initNumBadElts);
 
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+    if(nthreads > 1 && !par.nCurses && initNumBadElts > 1) {
+      optimizeColoredPatches(vertex2elements, e2ePatch, e2eOpt, el2BndEl,
+                             bndEl2Ent, badElts, nbPatchSuccess,
+                             newObjFunctionRange, objFunctionNames, par,
+                             nthreads);
+      if(par.verbose > 0 && !badElts.empty())
+        Msg::Info("%d patches need to be adapted, continuing sequentially...",
+                  (int)badElts.size());
+    }
+
     elElSetMap
       element2elements; // Element to element connectivity, built progressively
 
@@ -654,20 +835,7 @@ namespace {
         // otherwise adapt
         if((success > 0) || (iAdapt == par.patchDef->maxPatchAdapt - 1)) {
           opt.updateResults();
-          if(newObjFunctionRange.size() == 0) {
-            newObjFunctionRange = opt.objFunction()->minMax();
-            objFunctionNames = opt.objFunction()->names();
-          }
-          else {
-            for(int i = 0; i < newObjFunctionRange.size(); i++) {
-              newObjFunctionRange[i].first =
-                std::min(newObjFunctionRange[i].first,
-                         opt.objFunction()->minMax()[i].first);
-              newObjFunctionRange[i].second =
-                std::max(newObjFunctionRange[i].second,
-                         opt.objFunction()->minMax()[i].second);
-            }
-          }
+          updateObjFunctionRange(opt, newObjFunctionRange, objFunctionNames);
           if(success >= 0) {
             opt.patch.updateGEntityPositions();
             break;
@@ -6,6 +6,7 @@ extern "C" {
 }
 
 #include <assert.h>
+#include <chrono>
 #include <set>
 #include <vector>
 #include <time.h>
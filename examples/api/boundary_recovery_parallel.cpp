@@ -0,0 +1,107 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <gmsh.h>
+
+// Check that the boundary recovery of a volume with several independent
+// clusters of missing segments and subfaces (around twisted prismatic holes,
+// whose lateral faces are not in the Delaunay tetrahedralization) gives the
+// same mesh when the clusters are recovered in parallel as when they are
+// recovered serially. Returns a non-zero exit code if the meshes differ.
+
+static void mesh(int numThreads, std::vector<std::size_t> &tets,
+                 std::vector<double> &coord, int &recovered)
+{
+  gmsh::clear();
+  gmsh::model::add("boundary_recovery_parallel");
+
+  // a box with 4 twisted prismatic holes
+  const int nh = 4;
+  std::vector<int> p, l, s;
+  p.push_back(gmsh::model::geo::addPoint(0, 0, 0));
+  p.push_back(gmsh::model::geo::addPoint(5 * nh, 0, 0));
+  p.push_back(gmsh::model::geo::addPoint(5 * nh, 2, 0));
+  p.push_back(gmsh::model::geo::addPoint(0, 2, 0));
+  for(int i = 0; i < 4; i++)
+    l.push_back(gmsh::model::geo::addLine(p[i], p[(i + 1) % 4]));
+  s.push_back(gmsh::model::geo::addPlaneSurface(
+    {gmsh::model::geo::addCurveLoop(l)}));
+  gmsh::vectorpair out;
+  gmsh::model::geo::extrude({{2, s[0]}}, 0, 0, 2, out);
+  gmsh::model::geo::remove({out[1]});
+  s.push_back(out[0].second);
+  for(int i = 2; i < 6; i++) s.push_back(out[i].second);
+  std::vector<int> loops = {gmsh::model::geo::addSurfaceLoop(s)};
+  for(int k = 0; k < nh; k++) {
+    double x = 5 * k + 2;
+    p = {gmsh::model::geo::addPoint(x + 1, 1, 0.5),
+         gmsh::model::geo::addPoint(x - 0.5, 1.866, 0.5),
+         gmsh::model::geo::addPoint(x - 0.5, 0.134, 0.5)};
+    l.clear();
+    gmsh::vectorpair curves;
+    for(int i = 0; i < 3; i++) {
+      l.push_back(gmsh::model::geo::addLine(p[i], p[(i + 1) % 3]));
+      curves.push_back({1, l.back()});
+    }
+    gmsh::model::geo::twist(curves, x, 1, 0, 0, 0, 1, 0, 0, 1, M_PI / 4, out,
+                            {1});
+    s = {gmsh::model::geo::addPlaneSurface(
+           {gmsh::model::geo::addCurveLoop(l)}),
+         gmsh::model::geo::addPlaneSurface({gmsh::model::geo::addCurveLoop(
+           {out[0].second, out[4].second, out[8].second})}),
+         out[1].second, out[5].second, out[9].second};
+    loops.push_back(gmsh::model::geo::addSurfaceLoop(s));
+  }
+  gmsh::model::geo::addVolume(loops, 1);
+  gmsh::model::geo::synchronize();
+  gmsh::option::setNumber("Mesh.MeshSizeMax", 0.5);
+
+  gmsh::option::setNumber("General.NumThreads", 1);
+  gmsh::model::mesh::generate(2);
+
+  // only the 3D meshing (and thus the boundary recovery) is multi-threaded
+  gmsh::option::setNumber("General.NumThreads", numThreads);
+  gmsh::logger::start();
+  gmsh::model::mesh::generate(3);
+  std::vector<std::string> log;
+  gmsh::logger::get(log);
+  gmsh::logger::stop();
+  recovered = 0;
+  const std::string pass = "segments and subfaces in clusters: ";
+  for(auto &line : log) {
+    std::size_t pos = line.find(pass);
+    if(pos != std::string::npos)
+      recovered += std::atoi(line.c_str() + pos + pass.size());
+  }
+  std::vector<std::size_t> elementTags, nodeTags;
+  gmsh::model::mesh::getElementsByType(4, elementTags, tets, 1);
+  std::vector<double> parametricCoord;
+  gmsh::model::mesh::getNodes(nodeTags, coord, parametricCoord, 3, 1);
+}
+
+int main(int argc, char **argv)
+{
+  gmsh::initialize(argc, argv);
+
+  std::vector<std::size_t> tets1, tets4;
+  std::vector<double> coord1, coord4;
+  int recovered1, recovered4;
+  mesh(1, tets1, coord1, recovered1);
+  mesh(4, tets4, coord4, recovered4);
+
+  int ret = 0;
+  printf("%d segments and subfaces recovered in clusters with 1 thread, %d "
+         "with 4 threads\n", recovered1, recovered4);
+  if(!recovered1 || recovered1 != recovered4) ret = 1;
+  printf("%lu tetrahedra with 1 thread, %lu with 4 threads\n",
+         tets1.size() / 4, tets4.size() / 4);
+  if(tets1.empty() || tets1 != tets4 || coord1 != coord4) {
+    printf("the meshes differ\n");
+    ret = 1;
+  }
+
+  gmsh::finalize();
+  return ret;
+}
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <vector>
+#include <gmsh.h>
+
+// Check that incremental mesh generation (Mesh.Incremental) only regenerates
+// the mesh of the outdated entities: after marking one of two stacked boxes as
+// outdated, the nodes and elements of all the other entities must keep their
+// tags. Returns a non-zero exit code if they do not.
+
+struct entityMesh {
+  std::vector<std::size_t> nodeTags;
+  std::vector<double> coord;
+  std::vector<int> elementTypes;
+  std::vector<std::vector<std::size_t> > elementTags, elementNodeTags;
+  bool operator==(const entityMesh &other) const
+  {
+    return nodeTags == other.nodeTags && coord == other.coord &&
+           elementTypes == other.elementTypes &&
+           elementTags == other.elementTags &&
+           elementNodeTags == other.elementNodeTags;
+  }
+};
+
+static void getMesh(const gmsh::vectorpair &entities,
+                    std::vector<entityMesh> &meshes)
+{
+  meshes.resize(entities.size());
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    int dim = entities[i].first, tag = entities[i].second;
+    std::vector<double> parametricCoord;
+    gmsh::model::mesh::getNodes(meshes[i].nodeTags, meshes[i].coord,
+                                parametricCoord, dim, tag);
+    gmsh::model::mesh::getElements(meshes[i].elementTypes,
+                                   meshes[i].elementTags,
+                                   meshes[i].elementNodeTags, dim, tag);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  gmsh::initialize(argc, argv);
+  gmsh::model::add("incremental_mesh");
+
+  // two stacked boxes, sharing a face
+  int p1 = gmsh::model::geo::addPoint(0, 0, 0);
+  int p2 = gmsh::model::geo::addPoint(1, 0, 0);
+  int p3 = gmsh::model::geo::addPoint(1, 1, 0);
+  int p4 = gmsh::model::geo::addPoint(0, 1, 0);
+  int l1 = gmsh::model::geo::addLine(p1, p2);
+  int l2 = gmsh::model::geo::addLine(p2, p3);
+  int l3 = gmsh::model::geo::addLine(p3, p4);
+  int l4 = gmsh::model::geo::addLine(p4, p1);
+  int s = gmsh::model::geo::addPlaneSurface(
+    {gmsh::model::geo::addCurveLoop({l1, l2, l3, l4})});
+  gmsh::vectorpair box1, box2;
+  gmsh::model::geo::extrude({{2, s}}, 0, 0, 1, box1);
+  gmsh::model::geo::extrude({box1[0]}, 0, 0, 1, box2);
+  gmsh::model::geo::synchronize();
+  gmsh::option::setNumber("Mesh.MeshSizeMax", 0.1);
+  gmsh::model::mesh::generate(3);
+
+  gmsh::vectorpair entities;
+  gmsh::model::getEntities(entities);
+  std::vector<entityMesh> before, after;
+  getMesh(entities, before);
+
+  // only remesh the top box; the optimization threshold is raised so that the
+  // mesh of the bottom box would be modified if it was optimized again
+  gmsh::option::setNumber("Mesh.Incremental", 1);
+  gmsh::option::setNumber("Mesh.OptimizeThreshold", 0.5);
+  gmsh::model::mesh::setOutdated({box2[1]});
+  gmsh::model::mesh::generate(3);
+  getMesh(entities, after);
+
+  int ret = 0, changed = 0;
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    if(entities[i] == box2[1]) {
+      if(after[i].elementTypes.empty()) {
+        printf("volume %d has not been remeshed\n", entities[i].second);
+        ret = 1;
+      }
+    }
+    else if(!(before[i] == after[i])) {
+      changed++;
+      ret = 1;
+    }
+  }
+  printf("%d entities out of %lu changed\n", changed, entities.size() - 1);
+
+  gmsh::finalize();
+  return ret;
+}
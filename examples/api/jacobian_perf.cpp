@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <gmsh.h>
+
+// Micro-benchmark of the throughput of Jacobian and quality computations when
+// called concurrently from several threads. All the threads query the basis
+// functions of the same element type, which stresses the basis caches shared
+// by all elements (make the mesh finer e.g. with "-clscale 0.05").
+
+void jacobians(const std::vector<std::size_t> &tags, std::size_t begin,
+               std::size_t end, const std::vector<double> &localCoord)
+{
+  std::vector<double> jac, det, coord;
+  for(std::size_t i = begin; i < end; i++)
+    gmsh::model::mesh::getJacobian(tags[i], localCoord, jac, det, coord);
+}
+
+double run(int numThreads, const std::vector<std::size_t> &tags,
+           const std::vector<double> &localCoord, std::vector<double> &qual)
+{
+  double tic = gmsh::logger::getWallTime();
+  std::vector<std::thread> threads;
+  for(int t = 0; t < numThreads; t++) {
+    std::size_t begin = (t * tags.size()) / numThreads;
+    std::size_t end = ((t + 1) * tags.size()) / numThreads;
+    threads.push_back(std::thread([&, t, begin, end]() {
+      jacobians(tags, begin, end, localCoord);
+      gmsh::model::mesh::getElementQualities(tags, qual, "minSICN", t,
+                                             numThreads);
+    }));
+  }
+  for(auto &t : threads) t.join();
+  return gmsh::logger::getWallTime() - tic;
+}
+
+int main(int argc, char **argv)
+{
+  gmsh::initialize(argc, argv);
+
+  gmsh::model::add("jacobian_perf");
+  gmsh::model::occ::addBox(0, 0, 0, 1, 1, 1);
+  gmsh::model::occ::synchronize();
+  gmsh::option::setNumber("Mesh.MeshSizeMax", 0.05);
+  gmsh::model::mesh::generate(3);
+  gmsh::model::mesh::setOrder(2);
+
+  int elementType = gmsh::model::mesh::getElementType("tetrahedron", 2);
+  std::vector<std::size_t> tags, nodeTags;
+  gmsh::model::mesh::getElementsByType(elementType, tags, nodeTags);
+  if(tags.empty()) {
+    gmsh::finalize();
+    return 0;
+  }
+
+  std::vector<double> localCoord, weights;
+  gmsh::model::mesh::getIntegrationPoints(elementType, "Gauss4", localCoord,
+                                          weights);
+
+  // warm-up (builds the element cache and the bases)
+  std::vector<double> qual(tags.size());
+  run(1, tags, localCoord, qual);
+
+  int maxThreads = std::thread::hardware_concurrency();
+  if(maxThreads < 1) maxThreads = 1;
+  double t1 = 0.;
+  for(int n = 1; n <= maxThreads; n *= 2) {
+    double t = run(n, tags, localCoord, qual);
+    if(n == 1) t1 = t;
+    printf("==> %d thread(s): %lu elements in %g seconds (%g elements/s, "
+           "speedup %g)\n",
+           n, tags.size(), t, tags.size() / t, t1 / t);
+  }
+
+  gmsh::finalize();
+  return 0;
+}
@@ -0,0 +1,116 @@
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <gmsh.h>
+
+// Check that the Jacobian-based quality measures computed by the
+// AnalyseMeshQuality plugin, which processes the elements in batches (and in
+// parallel), are the same as the ones computed element by element by
+// getElementQualities, on a curved high-order mesh mixing tetrahedra and
+// prisms. Returns a non-zero exit code if they differ.
+
+static int compare(const std::string &what,
+                   const std::map<std::size_t, double> &ref,
+                   const std::vector<std::size_t> &viewTags,
+                   const std::vector<std::vector<double> > &viewData)
+{
+  int numDiff = 0;
+  if(viewTags.size() != ref.size()) {
+    printf("%s: %lu values in the plugin view instead of %lu\n", what.c_str(),
+           viewTags.size(), ref.size());
+    return 1;
+  }
+  for(std::size_t i = 0; i < viewTags.size(); i++) {
+    auto it = ref.find(viewTags[i]);
+    if(it == ref.end() || viewData[i].size() != 1) {
+      printf("%s: unexpected data in the plugin view\n", what.c_str());
+      return 1;
+    }
+    double batched = viewData[i][0], single = it->second;
+    if(std::abs(batched - single) > 1e-8 * std::max(1., std::abs(single))) {
+      if(numDiff < 10)
+        printf("%s: element %lu: %.16g (batched) != %.16g (per element)\n",
+               what.c_str(), viewTags[i], batched, single);
+      numDiff++;
+    }
+  }
+  printf("%s: %lu elements, %d difference(s)\n", what.c_str(), ref.size(),
+         numDiff);
+  return numDiff;
+}
+
+int main(int argc, char **argv)
+{
+  gmsh::initialize(argc, argv);
+  gmsh::option::setNumber("General.NumThreads", 4);
+
+  // two twisted cylinders, meshed with prisms and with tetrahedra
+  gmsh::model::add("mesh_quality_batched");
+  for(int k = 0; k < 2; k++) {
+    double x = 3. * k, r = 1.;
+    int c = gmsh::model::geo::addPoint(x, 0, 0);
+    std::vector<int> p, l;
+    for(int i = 0; i < 4; i++)
+      p.push_back(gmsh::model::geo::addPoint(x + r * std::cos(i * M_PI / 2),
+                                             r * std::sin(i * M_PI / 2), 0));
+    for(int i = 0; i < 4; i++)
+      l.push_back(gmsh::model::geo::addCircleArc(p[i], c, p[(i + 1) % 4]));
+    int cl = gmsh::model::geo::addCurveLoop(l);
+    int s = gmsh::model::geo::addPlaneSurface({cl});
+    gmsh::vectorpair out;
+    gmsh::model::geo::twist({{2, s}}, x, 0, 0, 0, 0, 2, 0, 0, 1, M_PI / 2, out,
+                            {6}, {}, k == 0);
+  }
+  gmsh::model::geo::synchronize();
+  gmsh::option::setNumber("Mesh.MeshSizeMax", 0.4);
+  gmsh::model::mesh::generate(3);
+  gmsh::model::mesh::setOrder(2);
+
+  std::vector<int> types;
+  std::vector<std::vector<std::size_t> > eleTags, nodeTags;
+  gmsh::model::mesh::getElements(types, eleTags, nodeTags, 3);
+  std::vector<std::size_t> tags;
+  for(auto &t : eleTags) tags.insert(tags.end(), t.begin(), t.end());
+
+  // element by element
+  std::vector<double> minJ, maxJ, icn;
+  gmsh::model::mesh::getElementQualities(tags, minJ, "minDetJac");
+  gmsh::model::mesh::getElementQualities(tags, maxJ, "maxDetJac");
+  gmsh::model::mesh::getElementQualities(tags, icn, "minIsotropy");
+  std::map<std::size_t, double> ratio, minICN;
+  for(std::size_t i = 0; i < tags.size(); i++) {
+    ratio[tags[i]] = 0.;
+    if(maxJ[i] > 0)
+      ratio[tags[i]] = minJ[i] / maxJ[i];
+    else if(maxJ[i] < 0)
+      ratio[tags[i]] = maxJ[i] / minJ[i];
+    minICN[tags[i]] = icn[i];
+  }
+
+  // batched, with the plugin
+  gmsh::plugin::setNumber("AnalyseMeshQuality", "JacobianDeterminant", 1);
+  gmsh::plugin::setNumber("AnalyseMeshQuality", "CreateView", 1);
+  gmsh::plugin::setNumber("AnalyseMeshQuality", "DimensionOfElements", 3);
+  int jacView = gmsh::plugin::run("AnalyseMeshQuality");
+  gmsh::plugin::setNumber("AnalyseMeshQuality", "JacobianDeterminant", 0);
+  gmsh::plugin::setNumber("AnalyseMeshQuality", "ICNMeasure", 1);
+  int icnView = gmsh::plugin::run("AnalyseMeshQuality");
+
+  int numDiff = 0;
+  std::string dataType;
+  std::vector<std::size_t> viewTags;
+  std::vector<std::vector<double> > viewData;
+  double time;
+  int numComp;
+  gmsh::view::getModelData(jacView, 0, dataType, viewTags, viewData, time,
+                           numComp);
+  numDiff += compare("minJ/maxJ", ratio, viewTags, viewData);
+  gmsh::view::getModelData(icnView, 0, dataType, viewTags, viewData, time,
+                           numComp);
+  numDiff += compare("ICN", minICN, viewTags, viewData);
+
+  gmsh::finalize();
+  return numDiff ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <gmsh.h>
+
+// Check that the partitions of a mixed-order mesh (linear triangles on the left
+// half of a rectangle, quadratic triangles on the right half) are balanced when
+// the weight of the elements is scaled by their number of nodes per direction
+// to the power of their dimension (Mesh.PartitionOrderWeight), i.e. with a
+// weight of 4 for the linear triangles and 9 for the quadratic ones. Returns a
+// non-zero exit code if they are not.
+
+static double imbalance(int orderWeight, int numPart)
+{
+  gmsh::clear();
+  gmsh::model::add("partition_order_weight");
+  std::vector<int> p, l;
+  for(int i = 0; i < 3; i++) p.push_back(gmsh::model::geo::addPoint(i, 0, 0));
+  for(int i = 0; i < 3; i++) p.push_back(gmsh::model::geo::addPoint(i, 1, 0));
+  for(int i = 0; i < 2; i++)
+    l.push_back(gmsh::model::geo::addLine(p[i], p[i + 1]));
+  for(int i = 0; i < 2; i++)
+    l.push_back(gmsh::model::geo::addLine(p[i + 3], p[i + 4]));
+  for(int i = 0; i < 3; i++)
+    l.push_back(gmsh::model::geo::addLine(p[i], p[i + 3]));
+  int s1 = gmsh::model::geo::addPlaneSurface(
+    {gmsh::model::geo::addCurveLoop({l[0], l[5], -l[2], -l[4]})});
+  gmsh::model::geo::addPlaneSurface(
+    {gmsh::model::geo::addCurveLoop({l[1], l[6], -l[3], -l[5]})});
+  gmsh::model::geo::synchronize();
+  gmsh::option::setNumber("Mesh.MeshSizeMax", 0.05);
+  gmsh::model::mesh::generate(2);
+  gmsh::model::mesh::setOrder(2);
+
+  // replace the quadratic triangles of the left surface by linear ones
+  std::vector<std::size_t> elementTags, nodeTags, newTags, newNodeTags;
+  gmsh::model::mesh::getElementsByType(9, elementTags, nodeTags, s1);
+  std::size_t maxTag;
+  gmsh::model::mesh::getMaxElementTag(maxTag);
+  for(std::size_t i = 0; i < elementTags.size(); i++) {
+    newTags.push_back(maxTag + 1 + i);
+    for(int j = 0; j < 3; j++) newNodeTags.push_back(nodeTags[6 * i + j]);
+  }
+  gmsh::model::mesh::removeElements(2, s1);
+  gmsh::model::mesh::addElementsByType(s1, 2, newTags, newNodeTags);
+
+  gmsh::option::setNumber("Mesh.PartitionOrderWeight", orderWeight);
+  gmsh::model::mesh::partition(numPart);
+
+  // sum the (order-scaled) weights of the triangles in each partition
+  std::vector<double> weights(numPart, 0.);
+  gmsh::vectorpair entities;
+  gmsh::model::getEntities(entities, 2);
+  for(auto &e : entities) {
+    std::vector<int> partitions;
+    gmsh::model::getPartitions(e.first, e.second, partitions);
+    if(partitions.size() != 1) continue;
+    std::vector<int> elementTypes;
+    std::vector<std::vector<std::size_t> > tags, nodes;
+    gmsh::model::mesh::getElements(elementTypes, tags, nodes, e.first,
+                                   e.second);
+    for(std::size_t i = 0; i < elementTypes.size(); i++) {
+      if(elementTypes[i] == 2)
+        weights[partitions[0] - 1] += 4. * tags[i].size();
+      else if(elementTypes[i] == 9)
+        weights[partitions[0] - 1] += 9. * tags[i].size();
+    }
+  }
+  double sum = 0.;
+  for(auto w : weights) sum += w;
+  return *std::max_element(weights.begin(), weights.end()) * numPart / sum;
+}
+
+int main(int argc, char **argv)
+{
+  gmsh::initialize(argc, argv);
+  gmsh::option::setNumber("General.Terminal", 0);
+
+  const int numPart = 4;
+  double unweighted = imbalance(0, numPart);
+  double weighted = imbalance(1, numPart);
+
+  int ret = 0;
+  printf("load imbalance of %d partitions: %g without order weights, %g with "
+         "order weights\n", numPart, unweighted, weighted);
+  if(weighted > 1.05 || weighted >= unweighted) ret = 1;
+
+  gmsh::finalize();
+  return ret;
+}
@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <gmsh.h>
+
+// Distributed reading of a large MSH4 file: run e.g. with
+//
+//   mpirun -np 4 ./read_distributed mesh.msh
+//
+// with a Gmsh library compiled with MPI support (-DENABLE_MPI=1). Each process
+// reads a share of the file and keeps a compact part of the mesh. Returns a
+// non-zero exit code if the file could not be read or if the local mesh is
+// empty.
+
+int main(int argc, char **argv)
+{
+  std::string fileName;
+  for(int i = 1; i < argc; i++)
+    if(argv[i][0] != '-') fileName = argv[i];
+  if(fileName.empty()) {
+    printf("Usage: %s file.msh\n", argv[0]);
+    return 0;
+  }
+
+  gmsh::initialize(argc, argv);
+  gmsh::model::add("distributed");
+  gmsh::model::mesh::readDistributed(fileName);
+
+  std::vector<std::size_t> nodeTags;
+  std::vector<double> coord, param;
+  gmsh::model::mesh::getNodes(nodeTags, coord, param);
+  std::vector<int> elementTypes;
+  std::vector<std::vector<std::size_t> > elementTags, elementNodeTags;
+  gmsh::model::mesh::getElements(elementTypes, elementTags, elementNodeTags);
+  std::size_t numElements = 0;
+  for(auto &tags : elementTags) numElements += tags.size();
+  gmsh::logger::write("Local mesh: " + std::to_string(nodeTags.size()) +
+                      " nodes, " + std::to_string(numElements) + " elements");
+
+  std::string error;
+  gmsh::logger::getLastError(error);
+  int ret = (!error.empty() || nodeTags.empty() || !numElements) ? 1 : 0;
+
+  gmsh::finalize();
+  return ret;
+}
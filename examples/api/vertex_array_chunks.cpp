@@ -0,0 +1,266 @@
+// Round-trip test of the streaming of vertex arrays by a remote Gmsh (see
+// GmshRemote.cpp and VertexArray.h) over a localhost TCP socket:
+//
+//   vertex_array_chunks gmsh-executable [compression-level]
+//
+// The test writes a post-processing view with a large number of triangles,
+// starts "gmsh view.pos -socket 127.0.0.1:port" and reassembles the chunks of
+// the vertex arrays it sends. It then checks that
+//
+// 1) the triangle vertex array contains exactly the triangles of the view;
+// 2) the arrays sent again on request (after a GMSH_VERTEX_ARRAY_CHUNK
+//    message) are identical to the first ones;
+// 3) when the arrays are recomputed without any change (after a
+//    GMSH_VERTEX_ARRAY message), they are all marked as unchanged, and no data
+//    is sent.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include "GmshSocket.h"
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+// kinds of the chunk messages (see VertexArray.h)
+enum { CHUNK_BEGIN = 1, CHUNK_DATA = 2, CHUNK_END = 3 };
+
+static const int N = 300; // the view has 2 * N * N triangles
+
+class testServer : public GmshServer {
+private:
+  pid_t _pid;
+
+public:
+  testServer() : GmshServer(), _pid(-1) {}
+  pid_t getPid() const { return _pid; }
+  int NonBlockingSystemCall(const std::string &exe, const std::string &args)
+  {
+    std::string cmd = exe + " " + args;
+    _pid = fork();
+    if(_pid == 0) {
+      execl("/bin/sh", "sh", "-c", cmd.c_str(), (char *)nullptr);
+      _exit(127);
+    }
+    return _pid < 0 ? 1 : 0;
+  }
+  int NonBlockingWait(double waitint, double timeout, int socket = -1)
+  {
+    time_t start = time(nullptr);
+    while(1) {
+      if(timeout > 0 && difftime(time(nullptr), start) > timeout) return 2;
+      int ret = Select(0, (int)(waitint * 1e6), socket);
+      if(ret > 0) return 0; // data (or a connection) is available
+      if(ret < 0) return 1; // error
+    }
+  }
+};
+
+// the vertex, normal and color arrays of a vertex array, as received
+struct receivedArrays {
+  std::vector<char> bytes[3];
+  int changed[3] = {0, 0, 0};
+  int numData = 0;
+};
+
+static bool fail(const char *msg)
+{
+  fprintf(stderr, "Error: %s\n", msg);
+  return false;
+}
+
+// receive messages until the end of the last vertex array of the view (the
+// vector array, of type 4), answering the ONELAB parameter queries and
+// reassembling the chunks
+static bool receiveArrays(testServer &server,
+                          std::map<int, receivedArrays> &arrays)
+{
+  arrays.clear();
+  while(1) {
+    if(server.Select(120, 0) <= 0) return fail("timeout waiting for data");
+    int type, length, swap;
+    if(!server.ReceiveHeader(&type, &length, &swap))
+      return fail("could not receive message header");
+    if(swap) return fail("byte swapping is not supported by this test");
+    std::vector<char> msg(length + 1, 0);
+    if(length && !server.ReceiveMessage(length, &msg[0]))
+      return fail("could not receive message body");
+    if(type == GmshSocket::GMSH_PARAMETER_QUERY ||
+       type == GmshSocket::GMSH_PARAMETER_QUERY_ALL ||
+       type == GmshSocket::GMSH_PARAMETER_QUERY_WITHOUT_CHOICES) {
+      // no ONELAB parameters on this side
+      server.SendMessage(GmshSocket::GMSH_PARAMETER_NOT_FOUND, length,
+                         &msg[0]);
+      continue;
+    }
+    if(type == GmshSocket::GMSH_ERROR) {
+      fprintf(stderr, "Remote error: %s\n", &msg[0]);
+      continue;
+    }
+    if(type != GmshSocket::GMSH_VERTEX_ARRAY_CHUNK) continue;
+
+    const int is = sizeof(int), ls = sizeof(int64_t);
+    if(length < 3 * is) return fail("chunk message is too short");
+    int kind, tag, vatype, index = 0;
+    memcpy(&kind, &msg[index], is); index += is;
+    memcpy(&tag, &msg[index], is); index += is;
+    memcpy(&vatype, &msg[index], is); index += is;
+    receivedArrays &a = arrays[vatype];
+    if(kind == CHUNK_BEGIN) {
+      for(int i = 0; i < 3; i++) {
+        int64_t n;
+        memcpy(&n, &msg[index], ls); index += ls;
+        memcpy(&a.changed[i], &msg[index], is); index += is;
+        a.bytes[i].resize(n);
+      }
+    }
+    else if(kind == CHUNK_DATA) {
+      int i, raw, comp;
+      int64_t offset;
+      memcpy(&i, &msg[index], is); index += is;
+      memcpy(&offset, &msg[index], ls); index += ls;
+      memcpy(&raw, &msg[index], is); index += is;
+      memcpy(&comp, &msg[index], is); index += is;
+      if(i < 0 || i > 2 || offset + raw > (int64_t)a.bytes[i].size())
+        return fail("chunk is out of the bounds of its array");
+      char *dst = &a.bytes[i][offset];
+      if(comp) {
+#if defined(HAVE_LIBZ)
+        uLongf dstLen = raw;
+        if(uncompress((Bytef *)dst, &dstLen, (const Bytef *)&msg[index],
+                      length - index) != Z_OK ||
+           (int)dstLen != raw)
+          return fail("could not uncompress chunk");
+#else
+        return fail("received a compressed chunk without zlib support");
+#endif
+      }
+      else {
+        if(length - index != raw) return fail("wrong size of chunk");
+        memcpy(dst, &msg[index], raw);
+      }
+      a.numData++;
+    }
+    else if(kind == CHUNK_END) {
+      if(vatype == 4) return true;
+    }
+    else
+      return fail("unknown kind of chunk");
+  }
+}
+
+static bool checkTriangles(const receivedArrays &a)
+{
+  const std::vector<char> &v = a.bytes[0];
+  std::size_t nv = v.size() / (3 * sizeof(float));
+  if(nv != 6 * (std::size_t)N * N) return fail("wrong number of vertices");
+  if(a.bytes[1].size() % (3 * nv) || a.bytes[2].size() != 4 * nv)
+    return fail("wrong size of normal or color array");
+  std::vector<float> xyz(3 * nv);
+  memcpy(&xyz[0], &v[0], v.size());
+  // each received triangle, with its vertices sorted
+  std::vector<std::array<float, 9> > received(nv / 3), expected;
+  for(std::size_t t = 0; t < nv / 3; t++) {
+    std::array<std::array<float, 3>, 3> p;
+    for(int j = 0; j < 3; j++)
+      for(int k = 0; k < 3; k++) p[j][k] = xyz[9 * t + 3 * j + k];
+    std::sort(p.begin(), p.end());
+    for(int j = 0; j < 9; j++) received[t][j] = p[j / 3][j % 3];
+  }
+  for(int i = 0; i < N; i++) {
+    for(int j = 0; j < N; j++) {
+      float x = i, y = j, x1 = i + 1, y1 = j + 1;
+      expected.push_back({x, y, 0, x, y1, 0, x1, y, 0});
+      expected.push_back({x, y1, 0, x1, y, 0, x1, y1, 0});
+    }
+  }
+  std::sort(received.begin(), received.end());
+  std::sort(expected.begin(), expected.end());
+  if(received != expected) return fail("received triangles differ");
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  if(argc < 2) {
+    printf("Usage: %s gmsh-executable [compression-level]\n", argv[0]);
+    return 1;
+  }
+  std::string level = (argc > 2) ? argv[2] : "0";
+
+  const char *fileName = "vertex_array_chunks.pos";
+  FILE *fp = fopen(fileName, "w");
+  if(!fp) return !fail("could not create view file");
+  fprintf(fp, "View \"chunks\" {\n");
+  for(int i = 0; i < N; i++) {
+    for(int j = 0; j < N; j++) {
+      fprintf(fp, "ST(%d,%d,0,%d,%d,0,%d,%d,0){%d,%d,%d};\n", i, j, i + 1, j,
+              i, j + 1, i, i + 1, i);
+      fprintf(fp, "ST(%d,%d,0,%d,%d,0,%d,%d,0){%d,%d,%d};\n", i + 1, j,
+              i + 1, j + 1, i, j + 1, i + 1, i + 1, i);
+    }
+  }
+  fprintf(fp, "};\n");
+  fclose(fp);
+
+  testServer server;
+  std::string args = std::string(fileName) +
+                     " -setnumber Solver.RemoteCompression " + level +
+                     " -socket %s";
+  try {
+    if(server.Start(argv[1], args, "127.0.0.1:0", 60.) < 0)
+      return !fail("could not start remote Gmsh");
+  } catch(std::runtime_error &e) {
+    return !fail(e.what());
+  }
+
+  bool ok = true;
+  std::map<int, receivedArrays> first, second, third;
+
+  // 1) initial arrays
+  ok = ok && receiveArrays(server, first) && checkTriangles(first[3]);
+
+  // 2) full resend on request
+  if(ok) {
+    int request[2] = {1, 3};
+    server.SendMessage(GmshSocket::GMSH_VERTEX_ARRAY_CHUNK, sizeof(request),
+                       request);
+    ok = receiveArrays(server, second);
+  }
+  for(int t = 1; ok && t <= 4; t++) {
+    for(int i = 0; i < 3; i++) {
+      if(!second[t].changed[i] || second[t].bytes[i] != first[t].bytes[i])
+        ok = fail("arrays sent again differ from the first ones");
+    }
+  }
+
+  // 3) recomputed arrays without any change
+  if(ok) {
+    server.SendString(GmshSocket::GMSH_VERTEX_ARRAY, "// no change");
+    ok = receiveArrays(server, third);
+  }
+  for(int t = 1; ok && t <= 4; t++) {
+    for(int i = 0; i < 3; i++) {
+      if(third[t].changed[i] || third[t].numData)
+        ok = fail("unchanged arrays have been sent again");
+    }
+  }
+
+  server.SendString(GmshSocket::GMSH_STOP, "Goodbye!");
+  int status = 0;
+  if(server.getPid() > 0) waitpid(server.getPid(), &status, 0);
+  server.Shutdown();
+  remove(fileName);
+
+  if(ok) printf("Vertex arrays received correctly\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,613 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "GmshConfig.h"
+#include "GmshMessage.h"
+#include "Context.h"
+#include "StringUtils.h"
+#include "CompressedFile.h"
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(HAVE_LIBZ) || defined(HAVE_ZSTD)
+
+enum { COMPRESSION_NONE, COMPRESSION_GZIP, COMPRESSION_ZSTD };
+
+static int GetCompressionFromExtension(const std::string &fileName)
+{
+  std::string ext = SplitFileName(fileName)[2];
+#if defined(HAVE_LIBZ)
+  if(ext == ".gz" || ext == ".GZ") return COMPRESSION_GZIP;
+#endif
+#if defined(HAVE_ZSTD)
+  if(ext == ".zst" || ext == ".ZST") return COMPRESSION_ZSTD;
+#endif
+  return COMPRESSION_NONE;
+}
+
+static int GetCompressionFromMagicNumber(const unsigned char *m, std::size_t n)
+{
+#if defined(HAVE_LIBZ)
+  if(n >= 2 && m[0] == 0x1f && m[1] == 0x8b) return COMPRESSION_GZIP;
+#endif
+#if defined(HAVE_ZSTD)
+  if(n >= 4 && m[0] == 0x28 && m[1] == 0xb5 && m[2] == 0x2f && m[3] == 0xfd)
+    return COMPRESSION_ZSTD;
+#endif
+  return COMPRESSION_NONE;
+}
+
+// size of the uncompressed data in the blocks we read and write
+static const std::size_t blockSize = 1 << 20;
+
+#if defined(HAVE_LIBZ)
+
+// Each gzip member we write starts with a 20 bytes header: magic number,
+// deflate method, FEXTRA flag, no modification time, no extra flags, unknown
+// OS, then an 8 bytes extra field containing a "GM" subfield with the total
+// size of the member. The 8 bytes trailer is the standard CRC32 and size of
+// the uncompressed data.
+static const std::size_t gzipHeaderSize = 20;
+static const std::size_t gzipTrailerSize = 8;
+
+static void PutLE32(unsigned char *p, unsigned long v)
+{
+  for(int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xff;
+}
+
+static unsigned long GetLE32(const unsigned char *p)
+{
+  return (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+         ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static bool DeflateMember(const std::vector<char> &in,
+                          std::vector<unsigned char> &out)
+{
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if(deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                  Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  out.resize(gzipHeaderSize + deflateBound(&zs, in.size()) + gzipTrailerSize);
+  zs.next_in = (Bytef *)in.data();
+  zs.avail_in = in.size();
+  zs.next_out = &out[gzipHeaderSize];
+  zs.avail_out = out.size() - gzipHeaderSize - gzipTrailerSize;
+  int ret = deflate(&zs, Z_FINISH);
+  deflateEnd(&zs);
+  if(ret != Z_STREAM_END) return false;
+  std::size_t size = gzipHeaderSize + zs.total_out + gzipTrailerSize;
+  out.resize(size);
+  const unsigned char header[16] = {0x1f, 0x8b, 8,   4,   0,   0, 0, 0,
+                                    0,    255,  8,   0,   'G', 'M', 4, 0};
+  memcpy(&out[0], header, sizeof(header));
+  PutLE32(&out[16], size);
+  PutLE32(&out[size - 8], crc32(0L, (const Bytef *)in.data(), in.size()));
+  PutLE32(&out[size - 4], in.size());
+  return true;
+}
+
+static bool InflateMember(const std::vector<unsigned char> &in,
+                          std::vector<char> &out)
+{
+  const unsigned char *trailer = &in[in.size() - gzipTrailerSize];
+  out.resize(GetLE32(trailer + 4));
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if(inflateInit2(&zs, -MAX_WBITS) != Z_OK) return false;
+  unsigned char dummy;
+  zs.next_in = const_cast<Bytef *>(&in[gzipHeaderSize]);
+  zs.avail_in = in.size() - gzipHeaderSize - gzipTrailerSize;
+  zs.next_out = out.empty() ? &dummy : (Bytef *)&out[0];
+  zs.avail_out = out.size();
+  int ret = inflate(&zs, Z_FINISH);
+  inflateEnd(&zs);
+  return ret == Z_STREAM_END && !zs.avail_out &&
+         crc32(0L, (const Bytef *)out.data(), out.size()) == GetLE32(trailer);
+}
+
+#endif
+
+class compressedStream {
+private:
+  FILE *_fp;
+  std::string _fileName;
+  int _compression, _numThreads;
+  bool _write, _parallel, _inputEnd, _frameEnd, _error;
+  // uncompressed data: current block, position in the current block and
+  // position of the current block in the file
+  std::vector<char> _data;
+  std::size_t _pos;
+  long long _offset;
+  // uncompressed blocks ready to be read, or waiting to be compressed
+  std::deque<std::vector<char> > _blocks;
+  // buffered compressed data
+  std::vector<unsigned char> _in;
+  std::size_t _inPos, _inSize;
+  std::vector<char> _out;
+#if defined(HAVE_LIBZ)
+  z_stream _zs;
+  bool _zsInit;
+#endif
+#if defined(HAVE_ZSTD)
+  ZSTD_DCtx *_zd;
+  ZSTD_CCtx *_zc;
+#endif
+  void _setError(const char *msg)
+  {
+    if(!_error) Msg::Error("%s '%s'", msg, _fileName.c_str());
+    _error = true;
+  }
+  bool _readInput()
+  {
+    if(_inPos) {
+      memmove(&_in[0], &_in[_inPos], _inSize - _inPos);
+      _inSize -= _inPos;
+      _inPos = 0;
+    }
+    std::size_t n = fread(&_in[_inSize], 1, _in.size() - _inSize, _fp);
+    _inSize += n;
+    return n > 0;
+  }
+#if defined(HAVE_LIBZ)
+  // read the next members written with a "GM" extra field (one per thread)
+  // and decompress them in parallel; switch to sequential decompression as
+  // soon as another kind of member is found
+  void _inflateMembers()
+  {
+    std::vector<std::vector<unsigned char> > members;
+    while((int)members.size() < _numThreads) {
+      unsigned char h[gzipHeaderSize];
+      std::size_t n = fread(h, 1, gzipHeaderSize, _fp);
+      if(!n) {
+        _inputEnd = true;
+        break;
+      }
+      std::size_t size = 0;
+      if(n == gzipHeaderSize && h[0] == 0x1f && h[1] == 0x8b && h[2] == 8 &&
+         h[3] == 4 && h[10] == 8 && h[11] == 0 && h[12] == 'G' &&
+         h[13] == 'M' && h[14] == 4 && h[15] == 0)
+        size = GetLE32(&h[16]);
+      if(size < gzipHeaderSize + gzipTrailerSize) {
+        memcpy(&_in[0], h, n);
+        _inPos = 0;
+        _inSize = n;
+        _parallel = false;
+        break;
+      }
+      members.push_back(std::vector<unsigned char>(size));
+      std::vector<unsigned char> &m = members.back();
+      memcpy(&m[0], h, gzipHeaderSize);
+      if(fread(&m[gzipHeaderSize], 1, size - gzipHeaderSize, _fp) !=
+         size - gzipHeaderSize) {
+        _setError("Unexpected end of compressed file");
+        return;
+      }
+    }
+    std::vector<std::vector<char> > out(members.size());
+    std::vector<char> ok(members.size(), 0);
+#pragma omp parallel for schedule(dynamic) num_threads(_numThreads)
+    for(int i = 0; i < (int)members.size(); i++)
+      ok[i] = InflateMember(members[i], out[i]);
+    for(std::size_t i = 0; i < out.size(); i++) {
+      if(!ok[i]) {
+        _setError("Could not decompress file");
+        return;
+      }
+      _blocks.push_back(std::vector<char>());
+      _blocks.back().swap(out[i]);
+    }
+  }
+  void _inflate()
+  {
+    if(!_zsInit) {
+      memset(&_zs, 0, sizeof(_zs));
+      if(inflateInit2(&_zs, MAX_WBITS + 16) != Z_OK) {
+        _setError("Could not decompress file");
+        return;
+      }
+      _zsInit = true;
+    }
+    std::vector<char> out(blockSize);
+    _zs.next_out = (Bytef *)&out[0];
+    _zs.avail_out = out.size();
+    while(_zs.avail_out && !_inputEnd) {
+      if(_inPos == _inSize) _readInput();
+      _zs.next_in = &_in[_inPos];
+      _zs.avail_in = _inSize - _inPos;
+      int ret = inflate(&_zs, Z_NO_FLUSH);
+      _inPos = _inSize - _zs.avail_in;
+      if(ret == Z_STREAM_END) {
+        // the file can contain several concatenated members
+        if(_inSize - _inPos < 2) _readInput();
+        if(_inSize - _inPos < 2 || _in[_inPos] != 0x1f ||
+           _in[_inPos + 1] != 0x8b)
+          _inputEnd = true;
+        else
+          inflateReset(&_zs);
+      }
+      else if(ret == Z_BUF_ERROR && _inPos == _inSize) {
+        _setError("Unexpected end of compressed file");
+        break;
+      }
+      else if(ret != Z_OK) {
+        _setError("Could not decompress file");
+        break;
+      }
+    }
+    out.resize(out.size() - _zs.avail_out);
+    _blocks.push_back(std::vector<char>());
+    _blocks.back().swap(out);
+  }
+  // compress the waiting blocks in parallel, and write them as independent
+  // members
+  void _deflateBlocks()
+  {
+    std::vector<std::vector<unsigned char> > members(_blocks.size());
+    std::vector<char> ok(_blocks.size(), 0);
+#pragma omp parallel for schedule(dynamic) num_threads(_numThreads)
+    for(int i = 0; i < (int)_blocks.size(); i++)
+      ok[i] = DeflateMember(_blocks[i], members[i]);
+    _blocks.clear();
+    for(std::size_t i = 0; i < members.size(); i++) {
+      if(!ok[i] || fwrite(&members[i][0], 1, members[i].size(), _fp) !=
+                     members[i].size()) {
+        _setError("Could not write compressed file");
+        return;
+      }
+    }
+  }
+#endif
+#if defined(HAVE_ZSTD)
+  void _zstdDecompress()
+  {
+    std::vector<char> out(blockSize);
+    ZSTD_outBuffer o = {&out[0], out.size(), 0};
+    while(o.pos < o.size && !_inputEnd) {
+      if(_inPos == _inSize) _readInput();
+      ZSTD_inBuffer i = {&_in[_inPos], _inSize - _inPos, 0};
+      std::size_t before = o.pos;
+      std::size_t ret = ZSTD_decompressStream(_zd, &o, &i);
+      _inPos += i.pos;
+      if(ZSTD_isError(ret)) {
+        _setError("Could not decompress file");
+        break;
+      }
+      if(!i.pos && o.pos == before) {
+        if(!_frameEnd) _setError("Unexpected end of compressed file");
+        _inputEnd = true;
+        break;
+      }
+      _frameEnd = !ret;
+    }
+    out.resize(o.pos);
+    _blocks.push_back(std::vector<char>());
+    _blocks.back().swap(out);
+  }
+  bool _zstdCompress(const char *buf, std::size_t size, ZSTD_EndDirective mode)
+  {
+    ZSTD_inBuffer i = {buf, size, 0};
+    while(true) {
+      ZSTD_outBuffer o = {&_out[0], _out.size(), 0};
+      std::size_t ret = ZSTD_compressStream2(_zc, &o, &i, mode);
+      if(ZSTD_isError(ret) || fwrite(&_out[0], 1, o.pos, _fp) != o.pos) {
+        _setError("Could not write compressed file");
+        return false;
+      }
+      if(mode == ZSTD_e_end ? !ret : i.pos == i.size) return true;
+    }
+  }
+#endif
+  void _decompress()
+  {
+    if(_error || _inputEnd) return;
+#if defined(HAVE_LIBZ)
+    if(_compression == COMPRESSION_GZIP) {
+      if(_parallel) {
+        _inflateMembers();
+        if(_parallel || !_blocks.empty()) return;
+      }
+      _inflate();
+    }
+#endif
+#if defined(HAVE_ZSTD)
+    if(_compression == COMPRESSION_ZSTD) _zstdDecompress();
+#endif
+  }
+  bool _next()
+  {
+    if(_blocks.empty()) _decompress();
+    if(_blocks.empty()) return false;
+    _offset += _data.size();
+    _data.swap(_blocks.front());
+    _blocks.pop_front();
+    _pos = 0;
+    return true;
+  }
+  void _restart()
+  {
+    fseek(_fp, 0, SEEK_SET);
+    _data.clear();
+    _blocks.clear();
+    _pos = _inPos = _inSize = 0;
+    _offset = 0;
+    _parallel = (_compression == COMPRESSION_GZIP);
+    _inputEnd = false;
+    _frameEnd = true;
+#if defined(HAVE_LIBZ)
+    if(_zsInit) inflateReset(&_zs);
+#endif
+#if defined(HAVE_ZSTD)
+    if(_zd) ZSTD_DCtx_reset(_zd, ZSTD_reset_session_only);
+#endif
+  }
+
+public:
+  compressedStream(FILE *fp, const std::string &fileName, int compression,
+                   bool write)
+    : _fp(fp), _fileName(fileName), _compression(compression), _write(write),
+      _parallel(compression == COMPRESSION_GZIP), _inputEnd(false),
+      _frameEnd(true), _error(false), _pos(0), _offset(0), _inPos(0),
+      _inSize(0)
+  {
+    _numThreads = CTX::instance()->numThreads;
+    if(!_numThreads) _numThreads = Msg::GetMaxThreads();
+    _numThreads = std::max(1, _numThreads);
+    if(_write)
+      _data.reserve(blockSize);
+    else
+      _in.resize(1 << 18);
+#if defined(HAVE_LIBZ)
+    _zsInit = false;
+#endif
+#if defined(HAVE_ZSTD)
+    _zd = nullptr;
+    _zc = nullptr;
+    if(_compression == COMPRESSION_ZSTD) {
+      if(_write) {
+        _zc = ZSTD_createCCtx();
+        // this is ignored if zstd was compiled without multithreading
+        if(_numThreads > 1)
+          ZSTD_CCtx_setParameter(_zc, ZSTD_c_nbWorkers, _numThreads);
+        _out.resize(ZSTD_CStreamOutSize());
+      }
+      else
+        _zd = ZSTD_createDCtx();
+    }
+#endif
+  }
+  ~compressedStream()
+  {
+#if defined(HAVE_LIBZ)
+    if(_zsInit) inflateEnd(&_zs);
+#endif
+#if defined(HAVE_ZSTD)
+    if(_zd) ZSTD_freeDCtx(_zd);
+    if(_zc) ZSTD_freeCCtx(_zc);
+#endif
+  }
+  long long tell() const
+  {
+    return _offset + (long long)(_write ? _data.size() : _pos);
+  }
+  long long read(char *buf, std::size_t size)
+  {
+    std::size_t n = 0;
+    while(n < size) {
+      if(_pos == _data.size() && !_next()) break;
+      std::size_t m = std::min(size - n, _data.size() - _pos);
+      if(m) memcpy(buf + n, &_data[_pos], m);
+      _pos += m;
+      n += m;
+    }
+    if(!n && _error) return -1;
+    return n;
+  }
+  long long write(const char *buf, std::size_t size)
+  {
+    if(_error) return -1;
+#if defined(HAVE_ZSTD)
+    if(_compression == COMPRESSION_ZSTD) {
+      if(!_zstdCompress(buf, size, ZSTD_e_continue)) return -1;
+      _offset += size;
+      return size;
+    }
+#endif
+#if defined(HAVE_LIBZ)
+    std::size_t n = 0;
+    while(n < size) {
+      if(_data.size() == blockSize) {
+        _offset += _data.size();
+        _blocks.push_back(std::vector<char>());
+        _blocks.back().swap(_data);
+        _data.reserve(blockSize);
+        if((int)_blocks.size() >= _numThreads) _deflateBlocks();
+        if(_error) return -1;
+      }
+      std::size_t m = std::min(size - n, blockSize - _data.size());
+      _data.insert(_data.end(), buf + n, buf + n + m);
+      n += m;
+    }
+#endif
+    return size;
+  }
+  long long seek(long long offset, int whence)
+  {
+    long long pos = tell();
+    if(whence == SEEK_SET)
+      pos = offset;
+    else if(whence == SEEK_CUR)
+      pos += offset;
+    else
+      return -1;
+    if(_write) return (pos == tell()) ? pos : -1;
+    if(pos < 0) return -1;
+    if(pos < _offset) _restart();
+    while(pos > _offset + (long long)_data.size()) {
+      if(!_next()) return -1;
+    }
+    _pos = pos - _offset;
+    return pos;
+  }
+  int close()
+  {
+    if(_write) {
+#if defined(HAVE_LIBZ)
+      if(_compression == COMPRESSION_GZIP) {
+        // always write at least one member, so that the file is valid
+        if(!_data.empty() || !_offset) {
+          _blocks.push_back(std::vector<char>());
+          _blocks.back().swap(_data);
+        }
+        _deflateBlocks();
+      }
+#endif
+#if defined(HAVE_ZSTD)
+      if(_compression == COMPRESSION_ZSTD) _zstdCompress(nullptr, 0, ZSTD_e_end);
+#endif
+    }
+    int ret = fclose(_fp);
+    return (ret || _error) ? EOF : 0;
+  }
+};
+
+#if defined(__GLIBC__)
+
+static ssize_t CookieRead(void *c, char *buf, size_t size)
+{
+  return ((compressedStream *)c)->read(buf, size);
+}
+
+static ssize_t CookieWrite(void *c, const char *buf, size_t size)
+{
+  long long n = ((compressedStream *)c)->write(buf, size);
+  return (n < 0) ? 0 : n;
+}
+
+static int CookieSeek(void *c, off64_t *offset, int whence)
+{
+  long long pos = ((compressedStream *)c)->seek(*offset, whence);
+  if(pos < 0) return -1;
+  *offset = pos;
+  return 0;
+}
+
+static int CookieClose(void *c)
+{
+  compressedStream *s = (compressedStream *)c;
+  int ret = s->close();
+  delete s;
+  return ret;
+}
+
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) ||   \
+  defined(__NetBSD__)
+
+#define HAVE_FUNOPEN
+
+static int CookieRead(void *c, char *buf, int size)
+{
+  return (int)((compressedStream *)c)->read(buf, size);
+}
+
+static int CookieWrite(void *c, const char *buf, int size)
+{
+  return (int)((compressedStream *)c)->write(buf, size);
+}
+
+static fpos_t CookieSeek(void *c, fpos_t offset, int whence)
+{
+  return ((compressedStream *)c)->seek(offset, whence);
+}
+
+static int CookieClose(void *c)
+{
+  compressedStream *s = (compressedStream *)c;
+  int ret = s->close();
+  delete s;
+  return ret;
+}
+
+#endif
+
+#endif
+
+bool IsCompressedFileName(const std::string &fileName)
+{
+#if defined(HAVE_LIBZ) || defined(HAVE_ZSTD)
+  return GetCompressionFromExtension(fileName) != COMPRESSION_NONE;
+#else
+  return false;
+#endif
+}
+
+FILE *OpenCompressedStream(FILE *fp, const std::string &fileName,
+                           const char *mode)
+{
+#if defined(HAVE_LIBZ) || defined(HAVE_ZSTD)
+  if(!fp || strchr(mode, '+')) return fp;
+  int compression = GetCompressionFromExtension(fileName);
+  bool write = (mode[0] == 'w' || mode[0] == 'a');
+  if(!write) {
+    // read files which are not actually compressed as is
+    unsigned char magic[4];
+    std::size_t n = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+    compression = GetCompressionFromMagicNumber(magic, n);
+  }
+  if(compression == COMPRESSION_NONE) return fp;
+
+  compressedStream *s = new compressedStream(fp, fileName, compression, write);
+#if defined(__GLIBC__) || defined(HAVE_FUNOPEN)
+#if defined(__GLIBC__)
+  cookie_io_functions_t io = {CookieRead, CookieWrite, CookieSeek,
+                              CookieClose};
+  FILE *f = fopencookie(s, write ? "w" : "r", io);
+#else
+  FILE *f = funopen(s, write ? nullptr : CookieRead,
+                    write ? CookieWrite : nullptr, CookieSeek, CookieClose);
+#endif
+  if(!f) {
+    s->close();
+    delete s;
+    return nullptr;
+  }
+  setvbuf(f, nullptr, _IOFBF, 1 << 16);
+  return f;
+#else
+  // no custom streams on this platform: decompress in a temporary file, and
+  // write uncompressed data
+  if(write) {
+    Msg::Warning("Compressed output not available on this platform: writing "
+                 "uncompressed data in '%s'", fileName.c_str());
+    delete s;
+    return fp;
+  }
+  FILE *f = tmpfile();
+  if(f) {
+    std::vector<char> buf(blockSize);
+    long long n;
+    while((n = s->read(&buf[0], buf.size())) > 0) fwrite(&buf[0], 1, n, f);
+    rewind(f);
+  }
+  s->close();
+  delete s;
+  return f;
+#endif
+#else
+  return fp;
+#endif
+}
@@ -0,0 +1,34 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef COMPRESSED_FILE_H
+#define COMPRESSED_FILE_H
+
+#include <string>
+#include <stdio.h>
+
+// Return true if the extension of 'fileName' corresponds to a compression
+// format that can be read and written in-process: ".gz" (with zlib) or ".zst"
+// (with zstd).
+bool IsCompressedFileName(const std::string &fileName);
+
+// Wrap the stream 'fp', opened in binary mode on the compressed file
+// 'fileName', in a standard stream which transparently decompresses the data
+// on the fly (in read mode) or compresses it on the fly (in write or append
+// mode), so that the usual stdio functions can be used on the uncompressed
+// data. Closing the returned stream closes 'fp'. In read mode, 'fp' itself is
+// returned if the file is not actually compressed.
+//
+// Gzip files are written as a series of independently compressed members of
+// 1 Mb of uncompressed data (in a standard way, so that they can still be
+// decompressed by any gzip tool), whose compressed size is stored in an extra
+// header field: this allows to compress them and to decompress them in
+// parallel. Other gzip files and zstd files are decompressed sequentially.
+// Backward seeks in read mode restart the decompression from the beginning of
+// the file.
+FILE *OpenCompressedStream(FILE *fp, const std::string &fileName,
+                           const char *mode);
+
+#endif
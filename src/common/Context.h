@@ -33,7 +33,7 @@ struct contextMeshOptions {
   int recombine3DAll, recombine3DLevel, recombine3DConformity;
   int flexibleTransfinite, quasiTransfinite, transfiniteTri, maxRetries;
   int order, secondOrderLinear, secondOrderIncomplete;
-  int meshOnlyVisible, meshOnlyEmpty;
+  int meshOnlyVisible, meshOnlyEmpty, incremental;
   int minCircleNodes, minCurveNodes, minLineNodes;
   int hoOptimize, hoPeriodic, hoNLayers, hoPrimSurfMesh, hoIterMax, hoPassMax;
   int hoDistCAD, hoSavePeriodic, hoFixBndNodes, hoSkipQualityCheck;
@@ -69,13 +69,15 @@ struct contextMeshOptions {
   int cgnsImportIgnoreBC, cgnsImportIgnoreSolution, cgnsImportOrder;
   int cgnsConstructTopology, cgnsExportCPEX0045, cgnsExportStructured;
   int preserveNumberingMsh2, createTopologyMsh2;
+  std::string streamFileName;
   // partitioning
   int numPartitions, partitionCreateTopology, partitionCreateGhostCells;
   int partitionCreatePhysicals, partitionSplitMeshFiles;
   int partitionSaveTopologyFile, partitionTriWeight, partitionQuaWeight;
   int partitionTetWeight, partitionHexWeight, partitionLinWeight;
   int partitionPriWeight, partitionPyrWeight, partitionTrihWeight;
-  int partitionOldStyleMsh2, partitionConvertMsh2;
+  int partitionOrderWeight, partitionOldStyleMsh2, partitionConvertMsh2;
+  std::string partitionHierarchy;
   int metisAlgorithm, metisEdgeMatching, metisRefinementAlgorithm;
   int metisObjective, metisMinConn;
   double metisMaxLoadImbalance;
@@ -88,6 +90,8 @@ struct contextMeshOptions {
   double nodeSize, lineWidth;
   int dual, voronoi, drawSkinOnly, colorCarousel, labelSampling;
   int smoothNormals, clip;
+  int levelOfDetail;
+  double levelOfDetailPixels;
   // records cpu times for 1D, 2D and 3D mesh generation
   double timer[3];
   // records minimal and average mesh quality after 2D and 3D mesh generation
@@ -107,8 +111,10 @@ struct contextGeometryOptions {
   int occSewFaces, occMakeSolids, occParallel;
   int occBoundsUseSTL, occDisableSTL, occImportLabels, occExportOnlyVisible;
   int occBooleanCheckInverted, occBooleanGlue, occBooleanNonDestructive;
-  int occBooleanPreserveNumbering, occBooleanSimplify;
+  int occBooleanPreserveNumbering, occBooleanSimplify, occBooleanClusters;
   int occThruSectionsDegree, occUseGenericClosestPoint;
+  int occEvaluationCache;
+  double occEvaluationCacheTolerance;
   int occBrepFormatVersion;
   double occScaling;
   std::string occTargetUnit;
@@ -267,6 +273,13 @@ public:
   int drawBBox, drawRotationCenter;
   // draw simplified model during user interaction?
   int fastRedraw;
+  // use vertex buffer objects (0: never, 1: except with software rendering,
+  // 2: always)?
+  int vertexBuffers;
+  // display the time taken to draw each frame?
+  int displayFrameTime;
+  // is the user currently rotating, panning or zooming the model?
+  int interacting;
   // small axes options
   int smallAxes, smallAxesSize, smallAxesPos[2];
   // large axes options
@@ -348,7 +361,7 @@ public:
   } post;
   // solver options
   struct {
-    int plugins, listen;
+    int plugins, listen, remoteCompression;
     double timeout;
     std::string socketName, pythonInterpreter, octaveInterpreter;
     std::string name[NUM_SOLVERS], extension[NUM_SOLVERS];
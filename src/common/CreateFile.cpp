@@ -13,6 +13,7 @@
 #include "OpenFile.h"
 #include "CreateFile.h"
 #include "OS.h"
+#include "CompressedFile.h"
 
 #if defined(HAVE_OPENGL)
 #include "drawContext.h"
@@ -101,8 +102,16 @@ int GetFileFormatFromExtension(const std::string &ext, double *version)
 
 int GuessFileFormatFromFileName(const std::string &fileName, double *version)
 {
-  std::string ext = SplitFileName(fileName)[2];
-  return GetFileFormatFromExtension(ext, version);
+  std::vector<std::string> split = SplitFileName(fileName);
+  int format = GetFileFormatFromExtension(split[2], version);
+  if(format < 0 && IsCompressedFileName(fileName)) {
+    // MSH, POS and STL files can be compressed in-process, on the fly
+    std::string ext = SplitFileName(split[0] + split[1])[2];
+    format = GetFileFormatFromExtension(ext, version);
+    if(format != FORMAT_MSH && format != FORMAT_POS && format != FORMAT_STL)
+      format = -1;
+  }
+  return format;
 }
 
 std::string GetDefaultFileExtension(int format, bool onlyMeshFormats)
@@ -201,6 +201,16 @@ StringXString GeometryOptions_String[] = {
 } ;
 
 StringXString MeshOptions_String[] = {
+  { F|O, "PartitionHierarchy" , opt_mesh_partition_hierarchy , "" ,
+    "Number of partitions at each level of a hierarchical partitioning, e.g. "
+    "\"4 2 8\" for 4 nodes with 2 sockets of 8 cores each: the mesh is first "
+    "partitioned across the first level, then each partition is partitioned "
+    "recursively, and the final partitions are numbered consecutively within "
+    "each level (empty for a flat partitioning)" },
+  { F, "StreamFileName" , opt_mesh_stream_file_name , "" ,
+    "File in which the 3D mesh is streamed (in MSH 4.1 format) while it is "
+    "generated, region by region, so that the complete mesh is never stored in "
+    "memory (empty to disable streaming)" },
   { 0, nullptr , nullptr , "" , nullptr }
 } ;
 
@@ -560,6 +570,9 @@ StringXNumber GeneralOptions_Number[] = {
     "On Windows, should processes created by Gmsh be detached?" },
   { F|O, "DisplayBorderFactor" , opt_general_display_border_factor , 0.2 ,
     "Border factor for model display (0: model fits window size exactly)" },
+  { F|O, "DisplayFrameTime" , opt_general_display_frame_time , 0. ,
+    "Display the time taken to draw each frame of the graphic window in the "
+    "status bar" },
   { F|O, "DoubleBuffer" , opt_general_double_buffer , 1. ,
     "Use a double buffered graphic window (on Unix, should be set to 0 when "
     "working on a remote host without GLX)" },
@@ -875,6 +888,10 @@ StringXNumber GeneralOptions_Number[] = {
 
   { F|O, "VectorType" , opt_general_vector_type , 4 ,
     "Default vector display type (for normals, etc.)" },
+  { F|O, "VertexBuffers" , opt_general_vertex_buffers , 1. ,
+    "Store the mesh and post-processing vertex arrays in graphics memory "
+    "(0: never, 1: unless the OpenGL renderer is a software rasterizer, e.g. "
+    "Mesa llvmpipe, 2: always)" },
   { F|O, "Verbosity" , opt_general_verbosity , 5. ,
     "Level of information printed on the terminal and the message console "
     "(0: silent except for fatal errors, 1: +errors, 2: +warnings, 3: +direct, "
@@ -973,6 +990,9 @@ StringXNumber GeometryOptions_Number[] = {
     "new entities with the OpenCASCADE kernel" },
   { F|O, "OCCBooleanCheckInverted" , opt_geometry_occ_boolean_check_inverted , 1. ,
     "Check input solid in boolean operations for inverted status?" },
+  { F|O, "OCCBooleanClusters" , opt_geometry_occ_boolean_clusters , 0. ,
+    "Compute boolean fragments separately (and concurrently) on clusters of "
+    "shapes with overlapping bounding boxes, instead of on all the shapes at once" },
   { F|O, "OCCBooleanGlue" , opt_geometry_occ_boolean_glue , 0. ,
     "Try to speed up boolean operation by speeding up the interference between "
     "shapes that do overlap but do not have real intersections (0: off, 1: allow "
@@ -991,6 +1011,13 @@ StringXNumber GeometryOptions_Number[] = {
     "1, 2, 3: currently supported versions)" },
   { F|O, "OCCDisableStl" , opt_geometry_occ_disable_stl , 0. ,
     "Disable STL creation in OpenCASCADE kernel" },
+  { F|O, "OCCEvaluationCache" , opt_geometry_occ_evaluation_cache , 0. ,
+    "Cache piecewise bicubic approximations of BSpline, Bezier and general "
+    "surfaces in the OpenCASCADE kernel, used instead of the exact evaluation of "
+    "points, normals and first derivatives when they are accurate enough" },
+  { F|O, "OCCEvaluationCacheTolerance" , opt_geometry_occ_evaluation_cache_tolerance , 1e-6 ,
+    "Relative tolerance of the approximations cached with OCCEvaluationCache, with "
+    "respect to the size of the approximated surface patches" },
   { F|O, "OCCFixDegenerated" , opt_geometry_occ_fix_degenerated , 0. ,
     "Fix degenerated edges/faces when importing STEP, IGES and BRep models with the "
     "OpenCASCADE kernel" },
@@ -1281,6 +1308,13 @@ StringXNumber MeshOptions_Number[] = {
   { F|O, "IgnorePeriodicity" , opt_mesh_ignore_periodicity , 1. ,
     "Skip periodic node section and skip periodic boundary alignment step when "
     "reading meshes in the MSH2 format" },
+  { F|O, "Incremental" , opt_mesh_incremental , 0. ,
+    "Only regenerate the mesh of the entities that have changed since the last "
+    "mesh generation (entities without mesh, whose mesh does not lie on their "
+    "geometry anymore or whose mesh constraints have been changed through the "
+    "API), and of the entities that depend on them; reuse the mesh of all the "
+    "other entities. Mesh constraints changed in .geo scripts are not detected: "
+    "use `gmsh/model/mesh/setOutdated' to force the remeshing of an entity" },
 
   { F|O, "LabelSampling" , opt_mesh_label_sampling , 1. ,
     "Label sampling rate (display one label every `LabelSampling' elements)" },
@@ -1289,6 +1323,15 @@ StringXNumber MeshOptions_Number[] = {
     "2: physical entity tag, 3: partition, 4: coordinates)" },
   { F|O, "LcIntegrationPrecision" , opt_mesh_lc_integration_precision, 1.e-9 ,
     "Accuracy of evaluation of the LC field for 1D mesh generation" },
+  { F|O, "LevelOfDetail" , opt_mesh_level_of_detail , 0. ,
+    "Split the mesh vertex arrays into spatial clusters, which are not drawn "
+    "if they are outside of the view or clipped, and which are drawn with a "
+    "simplified representation if their details are smaller than "
+    "`LevelOfDetailPixels' (0: no clusters, 1: simplified representations "
+    "only while rotating, panning and zooming, 2: always)" },
+  { F|O, "LevelOfDetailPixels" , opt_mesh_level_of_detail_pixels , 2. ,
+    "Size (in pixels) under which details are not drawn with "
+    "`LevelOfDetail'" },
   { F|O, "Light" , opt_mesh_light , 1. ,
     "Enable lighting for the mesh" },
   { F|O, "LightLines" , opt_mesh_light_lines , 2. ,
@@ -1448,6 +1491,10 @@ StringXNumber MeshOptions_Number[] = {
     "Weight of tetrahedral element for METIS load balancing (-1: automatic)" },
   { F|O, "PartitionTriWeight" , opt_mesh_partition_tri_weight , -1 ,
     "Weight of triangle element for METIS load balancing (-1: automatic)" },
+  { F|O, "PartitionOrderWeight" , opt_mesh_partition_order_weight , 0 ,
+    "Multiply the weight of the elements for METIS load balancing by their "
+    "number of nodes per direction (polynomial order + 1) to the power of their "
+    "dimension" },
   { F|O, "PartitionCreateTopology" , opt_mesh_partition_create_topology , 1 ,
     "Create boundary representation of partitions" },
   { F|O, "PartitionCreatePhysicals" , opt_mesh_partition_create_physicals , 1 ,
@@ -1702,6 +1749,10 @@ StringXNumber SolverOptions_Number[] = {
   { F|O, "Plugins" , opt_solver_plugins , 0. ,
     "Enable default solver plugins?" },
 
+  { F|O, "RemoteCompression" , opt_solver_remote_compression , 0. ,
+    "Compression level (0: none, 1-9: zlib levels) of the vertex arrays sent "
+    "by remote Gmsh servers, to save bandwidth on slow networks" },
+
   { F|O, "ShowInvisibleParameters" , opt_solver_show_invisible_parameters , 0. ,
     "Show all parameters, even those marked invisible" },
 
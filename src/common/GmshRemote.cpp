@@ -17,6 +17,11 @@
 #endif
 
 #include <sstream>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
 #include "GmshMessage.h"
 
 #if defined(HAVE_ONELAB) && defined(HAVE_POST)
@@ -30,9 +35,117 @@
 #include "PViewOptions.h"
 #include "PViewData.h"
 #include "PViewDataRemote.h"
+#include "Context.h"
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+// hash of the raw vertex, normal and color arrays last sent for each view tag
+// and vertex array type
+static std::map<std::pair<int, int>, std::vector<uint64_t> > sentVertexArrays;
+
+static uint64_t HashBytes(const char *bytes, std::size_t n)
+{
+  uint64_t h = 14695981039346656037ULL ^ n;
+  std::size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    uint64_t w;
+    memcpy(&w, bytes + i, 8);
+    h = (h ^ w) * 1099511628211ULL;
+    h ^= h >> 32;
+  }
+  for(; i < n; i++) h = (h ^ (unsigned char)bytes[i]) * 1099511628211ULL;
+  return h;
+}
+
+// Send a vertex array in chunks (see VertexArray.h), directly from its raw
+// arrays and skipping the ones that did not change since they were last sent,
+// so that the receiver can process the other events between the chunks
+static void SendVertexArray(GmshClient *client, VertexArray *va, int tag,
+                            const std::string &name, int type, double min,
+                            double max, int numSteps, double time,
+                            const SBoundingBox3d &bbox, std::size_t &sent)
+{
+  const int chunkSize = 1 << 22;
+  const int is = sizeof(int), ls = sizeof(int64_t);
+
+  std::vector<uint64_t> &last = sentVertexArrays[std::make_pair(tag, type)];
+  std::vector<uint64_t> hash(3);
+  int changed[3];
+
+  std::vector<char> begin(3 * is + 3 * (ls + is));
+  int kind = VertexArray::CHUNK_BEGIN;
+  int index = 0;
+  memcpy(&begin[index], &kind, is); index += is;
+  memcpy(&begin[index], &tag, is); index += is;
+  memcpy(&begin[index], &type, is); index += is;
+  for(int i = 0; i < 3; i++) {
+    int64_t n = va->getNumRawBytes(i);
+    hash[i] = HashBytes(va->getRawBytes(i), n);
+    changed[i] = (last.size() != 3 || last[i] != hash[i]) ? 1 : 0;
+    memcpy(&begin[index], &n, ls); index += ls;
+    memcpy(&begin[index], &changed[i], is); index += is;
+  }
+  VertexArray::encodeHeader(tag, name, type, min, max, numSteps, time, bbox,
+                            begin);
+  client->SendMessage(GmshSocket::GMSH_VERTEX_ARRAY_CHUNK, begin.size(),
+                      &begin[0]);
+  sent += begin.size();
+
+#if defined(HAVE_LIBZ)
+  int level = CTX::instance()->solver.remoteCompression;
+  std::vector<char> compressed;
+#endif
+  for(int i = 0; i < 3; i++) {
+    if(!changed[i]) continue;
+    int64_t n = va->getNumRawBytes(i);
+    const char *bytes = va->getRawBytes(i);
+    for(int64_t offset = 0; offset < n; offset += chunkSize) {
+      int raw = (int)std::min((int64_t)chunkSize, n - offset);
+      const void *data = bytes + offset;
+      int len = raw, comp = 0;
+#if defined(HAVE_LIBZ)
+      if(level > 0) {
+        uLongf dstLen = compressBound(raw);
+        compressed.resize(dstLen);
+        if(compress2((Bytef *)&compressed[0], &dstLen, (const Bytef *)data,
+                     raw, level) == Z_OK &&
+           (int)dstLen < raw) {
+          data = &compressed[0];
+          len = dstLen;
+          comp = 1;
+        }
+      }
+#endif
+      char prefix[6 * sizeof(int) + sizeof(int64_t)];
+      kind = VertexArray::CHUNK_DATA;
+      index = 0;
+      memcpy(&prefix[index], &kind, is); index += is;
+      memcpy(&prefix[index], &tag, is); index += is;
+      memcpy(&prefix[index], &type, is); index += is;
+      memcpy(&prefix[index], &i, is); index += is;
+      memcpy(&prefix[index], &offset, ls); index += ls;
+      memcpy(&prefix[index], &raw, is); index += is;
+      memcpy(&prefix[index], &comp, is); index += is;
+      const void *parts[2] = {prefix, data};
+      int lengths[2] = {index, len};
+      client->SendMessage(GmshSocket::GMSH_VERTEX_ARRAY_CHUNK, 2, parts,
+                          lengths);
+      sent += index + len;
+    }
+  }
+
+  int end[3] = {VertexArray::CHUNK_END, tag, type};
+  client->SendMessage(GmshSocket::GMSH_VERTEX_ARRAY_CHUNK, sizeof(end), end);
+  sent += sizeof(end);
+  last = hash;
+}
 
 static void ComputeAndSendVertexArrays(GmshClient *client, bool compute = true)
 {
+  double t1 = TimeOfDay();
+  std::size_t sent = 0;
   for(std::size_t i = 0; i < PView::list.size(); i++) {
     PView *p = PView::list[i];
     if(compute) p->fillVertexArrays();
@@ -46,17 +159,15 @@ static void ComputeAndSendVertexArrays(GmshClient *client, bool compute = true)
     VertexArray *va[4] = {p->va_points, p->va_lines, p->va_triangles,
                           p->va_vectors};
     for(int type = 0; type < 4; type++) {
-      if(va[type]) {
-        int len;
-        char *str = va[type]->toChar(p->getTag(), data->getName(), type + 1,
-                                     min, max, data->getNumTimeSteps(),
-                                     data->getTime(opt->timeStep),
-                                     data->getBoundingBox(), len);
-        client->SendMessage(GmshSocket::GMSH_VERTEX_ARRAY, len, str);
-        delete[] str;
-      }
+      if(va[type])
+        SendVertexArray(client, va[type], p->getTag(), data->getName(),
+                        type + 1, min, max, data->getNumTimeSteps(),
+                        data->getTime(opt->timeStep), data->getBoundingBox(),
+                        sent);
     }
   }
+  Msg::Debug("Sent vertex arrays (%g Mb) in %g seconds",
+             sent / 1024. / 1024., TimeOfDay() - t1);
 }
 
 #if defined(HAVE_MPI)
@@ -225,6 +336,11 @@ int GmshRemote()
         GatherAndSendVertexArrays(client, swap);
 #endif
       }
+      else if(type == GmshSocket::GMSH_VERTEX_ARRAY_CHUNK) {
+        // the receiver lost track of the vertex arrays: send them all again
+        sentVertexArrays.clear();
+        ComputeAndSendVertexArrays(client, false);
+      }
       else if(type == GmshSocket::GMSH_MERGE_FILE) {
         MergeFile(msg);
 #if !defined(HAVE_MPI)
@@ -18,6 +18,7 @@
 #include "GmshConfig.h"
 #include "StringUtils.h"
 #include "Context.h"
+#include "CompressedFile.h"
 
 #if defined(HAVE_ZIPPER)
 #include <iostream>
@@ -272,13 +273,21 @@ static void setwbuf(int i, const char *f)
 
 FILE *Fopen(const char *f, const char *mode)
 {
+  // compressed files are always opened in binary mode, and are transparently
+  // decompressed (or compressed) on the fly
+  bool compressed = IsCompressedFileName(f);
+  std::string m(mode);
+  if(compressed && m.find('b') == std::string::npos) m += "b";
+  FILE *fp;
 #if defined(WIN32) && !defined(__CYGWIN__)
   setwbuf(0, f);
-  setwbuf(1, mode);
-  return _wfopen(wbuf[0], wbuf[1]);
+  setwbuf(1, m.c_str());
+  fp = _wfopen(wbuf[0], wbuf[1]);
 #else
-  return fopen(f, mode);
+  fp = fopen(f, m.c_str());
 #endif
+  if(fp && compressed) fp = OpenCompressedStream(fp, f, m.c_str());
+  return fp;
 }
 
 std::string GetEnvironmentVar(const std::string &var)
@@ -20,6 +20,7 @@ typedef unsigned long intptr_t;
 #include "OpenFile.h"
 #include "CommandLine.h"
 #include "OS.h"
+#include "CompressedFile.h"
 #include "StringUtils.h"
 #include "GeomMeshMatcher.h"
 
@@ -320,8 +321,17 @@ int MergeFile(const std::string &fileName, bool errorIfMissing,
   std::vector<std::string> split = SplitFileName(fileName);
   std::string noExt = split[0] + split[1], ext = split[2];
 
-  if(ext == ".gz") {
-    if(DoSystemUncompress(fileName, noExt)) return MergeFile(noExt, false);
+  if(ext == ".gz" || IsCompressedFileName(fileName)) {
+    // MSH, POS and STL files are decompressed in-process, on the fly (the
+    // header above has been read from the decompressed stream)
+    std::vector<std::string> split2 = SplitFileName(noExt);
+    if(IsCompressedFileName(fileName) &&
+       (header[0] == '$' || split2[2] == ".stl" || split2[2] == ".STL")) {
+      split = split2;
+      ext = split[2];
+    }
+    else if(ext == ".gz" && DoSystemUncompress(fileName, noExt))
+      return MergeFile(noExt, false);
   }
 
   CTX::instance()->geom.draw = 0; // don't try to draw the model while reading
@@ -359,7 +369,7 @@ int MergeFile(const std::string &fileName, bool errorIfMissing,
 
   if(GModel::current()->getName() == "") {
     GModel::current()->setFileName(fileName);
-    GModel::current()->setName(SplitFileName(fileName)[1]);
+    GModel::current()->setName(split[1]);
   }
 
   if(ext == ".stl" || ext == ".STL") {
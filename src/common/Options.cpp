@@ -2912,6 +2912,22 @@ double opt_general_display_border_factor(OPT_ARGS_NUM)
   return CTX::instance()->displayBorderFactor;
 }
 
+double opt_general_display_frame_time(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->displayFrameTime = (int)val;
+  return CTX::instance()->displayFrameTime;
+}
+
+double opt_general_vertex_buffers(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+    CTX::instance()->vertexBuffers = (int)val;
+    if(CTX::instance()->vertexBuffers < 0 || CTX::instance()->vertexBuffers > 2)
+      CTX::instance()->vertexBuffers = 1;
+  }
+  return CTX::instance()->vertexBuffers;
+}
+
 double opt_geometry_reparam_on_face_robust(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->geom.reparamOnFaceRobust = val;
@@ -4700,6 +4716,19 @@ double opt_geometry_occ_disable_stl(OPT_ARGS_NUM)
   return CTX::instance()->geom.occDisableSTL;
 }
 
+double opt_geometry_occ_evaluation_cache(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->geom.occEvaluationCache = (int)val;
+  return CTX::instance()->geom.occEvaluationCache;
+}
+
+double opt_geometry_occ_evaluation_cache_tolerance(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET)
+    CTX::instance()->geom.occEvaluationCacheTolerance = val;
+  return CTX::instance()->geom.occEvaluationCacheTolerance;
+}
+
 double opt_geometry_occ_fix_degenerated(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->geom.occFixDegenerated = val ? 1 : 0;
@@ -4779,6 +4808,12 @@ double opt_geometry_occ_boolean_check_inverted(OPT_ARGS_NUM)
   return CTX::instance()->geom.occBooleanCheckInverted;
 }
 
+double opt_geometry_occ_boolean_clusters(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->geom.occBooleanClusters = (int)val;
+  return CTX::instance()->geom.occBooleanClusters;
+}
+
 double opt_geometry_occ_boolean_glue(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET)
@@ -4975,6 +5010,18 @@ double opt_geometry_match_mesh_tolerance(OPT_ARGS_NUM)
   return CTX::instance()->geom.matchMeshTolerance;
 }
 
+std::string opt_mesh_partition_hierarchy(OPT_ARGS_STR)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.partitionHierarchy = val;
+  return CTX::instance()->mesh.partitionHierarchy;
+}
+
+std::string opt_mesh_stream_file_name(OPT_ARGS_STR)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.streamFileName = val;
+  return CTX::instance()->mesh.streamFileName;
+}
+
 double opt_mesh_optimize(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) {
@@ -5758,6 +5805,22 @@ double opt_mesh_angle_smooth_normals(OPT_ARGS_NUM)
   return CTX::instance()->mesh.angleSmoothNormals;
 }
 
+double opt_mesh_level_of_detail(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+    if(CTX::instance()->mesh.levelOfDetail != (int)val)
+      CTX::instance()->mesh.changed |= (ENT_CURVE | ENT_SURFACE | ENT_VOLUME);
+    CTX::instance()->mesh.levelOfDetail = (int)val;
+  }
+  return CTX::instance()->mesh.levelOfDetail;
+}
+
+double opt_mesh_level_of_detail_pixels(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.levelOfDetailPixels = val;
+  return CTX::instance()->mesh.levelOfDetailPixels;
+}
+
 double opt_mesh_light(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.light = (int)val;
@@ -5893,6 +5956,12 @@ double opt_mesh_partition_tri_weight(OPT_ARGS_NUM)
   return CTX::instance()->mesh.partitionTriWeight;
 }
 
+double opt_mesh_partition_order_weight(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.partitionOrderWeight = (int)val;
+  return CTX::instance()->mesh.partitionOrderWeight;
+}
+
 double opt_mesh_partition_line_weight(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.partitionLinWeight = (int)val;
@@ -6784,6 +6853,12 @@ double opt_mesh_ignore_periodicity(OPT_ARGS_NUM)
   return CTX::instance()->mesh.ignorePeriodicityMsh2;
 }
 
+double opt_mesh_incremental(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.incremental = (int)val;
+  return CTX::instance()->mesh.incremental;
+}
+
 double opt_mesh_max_iter_delaunay_3d(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.maxIterDelaunay3D = (int)val;
@@ -6904,6 +6979,14 @@ double opt_solver_plugins(OPT_ARGS_NUM)
   return CTX::instance()->solver.plugins;
 }
 
+double opt_solver_remote_compression(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET)
+    CTX::instance()->solver.remoteCompression =
+      std::max(0, std::min(9, (int)val));
+  return CTX::instance()->solver.remoteCompression;
+}
+
 double opt_solver_auto_load_database(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->solver.autoLoadDatabase = (int)val;
@@ -295,6 +295,8 @@ double opt_general_double_buffer(OPT_ARGS_NUM);
 double opt_general_antialiasing(OPT_ARGS_NUM);
 double opt_general_alpha_blending(OPT_ARGS_NUM);
 double opt_general_vector_type(OPT_ARGS_NUM);
+double opt_general_vertex_buffers(OPT_ARGS_NUM);
+double opt_general_display_frame_time(OPT_ARGS_NUM);
 double opt_general_arrow_head_radius(OPT_ARGS_NUM);
 double opt_general_arrow_stem_length(OPT_ARGS_NUM);
 double opt_general_arrow_stem_radius(OPT_ARGS_NUM);
@@ -418,6 +420,8 @@ double opt_geometry_occ_auto_fix(OPT_ARGS_NUM);
 double opt_geometry_occ_bounds_use_stl(OPT_ARGS_NUM);
 double opt_geometry_occ_brep_format_version(OPT_ARGS_NUM);
 double opt_geometry_occ_disable_stl(OPT_ARGS_NUM);
+double opt_geometry_occ_evaluation_cache(OPT_ARGS_NUM);
+double opt_geometry_occ_evaluation_cache_tolerance(OPT_ARGS_NUM);
 double opt_geometry_occ_fix_degenerated(OPT_ARGS_NUM);
 double opt_geometry_occ_fix_small_edges(OPT_ARGS_NUM);
 double opt_geometry_occ_fix_small_faces(OPT_ARGS_NUM);
@@ -425,6 +429,7 @@ double opt_geometry_occ_sew_faces(OPT_ARGS_NUM);
 double opt_geometry_occ_make_solids(OPT_ARGS_NUM);
 double opt_geometry_occ_parallel(OPT_ARGS_NUM);
 double opt_geometry_occ_boolean_check_inverted(OPT_ARGS_NUM);
+double opt_geometry_occ_boolean_clusters(OPT_ARGS_NUM);
 double opt_geometry_occ_boolean_glue(OPT_ARGS_NUM);
 double opt_geometry_occ_boolean_non_destructive(OPT_ARGS_NUM);
 double opt_geometry_occ_boolean_preserve_numbering(OPT_ARGS_NUM);
@@ -452,6 +457,8 @@ double opt_geometry_exact_extrusion(OPT_ARGS_NUM);
 double opt_geometry_match_geom_and_mesh(OPT_ARGS_NUM);
 double opt_geometry_match_mesh_scale_factor(OPT_ARGS_NUM);
 double opt_geometry_match_mesh_tolerance(OPT_ARGS_NUM);
+std::string opt_mesh_partition_hierarchy(OPT_ARGS_STR);
+std::string opt_mesh_stream_file_name(OPT_ARGS_STR);
 double opt_mesh_label_sampling(OPT_ARGS_NUM);
 double opt_mesh_optimize(OPT_ARGS_NUM);
 double opt_mesh_optimize_threshold(OPT_ARGS_NUM);
@@ -473,6 +480,8 @@ double opt_mesh_lc_from_points(OPT_ARGS_NUM);
 double opt_mesh_lc_from_parametric_points(OPT_ARGS_NUM);
 double opt_mesh_lc_extend_from_boundary(OPT_ARGS_NUM);
 double opt_mesh_lc_integration_precision(OPT_ARGS_NUM);
+double opt_mesh_level_of_detail(OPT_ARGS_NUM);
+double opt_mesh_level_of_detail_pixels(OPT_ARGS_NUM);
 double opt_mesh_check_surface_normal_validity(OPT_ARGS_NUM);
 double opt_mesh_rand_factor(OPT_ARGS_NUM);
 double opt_mesh_rand_factor3d(OPT_ARGS_NUM);
@@ -534,6 +543,7 @@ double opt_mesh_partition_trih_weight(OPT_ARGS_NUM);
 double opt_mesh_partition_qua_weight(OPT_ARGS_NUM);
 double opt_mesh_partition_tet_weight(OPT_ARGS_NUM);
 double opt_mesh_partition_tri_weight(OPT_ARGS_NUM);
+double opt_mesh_partition_order_weight(OPT_ARGS_NUM);
 double opt_mesh_partition_line_weight(OPT_ARGS_NUM);
 double opt_mesh_partition_create_topology(OPT_ARGS_NUM);
 double opt_mesh_partition_create_physicals(OPT_ARGS_NUM);
@@ -631,6 +641,7 @@ double opt_mesh_avg_quality(OPT_ARGS_NUM);
 double opt_mesh_clip(OPT_ARGS_NUM);
 double opt_mesh_ignore_unknown_sections(OPT_ARGS_NUM);
 double opt_mesh_ignore_periodicity(OPT_ARGS_NUM);
+double opt_mesh_incremental(OPT_ARGS_NUM);
 double opt_mesh_preserve_numbering_msh2(OPT_ARGS_NUM);
 double opt_mesh_max_iter_delaunay_3d(OPT_ARGS_NUM);
 double opt_mesh_max_num_threads_1d(OPT_ARGS_NUM);
@@ -650,6 +661,7 @@ double opt_mesh_old_initial_delaunay_2d(OPT_ARGS_NUM);
 double opt_solver_listen(OPT_ARGS_NUM);
 double opt_solver_timeout(OPT_ARGS_NUM);
 double opt_solver_plugins(OPT_ARGS_NUM);
+double opt_solver_remote_compression(OPT_ARGS_NUM);
 double opt_solver_auto_load_database(OPT_ARGS_NUM);
 double opt_solver_auto_save_database(OPT_ARGS_NUM);
 double opt_solver_auto_archive_output_files(OPT_ARGS_NUM);
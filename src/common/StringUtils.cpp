@@ -5,6 +5,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <cmath>
 #include <regex>
 #if defined(__CYGWIN__)
 #include <sys/cygwin.h>
@@ -234,3 +236,147 @@ bool IsOnelabName(const std::string &name, std::string &cleanName)
 
   return true;
 }
+
+char *FormatUnsigned(char *buf, std::size_t v)
+{
+  char tmp[24];
+  int n = 0;
+  do {
+    tmp[n++] = '0' + (v % 10);
+    v /= 10;
+  } while(v);
+  while(n) *buf++ = tmp[--n];
+  *buf = '\0';
+  return buf;
+}
+
+#if defined(__SIZEOF_INT128__)
+
+typedef unsigned __int128 uint128;
+
+// compute m * 2^e * 10^p rounded to the nearest integer (ties to even, as
+// glibc's printf in the default rounding mode), if it can be done exactly
+// with 128 bit integers
+static bool ScaleAndRound(uint64_t m, int e, int p, uint64_t &d)
+{
+  if(p > 27 || p < -27) return false;
+  uint128 pow5 = 1;
+  for(int i = 0; i < std::abs(p); i++) pow5 *= 5;
+  uint128 q, r, div;
+  if(p >= 0) {
+    uint128 x = (uint128)m * pow5; // < 2^116
+    int s = e + p;
+    if(s >= 0) {
+      if(s >= 64 || (x >> (64 - s))) return false;
+      d = (uint64_t)(x << s);
+      return true;
+    }
+    if(-s >= 127) return false;
+    q = x >> -s;
+    r = x - (q << -s);
+    div = (uint128)1 << -s;
+  }
+  else {
+    int s = e + p;
+    uint128 x = m;
+    div = pow5;
+    if(s >= 0) {
+      if(s > 74) return false;
+      x <<= s;
+    }
+    else {
+      if(-s > 64) return false;
+      div <<= -s;
+    }
+    q = x / div;
+    r = x % div;
+  }
+  if(2 * r > div || (2 * r == div && (q & 1))) q++;
+  if(q >> 64) return false;
+  d = (uint64_t)q;
+  return true;
+}
+
+#endif
+
+char *FormatDouble(char *buf, double v)
+{
+  if(v == 0.) {
+    if(std::signbit(v)) *buf++ = '-';
+    *buf++ = '0';
+    *buf = '\0';
+    return buf;
+  }
+#if defined(__SIZEOF_INT128__)
+  if(std::isfinite(v)) {
+    double a = std::abs(v);
+    int e;
+    uint64_t m = (uint64_t)std::ldexp(std::frexp(a, &e), 53); // a = m 2^(e-53)
+    e -= 53;
+    int k = (int)std::floor(std::log10(a)); // estimate of the decimal exponent
+    const uint64_t lo = 1000000000000000ULL, hi = 10 * lo;
+    uint64_t d = 0;
+    bool ok = false;
+    for(int iter = 0; iter < 3; iter++) {
+      if(!ScaleAndRound(m, e, 15 - k, d)) break;
+      if(d < lo)
+        k--;
+      else if(d >= hi)
+        k++;
+      else {
+        ok = true;
+        break;
+      }
+    }
+    // the estimate can be too large by one if the value rounds up to 10^k
+    if(ok && d == lo) {
+      uint64_t d2;
+      if(!ScaleAndRound(m, e, 16 - k, d2))
+        ok = false;
+      else if(d2 < hi) {
+        d = d2;
+        k--;
+      }
+    }
+    if(ok) {
+      // 16 significant digits, without trailing zeros
+      char digits[16];
+      for(int i = 15; i >= 0; i--) {
+        digits[i] = '0' + (d % 10);
+        d /= 10;
+      }
+      int n = 16;
+      while(digits[n - 1] == '0') n--;
+      if(v < 0) *buf++ = '-';
+      if(k < -4 || k >= 16) {
+        *buf++ = digits[0];
+        if(n > 1) {
+          *buf++ = '.';
+          for(int i = 1; i < n; i++) *buf++ = digits[i];
+        }
+        *buf++ = 'e';
+        *buf++ = (k < 0) ? '-' : '+';
+        int x = std::abs(k);
+        if(x < 10) *buf++ = '0';
+        buf = FormatUnsigned(buf, x);
+      }
+      else if(k >= 0) {
+        for(int i = 0; i <= k; i++) *buf++ = digits[i];
+        if(n > k + 1) {
+          *buf++ = '.';
+          for(int i = k + 1; i < n; i++) *buf++ = digits[i];
+        }
+      }
+      else {
+        *buf++ = '0';
+        *buf++ = '.';
+        for(int i = 0; i < -k - 1; i++) *buf++ = '0';
+        for(int i = 0; i < n; i++) *buf++ = digits[i];
+      }
+      *buf = '\0';
+      return buf;
+    }
+  }
+#endif
+  return buf + sprintf(buf, "%.16g", v);
+}
@@ -31,4 +31,10 @@ std::vector<std::string> SplitString(const std::string &msg, char separator,
 std::string RemoveWhiteSpace(const std::string &s);
 bool IsOnelabName(const std::string &name, std::string &cleanName);
 
+// Fast equivalents of sprintf(buf, "%lu", v) and sprintf(buf, "%.16g", v),
+// producing the same output: 'buf' should be at least 32 chars long. Return a
+// pointer to the terminating null character.
+char *FormatUnsigned(char *buf, std::size_t v);
+char *FormatDouble(char *buf, double v);
+
 #endif
@@ -4,18 +4,22 @@
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <string.h>
+#include <stdint.h>
 #include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <set>
 #include "GmshMessage.h"
 #include "VertexArray.h"
 #include "Context.h"
 #include "Numeric.h"
 #include "OS.h"
 
-template<int N> float ElementDataLessThan<N>::tolerance = 0.0F;
 float BarycenterLessThan::tolerance = 0.0F;
 
 VertexArray::VertexArray(int numVerticesPerElement, int numElements)
-  : _numVerticesPerElement(numVerticesPerElement)
+  : _numVerticesPerElement(numVerticesPerElement), _buffer(nullptr),
+    _changes(0), _simplified(nullptr)
 {
   int nb = (numElements ? numElements : 1) * _numVerticesPerElement;
 
@@ -101,15 +105,11 @@ void VertexArray::add(double *x, double *y, double *z, SVector3 *n, unsigned cha
                       MElement *ele, bool unique, bool boundary)
 {
   int npe = getNumVerticesPerElement();
+  _changes++;
+  if(_simplified) _clearClusters();
 
   if(boundary && npe == 3){
-    ElementData<3> e(x, y, z, n, r, g, b, a, ele);
-    ElementDataLessThan<3>::tolerance = (float)(CTX::instance()->lc * 1.e-12);
-    auto it = _data3.find(e);
-    if(it == _data3.end())
-      _data3.insert(e);
-    else
-      _data3.erase(it);
+    _data3.push_back(ElementData<3>(x, y, z, n, r, g, b, a, ele));
     return;
   }
 
@@ -135,21 +135,118 @@ void VertexArray::add(double *x, double *y, double *z, SVector3 *n, unsigned cha
   }
 }
 
+// triangle identified by its vertices sorted lexicographically, so that the
+// same face seen from its two neighboring elements has exactly the same key
+class TriangleKey {
+private:
+  uint32_t _v[9];
+
+public:
+  TriangleKey(const ElementData<3> &e)
+  {
+    int o[3] = {0, 1, 2};
+    auto less = [&e](int i, int j) {
+      if(e.x(i) != e.x(j)) return e.x(i) < e.x(j);
+      if(e.y(i) != e.y(j)) return e.y(i) < e.y(j);
+      return e.z(i) < e.z(j);
+    };
+    if(less(o[1], o[0])) std::swap(o[0], o[1]);
+    if(less(o[2], o[1])) std::swap(o[1], o[2]);
+    if(less(o[1], o[0])) std::swap(o[0], o[1]);
+    for(int i = 0; i < 3; i++) {
+      float c[3] = {e.x(o[i]), e.y(o[i]), e.z(o[i])};
+      memcpy(&_v[3 * i], c, sizeof(c));
+    }
+  }
+  bool operator==(const TriangleKey &k) const
+  {
+    return !memcmp(_v, k._v, sizeof(_v));
+  }
+  std::size_t hash() const
+  {
+    uint64_t h = 14695981039346656037ULL;
+    for(int i = 0; i < 9; i++) {
+      h ^= _v[i];
+      h *= 1099511628211ULL;
+    }
+    return (std::size_t)(h ^ (h >> 29));
+  }
+};
+
+class TriangleKeyHash {
+public:
+  std::size_t operator()(const TriangleKey &k) const { return k.hash(); }
+};
+
+// flag the boundary triangles that appear an odd number of times (the last
+// occurrence is kept). The triangles are distributed by hash among
+// independent partitions, which are processed in parallel.
+static void flagBoundaryTriangles(const std::vector<ElementData<3> > &data,
+                                  std::vector<char> &keep)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  const std::size_t n = data.size();
+  const std::size_t np = nthreads;
+  keep.assign(n, 0);
+
+  std::vector<std::size_t> part(n);
+  std::vector<std::size_t> count(np * np, 0);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t t = 0; t < np; t++) {
+    std::size_t b = (t * n) / np, e = ((t + 1) * n) / np;
+    for(std::size_t i = b; i < e; i++) {
+      part[i] = (TriangleKey(data[i]).hash() >> 16) % np;
+      count[part[i] * np + t]++;
+    }
+  }
+
+  // sort the indices by partition, keeping the original order in each
+  std::vector<std::size_t> offset(np * np + 1, 0);
+  for(std::size_t i = 0; i < np * np; i++) offset[i + 1] = offset[i] + count[i];
+  std::vector<std::size_t> index(n);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t t = 0; t < np; t++) {
+    std::size_t b = (t * n) / np, e = ((t + 1) * n) / np;
+    std::vector<std::size_t> pos(np);
+    for(std::size_t p = 0; p < np; p++) pos[p] = offset[p * np + t];
+    for(std::size_t i = b; i < e; i++) index[pos[part[i]]++] = i;
+  }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t p = 0; p < np; p++) {
+    std::size_t b = offset[p * np], e = offset[(p + 1) * np];
+    std::unordered_map<TriangleKey, std::size_t, TriangleKeyHash> odd;
+    odd.reserve(e - b);
+    for(std::size_t i = b; i < e; i++) {
+      std::size_t j = index[i];
+      auto ret = odd.insert(std::make_pair(TriangleKey(data[j]), j));
+      if(!ret.second) odd.erase(ret.first);
+    }
+    for(auto &it : odd) keep[it.second] = 1;
+  }
+}
+
 void VertexArray::finalize()
 {
+  _clearClusters();
   if(_data3.size()){
-    auto it = _data3.begin();
-    for(; it != _data3.end(); it++){
+    std::vector<char> keep;
+    flagBoundaryTriangles(_data3, keep);
+    for(std::size_t j = 0; j < _data3.size(); j++){
+      if(!keep[j]) continue;
+      const ElementData<3> &d = _data3[j];
       for(int i = 0; i < 3; i++){
-        _addVertex(it->x(i), it->y(i), it->z(i));
-        _addNormal(it->nx(i), it->ny(i), it->nz(i));
-        _addColor(it->r(i), it->g(i), it->b(i), it->a(i));
-        _addElement(it->ele());
+        _addVertex(d.x(i), d.y(i), d.z(i));
+        _addNormal(d.nx(i), d.ny(i), d.nz(i));
+        _addColor(d.r(i), d.g(i), d.b(i), d.a(i));
+        _addElement(d.ele());
       }
     }
-    _data3.clear();
+    std::vector<ElementData<3> >().swap(_data3);
   }
   _barycenters.clear();
+  _changes++;
 }
 
 class AlphaElement {
@@ -229,27 +326,25 @@ void VertexArray::sort(double x, double y, double z)
   _vertices = sortedVertices;
   _normals = sortedNormals;
   _colors = sortedColors;
+  _changes++;
+  _clearClusters();
 }
 
-char *VertexArray::toChar(int num, const std::string &name, int type,
-                          double min, double max, int numsteps, double time,
-                          const SBoundingBox3d &bbox, int &len)
+void VertexArray::encodeHeader(int num, const std::string &name, int type,
+                               double min, double max, int numsteps,
+                               double time, const SBoundingBox3d &bbox,
+                               std::vector<char> &bytes)
 {
-  int vn = _vertices.size(), nn = _normals.size(), cn = _colors.size();
-  int vs = vn * sizeof(float),
-      ns = nn * sizeof(normal_type),
-      cs = cn * sizeof(unsigned char);
   int is = sizeof(int), ds = sizeof(double);
   int ss = name.size();
   double xmin = bbox.min().x(), ymin = bbox.min().y(), zmin = bbox.min().z();
   double xmax = bbox.max().x(), ymax = bbox.max().y(), zmax = bbox.max().z();
 
-  len = ss + 7 * is + 9 * ds + vs + ns + cs;
-  char *bytes = new char[len];
-  int index = 0;
+  std::size_t index = bytes.size();
+  bytes.resize(index + ss + 4 * is + 9 * ds);
   memcpy(&bytes[index], &num, is); index += is;
   memcpy(&bytes[index], &ss, is); index += is;
-  memcpy(&bytes[index], name.c_str(), ss); index += ss;
+  if(ss){ memcpy(&bytes[index], name.c_str(), ss); index += ss; }
   memcpy(&bytes[index], &type, is); index += is;
   memcpy(&bytes[index], &min, ds); index += ds;
   memcpy(&bytes[index], &max, ds); index += ds;
@@ -260,7 +355,27 @@ char *VertexArray::toChar(int num, const std::string &name, int type,
   memcpy(&bytes[index], &zmin, ds); index += ds;
   memcpy(&bytes[index], &xmax, ds); index += ds;
   memcpy(&bytes[index], &ymax, ds); index += ds;
-  memcpy(&bytes[index], &zmax, ds); index += ds;
+  memcpy(&bytes[index], &zmax, ds);
+}
+
+char *VertexArray::toChar(int num, const std::string &name, int type,
+                          double min, double max, int numsteps, double time,
+                          const SBoundingBox3d &bbox, int &len)
+{
+  int vn = _vertices.size(), nn = _normals.size(), cn = _colors.size();
+  int vs = vn * sizeof(float),
+      ns = nn * sizeof(normal_type),
+      cs = cn * sizeof(unsigned char);
+  int is = sizeof(int);
+
+  std::vector<char> header;
+  encodeHeader(num, name, type, min, max, numsteps, time, bbox, header);
+  int hs = header.size();
+
+  len = hs + 3 * is + vs + ns + cs;
+  char *bytes = new char[len];
+  int index = 0;
+  memcpy(&bytes[index], &header[0], hs); index += hs;
   memcpy(&bytes[index], &vn, is); index += is;
   if(vs){ memcpy(&bytes[index], &_vertices[0], vs); index += vs; }
   memcpy(&bytes[index], &nn, is); index += is;
@@ -338,6 +453,50 @@ void VertexArray::fromChar(int length, const char *bytes, int swap)
     _colors.resize(cn); int cs = cn * sizeof(unsigned char);
     memcpy(&_colors[0], &bytes[index], cs); /* index += cs; */
   }
+  _changes++;
+  _clearClusters();
+}
+
+std::size_t VertexArray::getNumRawBytes(int i) const
+{
+  if(i == 0) return _vertices.size() * sizeof(float);
+  if(i == 1) return _normals.size() * sizeof(normal_type);
+  if(i == 2) return _colors.size() * sizeof(unsigned char);
+  return 0;
+}
+
+char *VertexArray::getRawBytes(int i)
+{
+  if(i == 0 && _vertices.size()) return (char *)&_vertices[0];
+  if(i == 1 && _normals.size()) return (char *)&_normals[0];
+  if(i == 2 && _colors.size()) return (char *)&_colors[0];
+  return nullptr;
+}
+
+bool VertexArray::resizeRawBytes(int i, std::size_t bytes)
+{
+  if(i == 0 && !(bytes % sizeof(float)))
+    _vertices.resize(bytes / sizeof(float));
+  else if(i == 1 && !(bytes % sizeof(normal_type)))
+    _normals.resize(bytes / sizeof(normal_type));
+  else if(i == 2)
+    _colors.resize(bytes);
+  else
+    return false;
+  _changes++;
+  _clearClusters();
+  return true;
+}
+
+void VertexArray::swapRawBytes(int i, VertexArray *va)
+{
+  if(i == 0) _vertices.swap(va->_vertices);
+  else if(i == 1) _normals.swap(va->_normals);
+  else if(i == 2) _colors.swap(va->_colors);
+  _changes++;
+  _clearClusters();
+  va->_changes++;
+  va->_clearClusters();
 }
 
 void VertexArray::merge(VertexArray* va)
@@ -349,4 +508,202 @@ void VertexArray::merge(VertexArray* va)
     _elements.insert(_elements.end(), va->firstElementPointer(),
                      va->lastElementPointer());
   }
+  _data3.insert(_data3.end(), va->_data3.begin(), va->_data3.end());
+  _changes++;
+  _clearClusters();
+}
+
+void VertexArray::merge(const std::vector<VertexArray *> &va)
+{
+  // offsets of the arrays in the merged arrays
+  std::size_t nv = _vertices.size(), nn = _normals.size(),
+              nc = _colors.size(), ne = _elements.size(), nd = _data3.size();
+  std::vector<std::size_t> ov(va.size()), on(va.size()), oc(va.size()),
+    oe(va.size());
+  for(std::size_t i = 0; i < va.size(); i++) {
+    ov[i] = nv;
+    on[i] = nn;
+    oc[i] = nc;
+    oe[i] = ne;
+    nv += va[i]->_vertices.size();
+    nn += va[i]->_normals.size();
+    nc += va[i]->_colors.size();
+    ne += va[i]->_elements.size();
+    nd += va[i]->_data3.size();
+  }
+  _vertices.resize(nv);
+  _normals.resize(nn);
+  _colors.resize(nc);
+  _elements.resize(ne);
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < va.size(); i++) {
+    std::copy(va[i]->_vertices.begin(), va[i]->_vertices.end(),
+              _vertices.begin() + ov[i]);
+    std::copy(va[i]->_normals.begin(), va[i]->_normals.end(),
+              _normals.begin() + on[i]);
+    std::copy(va[i]->_colors.begin(), va[i]->_colors.end(),
+              _colors.begin() + oc[i]);
+    std::copy(va[i]->_elements.begin(), va[i]->_elements.end(),
+              _elements.begin() + oe[i]);
+  }
+
+  // boundary triangles are only filtered in finalize()
+  _data3.reserve(nd);
+  for(std::size_t i = 0; i < va.size(); i++)
+    _data3.insert(_data3.end(), va[i]->_data3.begin(), va[i]->_data3.end());
+  _changes++;
+  _clearClusters();
+}
+
+void VertexArray::_clearClusters()
+{
+  _clusters.clear();
+  delete _simplified;
+  _simplified = nullptr;
+}
+
+// interleave the bits of 3 10-bit integers
+static uint32_t mortonCode(uint32_t x, uint32_t y, uint32_t z)
+{
+  uint32_t code = 0;
+  for(int i = 0; i < 10; i++) {
+    code |= ((x >> i) & 1) << (3 * i);
+    code |= ((y >> i) & 1) << (3 * i + 1);
+    code |= ((z >> i) & 1) << (3 * i + 2);
+  }
+  return code;
+}
+
+void VertexArray::buildClusters(int numElementsPerCluster, int resolution)
+{
+  _clearClusters();
+  int npe = getNumVerticesPerElement();
+  std::size_t n = _vertices.size() / (3 * npe);
+  if(npe < 2 || numElementsPerCluster < 1 ||
+     n < 2 * (std::size_t)numElementsPerCluster)
+    return;
+  resolution = std::max(2, std::min(resolution, 32));
+
+  // sort the elements along a Morton curve, so that consecutive elements are
+  // close to each other
+  SBoundingBox3d bbox;
+  for(std::size_t i = 0; i < _vertices.size(); i += 3)
+    bbox += SPoint3(_vertices[i], _vertices[i + 1], _vertices[i + 2]);
+  double size[3] = {bbox.max().x() - bbox.min().x(),
+                    bbox.max().y() - bbox.min().y(),
+                    bbox.max().z() - bbox.min().z()};
+  std::vector<std::pair<uint32_t, std::size_t> > codes(n);
+  for(std::size_t e = 0; e < n; e++) {
+    uint32_t q[3];
+    for(int k = 0; k < 3; k++) {
+      double c = 0.;
+      for(int j = 0; j < npe; j++) c += _vertices[3 * (npe * e + j) + k];
+      c = c / npe - bbox.min()[k];
+      q[k] = size[k] > 0. ? (uint32_t)std::min(1023., 1024. * c / size[k]) : 0;
+    }
+    codes[e] = std::make_pair(mortonCode(q[0], q[1], q[2]), e);
+  }
+  std::sort(codes.begin(), codes.end());
+
+  bool normals = _normals.size() == 3 * npe * n;
+  bool colors = _colors.size() == 4 * npe * n;
+  bool elements = _elements.size() == npe * n;
+  std::vector<float> vertices(_vertices.size());
+  std::vector<normal_type> nor(normals ? _normals.size() : 0);
+  std::vector<unsigned char> col(colors ? _colors.size() : 0);
+  std::vector<MElement *> ele(elements ? _elements.size() : 0);
+  for(std::size_t e = 0; e < n; e++) {
+    std::size_t o = codes[e].second;
+    std::copy(&_vertices[3 * npe * o], &_vertices[3 * npe * (o + 1)],
+              &vertices[3 * npe * e]);
+    if(normals)
+      std::copy(&_normals[3 * npe * o], &_normals[3 * npe * (o + 1)],
+                &nor[3 * npe * e]);
+    if(colors)
+      std::copy(&_colors[4 * npe * o], &_colors[4 * npe * (o + 1)],
+                &col[4 * npe * e]);
+    if(elements)
+      std::copy(&_elements[npe * o], &_elements[npe * (o + 1)],
+                &ele[npe * e]);
+  }
+  _vertices.swap(vertices);
+  if(normals) _normals.swap(nor);
+  if(colors) _colors.swap(col);
+  if(elements) _elements.swap(ele);
+  _changes++;
+
+  // split the sorted elements in clusters, and simplify each cluster
+  _simplified = new VertexArray(npe, n / 8);
+  for(std::size_t e = 0; e < n; e += numElementsPerCluster) {
+    std::size_t end = std::min(n, e + numElementsPerCluster);
+    VertexArrayCluster c;
+    c.first = npe * e;
+    c.num = npe * (end - e);
+    for(int i = c.first; i < c.first + c.num; i++)
+      c.bbox += SPoint3(_vertices[3 * i], _vertices[3 * i + 1],
+                        _vertices[3 * i + 2]);
+    _simplifyCluster(c, resolution);
+    _clusters.push_back(c);
+  }
+}
+
+void VertexArray::_simplifyCluster(VertexArrayCluster &c, int resolution)
+{
+  // vertex clustering: each vertex is moved to the average position of the
+  // vertices in its cell, and the elements that become degenerate (or
+  // duplicated) are removed
+  int npe = getNumVerticesPerElement();
+  bool normals = _normals.size() == _vertices.size();
+  bool colors = 3 * _colors.size() == 4 * _vertices.size();
+  SPoint3 pmin = c.bbox.min();
+  double size[3] = {c.bbox.max().x() - pmin.x(), c.bbox.max().y() - pmin.y(),
+                    c.bbox.max().z() - pmin.z()};
+  c.cellSize = std::max(size[0], std::max(size[1], size[2])) / resolution;
+
+  std::vector<int> cell(c.num);
+  std::vector<double> sum(4 * resolution * resolution * resolution, 0.);
+  for(int i = 0; i < c.num; i++) {
+    const float *v = &_vertices[3 * (c.first + i)];
+    int q[3];
+    for(int k = 0; k < 3; k++)
+      q[k] = size[k] > 0. ? std::min(resolution - 1,
+                                     (int)(resolution * (v[k] - pmin[k]) /
+                                           size[k])) :
+                            0;
+    cell[i] = q[0] + resolution * (q[1] + resolution * q[2]);
+    for(int k = 0; k < 3; k++) sum[4 * cell[i] + k] += v[k];
+    sum[4 * cell[i] + 3] += 1.;
+  }
+
+  VertexArray *s = _simplified;
+  c.simplifiedFirst = s->getNumVertices();
+  // the elements are identified by the (sorted) cells of their first 3
+  // vertices
+  std::set<std::array<uint64_t, 3> > done;
+  int nk = std::min(npe, 3);
+  for(int e = 0; e < c.num; e += npe) {
+    std::array<uint64_t, 3> key = {{UINT64_MAX, UINT64_MAX, UINT64_MAX}};
+    for(int j = 0; j < nk; j++) key[j] = cell[e + j];
+    std::sort(key.begin(), key.end());
+    bool degenerate = false;
+    for(int j = 1; j < nk; j++)
+      if(key[j] == key[j - 1]) degenerate = true;
+    if(degenerate || !done.insert(key).second) continue;
+    for(int j = 0; j < npe; j++) {
+      int i = c.first + e + j;
+      const double *p = &sum[4 * cell[e + j]];
+      s->_addVertex((float)(p[0] / p[3]), (float)(p[1] / p[3]),
+                    (float)(p[2] / p[3]));
+      if(normals)
+        s->_normals.insert(s->_normals.end(), &_normals[3 * i],
+                           &_normals[3 * i + 3]);
+      if(colors)
+        s->_colors.insert(s->_colors.end(), &_colors[4 * i],
+                          &_colors[4 * i + 4]);
+    }
+  }
+  c.simplifiedNum = s->getNumVertices() - c.simplifiedFirst;
 }
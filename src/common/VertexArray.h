@@ -78,22 +78,6 @@ public:
   }
 };
 
-template <int N> class ElementDataLessThan {
-public:
-  static float tolerance;
-  bool operator()(const ElementData<N> &e1, const ElementData<N> &e2) const
-  {
-    SPoint3 p1 = e1.barycenter();
-    SPoint3 p2 = e2.barycenter();
-    if(p1.x() - p2.x() > tolerance) return true;
-    if(p1.x() - p2.x() < -tolerance) return false;
-    if(p1.y() - p2.y() > tolerance) return true;
-    if(p1.y() - p2.y() < -tolerance) return false;
-    if(p1.z() - p2.z() > tolerance) return true;
-    return false;
-  }
-};
-
 class Barycenter {
 private:
   float _x, _y, _z;
@@ -148,6 +132,25 @@ public:
 
 //#include <tr1/unordered_set>
 
+// Copy of a vertex array in graphics memory, created and managed by the
+// graphics module
+class VertexArrayBuffer {
+public:
+  virtual ~VertexArrayBuffer() {}
+};
+
+// Spatially coherent cluster of elements of a vertex array, with a simplified
+// representation stored in another vertex array
+class VertexArrayCluster {
+public:
+  // range of vertices in the vertex array and in the simplified vertex array
+  int first, num, simplifiedFirst, simplifiedNum;
+  // bounding box of the elements
+  SBoundingBox3d bbox;
+  // size of the cells used to simplify the cluster
+  double cellSize;
+};
+
 class VertexArray {
 private:
   int _numVerticesPerElement;
@@ -155,10 +158,21 @@ private:
   std::vector<normal_type> _normals;
   std::vector<unsigned char> _colors;
   std::vector<MElement *> _elements;
-  std::set<ElementData<3>, ElementDataLessThan<3> > _data3;
+  // boundary triangles, kept in finalize() only if they appear an odd number
+  // of times
+  std::vector<ElementData<3> > _data3;
   std::set<Barycenter, BarycenterLessThan> _barycenters;
   // std::tr1::unordered_set<Barycenter, BarycenterHash, BarycenterEqual>
   // _barycenters;
+  VertexArrayBuffer *_buffer;
+  // number of modifications of the arrays (which are always updated as a
+  // whole in graphics memory)
+  int _changes;
+  // clusters of elements and their simplified representation
+  std::vector<VertexArrayCluster> _clusters;
+  VertexArray *_simplified;
+  void _clearClusters();
+  void _simplifyCluster(VertexArrayCluster &c, int resolution);
 
   // add stuff in the arrays
   void _addVertex(float x, float y, float z);
@@ -169,7 +183,13 @@ private:
 
 public:
   VertexArray(int numVerticesPerElement, int numElements);
-  ~VertexArray() {}
+  ~VertexArray()
+  {
+    delete _buffer;
+    delete _simplified;
+  }
+  VertexArray(const VertexArray &) = delete;
+  VertexArray &operator=(const VertexArray &) = delete;
   // return the number of vertices in the array
   int getNumVertices() { return (int)_vertices.size() / 3; }
   // return the number of vertices per element
@@ -204,6 +224,27 @@ public:
     return _elements.end();
   }
 
+  // get/set the copy of the arrays in graphics memory (the vertex array takes
+  // ownership of the buffer)
+  VertexArrayBuffer *getBuffer() { return _buffer; }
+  void setBuffer(VertexArrayBuffer *buffer)
+  {
+    if(buffer != _buffer) delete _buffer;
+    _buffer = buffer;
+  }
+  // return the number of modifications of the arrays, used to update the copy
+  // in graphics memory
+  int getNumChanges() const { return _changes; }
+
+  // reorder the elements in spatially coherent clusters of about
+  // 'numElementsPerCluster' elements, and compute a simplified representation
+  // of each cluster by vertex clustering on a 'resolution'^3 grid
+  void buildClusters(int numElementsPerCluster = 2048, int resolution = 8);
+  // return the clusters (if any) and the simplified vertex array
+  int getNumClusters() const { return (int)_clusters.size(); }
+  const VertexArrayCluster &getCluster(int i) const { return _clusters[i]; }
+  VertexArray *getSimplifiedArray() { return _simplified; }
+
   // add element data in the arrays (if unique is set, only add the
   // element if another one with the same barycenter is not already
   // present)
@@ -218,19 +259,42 @@ public:
   void sort(double x, double y, double z);
   // estimate the size of the vertex array in megabytes
   double getMemoryInMb();
+  // kinds of messages used to stream a vertex array over the network: a
+  // CHUNK_BEGIN message with the size of the vertex, normal and color arrays
+  // (and whether they changed since they were last sent), followed by the
+  // header encoded by encodeHeader(); CHUNK_DATA messages with a (possibly
+  // compressed) chunk of one of the arrays that changed; and a CHUNK_END
+  // message. All the messages start with their kind, the view tag and the
+  // type of the vertex array.
+  enum { CHUNK_BEGIN = 1, CHUNK_DATA = 2, CHUNK_END = 3 };
   // serialize the vertex array into a string (for sending over the
   // network)
   char *toChar(int num, const std::string &name, int type, double min,
                double max, int numsteps, double time,
                const SBoundingBox3d &bbox, int &len);
   void fromChar(int length, const char *bytes, int swap);
+  static void encodeHeader(int num, const std::string &name, int type,
+                           double min, double max, int numsteps, double time,
+                           const SBoundingBox3d &bbox,
+                           std::vector<char> &bytes);
   static int decodeHeader(int length, const char *bytes, int swap,
                           std::string &name, int &tag, int &type, double &min,
                           double &max, int &numSteps, double &time,
                           double &xmin, double &ymin, double &zmin,
                           double &xmax, double &ymax, double &zmax);
+  // access the raw bytes of the vertex (i = 0), normal (i = 1) or color (i =
+  // 2) array, e.g. to send or receive them over the network in chunks
+  std::size_t getNumRawBytes(int i) const;
+  char *getRawBytes(int i);
+  // resize the raw array (in bytes: returns false if the size is not a
+  // multiple of the size of its entries)
+  bool resizeRawBytes(int i, std::size_t bytes);
+  // exchange the raw array with the one of another vertex array
+  void swapRawBytes(int i, VertexArray *va);
   // merge another vertex array into this one
   void merge(VertexArray *va);
+  // merge several vertex arrays into this one (in parallel)
+  void merge(const std::vector<VertexArray *> &va);
 };
 
 #endif
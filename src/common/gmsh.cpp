@@ -1332,6 +1332,14 @@ GMSH_API void gmsh::model::mesh::unpartition()
   CTX::instance()->mesh.changed = ENT_ALL;
 }
 
+GMSH_API void gmsh::model::mesh::readDistributed(const std::string &fileName)
+{
+  if(!_checkInit()) return;
+  if(!GModel::current()->readMSH4Distributed(fileName))
+    Msg::Error("Could not read file '%s'", fileName.c_str());
+  CTX::instance()->mesh.changed = ENT_ALL;
+}
+
 GMSH_API void gmsh::model::mesh::refine()
 {
   if(!_checkInit()) return;
@@ -4755,7 +4763,10 @@ GMSH_API void gmsh::model::mesh::setSize(const vectorpair &dimTags,
     int dim = dimTags[i].first, tag = dimTags[i].second;
     if(dim == 0) {
       GVertex *gv = GModel::current()->getVertexByTag(tag);
-      if(gv) gv->setPrescribedMeshSizeAtVertex(size);
+      if(gv) {
+        gv->setPrescribedMeshSizeAtVertex(size);
+        gv->setMeshOutdated(true);
+      }
     }
   }
 }
@@ -4786,7 +4797,10 @@ GMSH_API void gmsh::model::mesh::setSizeAtParametricPoints(
   if(!_checkInit()) return;
   if(dim == 1) {
     GEdge *ge = GModel::current()->getEdgeByTag(tag);
-    if(ge) ge->setMeshSizeParametric(parametricCoord, sizes);
+    if(ge) {
+      ge->setMeshSizeParametric(parametricCoord, sizes);
+      ge->setMeshOutdated(true);
+    }
   }
 }
 
@@ -4816,6 +4830,7 @@ gmsh::model::mesh::setTransfiniteCurve(const int tag, const int numNodes,
     if(ge) {
       ge->meshAttributes.method = MESH_TRANSFINITE;
       ge->meshAttributes.nbPointsTransfinite = numNodes;
+      ge->setMeshOutdated(true);
       ge->meshAttributes.typeTransfinite =
         (meshType == "Progression" || meshType == "Power") ? 1 :
         (meshType == "Bump")                               ? 2 :
@@ -4849,6 +4864,7 @@ gmsh::model::mesh::setTransfiniteSurface(const int tag,
     return;
   }
   gf->meshAttributes.method = MESH_TRANSFINITE;
+  gf->setMeshOutdated(true);
   gf->meshAttributes.transfiniteArrangement =
     (arrangement == "Right")          ? 1 :
     (arrangement == "Left")           ? -1 :
@@ -4875,6 +4891,7 @@ gmsh::model::mesh::setTransfiniteVolume(const int tag,
     return;
   }
   gr->meshAttributes.method = MESH_TRANSFINITE;
+  gr->setMeshOutdated(true);
   if(cornerTags.empty() || cornerTags.size() == 6 || cornerTags.size() == 8) {
     for(std::size_t i = 0; i < cornerTags.size(); i++) {
       GVertex *gv = GModel::current()->getVertexByTag(cornerTags[i]);
@@ -5012,6 +5029,7 @@ GMSH_API void gmsh::model::mesh::setRecombine(const int dim, const int tag,
     }
     gf->meshAttributes.recombine = 1;
     gf->meshAttributes.recombineAngle = angle;
+    gf->setMeshOutdated(true);
   }
 }
 
@@ -5026,6 +5044,7 @@ GMSH_API void gmsh::model::mesh::setSmoothing(const int dim, const int tag,
       return;
     }
     gf->meshAttributes.transfiniteSmoothing = val;
+    gf->setMeshOutdated(true);
   }
 }
 
@@ -5040,6 +5059,7 @@ GMSH_API void gmsh::model::mesh::setReverse(const int dim, const int tag,
       return;
     }
     ge->meshAttributes.reverseMesh = val;
+    ge->setMeshOutdated(true);
   }
   else if(dim == 2) {
     GFace *gf = GModel::current()->getFaceByTag(tag);
@@ -5048,6 +5068,7 @@ GMSH_API void gmsh::model::mesh::setReverse(const int dim, const int tag,
       return;
     }
     gf->meshAttributes.reverseMesh = val;
+    gf->setMeshOutdated(true);
   }
 }
 
@@ -5062,6 +5083,7 @@ GMSH_API void gmsh::model::mesh::setAlgorithm(const int dim, const int tag,
       return;
     }
     gf->meshAttributes.algorithm = val;
+    gf->setMeshOutdated(true);
   }
 }
 
@@ -5077,6 +5099,7 @@ GMSH_API void gmsh::model::mesh::setSizeFromBoundary(const int dim,
       return;
     }
     gf->meshAttributes.meshSizeFromBoundary = val;
+    gf->setMeshOutdated(true);
   }
 }
 
@@ -5111,8 +5134,10 @@ GMSH_API void gmsh::model::mesh::removeConstraints(const vectorpair &dimTags)
   if(!_checkInit()) return;
   std::vector<GEntity *> entities;
   _getEntities(dimTags, entities);
-  for(std::size_t i = 0; i < entities.size(); i++)
+  for(std::size_t i = 0; i < entities.size(); i++) {
     entities[i]->resetMeshAttributes();
+    entities[i]->setMeshOutdated(true);
+  }
 }
 
 GMSH_API void gmsh::model::mesh::embed(const int dim,
@@ -5144,6 +5169,7 @@ GMSH_API void gmsh::model::mesh::embed(const int dim,
         gf->addEmbeddedEdge(ge);
       }
     }
+    gf->setMeshOutdated(true);
   }
   else if(inDim == 3) {
     GRegion *gr = GModel::current()->getRegionByTag(inTag);
@@ -5177,9 +5203,19 @@ GMSH_API void gmsh::model::mesh::embed(const int dim,
         gr->addEmbeddedFace(gf);
       }
     }
+    gr->setMeshOutdated(true);
   }
 }
 
+GMSH_API void gmsh::model::mesh::setOutdated(const vectorpair &dimTags)
+{
+  if(!_checkInit()) return;
+  std::vector<GEntity *> entities;
+  _getEntities(dimTags, entities);
+  for(std::size_t i = 0; i < entities.size(); i++)
+    entities[i]->setMeshOutdated(true);
+}
+
 GMSH_API void gmsh::model::mesh::removeEmbedded(const vectorpair &dimTags,
                                                 const int rdim)
 {
@@ -5194,6 +5230,7 @@ GMSH_API void gmsh::model::mesh::removeEmbedded(const vectorpair &dimTags,
       }
       if(rdim < 0 || rdim == 1) gf->embeddedEdges().clear();
       if(rdim < 0 || rdim == 0) gf->embeddedVertices().clear();
+      gf->setMeshOutdated(true);
     }
     else if(dimTags[i].first == 3) {
       GRegion *gr = GModel::current()->getRegionByTag(tag);
@@ -5204,6 +5241,7 @@ GMSH_API void gmsh::model::mesh::removeEmbedded(const vectorpair &dimTags,
       if(rdim < 0 || rdim == 2) gr->embeddedFaces().clear();
       if(rdim < 0 || rdim == 1) gr->embeddedEdges().clear();
       if(rdim < 0 || rdim == 0) gr->embeddedVertices().clear();
+      gr->setMeshOutdated(true);
     }
   }
 }
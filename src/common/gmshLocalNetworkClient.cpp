@@ -464,6 +464,19 @@ bool gmshLocalNetworkClient::receiveMessage(gmshLocalNetworkClient *master)
 #if defined(HAVE_POST)
     PView::fillVertexArray(this, length, &message[0], swap);
 #endif
+#if defined(HAVE_FLTK)
+    if(FlGui::available())
+      FlGui::instance()->updateViews(n != (int)PView::list.size(), true);
+    drawContext::global()->draw();
+#endif
+  } break;
+  case GmshSocket::GMSH_VERTEX_ARRAY_CHUNK: {
+#if defined(HAVE_FLTK)
+    int n = PView::list.size();
+#endif
+#if defined(HAVE_POST)
+    if(!PView::fillVertexArrayChunk(this, length, &message[0], swap)) break;
+#endif
 #if defined(HAVE_FLTK)
     if(FlGui::available())
       FlGui::instance()->updateViews(n != (int)PView::list.size(), true);
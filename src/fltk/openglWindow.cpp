@@ -26,6 +26,7 @@
 #include "Trackball.h"
 #include "GamePad.h"
 #include "StringUtils.h"
+#include "OS.h"
 
 // Navigator handler (read gamepad event if gamepad exists or question presence
 // of gamepad)
@@ -70,6 +71,12 @@ static void lassoZoom(drawContext *ctx, mousePosition &click1,
   FlGui::instance()->manip->update();
 }
 
+static void end_interaction_cb(void *data)
+{
+  CTX::instance()->interacting = 0;
+  ((openglWindow *)data)->redraw();
+}
+
 openglWindow::openglWindow(int x, int y, int w, int h)
   : Fl_Gl_Window(x, y, w, h, "gl"), _lock(false), _drawn(false),
     _selection(ENT_NONE), _trySelection(0), Nautilus(nullptr)
@@ -79,6 +86,7 @@ openglWindow::openglWindow(int x, int y, int w, int h)
   for(int i = 0; i < 3; i++) _point[i] = 0.;
   for(int i = 0; i < 4; i++) _trySelectionXYWH[i] = 0;
   _lassoXY[0] = _lassoXY[1] = 0;
+  _frameTime = 0.;
 
   addPointMode = 0;
   lassoMode = selectionMode = false;
@@ -96,6 +104,7 @@ openglWindow::openglWindow(int x, int y, int w, int h)
 
 openglWindow::~openglWindow()
 {
+  Fl::remove_timeout(end_interaction_cb, this);
   delete _ctx;
 #if defined(NEW_TOOLTIPS)
   delete _tooltip;
@@ -179,6 +188,7 @@ void openglWindow::draw()
   _drawn = true;
   if(_lock) return;
   _lock = true;
+  double w1 = TimeOfDay();
 
   Msg::Debug("openglWindow::draw()");
 
@@ -357,6 +367,15 @@ void openglWindow::draw()
     }
   }
   drawContext::global()->flushString();
+
+  if(CTX::instance()->displayFrameTime && !lassoMode) {
+    // wait for the rendering to complete, and average over the last frames
+    glFinish();
+    double dt = TimeOfDay() - w1;
+    _frameTime = (_frameTime > 0.) ? 0.8 * _frameTime + 0.2 * dt : dt;
+    Msg::StatusBar(false, "Frame drawn in %.3g ms (average %.3g ms, %.3g fps)",
+                   1.e3 * dt, 1.e3 * _frameTime, 1. / _frameTime);
+  }
   _lock = false;
 }
 
@@ -548,6 +567,7 @@ int openglWindow::handle(int event)
   case FL_RELEASE:
     _curr.set(_ctx, Fl::event_x(), Fl::event_y());
     CTX::instance()->drawRotationCenter = 0;
+    CTX::instance()->interacting = 0;
     if(!lassoMode) {
       CTX::instance()->mesh.draw = 1;
       CTX::instance()->post.draw = 1;
@@ -562,6 +582,12 @@ int openglWindow::handle(int event)
     double fact =
       (5. * CTX::instance()->zoomFactor * fabs(dy) + h()) / (double)h();
     bool direction = (CTX::instance()->mouseInvertZoom) ? (dy <= 0) : (dy > 0);
+    if(CTX::instance()->mesh.levelOfDetail == 1) {
+      // draw the full mesh again when the zoom stops
+      CTX::instance()->interacting = 1;
+      Fl::remove_timeout(end_interaction_cb, this);
+      Fl::add_timeout(0.3, end_interaction_cb, this);
+    }
     if(CTX::instance()->camera) {
       fact = (direction ? fact : 1. / fact);
       _ctx->camera.zoom(fact);
@@ -657,6 +683,7 @@ int openglWindow::handle(int event)
           }
         }
         CTX::instance()->drawRotationCenter = 1;
+        CTX::instance()->interacting = 1;
         if(CTX::instance()->fastRedraw) {
           CTX::instance()->mesh.draw = 0;
           CTX::instance()->post.draw = 0;
@@ -86,6 +86,8 @@ private:
   double _point[3];
   int _selection, _trySelection, _trySelectionXYWH[4];
   double _lassoXY[2];
+  // running average of the time taken to draw a frame
+  double _frameTime;
   void _drawScreenMessage();
   void _drawBorder();
   bool _select(int type, bool multiple, bool mesh, bool post, int x, int y,
@@ -18,8 +18,8 @@
 
 GEntity::GEntity(GModel *m, int t)
   : _model(m), _tag(t), _meshMaster(this), _visible(1), _selection(0),
-    _onlySomeElementsVisible(1), _obb(nullptr), va_lines(nullptr),
-    va_triangles(nullptr)
+    _onlySomeElementsVisible(1), _meshOutdated(false), _obb(nullptr),
+    va_lines(nullptr), va_triangles(nullptr)
 {
   // default color when none is explicitly specified - don't change this, as it
   // is documented and used in scripts to detect if explicit colors are set
@@ -48,6 +48,10 @@ private:
   // the color of the entity (ignored if set to transparent blue)
   unsigned int _color;
 
+  // flag storing if the mesh of the entity is outdated, e.g. because its mesh
+  // constraints have changed since it was generated
+  bool _meshOutdated;
+
 protected:
   // the oriented bounding box of the entity
   SOrientedBoundingBox *_obb;
@@ -315,6 +319,11 @@ public:
     _visible = val;
   }
 
+  // get/set the flag telling if the mesh is outdated (used for incremental
+  // mesh generation)
+  bool getMeshOutdated() const { return _meshOutdated; }
+  void setMeshOutdated(bool val) { _meshOutdated = val; }
+
   // get/set the selection flag
   virtual char getSelection() { return _selection; }
   virtual void setSelection(char val) { _selection = val; }
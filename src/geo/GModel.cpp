@@ -2566,14 +2566,40 @@ void GModel::createGeometryOfDiscreteEntities(
   if(f.size()) {
     Msg::StatusBar(true, "Creating geometry of discrete surfaces...");
     double t1 = Cpu(), w1 = TimeOfDay();
+    // the parametrizations of the surfaces are independent
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+#if defined(HAVE_PETSC)
+    // PETSc solvers are not thread-safe
+    nthreads = 1;
+#endif
+    // the nodes and triangles of the parametrizations are renumbered after the
+    // loop, so that their numbers do not depend on the order of the threads
+    std::size_t vertexNum = getMaxVertexNumber();
+    std::size_t elementNum = getMaxElementNumber();
     Msg::StartProgressMeter(f.size());
+    int done = 0;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
     for(std::size_t i = 0; i < f.size(); i++) {
-      Msg::ProgressMeter(i, true, "Creating geometry");
-      if(f[i]->createGeometry())
+      int ret = 1;
+      try { // OpenMP forbids leaving block via exception
+        ret = f[i]->createGeometry();
+      }
+      catch(...) {
+      }
+      if(ret)
         Msg::Error("Could not create geometry of discrete surface %d",
                    f[i]->tag());
+      int localDone;
+#pragma omp atomic capture
+      localDone = ++done;
+      Msg::ProgressMeter(localDone, true, "Creating geometry");
     }
     Msg::StopProgressMeter();
+    if(nthreads > 1) {
+      for(std::size_t i = 0; i < f.size(); i++)
+        f[i]->renumberParametrization(vertexNum, elementNum);
+    }
     double t2 = Cpu();
     double w2 = TimeOfDay();
     Msg::StatusBar(true,
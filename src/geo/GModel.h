@@ -223,11 +223,21 @@ public:
   std::size_t getMaxElementNumber() const { return _maxElementNum; }
   void setMaxVertexNumber(std::size_t num)
   {
+    // only write if needed, so that threads creating entities with known tags
+    // do not all write to the same cache line
+    std::size_t current;
+#pragma omp atomic read
+    current = _maxVertexNum;
+    if(num <= current) return;
 #pragma omp atomic write
     _maxVertexNum = _maxVertexNum > num ? _maxVertexNum : num;
   }
   void setMaxElementNumber(std::size_t num)
   {
+    std::size_t current;
+#pragma omp atomic read
+    current = _maxElementNum;
+    if(num <= current) return;
 #pragma omp atomic write
     _maxElementNum = _maxElementNum > num ? _maxElementNum : num;
   }
@@ -793,6 +803,9 @@ public:
                           bool binary = false, bool saveAll = false,
                           bool saveParametric = false,
                           double scalingFactor = 1.0);
+  // read a MSH4 file cooperatively on all the MPI processes, each process
+  // ending up with a part of the mesh
+  int readMSH4Distributed(const std::string &name);
 
   // Iridium file format
   int writeIR3(const std::string &name, int elementTagType, bool saveAll,
@@ -16,6 +16,8 @@
 #include <cstdlib>
 #include <limits>
 #include <stdexcept>
+#include <unordered_map>
+#include <stdint.h>
 
 #include "GmshDefines.h"
 #include "OS.h"
@@ -40,11 +42,17 @@
 #include "MPyramid.h"
 #include "MTrihedron.h"
 #include "StringUtils.h"
+#include "GModelIO_MSH4.h"
+#include "CompressedFile.h"
 
 #if defined(HAVE_POST)
 #include "PView.h"
 #endif
 
+#if defined(HAVE_MPI)
+#include <mpi.h>
+#endif
+
 static bool readMSH4Physicals(GModel *const model, FILE *fp,
                               GEntity *const entity, bool binary,
                               bool swap)
@@ -1977,83 +1985,217 @@ static void writeMSH4Entities(GModel *const model, FILE *fp, bool partition,
     fprintf(fp, "$EndEntities\n");
 }
 
-static void writeMSH4EntityNodes(GEntity *ge, FILE *fp, bool binary,
-                                 int saveParametric, double scalingFactor,
-                                 double version)
+// Node and element blocks are serialized in memory in chunks of at most
+// 'msh4ChunkSize' nodes or elements, in parallel, then written in order: the
+// output is the same as if the blocks were written sequentially.
+static const std::size_t msh4ChunkSize = 100000;
+
+namespace {
+  struct msh4Chunk {
+    enum { NODE_HEADER, NODE_TAGS, NODES, ELEMENT_HEADER, ELEMENTS };
+    int what;
+    GEntity *entity;
+    const std::vector<MElement *> *elements;
+    int dim, tag, type;
+    std::size_t first, last;
+    std::string data;
+    msh4Chunk(int w, GEntity *ge, const std::vector<MElement *> *ele, int d,
+              int t, int ty, std::size_t f, std::size_t l)
+      : what(w), entity(ge), elements(ele), dim(d), tag(t), type(ty), first(f),
+        last(l)
+    {
+    }
+  };
+} // namespace
+
+template <class T> static void appendMSH4Binary(std::string &s, const T &val)
 {
-  int parametric = saveParametric;
-  if(ge->dim() != 1 && ge->dim() != 2)
-    parametric = 0; // Gmsh only stores parametric coordinates for dim 1 and 2
+  s.append((const char *)&val, sizeof(T));
+}
 
+static void appendMSH4Nodes(GEntity *ge, bool binary, double version,
+                            std::vector<msh4Chunk> &chunks)
+{
   std::size_t numVerts = ge->getNumMeshVertices();
-
-  if(binary) {
-    int entityDim = ge->dim();
-    int entityTag = ge->tag();
-    fwrite(&entityDim, sizeof(int), 1, fp);
-    fwrite(&entityTag, sizeof(int), 1, fp);
-    fwrite(&parametric, sizeof(int), 1, fp);
-    fwrite(&numVerts, sizeof(std::size_t), 1, fp);
-  }
-  else {
-    fprintf(fp, "%d %d %d %lu\n", (version >= 4.1) ? ge->dim() : ge->tag(),
-            (version >= 4.1) ? ge->tag() : ge->dim(), parametric,
-            ge->getNumMeshVertices());
+  chunks.push_back(msh4Chunk(msh4Chunk::NODE_HEADER, ge, nullptr, ge->dim(),
+                             ge->tag(), 0, 0, numVerts));
+  // node tags are written before the coordinates, except in MSH 4.0 ASCII
+  if(binary || version >= 4.1) {
+    for(std::size_t i = 0; i < numVerts; i += msh4ChunkSize)
+      chunks.push_back(msh4Chunk(msh4Chunk::NODE_TAGS, ge, nullptr, 0, 0, 0, i,
+                                 std::min(i + msh4ChunkSize, numVerts)));
   }
+  for(std::size_t i = 0; i < numVerts; i += msh4ChunkSize)
+    chunks.push_back(msh4Chunk(msh4Chunk::NODES, ge, nullptr, 0, 0, 0, i,
+                               std::min(i + msh4ChunkSize, numVerts)));
+}
 
-  if(!numVerts) {
-    return;
-  }
+static void appendMSH4Elements(const std::vector<MElement *> &elements,
+                               int dim, int entityTag, int elmType,
+                               std::vector<msh4Chunk> &chunks)
+{
+  std::size_t numElm = elements.size();
+  chunks.push_back(msh4Chunk(msh4Chunk::ELEMENT_HEADER, nullptr, &elements,
+                             dim, entityTag, elmType, 0, numElm));
+  for(std::size_t i = 0; i < numElm; i += msh4ChunkSize)
+    chunks.push_back(msh4Chunk(msh4Chunk::ELEMENTS, nullptr, &elements, dim,
+                               entityTag, elmType, i,
+                               std::min(i + msh4ChunkSize, numElm)));
+}
 
-  std::size_t n = 3;
-  if(parametric) n += ge->dim();
+static void serializeMSH4Chunk(msh4Chunk &c, bool binary, int saveParametric,
+                               double scalingFactor, double version)
+{
+  std::string &s = c.data;
+  std::size_t num = c.last - c.first;
+  char buf[256];
+  char *p;
+
+  if(c.what == msh4Chunk::NODE_HEADER || c.what == msh4Chunk::NODES) {
+    int parametric = saveParametric;
+    if(c.entity->dim() != 1 && c.entity->dim() != 2)
+      parametric = 0; // Gmsh only stores parametric coordinates for dim 1 and 2
+    std::size_t n = 3;
+    if(parametric) n += c.entity->dim();
 
-  if(binary) {
-    std::vector<size_t> tags(numVerts);
-    for(std::size_t i = 0; i < numVerts; i++)
-      tags[i] = ge->getMeshVertex(i)->getNum();
-    fwrite(&tags[0], sizeof(std::size_t), numVerts, fp);
-    std::vector<double> coord(n * numVerts);
-    std::size_t j = 0;
-    for(std::size_t i = 0; i < numVerts; i++) {
-      MVertex *mv = ge->getMeshVertex(i);
-      coord[j++] = mv->x() * scalingFactor;
-      coord[j++] = mv->y() * scalingFactor;
-      coord[j++] = mv->z() * scalingFactor;
-      if(n >= 4) mv->getParameter(0, coord[j++]);
-      if(n == 5) mv->getParameter(1, coord[j++]);
+    if(c.what == msh4Chunk::NODE_HEADER) {
+      if(binary) {
+        appendMSH4Binary(s, c.dim);
+        appendMSH4Binary(s, c.tag);
+        appendMSH4Binary(s, parametric);
+        appendMSH4Binary(s, num);
+      }
+      else {
+        sprintf(buf, "%d %d %d %lu\n", (version >= 4.1) ? c.dim : c.tag,
+                (version >= 4.1) ? c.tag : c.dim, parametric, num);
+        s.append(buf);
+      }
+      return;
+    }
+
+    if(binary) {
+      s.resize(n * num * sizeof(double));
+      std::size_t j = 0;
+      for(std::size_t i = c.first; i < c.last; i++) {
+        MVertex *mv = c.entity->getMeshVertex(i);
+        double coord[5] = {mv->x() * scalingFactor, mv->y() * scalingFactor,
+                           mv->z() * scalingFactor, 0., 0.};
+        if(n >= 4) mv->getParameter(0, coord[3]);
+        if(n == 5) mv->getParameter(1, coord[4]);
+        memcpy(&s[j], coord, n * sizeof(double));
+        j += n * sizeof(double);
+      }
+    }
+    else {
+      s.reserve(num * (n * 24 + 1));
+      for(std::size_t i = c.first; i < c.last; i++) {
+        MVertex *mv = c.entity->getMeshVertex(i);
+        double coord[5] = {mv->x() * scalingFactor, mv->y() * scalingFactor,
+                           mv->z() * scalingFactor, 0., 0.};
+        if(n >= 4) mv->getParameter(0, coord[3]);
+        if(n == 5) mv->getParameter(1, coord[4]);
+        p = buf;
+        if(version < 4.1) {
+          p = FormatUnsigned(p, mv->getNum());
+          *p++ = ' ';
+        }
+        for(std::size_t k = 0; k < n; k++) {
+          if(k) *p++ = ' ';
+          p = FormatDouble(p, coord[k]);
+        }
+        *p++ = '\n';
+        s.append(buf, p - buf);
+      }
     }
-    fwrite(&coord[0], sizeof(double), n * numVerts, fp);
   }
-  else {
-    if(version >= 4.1) {
-      for(std::size_t i = 0; i < numVerts; i++)
-        fprintf(fp, "%lu\n", ge->getMeshVertex(i)->getNum());
+  else if(c.what == msh4Chunk::NODE_TAGS) {
+    if(binary) {
+      s.resize(num * sizeof(std::size_t));
+      for(std::size_t i = c.first; i < c.last; i++) {
+        std::size_t tag = c.entity->getMeshVertex(i)->getNum();
+        memcpy(&s[(i - c.first) * sizeof(std::size_t)], &tag,
+               sizeof(std::size_t));
+      }
     }
-    for(std::size_t i = 0; i < numVerts; i++) {
-      MVertex *mv = ge->getMeshVertex(i);
-      double x = mv->x() * scalingFactor;
-      double y = mv->y() * scalingFactor;
-      double z = mv->z() * scalingFactor;
-      if(version < 4.1) fprintf(fp, "%lu ", mv->getNum());
-      if(n == 5) {
-        double u, v;
-        mv->getParameter(0, u);
-        mv->getParameter(1, v);
-        fprintf(fp, "%.16g %.16g %.16g %.16g %.16g\n", x, y, z, u, v);
-      }
-      else if(n == 4) {
-        double u;
-        mv->getParameter(0, u);
-        fprintf(fp, "%.16g %.16g %.16g %.16g\n", x, y, z, u);
+    else {
+      s.reserve(num * 8);
+      for(std::size_t i = c.first; i < c.last; i++) {
+        p = FormatUnsigned(buf, c.entity->getMeshVertex(i)->getNum());
+        *p++ = '\n';
+        s.append(buf, p - buf);
       }
-      else {
-        fprintf(fp, "%.16g %.16g %.16g\n", x, y, z);
+    }
+  }
+  else if(c.what == msh4Chunk::ELEMENT_HEADER) {
+    if(binary) {
+      appendMSH4Binary(s, c.dim);
+      appendMSH4Binary(s, c.tag);
+      appendMSH4Binary(s, c.type);
+      appendMSH4Binary(s, num);
+    }
+    else {
+      sprintf(buf, "%d %d %d %lu\n", (version >= 4.1) ? c.dim : c.tag,
+              (version >= 4.1) ? c.tag : c.dim, c.type, num);
+      s.append(buf);
+    }
+  }
+  else if(c.what == msh4Chunk::ELEMENTS) {
+    const std::vector<MElement *> &elements = *c.elements;
+    if(binary) {
+      const int numVertPerElm = MElement::getInfoMSH(c.type);
+      std::size_t n = 1 + numVertPerElm;
+      s.resize(num * n * sizeof(std::size_t));
+      std::vector<std::size_t> tags(n);
+      for(std::size_t i = c.first; i < c.last; i++) {
+        MElement *e = elements[i];
+        tags[0] = e->getNum();
+        for(int j = 0; j < numVertPerElm; j++)
+          tags[1 + j] = e->getVertex(j)->getNum();
+        memcpy(&s[(i - c.first) * n * sizeof(std::size_t)], &tags[0],
+               n * sizeof(std::size_t));
+      }
+    }
+    else {
+      s.reserve(num * 8 * (1 + elements[c.first]->getNumVertices()));
+      for(std::size_t i = c.first; i < c.last; i++) {
+        MElement *e = elements[i];
+        p = FormatUnsigned(buf, e->getNum());
+        *p++ = ' ';
+        s.append(buf, p - buf);
+        for(std::size_t j = 0; j < e->getNumVertices(); j++) {
+          p = FormatUnsigned(buf, e->getVertex(j)->getNum());
+          *p++ = ' ';
+          s.append(buf, p - buf);
+        }
+        s += '\n';
       }
     }
   }
 }
 
+static void writeMSH4Chunks(FILE *fp, std::vector<msh4Chunk> &chunks,
+                            bool binary, int saveParametric,
+                            double scalingFactor, double version)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // serialize a few chunks per thread at a time, to limit memory usage
+  std::size_t group = 4 * std::max(1, nthreads);
+  for(std::size_t start = 0; start < chunks.size(); start += group) {
+    std::size_t end = std::min(start + group, chunks.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = start; i < end; i++) {
+      serializeMSH4Chunk(chunks[i], binary, saveParametric, scalingFactor,
+                         version);
+    }
+    for(std::size_t i = start; i < end; i++) {
+      fwrite(chunks[i].data.data(), 1, chunks[i].data.size(), fp);
+      std::string().swap(chunks[i].data);
+    }
+  }
+}
+
 static std::size_t
 getAdditionalEntities(std::set<GRegion *, GEntityPtrLessThan> &regions,
                       std::set<GFace *, GEntityPtrLessThan> &faces,
@@ -2356,22 +2498,16 @@ static void writeMSH4Nodes(GModel *const model, FILE *fp, bool partitioned,
     }
   }
 
-  for(auto it = vertices.begin(); it != vertices.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
-  }
-  for(auto it = edges.begin(); it != edges.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
-  }
-  for(auto it = faces.begin(); it != faces.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
-  }
-  for(auto it = regions.begin(); it != regions.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
-  }
+  std::vector<msh4Chunk> chunks;
+  for(auto it = vertices.begin(); it != vertices.end(); ++it)
+    appendMSH4Nodes(*it, binary, version, chunks);
+  for(auto it = edges.begin(); it != edges.end(); ++it)
+    appendMSH4Nodes(*it, binary, version, chunks);
+  for(auto it = faces.begin(); it != faces.end(); ++it)
+    appendMSH4Nodes(*it, binary, version, chunks);
+  for(auto it = regions.begin(); it != regions.end(); ++it)
+    appendMSH4Nodes(*it, binary, version, chunks);
+  writeMSH4Chunks(fp, chunks, binary, saveParametric, scalingFactor, version);
 
   if(binary) fprintf(fp, "\n");
 
@@ -2496,51 +2632,14 @@ static void writeMSH4Elements(GModel *const model, FILE *fp, bool partitioned,
       fprintf(fp, "%lu %lu\n", numSection, numElements);
   }
 
+  std::vector<msh4Chunk> chunks;
   for(int dim = 0; dim <= 3; dim++) {
     for(auto it = elementsByType[dim].begin(); it != elementsByType[dim].end();
-        ++it) {
-      int entityTag = it->first.first;
-      int elmType = it->first.second;
-      std::size_t numElm = it->second.size();
-      if(binary) {
-        fwrite(&dim, sizeof(int), 1, fp);
-        fwrite(&entityTag, sizeof(int), 1, fp);
-        fwrite(&elmType, sizeof(int), 1, fp);
-        fwrite(&numElm, sizeof(std::size_t), 1, fp);
-      }
-      else {
-        fprintf(fp, "%d %d %d %lu\n", (version >= 4.1) ? dim : entityTag,
-                (version >= 4.1) ? entityTag : dim, elmType, numElm);
-      }
-
-      std::size_t N = it->second.size();
-      if(binary) {
-        const int numVertPerElm = MElement::getInfoMSH(elmType);
-        std::size_t n = 1 + numVertPerElm;
-        std::vector<std::size_t> tags(N * n);
-        std::size_t k = 0;
-        for(std::size_t i = 0; i < N; i++) {
-          MElement *e = it->second[i];
-          tags[k] = e->getNum();
-          for(int j = 0; j < numVertPerElm; j++) {
-            tags[k + 1 + j] = e->getVertex(j)->getNum();
-          }
-          k += n;
-        }
-        fwrite(&tags[0], sizeof(std::size_t), N * n, fp);
-      }
-      else {
-        for(std::size_t i = 0; i < N; i++) {
-          MElement *e = it->second[i];
-          fprintf(fp, "%lu ", e->getNum());
-          for(std::size_t i = 0; i < e->getNumVertices(); i++) {
-            fprintf(fp, "%lu ", e->getVertex(i)->getNum());
-          }
-          fprintf(fp, "\n");
-        }
-      }
-    }
+        ++it)
+      appendMSH4Elements(it->second, dim, it->first.first, it->first.second,
+                         chunks);
   }
+  writeMSH4Chunks(fp, chunks, binary, 0, 1., version);
 
   if(binary) fprintf(fp, "\n");
 
@@ -2775,6 +2874,32 @@ static void writeMSH4Parametrizations(GModel *const model, FILE *fp,
   fprintf(fp, "$EndParametrizations\n");
 }
 
+static void writeMSH4Header(GModel *const model, FILE *fp, double version,
+                            bool binary)
+{
+  fprintf(fp, "$MeshFormat\n");
+  fprintf(fp, "%g %d %lu\n", version, (binary ? 1 : 0), sizeof(std::size_t));
+  if(binary) {
+    int one = 1;
+    fwrite(&one, sizeof(int), 1, fp); // swapping byte
+    fprintf(fp, "\n");
+  }
+  fprintf(fp, "$EndMeshFormat\n");
+
+  if(model->numPhysicalNames() > 0) {
+    fprintf(fp, "$PhysicalNames\n");
+    fprintf(fp, "%d\n", model->numPhysicalNames());
+    for(auto it = model->firstPhysicalName(); it != model->lastPhysicalName();
+        ++it) {
+      std::string name = it->second;
+      if(name.size() > 128) name.resize(128);
+      fprintf(fp, "%d %d \"%s\"\n", it->first.first, it->first.second,
+              name.c_str());
+    }
+    fprintf(fp, "$EndPhysicalNames\n");
+  }
+}
+
 int GModel::_writeMSH4(const std::string &name, double version, bool binary,
                        bool saveAll, bool saveParametric, double scalingFactor,
                        bool append, int partitionToSave,
@@ -2799,28 +2924,8 @@ int GModel::_writeMSH4(const std::string &name, double version, bool binary,
   // if there are no physicals we save all the elements
   if(noPhysicalGroups()) saveAll = true;
 
-  // header
-  fprintf(fp, "$MeshFormat\n");
-  fprintf(fp, "%g %d %lu\n", version, (binary ? 1 : 0), sizeof(std::size_t));
-  if(binary) {
-    int one = 1;
-    fwrite(&one, sizeof(int), 1, fp); // swapping byte
-    fprintf(fp, "\n");
-  }
-  fprintf(fp, "$EndMeshFormat\n");
-
-  // physicals
-  if(numPhysicalNames() > 0) {
-    fprintf(fp, "$PhysicalNames\n");
-    fprintf(fp, "%d\n", numPhysicalNames());
-    for(auto it = firstPhysicalName(); it != lastPhysicalName(); ++it) {
-      std::string name = it->second;
-      if(name.size() > 128) name.resize(128);
-      fprintf(fp, "%d %d \"%s\"\n", it->first.first, it->first.second,
-              name.c_str());
-    }
-    fprintf(fp, "$EndPhysicalNames\n");
-  }
+  // header and physicals
+  writeMSH4Header(this, fp, version, binary);
 
   // entities
   writeMSH4Entities(this, fp, false, binary, scalingFactor, version,
@@ -2936,6 +3041,919 @@ int GModel::_writePartitionedMSH4(const std::string &baseName, double version,
   return 1;
 }
 
+MSH4StreamWriter::MSH4StreamWriter(GModel *model, const std::string &fileName,
+                                   bool binary, bool saveAll,
+                                   double scalingFactor)
+  : _model(model), _fileName(fileName), _nodes(nullptr), _elements(nullptr),
+    _binary(binary), _saveAll(saveAll), _scalingFactor(scalingFactor),
+    _numNodeBlocks(0), _numNodes(0),
+    _minNodeTag(std::numeric_limits<std::size_t>::max()), _maxNodeTag(0),
+    _numElementBlocks(0), _numElements(0),
+    _minElementTag(std::numeric_limits<std::size_t>::max()), _maxElementTag(0)
+{
+  // the temporary files are never compressed
+  std::vector<std::string> split = SplitFileName(fileName);
+  _nodesFileName = split[0] + split[1] + "_nodes.tmp";
+  _elementsFileName = split[0] + split[1] + "_elements.tmp";
+  _nodes = Fopen(_nodesFileName.c_str(), "w+b");
+  _elements = Fopen(_elementsFileName.c_str(), "w+b");
+  if(!ok())
+    Msg::Error("Unable to open temporary files '%s' and '%s'",
+               _nodesFileName.c_str(), _elementsFileName.c_str());
+  else
+    Msg::Info("Streaming mesh to file '%s'", _fileName.c_str());
+}
+
+MSH4StreamWriter::~MSH4StreamWriter()
+{
+  if(_nodes) {
+    fclose(_nodes);
+    UnlinkFile(_nodesFileName);
+  }
+  if(_elements) {
+    fclose(_elements);
+    UnlinkFile(_elementsFileName);
+  }
+}
+
+void MSH4StreamWriter::write(GEntity *ge, bool deleteMesh)
+{
+  if(!ok() || written(ge)) return;
+  _written.insert(ge);
+
+  const double version = 4.1;
+  std::size_t numVerts = ge->getNumMeshVertices();
+  if(numVerts) {
+    for(std::size_t i = 0; i < numVerts; i++) {
+      std::size_t tag = ge->getMeshVertex(i)->getNum();
+      _minNodeTag = std::min(_minNodeTag, tag);
+      _maxNodeTag = std::max(_maxNodeTag, tag);
+    }
+    _numNodeBlocks++;
+    _numNodes += numVerts;
+    std::vector<msh4Chunk> chunks;
+    appendMSH4Nodes(ge, _binary, version, chunks);
+    writeMSH4Chunks(_nodes, chunks, _binary, 0, _scalingFactor, version);
+  }
+
+  if(_saveAll || _model->noPhysicalGroups() || ge->physicals.size()) {
+    std::map<int, std::vector<MElement *> > elementsByType;
+    for(std::size_t i = 0; i < ge->getNumMeshElements(); i++) {
+      MElement *e = ge->getMeshElement(i);
+      elementsByType[e->getTypeForMSH()].push_back(e);
+      _minElementTag = std::min(_minElementTag, e->getNum());
+      _maxElementTag = std::max(_maxElementTag, e->getNum());
+    }
+    std::vector<msh4Chunk> chunks;
+    for(auto it = elementsByType.begin(); it != elementsByType.end(); ++it) {
+      _numElementBlocks++;
+      _numElements += it->second.size();
+      appendMSH4Elements(it->second, ge->dim(), ge->tag(), it->first, chunks);
+    }
+    writeMSH4Chunks(_elements, chunks, _binary, 0, 1., version);
+  }
+
+  if(deleteMesh) ge->deleteMesh();
+}
+
+static bool copyFileContents(FILE *from, FILE *to)
+{
+  if(fflush(from) || fseek(from, 0, SEEK_SET)) return false;
+  std::vector<char> buf(1 << 20);
+  std::size_t n;
+  while((n = fread(&buf[0], 1, buf.size(), from)) > 0) {
+    if(fwrite(&buf[0], 1, n, to) != n) return false;
+  }
+  return !ferror(from);
+}
+
+bool MSH4StreamWriter::finalize()
+{
+  if(!ok()) return false;
+
+  std::vector<GEntity *> entities;
+  _model->getEntities(entities);
+  for(std::size_t i = 0; i < entities.size(); i++) write(entities[i], false);
+
+  FILE *fp = Fopen(_fileName.c_str(), _binary ? "wb" : "w");
+  if(!fp) {
+    Msg::Error("Unable to open file '%s'", _fileName.c_str());
+    return false;
+  }
+
+  const double version = 4.1;
+  writeMSH4Header(_model, fp, version, _binary);
+  writeMSH4Entities(_model, fp, false, _binary, _scalingFactor, version,
+                    nullptr);
+
+  bool ok = true;
+  if(_numNodes) {
+    fprintf(fp, "$Nodes\n");
+    if(_binary) {
+      fwrite(&_numNodeBlocks, sizeof(std::size_t), 1, fp);
+      fwrite(&_numNodes, sizeof(std::size_t), 1, fp);
+      fwrite(&_minNodeTag, sizeof(std::size_t), 1, fp);
+      fwrite(&_maxNodeTag, sizeof(std::size_t), 1, fp);
+    }
+    else {
+      fprintf(fp, "%lu %lu %lu %lu\n", _numNodeBlocks, _numNodes, _minNodeTag,
+              _maxNodeTag);
+    }
+    ok = copyFileContents(_nodes, fp);
+    if(_binary) fprintf(fp, "\n");
+    fprintf(fp, "$EndNodes\n");
+  }
+  if(_numElements) {
+    fprintf(fp, "$Elements\n");
+    if(_binary) {
+      fwrite(&_numElementBlocks, sizeof(std::size_t), 1, fp);
+      fwrite(&_numElements, sizeof(std::size_t), 1, fp);
+      fwrite(&_minElementTag, sizeof(std::size_t), 1, fp);
+      fwrite(&_maxElementTag, sizeof(std::size_t), 1, fp);
+    }
+    else {
+      fprintf(fp, "%lu %lu %lu %lu\n", _numElementBlocks, _numElements,
+              _minElementTag, _maxElementTag);
+    }
+    ok = copyFileContents(_elements, fp) && ok;
+    if(_binary) fprintf(fp, "\n");
+    fprintf(fp, "$EndElements\n");
+  }
+
+  writeMSH4PeriodicNodes(_model, fp, _binary, version);
+
+  if(fclose(fp)) ok = false;
+  if(!ok) Msg::Error("Could not write file '%s'", _fileName.c_str());
+  else
+    Msg::Info("Done streaming mesh to file '%s' (%lu nodes, %lu elements)",
+              _fileName.c_str(), _numNodes, _numElements);
+  return ok;
+}
+
+#if defined(HAVE_MPI)
+
+// Distributed reading of MSH4 files: each process reads a contiguous share of
+// the nodes and of the elements of the file (the node and element blocks being
+// split as needed), the nodes are scattered in a directory distributed by tag,
+// and the elements are redistributed according to the Hilbert index of their
+// barycenter, so that each process ends up with a compact part of the mesh.
+
+struct msh4DistributedNode {
+  std::size_t tag;
+  double xyz[3];
+  int entityDim, entityTag;
+};
+
+struct msh4HilbertSample {
+  uint64_t key;
+  double weight;
+};
+
+// Return the range [begin, end) of the items read by the current process
+static void getMSH4Share(std::size_t num, std::size_t &begin, std::size_t &end)
+{
+  const std::size_t rank = Msg::GetCommRank(), size = Msg::GetCommSize();
+  begin = (num * rank) / size;
+  end = (num * (rank + 1)) / size;
+}
+
+static bool allMSH4Ok(bool ok)
+{
+  int local = ok ? 1 : 0, global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  return global == 1;
+}
+
+// Send the items in send[p] to process p, and store the items received from
+// all the processes in recv, concatenated in the order of the processes. The
+// number of items received from each process is stored in counts, if given.
+// Since the counts and displacements of MPI_Alltoallv are int, the data is
+// exchanged in rounds of at most INT_MAX bytes.
+template <class T>
+static void exchangeMSH4Data(std::vector<std::vector<T> > &send,
+                             std::vector<T> &recv,
+                             std::vector<std::size_t> *counts = nullptr)
+{
+  const int size = Msg::GetCommSize();
+  std::vector<unsigned long long> sendNum(size), recvNum(size);
+  for(int p = 0; p < size; p++) sendNum[p] = send[p].size();
+  MPI_Alltoall(&sendNum[0], 1, MPI_UNSIGNED_LONG_LONG, &recvNum[0], 1,
+               MPI_UNSIGNED_LONG_LONG, MPI_COMM_WORLD);
+  std::vector<std::size_t> recvOffset(size + 1, 0);
+  unsigned long long maxNum = 0;
+  for(int p = 0; p < size; p++) {
+    recvOffset[p + 1] = recvOffset[p] + recvNum[p];
+    maxNum = std::max(maxNum, std::max(sendNum[p], recvNum[p]));
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &maxNum, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX,
+                MPI_COMM_WORLD);
+  recv.resize(recvOffset[size]);
+
+  // maximum number of items sent to each process in a round
+  const unsigned long long maxBytes = std::numeric_limits<int>::max();
+  const unsigned long long chunk =
+    std::max(1ULL, maxBytes / (size * sizeof(T)));
+  const unsigned long long numRounds = (maxNum + chunk - 1) / chunk;
+  std::vector<int> sendCounts(size), recvCounts(size);
+  std::vector<int> sendDispls(size), recvDispls(size);
+  std::vector<T> sendBuffer, recvBuffer;
+  for(unsigned long long r = 0; r < numRounds; r++) {
+    const unsigned long long first = r * chunk;
+    int sendTotal = 0, recvTotal = 0;
+    sendBuffer.clear();
+    for(int p = 0; p < size; p++) {
+      unsigned long long ns =
+        (sendNum[p] > first) ? std::min(chunk, sendNum[p] - first) : 0;
+      unsigned long long nr =
+        (recvNum[p] > first) ? std::min(chunk, recvNum[p] - first) : 0;
+      sendCounts[p] = ns * sizeof(T);
+      recvCounts[p] = nr * sizeof(T);
+      sendDispls[p] = sendTotal;
+      recvDispls[p] = recvTotal;
+      sendTotal += sendCounts[p];
+      recvTotal += recvCounts[p];
+      if(!ns) continue;
+      sendBuffer.insert(sendBuffer.end(), send[p].begin() + first,
+                        send[p].begin() + first + ns);
+      if(first + ns == sendNum[p]) std::vector<T>().swap(send[p]);
+    }
+    recvBuffer.resize(recvTotal / sizeof(T));
+    MPI_Alltoallv(sendBuffer.data(), &sendCounts[0], &sendDispls[0], MPI_BYTE,
+                  recvBuffer.data(), &recvCounts[0], &recvDispls[0], MPI_BYTE,
+                  MPI_COMM_WORLD);
+    for(int p = 0; p < size; p++) {
+      if(!recvCounts[p]) continue;
+      auto it = recvBuffer.begin() + recvDispls[p] / sizeof(T);
+      std::copy(it, it + recvCounts[p] / sizeof(T),
+                recv.begin() + recvOffset[p] + first);
+    }
+  }
+  if(counts) counts->assign(recvNum.begin(), recvNum.end());
+}
+
+// Position in the file with 64-bit offsets, as the binary sections of a large
+// mesh are well above 2 GB
+#if defined(WIN32)
+typedef __int64 msh4Offset;
+static msh4Offset tellMSH4(FILE *fp) { return _ftelli64(fp); }
+static int seekMSH4(FILE *fp, msh4Offset offset)
+{
+  return _fseeki64(fp, offset, SEEK_SET);
+}
+#else
+typedef off_t msh4Offset;
+static msh4Offset tellMSH4(FILE *fp) { return ftello(fp); }
+static int seekMSH4(FILE *fp, msh4Offset offset)
+{
+  return fseeko(fp, offset, SEEK_SET);
+}
+#endif
+
+static bool readMSH4Line(FILE *fp, std::vector<char> &line)
+{
+  if(!fgets(&line[0], line.size(), fp)) return false;
+  while(!strchr(&line[0], '\n') && !feof(fp)) {
+    std::size_t n = strlen(&line[0]);
+    line.resize(2 * line.size());
+    if(!fgets(&line[n], line.size() - n, fp)) break;
+  }
+  return true;
+}
+
+// Read the share of the nodes of the current process in the $Nodes section
+static bool readMSH4NodesShare(FILE *fp, bool binary, bool swap,
+                               std::vector<msh4DistributedNode> &nodes)
+{
+  std::vector<char> line(1024);
+  std::size_t numBlock = 0, totalNumNodes = 0, minTag = 0, maxTag = 0;
+  if(binary) {
+    std::size_t data[4];
+    if(fread(data, sizeof(std::size_t), 4, fp) != 4) return false;
+    if(swap) SwapBytes((char *)data, sizeof(std::size_t), 4);
+    numBlock = data[0];
+    totalNumNodes = data[1];
+  }
+  else {
+    if(!readMSH4Line(fp, line) ||
+       sscanf(&line[0], "%lu %lu %lu %lu", &numBlock, &totalNumNodes, &minTag,
+              &maxTag) != 4)
+      return false;
+  }
+
+  std::size_t begin, end, offset = 0;
+  getMSH4Share(totalNumNodes, begin, end);
+  nodes.reserve(end - begin);
+  Msg::Info("Reading nodes %lu to %lu (of %lu)", begin + 1, end,
+            totalNumNodes);
+
+  for(std::size_t i = 0; i < numBlock; i++) {
+    int entityDim = 0, entityTag = 0, parametric = 0;
+    std::size_t numNodes = 0;
+    if(binary) {
+      int data[3];
+      if(fread(data, sizeof(int), 3, fp) != 3) return false;
+      if(swap) SwapBytes((char *)data, sizeof(int), 3);
+      entityDim = data[0];
+      entityTag = data[1];
+      parametric = data[2];
+      if(fread(&numNodes, sizeof(std::size_t), 1, fp) != 1) return false;
+      if(swap) SwapBytes((char *)&numNodes, sizeof(std::size_t), 1);
+    }
+    else {
+      if(!readMSH4Line(fp, line) ||
+         sscanf(&line[0], "%d %d %d %lu", &entityDim, &entityTag, &parametric,
+                &numNodes) != 4)
+        return false;
+    }
+    const std::size_t n = parametric ? 3 + entityDim : 3;
+    const std::size_t lo = std::min(std::max(begin, offset), offset + numNodes);
+    const std::size_t hi = std::max(std::min(end, offset + numNodes), lo);
+    const std::size_t first = nodes.size();
+    nodes.resize(first + hi - lo);
+    for(std::size_t j = first; j < nodes.size(); j++) {
+      nodes[j].entityDim = entityDim;
+      nodes[j].entityTag = entityTag;
+    }
+    if(binary) {
+      // only read the tags and the coordinates in the share, and skip the rest
+      const msh4Offset tagsStart = tellMSH4(fp);
+      const msh4Offset coordStart =
+        tagsStart + numNodes * sizeof(std::size_t);
+      const msh4Offset blockEnd = coordStart + numNodes * n * sizeof(double);
+      if(hi > lo) {
+        std::vector<std::size_t> tags(hi - lo);
+        std::vector<double> coord((hi - lo) * n);
+        if(seekMSH4(fp, tagsStart + (lo - offset) * sizeof(std::size_t)) ||
+           fread(&tags[0], sizeof(std::size_t), tags.size(), fp) !=
+             tags.size())
+          return false;
+        if(seekMSH4(fp, coordStart + (lo - offset) * n * sizeof(double)) ||
+           fread(&coord[0], sizeof(double), coord.size(), fp) != coord.size())
+          return false;
+        if(swap) {
+          SwapBytes((char *)&tags[0], sizeof(std::size_t), tags.size());
+          SwapBytes((char *)&coord[0], sizeof(double), coord.size());
+        }
+        for(std::size_t j = 0; j < hi - lo; j++) {
+          nodes[first + j].tag = tags[j];
+          for(int k = 0; k < 3; k++) nodes[first + j].xyz[k] = coord[n * j + k];
+        }
+      }
+      if(seekMSH4(fp, blockEnd)) return false;
+    }
+    else {
+      for(std::size_t j = 0; j < numNodes; j++) {
+        if(!readMSH4Line(fp, line)) return false;
+        if(offset + j >= lo && offset + j < hi &&
+           sscanf(&line[0], "%lu", &nodes[first + offset + j - lo].tag) != 1)
+          return false;
+      }
+      for(std::size_t j = 0; j < numNodes; j++) {
+        if(!readMSH4Line(fp, line)) return false;
+        if(offset + j >= lo && offset + j < hi) {
+          double *xyz = nodes[first + offset + j - lo].xyz;
+          if(sscanf(&line[0], "%lf %lf %lf", &xyz[0], &xyz[1], &xyz[2]) != 3)
+            return false;
+        }
+      }
+    }
+    offset += numNodes;
+  }
+  return true;
+}
+
+// Read the share of the elements of the current process in the $Elements
+// section, stored as (tag, type, entity dimension, entity tag, node tags)
+static bool readMSH4ElementsShare(FILE *fp, bool binary, bool swap,
+                                  std::vector<std::size_t> &elements,
+                                  std::size_t &numElementsRead)
+{
+  std::vector<char> line(1024);
+  std::size_t numBlock = 0, totalNumElements = 0, minTag = 0, maxTag = 0;
+  if(binary) {
+    std::size_t data[4];
+    if(fread(data, sizeof(std::size_t), 4, fp) != 4) return false;
+    if(swap) SwapBytes((char *)data, sizeof(std::size_t), 4);
+    numBlock = data[0];
+    totalNumElements = data[1];
+  }
+  else {
+    if(!readMSH4Line(fp, line) ||
+       sscanf(&line[0], "%lu %lu %lu %lu", &numBlock, &totalNumElements,
+              &minTag, &maxTag) != 4)
+      return false;
+  }
+
+  std::size_t begin, end, offset = 0;
+  getMSH4Share(totalNumElements, begin, end);
+  numElementsRead = end - begin;
+  Msg::Info("Reading elements %lu to %lu (of %lu)", begin + 1, end,
+            totalNumElements);
+
+  for(std::size_t i = 0; i < numBlock; i++) {
+    int entityDim = 0, entityTag = 0, elmType = 0;
+    std::size_t numElements = 0;
+    if(binary) {
+      int data[3];
+      if(fread(data, sizeof(int), 3, fp) != 3) return false;
+      if(swap) SwapBytes((char *)data, sizeof(int), 3);
+      entityDim = data[0];
+      entityTag = data[1];
+      elmType = data[2];
+      if(fread(&numElements, sizeof(std::size_t), 1, fp) != 1) return false;
+      if(swap) SwapBytes((char *)&numElements, sizeof(std::size_t), 1);
+    }
+    else {
+      if(!readMSH4Line(fp, line) ||
+         sscanf(&line[0], "%d %d %d %lu", &entityDim, &entityTag, &elmType,
+                &numElements) != 4)
+        return false;
+    }
+    const std::size_t numVertPerElm = MElement::getInfoMSH(elmType);
+    if(!numVertPerElm) {
+      Msg::Error("Unsupported element type %d", elmType);
+      return false;
+    }
+    const std::size_t lo =
+      std::min(std::max(begin, offset), offset + numElements);
+    const std::size_t hi = std::max(std::min(end, offset + numElements), lo);
+    if(binary) {
+      const std::size_t n = 1 + numVertPerElm;
+      const msh4Offset blockStart = tellMSH4(fp);
+      const msh4Offset blockEnd =
+        blockStart + numElements * n * sizeof(std::size_t);
+      if(hi > lo) {
+        std::vector<std::size_t> data((hi - lo) * n);
+        if(seekMSH4(fp,
+                    blockStart + (lo - offset) * n * sizeof(std::size_t)) ||
+           fread(&data[0], sizeof(std::size_t), data.size(), fp) !=
+             data.size())
+          return false;
+        if(swap) SwapBytes((char *)&data[0], sizeof(std::size_t), data.size());
+        for(std::size_t j = 0; j < data.size(); j += n) {
+          elements.push_back(data[j]);
+          elements.push_back(elmType);
+          elements.push_back(entityDim);
+          elements.push_back(entityTag);
+          elements.insert(elements.end(), &data[j + 1], &data[j] + n);
+        }
+      }
+      if(seekMSH4(fp, blockEnd)) return false;
+    }
+    else {
+      for(std::size_t j = 0; j < numElements; j++) {
+        if(!readMSH4Line(fp, line)) return false;
+        if(offset + j < lo || offset + j >= hi) continue;
+        char *p = &line[0], *q;
+        const std::size_t elmTag = strtoul(p, &q, 10);
+        if(q == p) return false;
+        elements.push_back(elmTag);
+        elements.push_back(elmType);
+        elements.push_back(entityDim);
+        elements.push_back(entityTag);
+        for(std::size_t k = 0; k < numVertPerElm; k++) {
+          p = q;
+          elements.push_back(strtoul(p, &q, 10));
+          if(q == p) return false;
+        }
+      }
+    }
+    offset += numElements;
+  }
+  return true;
+}
+
+// Get the nodes with the given tags from the distributed node directory (the
+// node with tag t being stored on process t % size): directory[index[t]] is
+// the node with tag t if it is stored on the current process
+static bool fetchMSH4DistributedNodes(
+  const std::vector<msh4DistributedNode> &directory,
+  const std::unordered_map<std::size_t, std::size_t> &index,
+  const std::vector<std::size_t> &tags,
+  std::unordered_map<std::size_t, msh4DistributedNode> &nodes)
+{
+  const int size = Msg::GetCommSize();
+  std::vector<std::vector<std::size_t> > request(size);
+  for(std::size_t i = 0; i < tags.size(); i++)
+    request[tags[i] % size].push_back(tags[i]);
+  std::vector<std::size_t> requested;
+  std::vector<std::size_t> counts;
+  exchangeMSH4Data(request, requested, &counts);
+
+  bool ok = true;
+  std::vector<std::vector<msh4DistributedNode> > reply(size);
+  std::size_t k = 0;
+  for(int p = 0; p < size; p++) {
+    reply[p].reserve(counts[p]);
+    for(std::size_t i = 0; i < counts[p]; i++, k++) {
+      auto it = index.find(requested[k]);
+      if(it == index.end()) {
+        Msg::Error("Unknown node %lu", requested[k]);
+        ok = false;
+        msh4DistributedNode unknown = {requested[k], {0., 0., 0.}, -1, -1};
+        reply[p].push_back(unknown);
+      }
+      else
+        reply[p].push_back(directory[it->second]);
+    }
+  }
+  std::vector<msh4DistributedNode> replied;
+  exchangeMSH4Data(reply, replied);
+
+  nodes.reserve(replied.size());
+  for(std::size_t i = 0; i < replied.size(); i++)
+    nodes[replied[i].tag] = replied[i];
+  return ok;
+}
+
+static void getMSH4ElementNodeTags(const std::vector<std::size_t> &elements,
+                                   std::vector<std::size_t> &tags)
+{
+  tags.clear();
+  for(std::size_t i = 0; i < elements.size();) {
+    const std::size_t n = MElement::getInfoMSH(elements[i + 1]);
+    tags.insert(tags.end(), &elements[i + 4], &elements[i + 4] + n);
+    i += 4 + n;
+  }
+  std::sort(tags.begin(), tags.end());
+  tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+}
+
+// Index of the point (x, y, z) in [0, 1]^3 along a Hilbert curve with 21 bits
+// per coordinate (J. Skilling, "Programming the Hilbert curve", 2004)
+static uint64_t getMSH4HilbertKey(double x, double y, double z)
+{
+  const int bits = 21;
+  const uint32_t max = (1u << bits) - 1;
+  uint32_t X[3];
+  const double c[3] = {x, y, z};
+  for(int i = 0; i < 3; i++)
+    X[i] = (uint32_t)(std::min(std::max(c[i], 0.), 1.) * max);
+  for(uint32_t Q = 1u << (bits - 1); Q > 1; Q >>= 1) {
+    const uint32_t P = Q - 1;
+    for(int i = 0; i < 3; i++) {
+      if(X[i] & Q)
+        X[0] ^= P;
+      else {
+        const uint32_t t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  for(int i = 1; i < 3; i++) X[i] ^= X[i - 1];
+  uint32_t t = 0;
+  for(uint32_t Q = 1u << (bits - 1); Q > 1; Q >>= 1)
+    if(X[2] & Q) t ^= Q - 1;
+  for(int i = 0; i < 3; i++) X[i] ^= t;
+  uint64_t key = 0;
+  for(int b = bits - 1; b >= 0; b--)
+    for(int i = 0; i < 3; i++) key = (key << 1) | ((X[i] >> b) & 1);
+  return key;
+}
+
+// Compute the destination process of each element, by splitting the Hilbert
+// curve through the barycenters of all the elements in parts with the same
+// number of elements (using a weighted sample of the keys on each process)
+static void getMSH4Destinations(const std::vector<uint64_t> &keys,
+                                std::vector<int> &dest)
+{
+  const int size = Msg::GetCommSize();
+  std::vector<uint64_t> sorted(keys);
+  std::sort(sorted.begin(), sorted.end());
+  const std::size_t numSamples = std::min<std::size_t>(sorted.size(), 64);
+  std::vector<msh4HilbertSample> samples(numSamples);
+  for(std::size_t i = 0; i < numSamples; i++) {
+    samples[i].key = sorted[(i * sorted.size()) / numSamples];
+    samples[i].weight = (double)sorted.size() / numSamples;
+  }
+  int numBytes = numSamples * sizeof(msh4HilbertSample);
+  std::vector<int> counts(size), displs(size, 0);
+  MPI_Allgather(&numBytes, 1, MPI_INT, &counts[0], 1, MPI_INT, MPI_COMM_WORLD);
+  for(int p = 1; p < size; p++) displs[p] = displs[p - 1] + counts[p - 1];
+  std::vector<msh4HilbertSample> all((displs[size - 1] + counts[size - 1]) /
+                                     sizeof(msh4HilbertSample));
+  MPI_Allgatherv(samples.data(), numBytes, MPI_BYTE, all.data(), &counts[0],
+                 &displs[0], MPI_BYTE, MPI_COMM_WORLD);
+  std::sort(all.begin(), all.end(),
+            [](const msh4HilbertSample &a, const msh4HilbertSample &b) {
+              return a.key < b.key;
+            });
+  double total = 0.;
+  for(std::size_t i = 0; i < all.size(); i++) total += all[i].weight;
+  std::vector<uint64_t> splitters;
+  double sum = 0.;
+  for(std::size_t i = 0; i < all.size() && (int)splitters.size() < size - 1;
+      i++) {
+    sum += all[i].weight;
+    while((int)splitters.size() < size - 1 &&
+          sum >= total * (splitters.size() + 1) / size)
+      splitters.push_back(all[i].key);
+  }
+  dest.resize(keys.size());
+  for(std::size_t i = 0; i < keys.size(); i++)
+    dest[i] = std::upper_bound(splitters.begin(), splitters.end(), keys[i]) -
+              splitters.begin();
+}
+
+static GEntity *getOrCreateMSH4Entity(GModel *model, int dim, int tag)
+{
+  GEntity *entity = model->getEntityByTag(dim, tag);
+  if(entity) return entity;
+  switch(dim) {
+  case 0: {
+    GVertex *gv = new discreteVertex(model, tag);
+    model->add(gv);
+    return gv;
+  }
+  case 1: {
+    GEdge *ge = new discreteEdge(model, tag, nullptr, nullptr);
+    model->add(ge);
+    return ge;
+  }
+  case 2: {
+    GFace *gf = new discreteFace(model, tag);
+    model->add(gf);
+    return gf;
+  }
+  case 3: {
+    GRegion *gr = new discreteRegion(model, tag);
+    model->add(gr);
+    return gr;
+  }
+  default:
+    Msg::Error("Invalid dimension %d to create discrete entity", dim);
+    return nullptr;
+  }
+}
+
+#endif
+
+int GModel::readMSH4Distributed(const std::string &name)
+{
+#if defined(HAVE_MPI)
+  const int size = Msg::GetCommSize();
+  if(size == 1) return readMSH(name);
+
+  double t1 = Cpu(), w1 = TimeOfDay();
+
+  // each process reads the header, the physical names and the entities, and
+  // its share of the nodes and of the elements
+  std::vector<msh4DistributedNode> nodes;
+  std::vector<std::size_t> elements;
+  std::size_t numElementsRead = 0;
+  FILE *fp = Fopen(name.c_str(), "rb");
+  bool ok = (fp != nullptr);
+  if(!fp) Msg::Error("Unable to open file '%s'", name.c_str());
+
+  // the shares are read at given offsets in the file, which cannot be done in
+  // a compressed stream
+  unsigned char magic[4] = {0, 0, 0, 0};
+  if(ok && (fread(magic, 1, 4, fp) != 4 || seekMSH4(fp, 0))) {
+    Msg::Error("Could not read file '%s'", name.c_str());
+    ok = false;
+  }
+  const bool gzip = (magic[0] == 0x1f && magic[1] == 0x8b);
+  const bool zstd = (magic[0] == 0x28 && magic[1] == 0xb5 &&
+                     magic[2] == 0x2f && magic[3] == 0xfd);
+  if(ok && (gzip || zstd || IsCompressedFileName(name))) {
+    Msg::Error("Distributed reading of compressed MSH files is not "
+               "supported: uncompress '%s' first", name.c_str());
+    ok = false;
+  }
+
+  char str[1024] = "x";
+  double version = 1.0;
+  bool binary = false, swap = false;
+  while(ok) {
+    while(str[0] != '$') {
+      if(!fgets(str, sizeof(str), fp) || feof(fp)) break;
+    }
+    if(feof(fp)) break;
+
+    std::string sectionName(&str[1]);
+    std::string endSectionName = "End" + sectionName;
+
+    if(!strncmp(&str[1], "MeshFormat", 10)) {
+      int format;
+      std::size_t sizeofSizeT;
+      if(!fgets(str, sizeof(str), fp) ||
+         sscanf(str, "%lf %d %lu", &version, &format, &sizeofSizeT) != 3) {
+        ok = false;
+        break;
+      }
+      if(format) {
+        binary = true;
+        int one;
+        if(fread(&one, sizeof(int), 1, fp) != 1) {
+          ok = false;
+          break;
+        }
+        if(one != 1) swap = true;
+      }
+      if(version < 4.1 || (binary && sizeofSizeT != sizeof(std::size_t))) {
+        Msg::Error("Distributed reading requires a MSH 4.1 file (with "
+                   "sizeof(size_t) = %lu in binary mode)",
+                   (unsigned long)sizeof(std::size_t));
+        ok = false;
+      }
+    }
+    else if(!strncmp(&str[1], "PhysicalNames", 13)) {
+      int numPhysicalNames = 0;
+      if(!fgets(str, sizeof(str), fp) ||
+         sscanf(str, "%d", &numPhysicalNames) != 1) {
+        ok = false;
+        break;
+      }
+      std::vector<GModel::piter> iterators;
+      getInnerPhysicalNamesIterators(iterators);
+      for(int i = 0; i < numPhysicalNames; i++) {
+        int dim = 0, tag = 0;
+        char name[256];
+        if(fscanf(fp, "%d %d", &dim, &tag) != 2 ||
+           !fgets(name, sizeof(name), fp)) {
+          ok = false;
+          break;
+        }
+        std::string physicalName = ExtractDoubleQuotedString(name, 256);
+        if(physicalName.size())
+          iterators[dim] =
+            setPhysicalName(iterators[dim], physicalName, dim, tag);
+      }
+    }
+    else if(!strncmp(&str[1], "Entities", 8)) {
+      if(!readMSH4Entities(this, fp, false, binary, swap, version)) {
+        Msg::Error("Could not read entities");
+        ok = false;
+      }
+    }
+    else if(!strncmp(&str[1], "PartitionedEntities", 19)) {
+      Msg::Error("Distributed reading of partitioned MSH files is not "
+                 "supported");
+      ok = false;
+    }
+    else if(!strncmp(&str[1], "Nodes", 5)) {
+      if(!readMSH4NodesShare(fp, binary, swap, nodes)) {
+        Msg::Error("Could not read nodes");
+        ok = false;
+      }
+    }
+    else if(!strncmp(&str[1], "Elements", 8)) {
+      if(!readMSH4ElementsShare(fp, binary, swap, elements, numElementsRead)) {
+        Msg::Error("Could not read elements");
+        ok = false;
+      }
+    }
+    else if(strlen(&str[1]) > 0) {
+      sectionName.pop_back();
+      Msg::Info("Ignoring section $%s in distributed reading",
+                sectionName.c_str());
+    }
+
+    while(ok && strncmp(&str[1], endSectionName.c_str(),
+                        endSectionName.size())) {
+      if(!fgets(str, sizeof(str), fp) || feof(fp)) { break; }
+    }
+    str[0] = 'a';
+  }
+  if(fp) fclose(fp);
+  if(!allMSH4Ok(ok)) return 0;
+
+  // scatter the nodes in the distributed directory
+  std::vector<msh4DistributedNode> directory;
+  {
+    std::vector<std::vector<msh4DistributedNode> > send(size);
+    for(std::size_t i = 0; i < nodes.size(); i++)
+      send[nodes[i].tag % size].push_back(nodes[i]);
+    std::vector<msh4DistributedNode>().swap(nodes);
+    exchangeMSH4Data(send, directory);
+  }
+  std::unordered_map<std::size_t, std::size_t> index;
+  index.reserve(directory.size());
+  for(std::size_t i = 0; i < directory.size(); i++)
+    index[directory[i].tag] = i;
+
+  // compute the Hilbert index of the barycenter of the elements that were read
+  std::vector<uint64_t> keys;
+  keys.reserve(numElementsRead);
+  {
+    std::vector<std::size_t> tags;
+    getMSH4ElementNodeTags(elements, tags);
+    std::unordered_map<std::size_t, msh4DistributedNode> elementNodes;
+    ok = fetchMSH4DistributedNodes(directory, index, tags, elementNodes);
+    std::vector<SPoint3> barycenters;
+    barycenters.reserve(numElementsRead);
+    SBoundingBox3d bbox;
+    for(std::size_t i = 0; i < elements.size();) {
+      const std::size_t n = MElement::getInfoMSH(elements[i + 1]);
+      SPoint3 b(0., 0., 0.);
+      for(std::size_t j = 0; j < n; j++) {
+        const double *xyz = elementNodes[elements[i + 4 + j]].xyz;
+        b += SPoint3(xyz[0] / n, xyz[1] / n, xyz[2] / n);
+      }
+      barycenters.push_back(b);
+      bbox += b;
+      i += 4 + n;
+    }
+    if(!allMSH4Ok(ok)) return 0;
+    double bmin[3] = {std::numeric_limits<double>::max(),
+                      std::numeric_limits<double>::max(),
+                      std::numeric_limits<double>::max()};
+    double bmax[3] = {-bmin[0], -bmin[1], -bmin[2]};
+    if(!bbox.empty()) {
+      for(int k = 0; k < 3; k++) {
+        bmin[k] = bbox.min()[k];
+        bmax[k] = bbox.max()[k];
+      }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, bmin, 3, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, bmax, 3, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    for(std::size_t i = 0; i < barycenters.size(); i++) {
+      double c[3];
+      for(int k = 0; k < 3; k++)
+        c[k] = (bmax[k] > bmin[k]) ?
+                 (barycenters[i][k] - bmin[k]) / (bmax[k] - bmin[k]) :
+                 0.;
+      keys.push_back(getMSH4HilbertKey(c[0], c[1], c[2]));
+    }
+  }
+
+  // send the elements to their destination
+  std::vector<int> dest;
+  getMSH4Destinations(keys, dest);
+  {
+    std::vector<std::vector<std::size_t> > send(size);
+    std::size_t e = 0;
+    for(std::size_t i = 0; i < elements.size(); e++) {
+      const std::size_t n = 4 + MElement::getInfoMSH(elements[i + 1]);
+      send[dest[e]].insert(send[dest[e]].end(), &elements[i],
+                           &elements[i] + n);
+      i += n;
+    }
+    std::vector<std::size_t>().swap(elements);
+    exchangeMSH4Data(send, elements);
+  }
+
+  // get the nodes of the received elements, and create the local mesh
+  std::vector<std::size_t> tags;
+  getMSH4ElementNodeTags(elements, tags);
+  std::unordered_map<std::size_t, msh4DistributedNode> localNodes;
+  ok = fetchMSH4DistributedNodes(directory, index, tags, localNodes);
+  std::vector<msh4DistributedNode>().swap(directory);
+  if(!allMSH4Ok(ok)) return 0;
+
+  std::unordered_map<std::size_t, MVertex *> vertices;
+  vertices.reserve(tags.size());
+  for(std::size_t i = 0; i < tags.size() && ok; i++) {
+    const msh4DistributedNode &node = localNodes[tags[i]];
+    GEntity *entity =
+      getOrCreateMSH4Entity(this, node.entityDim, node.entityTag);
+    if(!entity) {
+      ok = false;
+      break;
+    }
+    MVertex *v =
+      new MVertex(node.xyz[0], node.xyz[1], node.xyz[2], entity, node.tag);
+    entity->addMeshVertex(v);
+    vertices[node.tag] = v;
+  }
+
+  std::size_t numElements = 0;
+  MElementFactory elementFactory;
+  std::vector<MVertex *> elementVertices;
+  for(std::size_t i = 0; i < elements.size() && ok; numElements++) {
+    const int type = elements[i + 1];
+    const std::size_t n = MElement::getInfoMSH(type);
+    GEntity *entity =
+      getOrCreateMSH4Entity(this, elements[i + 2], elements[i + 3]);
+    elementVertices.resize(n);
+    for(std::size_t j = 0; j < n; j++)
+      elementVertices[j] = vertices[elements[i + 4 + j]];
+    MElement *element = entity ? elementFactory.create(
+                                   type, elementVertices, elements[i], 0,
+                                   false, 0, nullptr, nullptr, nullptr) :
+                                 nullptr;
+    if(!element) {
+      Msg::Error("Could not create element %lu of type %d", elements[i],
+                 type);
+      ok = false;
+      break;
+    }
+    entity->addElement(element);
+    i += 4 + n;
+  }
+  if(!allMSH4Ok(ok)) return 0;
+
+  double t2 = Cpu(), w2 = TimeOfDay();
+  Msg::Info("Done reading '%s' in parallel: %lu nodes, %lu elements on "
+            "this process (Wall %gs, CPU %gs)",
+            name.c_str(), tags.size(), numElements, w2 - w1, t2 - t1);
+  return 1;
+#else
+  return readMSH(name);
+#endif
+}
+
 static bool getPhyscialNameInfo(const std::string &name, int &parentPhysicalTag,
                                 std::vector<int> &partitions)
 {
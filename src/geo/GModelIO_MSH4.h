@@ -0,0 +1,48 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef GMODELIO_MSH4_H
+#define GMODELIO_MSH4_H
+
+#include <string>
+#include <set>
+#include <stdio.h>
+
+class GModel;
+class GEntity;
+
+// Streaming MSH4 (version 4.1) writer: the mesh of each entity can be written
+// as soon as it is generated, and then deleted, so that the complete mesh
+// never needs to be stored in memory. Since the node and element sections
+// need their total sizes in their header, the node and element blocks are
+// spilled in two temporary files next to the output file, and the output file
+// is assembled by finalize().
+class MSH4StreamWriter {
+private:
+  GModel *_model;
+  std::string _fileName, _nodesFileName, _elementsFileName;
+  FILE *_nodes, *_elements;
+  bool _binary, _saveAll;
+  double _scalingFactor;
+  std::size_t _numNodeBlocks, _numNodes, _minNodeTag, _maxNodeTag;
+  std::size_t _numElementBlocks, _numElements, _minElementTag, _maxElementTag;
+  std::set<GEntity *> _written;
+
+public:
+  MSH4StreamWriter(GModel *model, const std::string &fileName, bool binary,
+                   bool saveAll, double scalingFactor);
+  ~MSH4StreamWriter();
+  bool ok() const { return _nodes && _elements; }
+  // check if the mesh of the entity has already been written
+  bool written(GEntity *ge) const { return _written.count(ge) != 0; }
+  // write the nodes and the elements of the entity, and optionally delete its
+  // mesh
+  void write(GEntity *ge, bool deleteMesh = true);
+  // write the mesh of all the entities that have not been written yet (without
+  // deleting it), and assemble the output file
+  bool finalize();
+};
+
+#endif
@@ -3,6 +3,7 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include <numeric>
 #include <utility>
 #include "GmshConfig.h"
@@ -3809,6 +3810,155 @@ static void _printBooleanWarnings(T &algo, const std::string &what)
 #endif
 }
 
+// Compute boolean fragments independently on clusters of arguments whose
+// (slightly enlarged) bounding boxes overlap: arguments in different clusters
+// cannot intersect, so the fragments of each cluster can be computed
+// concurrently, and the result is the compound of the results of all the
+// clusters. This avoids the cost of the global intersection of all the
+// arguments for large assemblies of disjoint parts.
+static bool _booleanFragmentsByClusters(
+  const TopTools_ListOfShape &shapes, TopoDS_Shape &result,
+  std::vector<TopoDS_Shape> &mapOriginal,
+  std::vector<TopTools_ListOfShape> &mapModified,
+  std::vector<TopTools_ListOfShape> &mapGenerated,
+  std::vector<bool> &mapDeleted)
+{
+  std::vector<TopoDS_Shape> args;
+  TopTools_ListIteratorOfListOfShape it(shapes);
+  for(; it.More(); it.Next()) args.push_back(it.Value());
+  std::size_t n = args.size();
+
+  double tol = CTX::instance()->geom.tolerance;
+  if(CTX::instance()->geom.toleranceBoolean > 0.0)
+    tol += CTX::instance()->geom.toleranceBoolean;
+  std::vector<Bnd_Box> boxes(n);
+  std::vector<double> xmin(n, 0.), xmax(n, 0.);
+  std::vector<std::size_t> sorted;
+  for(std::size_t i = 0; i < n; i++) {
+    BRepBndLib::Add(args[i], boxes[i]);
+    if(boxes[i].IsVoid()) continue;
+    boxes[i].Enlarge(tol);
+    double ymin, zmin, ymax, zmax;
+    boxes[i].Get(xmin[i], ymin, zmin, xmax[i], ymax, zmax);
+    sorted.push_back(i);
+  }
+
+  // union-find of the arguments with overlapping boxes, using a sweep along x
+  std::vector<std::size_t> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto root = [&parent](std::size_t i) {
+    while(parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+  };
+  std::sort(sorted.begin(), sorted.end(),
+            [&xmin](std::size_t a, std::size_t b) { return xmin[a] < xmin[b]; });
+  for(std::size_t a = 0; a < sorted.size(); a++) {
+    std::size_t i = sorted[a];
+    for(std::size_t b = a + 1; b < sorted.size(); b++) {
+      std::size_t j = sorted[b];
+      if(xmin[j] > xmax[i]) break;
+      if(!boxes[i].IsOut(boxes[j])) parent[root(i)] = root(j);
+    }
+  }
+  std::vector<std::vector<std::size_t>> clusters;
+  std::map<std::size_t, std::size_t> clusterIndex;
+  for(std::size_t i = 0; i < n; i++) {
+    std::size_t r = root(i);
+    auto ci = clusterIndex.find(r);
+    if(ci == clusterIndex.end()) {
+      clusterIndex[r] = clusters.size();
+      clusters.push_back(std::vector<std::size_t>(1, i));
+    }
+    else {
+      clusters[ci->second].push_back(i);
+    }
+  }
+  Msg::Info("Computing boolean fragments on %lu independent cluster%s",
+            clusters.size(), clusters.size() > 1 ? "s" : "");
+
+  std::vector<TopoDS_Shape> clusterResults(clusters.size());
+  std::vector<TopTools_ListOfShape> modified(n), generated(n);
+  std::vector<char> deleted(n, 0); // not vector<bool>: written concurrently
+  std::vector<std::string> errors(clusters.size()), warnings(clusters.size());
+  int numStarted = 0;
+  Msg::StartProgressMeter(clusters.size());
+#pragma omp parallel for schedule(dynamic)
+  for(int c = 0; c < (int)clusters.size(); c++) {
+    int started;
+#pragma omp atomic capture
+    started = numStarted++;
+    Msg::ProgressMeter(started, false, "Fragments...");
+    const std::vector<std::size_t> &cluster = clusters[c];
+    if(cluster.size() == 1) { // nothing to intersect with
+      clusterResults[c] = args[cluster[0]];
+      continue;
+    }
+    try {
+      BRepAlgoAPI_BuilderAlgo fragments;
+      TopTools_ListOfShape clusterShapes;
+      for(auto i : cluster) clusterShapes.Append(args[i]);
+      fragments.SetArguments(clusterShapes);
+      _setBooleanOptions(fragments);
+      fragments.Build();
+      if(!fragments.IsDone()) {
+        std::ostringstream os;
+#if OCC_VERSION_HEX >= 0x070200
+        fragments.DumpErrors(os);
+#endif
+        errors[c] = ReplaceSubString("\n", " ", os.str());
+        if(errors[c].empty()) errors[c] = "unknown error";
+        continue;
+      }
+#if OCC_VERSION_HEX >= 0x070200
+      // the warnings are printed after the loop, in the order of the clusters
+      if(fragments.HasWarnings()) {
+        std::ostringstream os;
+        fragments.DumpWarnings(os);
+        warnings[c] = ReplaceSubString("\n", " ", os.str());
+      }
+#endif
+#if OCC_VERSION_HEX >= 0x070400
+      if(CTX::instance()->geom.occBooleanSimplify >= 2)
+        fragments.SimplifyResult();
+#endif
+      clusterResults[c] = fragments.Shape();
+      for(auto i : cluster) {
+        modified[i] = fragments.Modified(args[i]);
+        deleted[i] = fragments.IsDeleted(args[i]);
+        generated[i] = fragments.Generated(args[i]);
+      }
+    } catch(Standard_Failure &err) {
+      errors[c] = err.GetMessageString();
+    }
+  }
+  Msg::StopProgressMeter();
+
+  bool ok = true;
+  for(std::size_t c = 0; c < clusters.size(); c++) {
+    if(warnings[c].size())
+      Msg::Warning("Fragments of cluster %lu - %s", c, warnings[c].c_str());
+    if(errors[c].size()) {
+      Msg::Error("Fragments of cluster %lu failed - %s", c, errors[c].c_str());
+      ok = false;
+    }
+  }
+  if(!ok) return false;
+
+  BRep_Builder b;
+  TopoDS_Compound compound;
+  b.MakeCompound(compound);
+  for(std::size_t c = 0; c < clusters.size(); c++)
+    b.Add(compound, clusterResults[c]);
+  result = compound;
+  for(std::size_t i = 0; i < n; i++) {
+    mapOriginal.push_back(args[i]);
+    mapModified.push_back(modified[i]);
+    mapDeleted.push_back(deleted[i]);
+    mapGenerated.push_back(generated[i]);
+  }
+  return true;
+}
+
 bool OCC_Internals::booleanOperator(
   int tag, BooleanOperator op,
   const std::vector<std::pair<int, int>> &objectDimTags,
@@ -3976,9 +4126,15 @@ bool OCC_Internals::booleanOperator(
 
     case OCC_Internals::Fragments:
     default: {
-      BRepAlgoAPI_BuilderAlgo fragments;
       objectShapes.Append(toolShapes);
       toolShapes.Clear();
+      if(CTX::instance()->geom.occBooleanClusters && objectShapes.Extent() > 2) {
+        if(!_booleanFragmentsByClusters(objectShapes, result, mapOriginal,
+                                        mapModified, mapGenerated, mapDeleted))
+          return false;
+        break;
+      }
+      BRepAlgoAPI_BuilderAlgo fragments;
       fragments.SetArguments(objectShapes);
       _setBooleanOptions(fragments);
 #if OCC_VERSION_HEX >= 0x070700
@@ -82,6 +82,20 @@ addTriangle(MTriangle *t,
   }
 }
 
+// number of threads for the per-surface stages of the classification and
+// parametrization
+static int getNumThreads()
+{
+#if defined(HAVE_PETSC)
+  // PETSc solvers are not thread-safe
+  return 1;
+#else
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  return nthreads;
+#endif
+}
+
 static bool breakForLargeAngle(MVertex *vprev, MVertex *vmid, MVertex *vpos,
                                double threshold)
 {
@@ -432,11 +446,19 @@ void classifyFaces(GModel *gm, double angleThreshold, bool includeBoundary,
     }
   }
 
+  double w = TimeOfDay();
   computeDiscreteCurvatures(gm);
-  if(forParametrization)
+  Msg::Info("Done computing discrete curvatures (Wall %gs)", TimeOfDay() - w);
+  if(forParametrization) {
+    w = TimeOfDay();
     computeEdgeCut(gm, edge->lines, CTX::instance()->mesh.reparamMaxTriangles);
+    Msg::Info("Done splitting triangulations (Wall %gs)", TimeOfDay() - w);
+  }
+  w = TimeOfDay();
   computeNonManifoldEdges(gm, edge->lines, true);
   classifyFaces(gm, curveAngleThreshold);
+  Msg::Info("Done creating model curves and surfaces (Wall %gs)",
+            TimeOfDay() - w);
 
   gm->remove(edge);
   edge->lines.clear();
@@ -463,31 +485,37 @@ int computeDiscreteCurvatures(GModel *gm)
 {
   std::map<MVertex *, std::pair<SVector3, SVector3> > &C = gm->getCurvatures();
   C.clear();
-  for(auto it = gm->firstFace(); it != gm->lastFace(); ++it) {
-    GFace *gf = *it;
+  std::vector<GFace *> faces(gm->firstFace(), gm->lastFace());
+  std::vector<std::vector<MVertex *> > nodes(faces.size());
+  std::vector<std::vector<std::pair<SVector3, SVector3> > > curv(faces.size());
+#pragma omp parallel for schedule(dynamic) num_threads(getNumThreads())
+  for(std::size_t f = 0; f < faces.size(); f++) {
+    GFace *gf = faces[f];
     std::map<MVertex *, int> nodeIndex;
-    std::vector<SPoint3> nodes;
+    std::vector<SPoint3> points;
     std::vector<int> tris;
-    std::vector<std::pair<SVector3, SVector3> > curv;
     for(std::size_t i = 0; i < gf->triangles.size(); i++) {
       MTriangle *t = gf->triangles[i];
       for(int j = 0; j < 3; j++) {
         MVertex *v = t->getVertex(j);
-        if(nodeIndex.find(v) == nodeIndex.end()) {
-          int idx = nodes.size();
+        auto it = nodeIndex.find(v);
+        if(it == nodeIndex.end()) {
+          int idx = points.size();
           nodeIndex[v] = idx;
-          nodes.push_back(v->point());
+          nodes[f].push_back(v);
+          points.push_back(v->point());
           tris.push_back(idx);
         }
         else {
-          tris.push_back(nodeIndex[v]);
+          tris.push_back(it->second);
         }
       }
     }
-    CurvatureRusinkiewicz(tris, nodes, curv);
-    for(auto itv = nodeIndex.begin(); itv != nodeIndex.end(); itv++) {
-      C[itv->first] = curv[itv->second];
-    }
+    CurvatureRusinkiewicz(tris, points, curv[f]);
+  }
+  for(std::size_t f = 0; f < faces.size(); f++) {
+    for(std::size_t i = 0; i < nodes[f].size() && i < curv[f].size(); i++)
+      C[nodes[f][i]] = curv[f][i];
   }
   return 0;
 }
@@ -849,99 +877,115 @@ makePartitionSimplyConnected(std::vector<MTriangle *> &t,
   return true;
 }
 
-void computeEdgeCut(GModel *gm, std::vector<MLine *> &cut,
-                    int max_elems_per_cut)
+static void computeEdgeCut(GFace *gf, std::vector<MLine *> &cut,
+                           int max_elems_per_cut)
 {
-  Msg::Info("Splitting triangulations to make them parametrizable:");
-
-  for(auto it = gm->firstFace(); it != gm->lastFace(); ++it) {
-    int part = 0;
-    if((*it)->triangles.empty()) continue;
-    std::vector<MVertex *> verts = (*it)->mesh_vertices;
-    std::map<MTriangle *, int, MElementPtrLessThan> global;
-    std::map<MEdge, int, MEdgeLessThan> cuts;
-    std::stack<std::vector<MTriangle *> > partitions;
-    std::stack<int> _levels;
-    partitions.push((*it)->triangles);
-    _levels.push(0);
-    (*it)->triangles.clear();
-
-    while(!partitions.empty()) {
-      int level = _levels.top();
-      _levels.pop();
-      (*it)->triangles = partitions.top();
-      (*it)->mesh_vertices.clear();
-      std::set<MVertex *, MVertexPtrLessThan> vs;
-      for(std::size_t i = 0; i < (*it)->triangles.size(); ++i) {
-        for(std::size_t j = 0; j < 3; ++j)
-          vs.insert((*it)->triangles[i]->getVertex(j));
-      }
-      (*it)->mesh_vertices.insert((*it)->mesh_vertices.begin(), vs.begin(),
-                                  vs.end());
-      partitions.pop();
-      std::ostringstream why;
-      int np =
-        isTriangulationParametrizable((*it)->triangles, max_elems_per_cut, why);
-      if(np > 1) {
-        Msg::Info(" - Level %d partition with %d triangles split in %d "
-                  "parts because %s",
-                  level, (*it)->triangles.size(), np, why.str().c_str());
-      }
-      else if(np < 0) {
-        Msg::Error("Could not create parametrization (check orientation of "
-                   "input triangulations)");
-        break;
-      }
-      if(np == 1) {
-        for(std::size_t i = 0; i < (*it)->triangles.size(); i++)
-          global[(*it)->triangles[i]] = part;
-        part++;
-      }
-      else {
+  int part = 0;
+  if(gf->triangles.empty()) return;
+  std::vector<MVertex *> verts = gf->mesh_vertices;
+  std::map<MTriangle *, int, MElementPtrLessThan> global;
+  std::map<MEdge, int, MEdgeLessThan> cuts;
+  std::stack<std::vector<MTriangle *> > partitions;
+  std::stack<int> _levels;
+  partitions.push(gf->triangles);
+  _levels.push(0);
+  gf->triangles.clear();
+
+  while(!partitions.empty()) {
+    int level = _levels.top();
+    _levels.pop();
+    gf->triangles = partitions.top();
+    gf->mesh_vertices.clear();
+    std::set<MVertex *, MVertexPtrLessThan> vs;
+    for(std::size_t i = 0; i < gf->triangles.size(); ++i) {
+      for(std::size_t j = 0; j < 3; ++j)
+        vs.insert(gf->triangles[i]->getVertex(j));
+    }
+    gf->mesh_vertices.insert(gf->mesh_vertices.begin(), vs.begin(),
+                             vs.end());
+    partitions.pop();
+    std::ostringstream why;
+    int np =
+      isTriangulationParametrizable(gf->triangles, max_elems_per_cut, why);
+    if(np > 1) {
+      Msg::Info(" - Level %d partition with %d triangles split in %d "
+                "parts because %s",
+                level, gf->triangles.size(), np, why.str().c_str());
+    }
+    else if(np < 0) {
+      Msg::Error("Could not create parametrization (check orientation of "
+                 "input triangulations)");
+      break;
+    }
+    if(np == 1) {
+      for(std::size_t i = 0; i < gf->triangles.size(); i++)
+        global[gf->triangles[i]] = part;
+      part++;
+    }
+    else {
 #if defined(HAVE_MESH)
-        if(!PartitionFaceMinEdgeLength(*it, np)) {
-          std::vector<std::vector<MTriangle *> > t(np);
-          for(std::size_t i = 0; i < (*it)->triangles.size(); i++) {
-            int p = (*it)->triangles[i]->getPartition();
-            if(p >= 0 && p < np)
-              t[p].push_back((*it)->triangles[i]);
-            else
-              Msg::Error("Invalid partition index");
+      int err;
+      // METIS is not thread-safe (the random number generator of GKlib is a
+      // global, reseeded at each call)
+#pragma omp critical(metis)
+      err = PartitionFaceMinEdgeLength(gf, np);
+      if(!err) {
+        std::vector<std::vector<MTriangle *> > t(np);
+        for(std::size_t i = 0; i < gf->triangles.size(); i++) {
+          int p = gf->triangles[i]->getPartition();
+          if(p >= 0 && p < np)
+            t[p].push_back(gf->triangles[i]);
+          else
+            Msg::Error("Invalid partition index");
+        }
+        for(std::size_t i = 0; i < t.size(); i++) {
+          std::vector<std::vector<MTriangle *> > ts;
+          if(!makePartitionSimplyConnected(t[i], ts)) {
+            Msg::Warning("Could not make partition simply connected");
+            break;
           }
-          for(std::size_t i = 0; i < t.size(); i++) {
-            std::vector<std::vector<MTriangle *> > ts;
-            if(!makePartitionSimplyConnected(t[i], ts)) {
-              Msg::Warning("Could not make partition simply connected");
-              break;
-            }
-            for(std::size_t j = 0; j < ts.size(); j++) {
-              _levels.push(level + 1);
-              partitions.push(ts[j]);
-            }
+          for(std::size_t j = 0; j < ts.size(); j++) {
+            _levels.push(level + 1);
+            partitions.push(ts[j]);
           }
         }
+      }
 #else
-        Msg::Error("Partitioning surface requires Mesh module");
+      Msg::Error("Partitioning surface requires Mesh module");
 #endif
-      }
     }
-    (*it)->triangles.clear();
-    for(auto it2 = global.begin(); it2 != global.end(); ++it2) {
-      MTriangle *t = it2->first;
-      (*it)->triangles.push_back(t);
-      for(int i = 0; i < 3; i++) {
-        MEdge ed = t->getEdge(i);
-        auto it3 = cuts.find(ed);
-        if(it3 == cuts.end())
-          cuts[ed] = it2->second;
-        else {
-          if(it3->second != it2->second)
-            cut.push_back(new MLine(ed.getVertex(0), ed.getVertex(1)));
-        }
+  }
+  gf->triangles.clear();
+  for(auto it2 = global.begin(); it2 != global.end(); ++it2) {
+    MTriangle *t = it2->first;
+    gf->triangles.push_back(t);
+    for(int i = 0; i < 3; i++) {
+      MEdge ed = t->getEdge(i);
+      auto it3 = cuts.find(ed);
+      if(it3 == cuts.end())
+        cuts[ed] = it2->second;
+      else {
+        if(it3->second != it2->second)
+          cut.push_back(new MLine(ed.getVertex(0), ed.getVertex(1)));
       }
     }
-    (*it)->mesh_vertices = verts;
   }
+  gf->mesh_vertices = verts;
+}
+
+void computeEdgeCut(GModel *gm, std::vector<MLine *> &cut,
+                    int max_elems_per_cut)
+{
+  Msg::Info("Splitting triangulations to make them parametrizable:");
+
+  // surfaces are split independently
+  std::vector<GFace *> faces(gm->firstFace(), gm->lastFace());
+  std::vector<std::vector<MLine *> > cuts(faces.size());
+#pragma omp parallel for schedule(dynamic) num_threads(getNumThreads())
+  for(std::size_t i = 0; i < faces.size(); i++)
+    computeEdgeCut(faces[i], cuts[i], max_elems_per_cut);
+  for(std::size_t i = 0; i < cuts.size(); i++)
+    cut.insert(cut.end(), cuts[i].begin(), cuts[i].end());
   makeMLinesUnique(cut);
 }
 
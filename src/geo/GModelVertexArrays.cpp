@@ -3,6 +3,7 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include <cmath>
 #include "GmshMessage.h"
 #include "GmshDefines.h"
@@ -190,79 +191,113 @@ static void addSmoothNormals(GEntity *e, std::vector<T *> &elements)
   }
 }
 
-template <class T>
-static void addElementsInArrays(GEntity *e, std::vector<T *> &elements,
-                                bool edges, bool faces)
+static void addElementInArrays(GEntity *e, MElement *ele, bool edges,
+                               bool faces, VertexArray *va_lines,
+                               VertexArray *va_triangles)
 {
-  int nthreads = CTX::instance()->numThreads;
-  if(!nthreads) nthreads = Msg::GetMaxThreads();
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-  for(std::size_t i = 0; i < elements.size(); i++) {
-    MElement *ele = elements[i];
-
-    if(!isElementVisible(ele) || ele->getDim() < 1) continue;
-
-    unsigned int c = getColorByElement(ele);
-    unsigned int col[4] = {c, c, c, c};
-
-    const bool curved =
-      (ele->getPolynomialOrder() > 1) &&
-      (ele->maxDistToStraight() > curvedRepTol * ele->getInnerRadius());
-
-    SPoint3 pc(0., 0., 0.);
-    if(CTX::instance()->mesh.explode != 1.) pc = ele->barycenter();
-
-    if(edges) {
-      bool unique = e->dim() > 1 && !CTX::instance()->pickElements;
-      for(int j = 0; j < ele->getNumEdgesRep(curved); j++) {
-        double x[2], y[2], z[2];
-        SVector3 n[2];
-        ele->getEdgeRep(curved, j, x, y, z, n);
-        if(CTX::instance()->mesh.explode != 1.) {
-          for(int k = 0; k < 2; k++) {
-            x[k] = pc[0] + CTX::instance()->mesh.explode * (x[k] - pc[0]);
-            y[k] = pc[1] + CTX::instance()->mesh.explode * (y[k] - pc[1]);
-            z[k] = pc[2] + CTX::instance()->mesh.explode * (z[k] - pc[2]);
-          }
-        }
-        if(e->dim() == 2 && CTX::instance()->mesh.smoothNormals)
-          for(int k = 0; k < 2; k++)
-            e->model()->normals->get(x[k], y[k], z[k], n[k][0], n[k][1],
-                                     n[k][2]);
-#pragma omp critical(addElementsInArrays1)
-        {
-          e->va_lines->add(x, y, z, n, col, ele, unique);
+  if(!isElementVisible(ele) || ele->getDim() < 1) return;
+
+  unsigned int c = getColorByElement(ele);
+  unsigned int col[4] = {c, c, c, c};
+
+  const bool curved =
+    (ele->getPolynomialOrder() > 1) &&
+    (ele->maxDistToStraight() > curvedRepTol * ele->getInnerRadius());
+
+  SPoint3 pc(0., 0., 0.);
+  if(CTX::instance()->mesh.explode != 1.) pc = ele->barycenter();
+
+  if(edges) {
+    bool unique = e->dim() > 1 && !CTX::instance()->pickElements;
+    for(int j = 0; j < ele->getNumEdgesRep(curved); j++) {
+      double x[2], y[2], z[2];
+      SVector3 n[2];
+      ele->getEdgeRep(curved, j, x, y, z, n);
+      if(CTX::instance()->mesh.explode != 1.) {
+        for(int k = 0; k < 2; k++) {
+          x[k] = pc[0] + CTX::instance()->mesh.explode * (x[k] - pc[0]);
+          y[k] = pc[1] + CTX::instance()->mesh.explode * (y[k] - pc[1]);
+          z[k] = pc[2] + CTX::instance()->mesh.explode * (z[k] - pc[2]);
         }
       }
+      if(e->dim() == 2 && CTX::instance()->mesh.smoothNormals)
+        for(int k = 0; k < 2; k++)
+          e->model()->normals->get(x[k], y[k], z[k], n[k][0], n[k][1],
+                                   n[k][2]);
+      va_lines->add(x, y, z, n, col, ele, unique);
     }
+  }
 
-    if(faces) {
-      bool unique = e->dim() > 2 && !CTX::instance()->pickElements;
-      bool skin = e->dim() > 2 && CTX::instance()->mesh.drawSkinOnly;
-      for(int j = 0; j < ele->getNumFacesRep(curved); j++) {
-        double x[3], y[3], z[3];
-        SVector3 n[3];
-        ele->getFaceRep(curved, j, x, y, z, n);
-        if(CTX::instance()->mesh.explode != 1.) {
-          for(int k = 0; k < 3; k++) {
-            x[k] = pc[0] + CTX::instance()->mesh.explode * (x[k] - pc[0]);
-            y[k] = pc[1] + CTX::instance()->mesh.explode * (y[k] - pc[1]);
-            z[k] = pc[2] + CTX::instance()->mesh.explode * (z[k] - pc[2]);
-          }
-        }
-        if(e->dim() == 2 && CTX::instance()->mesh.smoothNormals)
-          for(int k = 0; k < 3; k++)
-            e->model()->normals->get(x[k], y[k], z[k], n[k][0], n[k][1],
-                                     n[k][2]);
-#pragma omp critical(addElementsInArrays2)
-        {
-          e->va_triangles->add(x, y, z, n, col, ele, unique, skin);
+  if(faces) {
+    bool unique = e->dim() > 2 && !CTX::instance()->pickElements;
+    bool skin = e->dim() > 2 && CTX::instance()->mesh.drawSkinOnly;
+    for(int j = 0; j < ele->getNumFacesRep(curved); j++) {
+      double x[3], y[3], z[3];
+      SVector3 n[3];
+      ele->getFaceRep(curved, j, x, y, z, n);
+      if(CTX::instance()->mesh.explode != 1.) {
+        for(int k = 0; k < 3; k++) {
+          x[k] = pc[0] + CTX::instance()->mesh.explode * (x[k] - pc[0]);
+          y[k] = pc[1] + CTX::instance()->mesh.explode * (y[k] - pc[1]);
+          z[k] = pc[2] + CTX::instance()->mesh.explode * (z[k] - pc[2]);
         }
       }
+      if(e->dim() == 2 && CTX::instance()->mesh.smoothNormals)
+        for(int k = 0; k < 3; k++)
+          e->model()->normals->get(x[k], y[k], z[k], n[k][0], n[k][1],
+                                   n[k][2]);
+      va_triangles->add(x, y, z, n, col, ele, unique, skin);
     }
   }
 }
 
+static void finalizeVertexArray(VertexArray *va)
+{
+  va->finalize();
+  if(CTX::instance()->mesh.levelOfDetail) va->buildClusters();
+}
+
+template <class T>
+static void addElementsInArrays(GEntity *e, std::vector<T *> &elements,
+                                bool edges, bool faces)
+{
+  if(elements.empty()) return;
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  std::size_t nchunks = std::min((std::size_t)nthreads,
+                                 elements.size() / 1000 + 1);
+  if(nchunks == 1) {
+    for(std::size_t i = 0; i < elements.size(); i++)
+      addElementInArrays(e, elements[i], edges, faces, e->va_lines,
+                         e->va_triangles);
+    return;
+  }
+
+  // each thread fills its own vertex arrays with a contiguous block of
+  // elements; the blocks are then merged in order, so that the result does not
+  // depend on the number of threads
+  std::vector<VertexArray *> lines(nchunks, nullptr);
+  std::vector<VertexArray *> triangles(nchunks, nullptr);
+  int numEdges = elements[0]->getNumEdges();
+  int numFaces = elements[0]->getNumFacesRep(false);
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+  for(std::size_t c = 0; c < nchunks; c++) {
+    std::size_t b = (c * elements.size()) / nchunks;
+    std::size_t end = ((c + 1) * elements.size()) / nchunks;
+    if(edges) lines[c] = new VertexArray(2, (end - b) * numEdges);
+    if(faces) triangles[c] = new VertexArray(3, (end - b) * numFaces);
+    for(std::size_t i = b; i < end; i++)
+      addElementInArrays(e, elements[i], edges, faces, lines[c],
+                         triangles[c]);
+  }
+  if(edges) e->va_lines->merge(lines);
+  if(faces) e->va_triangles->merge(triangles);
+  for(std::size_t c = 0; c < nchunks; c++) {
+    delete lines[c];
+    delete triangles[c];
+  }
+}
+
 class initMeshGEdge {
 private:
   int _estimateNumLines(GEdge *e)
@@ -285,7 +320,7 @@ public:
     if(CTX::instance()->mesh.lines) {
       e->va_lines = new VertexArray(2, _estimateNumLines(e));
       addElementsInArrays(e, e->lines, CTX::instance()->mesh.lines, false);
-      e->va_lines->finalize();
+      finalizeVertexArray(e->va_lines);
     }
   }
 };
@@ -347,8 +382,8 @@ public:
       if(CTX::instance()->mesh.quadrangles)
         addElementsInArrays(f, f->quadrangles, edg, fac);
       addElementsInArrays(f, f->polygons, edg, fac);
-      f->va_lines->finalize();
-      f->va_triangles->finalize();
+      finalizeVertexArray(f->va_lines);
+      finalizeVertexArray(f->va_triangles);
     }
   }
 };
@@ -443,8 +478,8 @@ public:
       if(CTX::instance()->mesh.trihedra)
         addElementsInArrays(r, r->trihedra, edg, fac);
       addElementsInArrays(r, r->polyhedra, edg, fac);
-      r->va_lines->finalize();
-      r->va_triangles->finalize();
+      finalizeVertexArray(r->va_lines);
+      finalizeVertexArray(r->va_triangles);
     }
   }
 };
@@ -2545,10 +2545,13 @@ void ReplaceAllDuplicatesNew(double tol)
   ReplaceDuplicateSurfaces(nullptr);
 }
 
-void ProtudeXYZ(double &x, double &y, double &z, ExtrudeParams *e)
+// rotate (x, y, z) by the fraction t of the extrusion angle; this does not
+// modify e, so that it can be called concurrently
+void ProtudeXYZ(double &x, double &y, double &z, ExtrudeParams *e, double t)
 {
   double matrix[4][4];
   double T[3];
+  double axe[3] = {e->geo.axe[0], e->geo.axe[1], e->geo.axe[2]};
   Vertex v(x, y, z);
 
   T[0] = -e->geo.pt[0];
@@ -2557,7 +2560,7 @@ void ProtudeXYZ(double &x, double &y, double &z, ExtrudeParams *e)
   SetTranslationMatrix(matrix, T);
   ApplyTransformationToPointAlways(matrix, &v);
 
-  SetRotationMatrix(matrix, e->geo.axe, e->geo.angle);
+  SetRotationMatrix(matrix, axe, e->geo.angle * t);
   ApplyTransformationToPointAlways(matrix, &v);
 
   T[0] = -T[0];
@@ -2569,8 +2572,6 @@ void ProtudeXYZ(double &x, double &y, double &z, ExtrudeParams *e)
   x = v.Pos.X;
   y = v.Pos.Y;
   z = v.Pos.Z;
-
-  List_Reset(ListOfTransformedPoints);
 }
 
 int ExtrudePoint(int type, int ip, double T0, double T1, double T2, double A0,
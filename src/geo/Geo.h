@@ -232,7 +232,8 @@ void ExtrudeShapes(int extrude_type, List_T *in, double T0, double T1,
                    double T2, double A0, double A1, double A2, double X0,
                    double X1, double X2, double alpha, ExtrudeParams *e,
                    List_T *out);
-void ProtudeXYZ(double &x, double &y, double &z, ExtrudeParams *e);
+void ProtudeXYZ(double &x, double &y, double &z, ExtrudeParams *e,
+                double t = 1.);
 
 void ReplaceAllDuplicates();
 void ReplaceAllDuplicatesNew(double tol = -1.);
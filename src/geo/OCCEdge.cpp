@@ -62,7 +62,13 @@ OCCEdge::OCCEdge(GModel *m, TopoDS_Edge c, int num, GVertex *v1, GVertex *v2)
       umin -= utol;
       umax += utol;
     }
-    _projector.Init(_curve, umin, umax);
+    Handle(Geom_Curve) curve = _curve;
+    _projectors.setCreator([curve, umin, umax]() {
+      GeomAPI_ProjectPointOnCurve *projector =
+        new GeomAPI_ProjectPointOnCurve();
+      projector->Init(curve, umin, umax);
+      return projector;
+    });
 
     // keep track of number of poles for drawing
     if(_curve->DynamicType() == STANDARD_TYPE(Geom_BSplineCurve))
@@ -216,21 +222,22 @@ bool OCCEdge::_project(const double p[3], double &u, double xyz[3]) const
   }
 
   gp_Pnt pnt(p[0], p[1], p[2]);
-  _projector.Perform(pnt);
+  OCCObjectPool<GeomAPI_ProjectPointOnCurve>::guard projector(_projectors);
+  projector->Perform(pnt);
 
-  if(!_projector.NbPoints()) {
+  if(!projector->NbPoints()) {
     Msg::Debug("Projection of point (%g, %g, %g) on curve %d failed", p[0],
                p[1], p[2], tag());
     return false;
   }
 
-  u = _projector.LowerDistanceParameter();
+  u = projector->LowerDistanceParameter();
 
   if(u < _s0 || u > _s1)
     Msg::Debug("Point projection is out of curve parameter bounds");
 
   if(xyz) {
-    pnt = _projector.NearestPoint();
+    pnt = projector->NearestPoint();
     xyz[0] = pnt.X();
     xyz[1] = pnt.Y();
     xyz[2] = pnt.Z();
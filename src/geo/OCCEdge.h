@@ -10,6 +10,7 @@
 #include "GEdge.h"
 #include "GModel.h"
 #include "Range.h"
+#include "OCCObjectPool.h"
 
 class OCCFace;
 
@@ -30,7 +31,9 @@ private:
   Handle(Geom_Curve) _curve;
   mutable Handle(Geom2d_Curve) _curve2d;
   mutable GFace *_trimmed;
-  mutable GeomAPI_ProjectPointOnCurve _projector;
+  // one projector per concurrent caller, as projectors store the state of the
+  // last query
+  mutable OCCObjectPool<GeomAPI_ProjectPointOnCurve> _projectors;
   bool _project(const double p[3], double &u, double xyz[3]) const;
 
 public:
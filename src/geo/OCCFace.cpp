@@ -42,7 +42,7 @@
 #include <gp_Sphere.hxx>
 
 OCCFace::OCCFace(GModel *m, TopoDS_Face s, int num)
-  : GFace(m, num), _s(s), _sf(s, Standard_True), _radius(-1)
+  : GFace(m, num), _s(s), _radius(-1)
 {
   _setup();
 
@@ -168,7 +168,15 @@ void OCCFace::_setup()
     vmin -= vtol;
     vmax += vtol;
   }
-  _projector.Init(_occface, umin, umax, vmin, vmax);
+  Handle(Geom_Surface) occface = _occface;
+  _projectors.setCreator([occface, umin, umax, vmin, vmax]() {
+    GeomAPI_ProjectPointOnSurf *projector = new GeomAPI_ProjectPointOnSurf();
+    projector->Init(occface, umin, umax, vmin, vmax);
+    return projector;
+  });
+  TopoDS_Face face = _s;
+  _adaptors.setCreator(
+    [face]() { return new BRepAdaptor_Surface(face, Standard_True); });
 
   if(OCCFace::geomType() == GEntity::Sphere) {
     BRepAdaptor_Surface surface(_s);
@@ -234,15 +242,53 @@ Range<double> OCCFace::parBounds(int i) const
   return Range<double>(_vmin, _vmax);
 }
 
-SVector3 OCCFace::normal(const SPoint2 &param) const
+surfaceTileCache *OCCFace::_getCache() const
 {
-  gp_Pnt pnt;
-  gp_Vec du, dv;
+  if(!CTX::instance()->geom.occEvaluationCache) return nullptr;
+  std::call_once(_cacheFlag, [this]() {
+    // analytical surfaces are cheaper to evaluate exactly
+    switch(geomType()) {
+    case Plane:
+    case Cylinder:
+    case Cone:
+    case Sphere:
+    case Torus: return;
+    default: break;
+    }
+    Handle(Geom_Surface) occface = _occface;
+    _cache.reset(new surfaceTileCache(
+      [occface](double u, double v, double p[3], double pu[3], double pv[3],
+                double puv[3]) {
+        gp_Pnt pnt;
+        gp_Vec du, dv, duu, dvv, duv;
+        occface->D2(u, v, pnt, du, dv, duu, dvv, duv);
+        for(int i = 0; i < 3; i++) {
+          p[i] = pnt.Coord(i + 1);
+          pu[i] = du.Coord(i + 1);
+          pv[i] = dv.Coord(i + 1);
+          puv[i] = duv.Coord(i + 1);
+        }
+      },
+      _umin, _umax, _vmin, _vmax,
+      CTX::instance()->geom.occEvaluationCacheTolerance));
+  });
+  return _cache.get();
+}
 
-  _occface->D1(param.x(), param.y(), pnt, du, dv);
+SVector3 OCCFace::normal(const SPoint2 &param) const
+{
+  SVector3 t1, t2;
+  surfaceTileCache *cache = _getCache();
+  double p[3];
+  if(!cache ||
+     !cache->evaluate(param.x(), param.y(), p, t1.data(), t2.data())) {
+    gp_Pnt pnt;
+    gp_Vec du, dv;
+    _occface->D1(param.x(), param.y(), pnt, du, dv);
+    t1 = SVector3(du.X(), du.Y(), du.Z());
+    t2 = SVector3(dv.X(), dv.Y(), dv.Z());
+  }
 
-  SVector3 t1(du.X(), du.Y(), du.Z());
-  SVector3 t2(dv.X(), dv.Y(), dv.Z());
   SVector3 n(crossprod(t1, t2));
   n.normalize();
   if(_s.Orientation() == TopAbs_REVERSED) return n * (-1.);
@@ -251,6 +297,13 @@ SVector3 OCCFace::normal(const SPoint2 &param) const
 
 Pair<SVector3, SVector3> OCCFace::firstDer(const SPoint2 &param) const
 {
+  surfaceTileCache *cache = _getCache();
+  if(cache) {
+    double p[3];
+    SVector3 du, dv;
+    if(cache->evaluate(param.x(), param.y(), p, du.data(), dv.data()))
+      return Pair<SVector3, SVector3>(du, dv);
+  }
   gp_Pnt pnt;
   gp_Vec du, dv;
   _occface->D1(param.x(), param.y(), pnt, du, dv);
@@ -273,6 +326,10 @@ void OCCFace::secondDer(const SPoint2 &param, SVector3 &dudu, SVector3 &dvdv,
 GPoint OCCFace::point(double par1, double par2) const
 {
   double pp[2] = {par1, par2};
+  surfaceTileCache *cache = _getCache();
+  double xyz[3];
+  if(cache && cache->evaluate(par1, par2, xyz))
+    return GPoint(xyz[0], xyz[1], xyz[2], this, pp);
   gp_Pnt val = _occface->Value(par1, par2);
   return GPoint(val.X(), val.Y(), val.Z(), this, pp);
 }
@@ -280,19 +337,20 @@ GPoint OCCFace::point(double par1, double par2) const
 bool OCCFace::_project(const double p[3], double uv[2], double xyz[3]) const
 {
   gp_Pnt pnt(p[0], p[1], p[2]);
-  _projector.Perform(pnt);
-  if(!_projector.NbPoints()) {
+  OCCObjectPool<GeomAPI_ProjectPointOnSurf>::guard projector(_projectors);
+  projector->Perform(pnt);
+  if(!projector->NbPoints()) {
     Msg::Debug("Projection of point (%g, %g, %g) on surface %d failed", p[0],
                p[1], p[2], tag());
     return false;
   }
-  _projector.LowerDistanceParameters(uv[0], uv[1]);
+  projector->LowerDistanceParameters(uv[0], uv[1]);
 
   if(uv[0] < _umin || uv[0] > _umax || uv[1] < _vmin || uv[1] > _vmax)
     Msg::Debug("Point projection is out of surface parameter bounds");
 
   if(xyz) {
-    pnt = _projector.NearestPoint();
+    pnt = projector->NearestPoint();
     xyz[0] = pnt.X();
     xyz[1] = pnt.Y();
     xyz[2] = pnt.Z();
@@ -352,7 +410,8 @@ GEntity::GeomType OCCFace::geomType() const
 double OCCFace::curvatureMax(const SPoint2 &param) const
 {
   const double eps = 1.e-12;
-  BRepLProp_SLProps prop(_sf, 2, eps);
+  OCCObjectPool<BRepAdaptor_Surface>::guard sf(_adaptors);
+  BRepLProp_SLProps prop(*sf, 2, eps);
   prop.SetParameters(param.x(), param.y());
 
   if(!prop.IsCurvatureDefined()) { return eps; }
@@ -365,7 +424,8 @@ double OCCFace::curvatures(const SPoint2 &param, SVector3 &dirMax,
                            double &curvMin) const
 {
   const double eps = 1.e-12;
-  BRepLProp_SLProps prop(_sf, 2, eps);
+  OCCObjectPool<BRepAdaptor_Surface>::guard sf(_adaptors);
+  BRepLProp_SLProps prop(*sf, 2, eps);
   prop.SetParameters(param.x(), param.y());
 
   if(!prop.IsCurvatureDefined()) { return -1.; }
@@ -10,6 +10,10 @@
 #include "GFace.h"
 #include "GModel.h"
 #include "Range.h"
+#include "OCCObjectPool.h"
+#include "surfaceTileCache.h"
+#include <memory>
+#include <mutex>
 
 #if defined(HAVE_OCC)
 
@@ -21,14 +25,21 @@ class OCCFace : public GFace {
 private:
   TopoDS_Face _s;
   Handle(Geom_Surface) _occface;
-  const BRepAdaptor_Surface _sf;
   double _umin, _umax, _vmin, _vmax;
   bool _periodic[2];
   double _period[2];
   double _radius;
   SPoint3 _center;
   void _setup();
-  mutable GeomAPI_ProjectPointOnSurf _projector;
+  // projectors and adaptors store the state of the last query: use one
+  // instance per concurrent caller
+  mutable OCCObjectPool<GeomAPI_ProjectPointOnSurf> _projectors;
+  mutable OCCObjectPool<BRepAdaptor_Surface> _adaptors;
+  // optional cache of approximations of the surface (see
+  // Geometry.OCCEvaluationCache), created on first use
+  mutable std::once_flag _cacheFlag;
+  mutable std::unique_ptr<surfaceTileCache> _cache;
+  surfaceTileCache *_getCache() const;
   bool _project(const double p[3], double uv[2], double xyz[3]) const;
 
 public:
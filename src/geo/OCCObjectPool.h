@@ -0,0 +1,79 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef OCC_OBJECT_POOL_H
+#define OCC_OBJECT_POOL_H
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Pool of OpenCASCADE objects that are not reentrant (projectors, adaptors
+// with internal evaluation caches, ...), so that the same geometrical entity
+// can be queried concurrently by several threads. Each thread borrows its own
+// instance for the duration of a query; new instances are only created when
+// all the existing ones are in use, i.e. the pool grows to the maximum number
+// of threads simultaneously working on the entity. The mutex only protects
+// the list of available instances, not the (potentially expensive) queries.
+template <class T> class OCCObjectPool {
+private:
+  std::mutex _mutex;
+  std::vector<T *> _available;
+  std::function<T *()> _create;
+
+public:
+  OCCObjectPool() {}
+  OCCObjectPool(const OCCObjectPool &) = delete;
+  OCCObjectPool &operator=(const OCCObjectPool &) = delete;
+  ~OCCObjectPool() { clear(); }
+  // set the function used to create new (initialized) instances; must not be
+  // called while instances are borrowed
+  void setCreator(std::function<T *()> create)
+  {
+    clear();
+    _create = create;
+  }
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(auto p : _available) delete p;
+    _available.clear();
+  }
+  T *acquire()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if(!_available.empty()) {
+        T *p = _available.back();
+        _available.pop_back();
+        return p;
+      }
+    }
+    return _create ? _create() : nullptr;
+  }
+  void release(T *p)
+  {
+    if(!p) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _available.push_back(p);
+  }
+  // borrow an instance for the lifetime of the guard
+  class guard {
+  private:
+    OCCObjectPool<T> &_pool;
+    T *_p;
+
+  public:
+    guard(OCCObjectPool<T> &pool) : _pool(pool), _p(pool.acquire()) {}
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+    ~guard() { _pool.release(_p); }
+    T *get() const { return _p; }
+    T *operator->() const { return _p; }
+    T &operator*() const { return *_p; }
+  };
+};
+
+#endif
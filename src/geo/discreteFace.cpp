@@ -597,6 +597,19 @@ int discreteFace::createGeometry()
   return 0;
 }
 
+void discreteFace::renumberParametrization(std::size_t &vertexNum,
+                                           std::size_t &elementNum)
+{
+  for(std::size_t i = 0; i < _param.v2d.size(); i++) {
+    _param.v2d[i].forceNum(++vertexNum);
+    _param.v3d[i].forceNum(++vertexNum);
+  }
+  for(std::size_t i = 0; i < _param.t2d.size(); i++) {
+    _param.t2d[i].forceNum(++elementNum);
+    _param.t3d[i].forceNum(++elementNum);
+  }
+}
+
 void discreteFace::_computeSTLNormals()
 {
   stl_normals.clear();
@@ -64,6 +64,9 @@ public:
   virtual void secondDer(const SPoint2 &param, SVector3 &dudu, SVector3 &dvdv,
                          SVector3 &dudv) const;
   int createGeometry();
+  // renumber the nodes and the triangles of the parametrization in the order
+  // in which they were created, after the given numbers
+  void renumberParametrization(std::size_t &vertexNum, std::size_t &elementNum);
   virtual bool haveParametrization() { return !_param.empty(); }
   virtual void mesh(bool verbose);
   int trianglePosition(double par1, double par2, double &u, double &v) const;
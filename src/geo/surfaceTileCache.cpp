@@ -0,0 +1,190 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <algorithm>
+#include <cmath>
+#include "surfaceTileCache.h"
+
+enum { TILE_UNBUILT = 0, TILE_SURROGATE, TILE_SPLIT, TILE_EXACT };
+
+struct surfaceTileCache::tile {
+  double u0, u1, v0, v1;
+  // position, scaled first derivatives and scaled mixed derivative at the
+  // corners (i, j) = (0, 0), (1, 0), (0, 1), (1, 1)
+  double p[4][3], pu[4][3], pv[4][3], puv[4][3];
+  tile *children[4];
+  std::atomic<int> state;
+  tile(double umin, double umax, double vmin, double vmax)
+    : u0(umin), u1(umax), v0(vmin), v1(vmax), children{nullptr, nullptr,
+                                                        nullptr, nullptr},
+      state(TILE_UNBUILT)
+  {
+  }
+  ~tile()
+  {
+    for(int i = 0; i < 4; i++) delete children[i];
+  }
+  // cubic Hermite basis functions (value at 0, value at 1, derivative at 0,
+  // derivative at 1) and their derivatives
+  static void hermite(double s, double h[4], double dh[4])
+  {
+    double s2 = s * s, s3 = s2 * s;
+    h[0] = 2 * s3 - 3 * s2 + 1;
+    h[1] = -2 * s3 + 3 * s2;
+    h[2] = s3 - 2 * s2 + s;
+    h[3] = s3 - s2;
+    dh[0] = 6 * s2 - 6 * s;
+    dh[1] = -6 * s2 + 6 * s;
+    dh[2] = 3 * s2 - 4 * s + 1;
+    dh[3] = 3 * s2 - 2 * s;
+  }
+  void evaluate(double u, double v, double xyz[3], double du[3],
+                double dv[3]) const
+  {
+    double hu = u1 - u0, hv = v1 - v0;
+    double hs[4], dhs[4], ht[4], dht[4];
+    hermite((u - u0) / hu, hs, dhs);
+    hermite((v - v0) / hv, ht, dht);
+    for(int k = 0; k < 3; k++) xyz[k] = du[k] = dv[k] = 0.;
+    for(int j = 0; j < 2; j++) {
+      for(int i = 0; i < 2; i++) {
+        int c = i + 2 * j;
+        for(int k = 0; k < 3; k++) {
+          xyz[k] += hs[i] * ht[j] * p[c][k] + hs[2 + i] * ht[j] * pu[c][k] +
+                    hs[i] * ht[2 + j] * pv[c][k] +
+                    hs[2 + i] * ht[2 + j] * puv[c][k];
+          du[k] += dhs[i] * ht[j] * p[c][k] + dhs[2 + i] * ht[j] * pu[c][k] +
+                   dhs[i] * ht[2 + j] * pv[c][k] +
+                   dhs[2 + i] * ht[2 + j] * puv[c][k];
+          dv[k] += hs[i] * dht[j] * p[c][k] + hs[2 + i] * dht[j] * pu[c][k] +
+                   hs[i] * dht[2 + j] * pv[c][k] +
+                   hs[2 + i] * dht[2 + j] * puv[c][k];
+        }
+      }
+    }
+    for(int k = 0; k < 3; k++) {
+      du[k] /= hu;
+      dv[k] /= hv;
+    }
+  }
+};
+
+static double dist(const double a[3], const double b[3])
+{
+  return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                   (a[1] - b[1]) * (a[1] - b[1]) +
+                   (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+surfaceTileCache::surfaceTileCache(evaluator eval, double umin, double umax,
+                                   double vmin, double vmax, double tolerance,
+                                   int maxDepth)
+  : _eval(eval), _umin(umin), _umax(umax), _vmin(vmin), _vmax(vmax),
+    _tolerance(tolerance), _maxDepth(maxDepth),
+    _root(new tile(umin, umax, vmin, vmax))
+{
+  if(!(umax > umin) || !(vmax > vmin)) _root->state = TILE_EXACT;
+}
+
+surfaceTileCache::~surfaceTileCache() { delete _root; }
+
+void surfaceTileCache::_build(tile *t, int depth)
+{
+  // interpolation data
+  tile tmp(t->u0, t->u1, t->v0, t->v1);
+  double hu = t->u1 - t->u0, hv = t->v1 - t->v0;
+  for(int j = 0; j < 2; j++) {
+    for(int i = 0; i < 2; i++) {
+      int c = i + 2 * j;
+      _eval(i ? t->u1 : t->u0, j ? t->v1 : t->v0, tmp.p[c], tmp.pu[c],
+            tmp.pv[c], tmp.puv[c]);
+      for(int k = 0; k < 3; k++) {
+        tmp.pu[c][k] *= hu;
+        tmp.pv[c][k] *= hv;
+        tmp.puv[c][k] *= hu * hv;
+      }
+    }
+  }
+
+  // error control on the center and the edge midpoints
+  double size = std::max(dist(tmp.p[0], tmp.p[3]), dist(tmp.p[1], tmp.p[2]));
+  for(int c = 0; c < 4; c++) {
+    for(int k = 0; k < 3; k++) {
+      size = std::max(size, std::abs(tmp.pu[c][k]));
+      size = std::max(size, std::abs(tmp.pv[c][k]));
+    }
+  }
+  bool ok = size > 0.;
+  const double samples[5][2] = {
+    {0.5, 0.5}, {0.5, 0.}, {1., 0.5}, {0.5, 1.}, {0., 0.5}};
+  for(int s = 0; s < 5 && ok; s++) {
+    double u = t->u0 + samples[s][0] * hu, v = t->v0 + samples[s][1] * hv;
+    double p[3], pu[3], pv[3], puv[3], sp[3], spu[3], spv[3];
+    _eval(u, v, p, pu, pv, puv);
+    tmp.evaluate(u, v, sp, spu, spv);
+    double tol = _tolerance * size;
+    if(dist(p, sp) > tol) ok = false;
+    for(int k = 0; k < 3; k++) {
+      if(std::abs(pu[k] - spu[k]) * hu > tol ||
+         std::abs(pv[k] - spv[k]) * hv > tol)
+        ok = false;
+    }
+  }
+
+  int state = ok ? TILE_SURROGATE :
+                   (depth < _maxDepth ? TILE_SPLIT : TILE_EXACT);
+  tile *children[4] = {nullptr, nullptr, nullptr, nullptr};
+  if(state == TILE_SPLIT) {
+    double um = 0.5 * (t->u0 + t->u1), vm = 0.5 * (t->v0 + t->v1);
+    children[0] = new tile(t->u0, um, t->v0, vm);
+    children[1] = new tile(um, t->u1, t->v0, vm);
+    children[2] = new tile(t->u0, um, vm, t->v1);
+    children[3] = new tile(um, t->u1, vm, t->v1);
+  }
+
+  // publish the tile, unless another thread did it in the meantime
+  std::lock_guard<std::mutex> lock(_mutex);
+  if(t->state.load(std::memory_order_relaxed) != TILE_UNBUILT) {
+    for(int i = 0; i < 4; i++) delete children[i];
+    return;
+  }
+  for(int c = 0; c < 4; c++) {
+    for(int k = 0; k < 3; k++) {
+      t->p[c][k] = tmp.p[c][k];
+      t->pu[c][k] = tmp.pu[c][k];
+      t->pv[c][k] = tmp.pv[c][k];
+      t->puv[c][k] = tmp.puv[c][k];
+    }
+  }
+  for(int i = 0; i < 4; i++) t->children[i] = children[i];
+  t->state.store(state, std::memory_order_release);
+}
+
+bool surfaceTileCache::evaluate(double u, double v, double p[3], double pu[3],
+                                double pv[3])
+{
+  if(u < _umin || u > _umax || v < _vmin || v > _vmax) return false;
+  tile *t = _root;
+  int depth = 0;
+  while(true) {
+    int state = t->state.load(std::memory_order_acquire);
+    if(state == TILE_UNBUILT) {
+      _build(t, depth);
+      continue;
+    }
+    if(state == TILE_EXACT) return false;
+    if(state == TILE_SURROGATE) break;
+    double um = 0.5 * (t->u0 + t->u1), vm = 0.5 * (t->v0 + t->v1);
+    t = t->children[(u < um ? 0 : 1) + (v < vm ? 0 : 2)];
+    depth++;
+  }
+  double du[3], dv[3];
+  t->evaluate(u, v, p, du, dv);
+  for(int k = 0; k < 3; k++) {
+    if(pu) pu[k] = du[k];
+    if(pv) pv[k] = dv[k];
+  }
+  return true;
+}
@@ -0,0 +1,55 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef SURFACE_TILE_CACHE_H
+#define SURFACE_TILE_CACHE_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+// Cache of bicubic Hermite surrogates of a parametric surface, used to
+// amortize the cost of expensive exact evaluations (e.g. of BSpline surfaces
+// in CAD kernels).
+//
+// The parametric domain is recursively split into a quadtree of tiles, built
+// lazily when queried. On each tile the surrogate interpolates the exact
+// position, first derivatives and mixed second derivative at the 4 corners;
+// it is only accepted if its error on the position and on the first
+// derivatives (scaled by the tile parametric size) at the center and at the
+// edge midpoints is smaller than 'tolerance' times the size of the tile. If
+// it is not, the tile is split, up to 'maxDepth' levels; beyond that the
+// queries fall back to the exact evaluation. Queries are thread-safe: a tile
+// is built outside of any lock and published atomically.
+class surfaceTileCache {
+public:
+  // exact evaluation of the position p, the first derivatives pu and pv and
+  // the mixed second derivative puv at (u, v)
+  typedef std::function<void(double u, double v, double p[3], double pu[3],
+                             double pv[3], double puv[3])>
+    evaluator;
+
+private:
+  struct tile;
+  evaluator _eval;
+  double _umin, _umax, _vmin, _vmax, _tolerance;
+  int _maxDepth;
+  tile *_root;
+  std::mutex _mutex;
+  void _build(tile *t, int depth);
+
+public:
+  surfaceTileCache(evaluator eval, double umin, double umax, double vmin,
+                   double vmax, double tolerance = 1e-6, int maxDepth = 10);
+  ~surfaceTileCache();
+  surfaceTileCache(const surfaceTileCache &) = delete;
+  surfaceTileCache &operator=(const surfaceTileCache &) = delete;
+  // evaluate the surrogate at (u, v); 'pu' and 'pv' can be null. Return false
+  // if the exact evaluation should be used instead.
+  bool evaluate(double u, double v, double p[3], double pu[3] = nullptr,
+                double pv[3] = nullptr);
+};
+
+#endif
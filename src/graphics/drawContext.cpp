@@ -9,6 +9,7 @@
 #include "GmshConfig.h"
 #include "GmshMessage.h"
 #include "drawContext.h"
+#include "drawVertexArray.h"
 #include "Trackball.h"
 #include "Context.h"
 #include "Numeric.h"
@@ -90,6 +91,7 @@ drawContextGlobal *drawContext::global()
 
 void drawContext::invalidateQuadricsAndDisplayLists()
 {
+  invalidateVertexBuffers();
   if(_quadric) {
     gluDeleteQuadric(_quadric);
     _quadric = nullptr;
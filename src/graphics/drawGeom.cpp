@@ -8,6 +8,7 @@
 #include "Context.h"
 #include "gl2ps.h"
 #include "VertexArray.h"
+#include "drawVertexArray.h"
 #include "GModel.h"
 #include "SBoundingBox3d.h"
 #include "GmshMessage.h"
@@ -258,24 +259,9 @@ private:
                         int forceColor = 0, unsigned int color = 0)
   {
     if(!va || !va->getNumVertices()) return;
-    glVertexPointer(3, GL_FLOAT, 0, va->getVertexArray());
-    glEnableClientState(GL_VERTEX_ARRAY);
-    if(useNormalArray) {
-      glEnable(GL_LIGHTING);
-      glNormalPointer(NORMAL_GLTYPE, 0, va->getNormalArray());
-      glEnableClientState(GL_NORMAL_ARRAY);
-    }
-    else {
-      glDisableClientState(GL_NORMAL_ARRAY);
-    }
-    if(forceColor) {
-      glDisableClientState(GL_COLOR_ARRAY);
-      glColor4ubv((GLubyte *)&color);
-    }
-    else {
-      glColorPointer(4, GL_UNSIGNED_BYTE, 0, va->getColorArray());
-      glEnableClientState(GL_COLOR_ARRAY);
-    }
+    if(useNormalArray) glEnable(GL_LIGHTING);
+    if(forceColor) glColor4ubv((GLubyte *)&color);
+    enableVertexArray(_ctx, va, useNormalArray, !forceColor);
     if(CTX::instance()->polygonOffset) glEnable(GL_POLYGON_OFFSET_FILL);
     if(CTX::instance()->geom.surfaceType > 1) {
       if(CTX::instance()->geom.lightTwoSide)
@@ -292,9 +278,7 @@ private:
     glDisable(GL_POLYGON_OFFSET_FILL);
     glDisable(GL_LIGHTING);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_NORMAL_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
+    disableVertexArray();
   }
 
 public:
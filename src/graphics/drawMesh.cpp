@@ -21,6 +21,7 @@
 #include "OS.h"
 #include "gl2ps.h"
 #include "VertexArray.h"
+#include "drawVertexArray.h"
 #include "SmoothData.h"
 #include "PView.h"
 #include "PViewData.h"
@@ -369,29 +370,16 @@ static void drawArrays(drawContext *ctx, GEntity *e, VertexArray *va,
     }
   }
 
-  glVertexPointer(3, GL_FLOAT, 0, va->getVertexArray());
-  glEnableClientState(GL_VERTEX_ARRAY);
+  if(useNormalArray) glEnable(GL_LIGHTING);
 
-  if(useNormalArray) {
-    glEnable(GL_LIGHTING);
-    glNormalPointer(NORMAL_GLTYPE, 0, va->getNormalArray());
-    glEnableClientState(GL_NORMAL_ARRAY);
-  }
-  else
-    glDisableClientState(GL_NORMAL_ARRAY);
-
-  if(forceColor) {
-    glDisableClientState(GL_COLOR_ARRAY);
+  bool useColorArray = false;
+  if(forceColor)
     glColor4ubv((GLubyte *)&color);
-  }
   else if(CTX::instance()->pickElements ||
           (!e->getSelection() && (CTX::instance()->mesh.colorCarousel == 0 ||
-                                  CTX::instance()->mesh.colorCarousel == 3))) {
-    glColorPointer(4, GL_UNSIGNED_BYTE, 0, va->getColorArray());
-    glEnableClientState(GL_COLOR_ARRAY);
-  }
+                                  CTX::instance()->mesh.colorCarousel == 3)))
+    useColorArray = true;
   else {
-    glDisableClientState(GL_COLOR_ARRAY);
     color = getColorByEntity(e);
     glColor4ubv((GLubyte *)&color);
   }
@@ -399,14 +387,16 @@ static void drawArrays(drawContext *ctx, GEntity *e, VertexArray *va,
   if(va->getNumVerticesPerElement() > 2 && CTX::instance()->polygonOffset)
     glEnable(GL_POLYGON_OFFSET_FILL);
 
-  glDrawArrays(type, 0, va->getNumVertices());
+  // simplified representations of the clusters of elements (if any)
+  double pixels = 0.;
+  if(CTX::instance()->mesh.levelOfDetail == 2 ||
+     (CTX::instance()->mesh.levelOfDetail == 1 &&
+      CTX::instance()->interacting))
+    pixels = CTX::instance()->mesh.levelOfDetailPixels;
+  drawVertexArray(ctx, va, type, useNormalArray, useColorArray, pixels);
 
   glDisable(GL_POLYGON_OFFSET_FILL);
   glDisable(GL_LIGHTING);
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_NORMAL_ARRAY);
-  glDisableClientState(GL_COLOR_ARRAY);
 }
 
 // GVertex drawing routines
@@ -15,6 +15,7 @@
 #include "Plugin.h"
 #include "Numeric.h"
 #include "VertexArray.h"
+#include "drawVertexArray.h"
 #include "Context.h"
 #include "gl2ps.h"
 
@@ -111,21 +112,10 @@ static void drawArrays(drawContext *ctx, PView *p, VertexArray *va, GLint type,
       gl2psEnable(GL2PS_LINE_STIPPLE);
     }
 
-    glVertexPointer(3, GL_FLOAT, 0, va->getVertexArray());
-    glEnableClientState(GL_VERTEX_ARRAY);
-    if(useNormalArray) {
-      glEnable(GL_LIGHTING);
-      glNormalPointer(NORMAL_GLTYPE, 0, va->getNormalArray());
-      glEnableClientState(GL_NORMAL_ARRAY);
-    }
-    else
-      glDisableClientState(GL_NORMAL_ARRAY);
-    glColorPointer(4, GL_UNSIGNED_BYTE, 0, va->getColorArray());
-    glEnableClientState(GL_COLOR_ARRAY);
+    if(useNormalArray) glEnable(GL_LIGHTING);
+    enableVertexArray(ctx, va, useNormalArray, true);
     glDrawArrays(type, 0, va->getNumVertices());
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_NORMAL_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
+    disableVertexArray();
 
     if(type == GL_LINES && opt->useStipple) {
       glDisable(GL_LINE_STIPPLE);
@@ -0,0 +1,354 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#if !defined(WIN32) && !defined(__APPLE__)
+#define GL_GLEXT_PROTOTYPES
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "GmshMessage.h"
+#include "Context.h"
+#include "VertexArray.h"
+#include "drawVertexArray.h"
+
+#if !defined(GL_ARRAY_BUFFER)
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+
+#if !defined(GL_STATIC_DRAW)
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+#if !defined(APIENTRY)
+#define APIENTRY
+#endif
+
+// OpenGL 1.5 entry points, resolved at runtime on Windows (where the system
+// library only exports OpenGL 1.1)
+struct bufferFunctions {
+  void(APIENTRY *genBuffers)(GLsizei, GLuint *);
+  void(APIENTRY *deleteBuffers)(GLsizei, const GLuint *);
+  void(APIENTRY *bindBuffer)(GLenum, GLuint);
+  void(APIENTRY *bufferData)(GLenum, ptrdiff_t, const void *, GLenum);
+  void(APIENTRY *bufferSubData)(GLenum, ptrdiff_t, ptrdiff_t, const void *);
+};
+
+static bufferFunctions gl = {nullptr, nullptr, nullptr, nullptr, nullptr};
+
+static bool loadBufferFunctions()
+{
+#if defined(WIN32)
+  gl.genBuffers = (decltype(gl.genBuffers))wglGetProcAddress("glGenBuffers");
+  gl.deleteBuffers =
+    (decltype(gl.deleteBuffers))wglGetProcAddress("glDeleteBuffers");
+  gl.bindBuffer = (decltype(gl.bindBuffer))wglGetProcAddress("glBindBuffer");
+  gl.bufferData = (decltype(gl.bufferData))wglGetProcAddress("glBufferData");
+  gl.bufferSubData =
+    (decltype(gl.bufferSubData))wglGetProcAddress("glBufferSubData");
+#elif defined(GL_VERSION_1_5)
+  gl.genBuffers = glGenBuffers;
+  gl.deleteBuffers = glDeleteBuffers;
+  gl.bindBuffer = glBindBuffer;
+  gl.bufferData = (decltype(gl.bufferData))glBufferData;
+  gl.bufferSubData = (decltype(gl.bufferSubData))glBufferSubData;
+#endif
+  return gl.genBuffers && gl.deleteBuffers && gl.bindBuffer &&
+         gl.bufferData && gl.bufferSubData;
+}
+
+// 0: buffer objects not supported, 1: supported, 2: supported by a software
+// rasterizer (slower than client arrays), -1: unknown
+static int checkBufferSupport()
+{
+  static int supported = -1;
+  if(supported >= 0) return supported;
+  const char *version = (const char *)glGetString(GL_VERSION);
+  const char *renderer = (const char *)glGetString(GL_RENDERER);
+  if(!version || !renderer) return 0; // no current context
+  int major = 0, minor = 0;
+  sscanf(version, "%d.%d", &major, &minor);
+  if((major > 1 || (major == 1 && minor >= 5)) && loadBufferFunctions()) {
+    std::string r(renderer);
+    bool software = r.find("llvmpipe") != std::string::npos ||
+                    r.find("softpipe") != std::string::npos ||
+                    r.find("Software Rasterizer") != std::string::npos ||
+                    r.find("SWR") != std::string::npos ||
+                    r.find("GDI Generic") != std::string::npos;
+    supported = software ? 2 : 1;
+  }
+  else
+    supported = 0;
+  Msg::Debug("OpenGL %s renderer '%s': vertex buffer objects %s", version,
+             renderer,
+             supported == 1 ? "supported" :
+             supported == 2 ? "supported (software rendering)" :
+                              "not supported");
+  return supported;
+}
+
+static bool useBuffers(drawContext *ctx)
+{
+  // buffer objects belong to the context of the graphic window: don't use
+  // them when printing (which can use an offscreen context), nor for picking
+  int opt = CTX::instance()->vertexBuffers;
+  if(!opt || CTX::instance()->printing ||
+     ctx->render_mode != drawContext::GMSH_RENDER)
+    return false;
+  int supported = checkBufferSupport();
+  return supported == 1 || (supported == 2 && opt == 2);
+}
+
+// buffer objects are invalid once the context is destroyed
+static std::atomic<int> bufferGeneration(0);
+
+// buffer objects of deleted vertex arrays, deleted at the next draw (vertex
+// arrays can be deleted while no context is current)
+static std::mutex releasedMutex;
+static std::vector<GLuint> released;
+
+class vertexBuffer : public VertexArrayBuffer {
+public:
+  GLuint name;
+  int generation, changes;
+  // offsets of the normals and the colors, and total size (in bytes)
+  ptrdiff_t normalOffset, colorOffset, size;
+  vertexBuffer()
+    : name(0), generation(bufferGeneration), changes(-1), normalOffset(0),
+      colorOffset(0), size(0)
+  {
+  }
+  ~vertexBuffer()
+  {
+    if(name && generation == bufferGeneration) {
+      std::lock_guard<std::mutex> lock(releasedMutex);
+      released.push_back(name);
+    }
+  }
+};
+
+static void deleteReleasedBuffers()
+{
+  std::lock_guard<std::mutex> lock(releasedMutex);
+  if(released.empty()) return;
+  gl.deleteBuffers((GLsizei)released.size(), &released[0]);
+  released.clear();
+}
+
+// upload the arrays of 'va' in its buffer object if necessary; return the
+// buffer object or null if it could not be created
+static vertexBuffer *updateBuffer(VertexArray *va)
+{
+  vertexBuffer *b = dynamic_cast<vertexBuffer *>(va->getBuffer());
+  if(!b || b->generation != bufferGeneration) {
+    b = new vertexBuffer();
+    va->setBuffer(b);
+  }
+
+  ptrdiff_t vs = (va->lastVertex() - va->firstVertex()) * sizeof(float);
+  ptrdiff_t ns = (va->lastNormal() - va->firstNormal()) * sizeof(normal_type);
+  ptrdiff_t cs =
+    (va->lastColor() - va->firstColor()) * sizeof(unsigned char);
+
+  if(b->changes == va->getNumChanges() && b->size == vs + ns + cs) {
+    if(!b->name) return nullptr; // previous upload failed
+    return b;
+  }
+
+  if(!b->name) gl.genBuffers(1, &b->name);
+  gl.bindBuffer(GL_ARRAY_BUFFER, b->name);
+  bool ok = true;
+  if(b->size != vs + ns + cs) {
+    while(glGetError() != GL_NO_ERROR) {}
+    gl.bufferData(GL_ARRAY_BUFFER, vs + ns + cs, nullptr, GL_STATIC_DRAW);
+    ok = (glGetError() == GL_NO_ERROR);
+  }
+  if(ok) {
+    if(vs) gl.bufferSubData(GL_ARRAY_BUFFER, 0, vs, va->getVertexArray());
+    if(ns) gl.bufferSubData(GL_ARRAY_BUFFER, vs, ns, va->getNormalArray());
+    if(cs) gl.bufferSubData(GL_ARRAY_BUFFER, vs + ns, cs, va->getColorArray());
+  }
+  gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+  b->changes = va->getNumChanges();
+  b->size = vs + ns + cs;
+  b->normalOffset = vs;
+  b->colorOffset = vs + ns;
+  if(!ok) {
+    // probably out of graphics memory: use client arrays until the next change
+    Msg::Debug("Could not allocate vertex buffer object of %g Mb",
+               (vs + ns + cs) / 1024. / 1024.);
+    gl.deleteBuffers(1, &b->name);
+    b->name = 0;
+    return nullptr;
+  }
+  return b;
+}
+
+void enableVertexArray(drawContext *ctx, VertexArray *va, bool normals,
+                       bool colors)
+{
+  vertexBuffer *b = nullptr;
+  if(useBuffers(ctx)) {
+    deleteReleasedBuffers();
+    b = updateBuffer(va);
+  }
+
+  if(b) {
+    gl.bindBuffer(GL_ARRAY_BUFFER, b->name);
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if(normals && b->colorOffset > b->normalOffset) {
+      glNormalPointer(NORMAL_GLTYPE, 0, (const GLvoid *)b->normalOffset);
+      glEnableClientState(GL_NORMAL_ARRAY);
+    }
+    else
+      glDisableClientState(GL_NORMAL_ARRAY);
+    if(colors && b->size > b->colorOffset) {
+      glColorPointer(4, GL_UNSIGNED_BYTE, 0, (const GLvoid *)b->colorOffset);
+      glEnableClientState(GL_COLOR_ARRAY);
+    }
+    else
+      glDisableClientState(GL_COLOR_ARRAY);
+    // the array pointers keep a reference to the buffer object
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+    return;
+  }
+
+  glVertexPointer(3, GL_FLOAT, 0, va->getVertexArray());
+  glEnableClientState(GL_VERTEX_ARRAY);
+  if(normals) {
+    glNormalPointer(NORMAL_GLTYPE, 0, va->getNormalArray());
+    glEnableClientState(GL_NORMAL_ARRAY);
+  }
+  else
+    glDisableClientState(GL_NORMAL_ARRAY);
+  if(colors) {
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, va->getColorArray());
+    glEnableClientState(GL_COLOR_ARRAY);
+  }
+  else
+    glDisableClientState(GL_COLOR_ARRAY);
+}
+
+void disableVertexArray()
+{
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+}
+
+// draw the ranges of vertices [first, first + num) of 'va', merging
+// consecutive ranges
+static void drawRanges(drawContext *ctx, VertexArray *va, GLenum type,
+                       bool normals, bool colors,
+                       const std::vector<std::pair<int, int> > &ranges)
+{
+  if(ranges.empty()) return;
+  enableVertexArray(ctx, va, normals, colors);
+  std::size_t i = 0;
+  while(i < ranges.size()) {
+    int first = ranges[i].first, num = ranges[i].second;
+    for(i++; i < ranges.size() && ranges[i].first == first + num; i++)
+      num += ranges[i].second;
+    glDrawArrays(type, first, num);
+  }
+  disableVertexArray();
+}
+
+void drawVertexArray(drawContext *ctx, VertexArray *va, GLenum type,
+                     bool normals, bool colors, double pixels)
+{
+  if(!va || !va->getNumVertices()) return;
+
+  if(!va->getNumClusters() || ctx->render_mode != drawContext::GMSH_RENDER) {
+    enableVertexArray(ctx, va, normals, colors);
+    glDrawArrays(type, 0, va->getNumVertices());
+    disableVertexArray();
+    return;
+  }
+
+  // current projection * modelview matrix (column-major) and clipping planes
+  double mv[16], pr[16], m[16];
+  glGetDoublev(GL_MODELVIEW_MATRIX, mv);
+  glGetDoublev(GL_PROJECTION_MATRIX, pr);
+  for(int i = 0; i < 4; i++) {
+    for(int j = 0; j < 4; j++) {
+      m[4 * j + i] = 0.;
+      for(int k = 0; k < 4; k++) m[4 * j + i] += pr[4 * k + i] * mv[4 * j + k];
+    }
+  }
+  std::vector<int> planes;
+  for(int i = 0; i < 6; i++)
+    if(glIsEnabled((GLenum)(GL_CLIP_PLANE0 + i))) planes.push_back(i);
+
+  std::vector<std::pair<int, int> > full, simplified;
+  for(int c = 0; c < va->getNumClusters(); c++) {
+    const VertexArrayCluster &cl = va->getCluster(c);
+    SPoint3 pmin = cl.bbox.min(), pmax = cl.bbox.max();
+    // number of corners of the bounding box outside of each side of the view
+    // volume, and on the negative side of each clipping plane
+    int out[6] = {0, 0, 0, 0, 0, 0}, clipped[6] = {0, 0, 0, 0, 0, 0};
+    bool behind = false;
+    double xmin = 1., xmax = -1., ymin = 1., ymax = -1.;
+    for(int k = 0; k < 8; k++) {
+      double p[3] = {(k & 1) ? pmax.x() : pmin.x(),
+                     (k & 2) ? pmax.y() : pmin.y(),
+                     (k & 4) ? pmax.z() : pmin.z()};
+      double q[4];
+      for(int i = 0; i < 4; i++)
+        q[i] = m[i] * p[0] + m[4 + i] * p[1] + m[8 + i] * p[2] + m[12 + i];
+      for(int i = 0; i < 3; i++) {
+        if(q[i] < -q[3]) out[2 * i]++;
+        if(q[i] > q[3]) out[2 * i + 1]++;
+      }
+      if(q[3] <= 0.)
+        behind = true;
+      else {
+        xmin = std::min(xmin, q[0] / q[3]);
+        xmax = std::max(xmax, q[0] / q[3]);
+        ymin = std::min(ymin, q[1] / q[3]);
+        ymax = std::max(ymax, q[1] / q[3]);
+      }
+      for(std::size_t i = 0; i < planes.size(); i++) {
+        double *eq = CTX::instance()->clipPlane[planes[i]];
+        if(eq[0] * p[0] + eq[1] * p[1] + eq[2] * p[2] + eq[3] < 0.)
+          clipped[i]++;
+      }
+    }
+    bool skip = false;
+    for(int i = 0; i < 6; i++)
+      if(out[i] == 8 || clipped[i] == 8) skip = true;
+    if(skip) continue;
+
+    // size of the simplification cells on the screen
+    double size = std::max(pmax.x() - pmin.x(),
+                           std::max(pmax.y() - pmin.y(), pmax.z() - pmin.z()));
+    bool coarse = false;
+    if(pixels > 0. && !behind && size > 0. && cl.simplifiedNum) {
+      double s = std::max(0.5 * (xmax - xmin) * ctx->viewport[2],
+                          0.5 * (ymax - ymin) * ctx->viewport[3]);
+      coarse = (s * cl.cellSize / size < pixels);
+    }
+    if(coarse)
+      simplified.push_back(std::make_pair(cl.simplifiedFirst, cl.simplifiedNum));
+    else
+      full.push_back(std::make_pair(cl.first, cl.num));
+  }
+
+  drawRanges(ctx, va, type, normals, colors, full);
+  drawRanges(ctx, va->getSimplifiedArray(), type, normals, colors, simplified);
+}
+
+void invalidateVertexBuffers()
+{
+  bufferGeneration++;
+  std::lock_guard<std::mutex> lock(releasedMutex);
+  released.clear();
+}
@@ -0,0 +1,35 @@
+// Gmsh - Copyright (C) 1997-2024 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef DRAW_VERTEX_ARRAY_H
+#define DRAW_VERTEX_ARRAY_H
+
+#include "drawContext.h"
+
+class VertexArray;
+
+// Enable the vertex (and optionally normal and color) arrays of 'va' for
+// glDrawArrays(). When vertex buffer objects are available (see the
+// General.VertexBuffers option), the arrays are copied in graphics memory the
+// first time they are drawn, and only uploaded again when they change (only
+// the colors are uploaded if only the colors changed). Otherwise the arrays
+// are read from client memory at each frame.
+void enableVertexArray(drawContext *ctx, VertexArray *va, bool normals,
+                       bool colors);
+
+// Disable the arrays enabled by enableVertexArray()
+void disableVertexArray();
+
+// Draw the elements of 'va'. If the vertex array is split in clusters (see
+// VertexArray::buildClusters()), the clusters outside of the view volume or
+// clipped away are skipped, and the clusters whose details are smaller than
+// 'pixels' on the screen are drawn with their simplified representation.
+void drawVertexArray(drawContext *ctx, VertexArray *va, GLenum type,
+                     bool normals, bool colors, double pixels = 0.);
+
+// Forget all the buffer objects, e.g. when the OpenGL context is destroyed
+void invalidateVertexBuffers();
+
+#endif
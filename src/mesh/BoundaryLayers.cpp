@@ -47,6 +47,9 @@ static void addExtrudeNormals(std::vector<T *> &elements, int invert,
     return;
   }
 
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
   if(octree && !gouraud) { // get extrusion direction from post-processing view
     std::set<MVertex *> verts;
     for(std::size_t i = 0; i < elements.size(); i++) {
@@ -70,16 +73,27 @@ static void addExtrudeNormals(std::vector<T *> &elements, int invert,
         }
       }
     }
-    for(auto it = verts.begin(); it != verts.end(); it++) {
-      MVertex *v = *it;
-      double nn[3] = {0., 0., 0.};
+    // search the view at all the nodes concurrently (the first search is done
+    // alone, as it builds the octree of model-based views)
+    std::vector<MVertex *> vv(verts.begin(), verts.end());
+    std::vector<double> nn(3 * vv.size(), 0.);
 #if defined(HAVE_POST)
-      octree->searchVector(v->x(), v->y(), v->z(), nn, 0);
+    if(vv.size())
+      octree->searchVector(vv[0]->x(), vv[0]->y(), vv[0]->z(), &nn[0], 0);
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
+    for(std::size_t i = 1; i < vv.size(); i++)
+      octree->searchVector(vv[i]->x(), vv[i]->y(), vv[i]->z(), &nn[3 * i], 0);
 #endif
-      ExtrudeParams::normals[index]->add(v->x(), v->y(), v->z(), 3, nn);
-    }
+    for(std::size_t i = 0; i < vv.size(); i++)
+      ExtrudeParams::normals[index]->add(vv[i]->x(), vv[i]->y(), vv[i]->z(), 3,
+                                         &nn[3 * i]);
   }
   else { // get extrusion direction from Gouraud-shaded element normals
+    // compute the element normals and the angles at their nodes concurrently,
+    // then accumulate them at the nodes in the original order
+    std::vector<SVector3> normals(elements.size());
+    std::vector<std::vector<double> > angles(elements.size());
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
     for(std::size_t i = 0; i < elements.size(); i++) {
       MElement *ele = elements[i];
       SVector3 n(0, 0, 0);
@@ -88,12 +102,22 @@ static void addExtrudeNormals(std::vector<T *> &elements, int invert,
       else if(ele->getDim() == 1) // FIXME: generalize this!
         n = crossprod(ele->getEdge(0).tangent(), SVector3(0., 0., 1.));
       if(invert) n *= -1.;
+      normals[i] = n;
+      if(!ExtrudeParams::calcLayerScaleFactor[index] && ele->getDim() == 2) {
+        angles[i].resize(ele->getNumVertices());
+        for(std::size_t k = 0; k < ele->getNumVertices(); k++)
+          angles[i][k] = ele->getAngleAtVertex(ele->getVertex(k));
+      }
+    }
+    for(std::size_t i = 0; i < elements.size(); i++) {
+      MElement *ele = elements[i];
+      SVector3 &n = normals[i];
       if(!ExtrudeParams::calcLayerScaleFactor[index]) {
         for(std::size_t k = 0; k < ele->getNumVertices(); k++) {
           MVertex *v = ele->getVertex(k);
           SVector3 nk = n;
           if(ele->getDim() == 2) { // scale by angle at vertex
-            double fact = ele->getAngleAtVertex(v) * 2 / M_PI;
+            double fact = angles[i][k] * 2 / M_PI;
             if(fact > 0) nk *= fact;
             else Msg::Warning("Ignoring invalid angle scaling %g", fact);
           }
@@ -137,6 +161,8 @@ static void addExtrudeNormals(std::set<T *> &entities,
                               std::map<int, bool> &skipScaleCalcMap)
 {
   bool normalize = true, special3dbox = false, extrudeField = false;
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
 #if defined(HAVE_POST)
   std::vector<PViewData *> datas;
 #endif
@@ -215,26 +241,40 @@ static void addExtrudeNormals(std::set<T *> &entities,
           }
         }
       }
-      if(extrudeField) { // force normals according to field
-        for(auto it = ExtrudeParams::normals[i]->begin();
-            it != ExtrudeParams::normals[i]->end(); it++) {
-          GEntity *ge = (GEntity *)(*entities.begin());
-          FieldManager *fields = ge->model()->getFields();
-          if(fields->getBackgroundField() > 0) {
-            Field *f = fields->get(fields->getBackgroundField());
-            double radius = (*f)(it->x, it->y, it->z);
-            for(int k = 0; k < 3; k++) it->vals[k] *= radius;
+      // evaluate the field and search the views at the nodes concurrently
+      std::vector<smooth_data::iter> nodes;
+      for(auto it = ExtrudeParams::normals[i]->begin();
+          it != ExtrudeParams::normals[i]->end(); it++)
+        nodes.push_back(it);
+      if(extrudeField && nodes.size()) { // force normals according to field
+        GEntity *ge = (GEntity *)(*entities.begin());
+        FieldManager *fields = ge->model()->getFields();
+        if(fields->getBackgroundField() > 0) {
+          Field *f = fields->get(fields->getBackgroundField());
+          // the first evaluation is done alone, as it can update the field
+          double radius = (*f)(nodes[0]->x, nodes[0]->y, nodes[0]->z);
+          for(int k = 0; k < 3; k++) nodes[0]->vals[k] *= radius;
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
+          for(std::size_t j = 1; j < nodes.size(); j++) {
+            double r = (*f)(nodes[j]->x, nodes[j]->y, nodes[j]->z);
+            for(int k = 0; k < 3; k++) nodes[j]->vals[k] *= r;
           }
         }
       }
 #if defined(HAVE_POST)
-      if(datas.size()) { // scale normals by scalar views
-        for(auto it = ExtrudeParams::normals[i]->begin();
-            it != ExtrudeParams::normals[i]->end(); it++) {
+      if(datas.size() && nodes.size()) { // scale normals by scalar views
+        // build the octrees of the views before the concurrent searches
+        for(std::size_t j = 0; j < datas.size(); j++) {
+          double d;
+          datas[j]->searchScalar(nodes[0]->x, nodes[0]->y, nodes[0]->z, &d, 0);
+        }
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
+        for(std::size_t l = 0; l < nodes.size(); l++) {
           for(std::size_t j = 0; j < datas.size(); j++) {
             double d, dist = -1.;
-            if(datas[j]->searchScalarClosest(it->x, it->y, it->z, dist, &d, 0)) {
-              for(int k = 0; k < 3; k++) it->vals[k] *= d;
+            if(datas[j]->searchScalarClosest(nodes[l]->x, nodes[l]->y,
+                                             nodes[l]->z, dist, &d, 0)) {
+              for(int k = 0; k < 3; k++) nodes[l]->vals[k] *= d;
               break;
             }
           }
@@ -41,6 +41,7 @@
 #include "meshQuadQuasiStructured.h"
 #include "meshGFaceBipartiteLabelling.h"
 #include "sizeField.h"
+#include "GModelIO_MSH4.h"
 
 #include "meshCombine3D.h"
 
@@ -327,7 +328,8 @@ static void GetQualityFast(GModel *m, int dim, double &qmin, double &qavg)
   qavg = qa;
 }
 
-static void CheckEmptyMesh(GModel *m, int dim)
+static void CheckEmptyMesh(GModel *m, int dim,
+                           MSH4StreamWriter *stream = nullptr)
 {
   std::vector<int> tags;
   std::vector<GEntity *> entities;
@@ -336,6 +338,9 @@ static void CheckEmptyMesh(GModel *m, int dim)
     if(CTX::instance()->mesh.meshOnlyVisible && !ge->getVisibility()) {
       continue;
     }
+    else if(stream && stream->written(ge)) {
+      continue;
+    }
     else if(dim == 1) {
       if(ge->geomType() == GEntity::BoundaryLayerCurve || ge->degenerate(0))
         continue;
@@ -734,7 +739,117 @@ static void TestConformity(GModel *gm)
 #endif
 
 
-static void Mesh3D(GModel *m)
+// Write the mesh of the regions that are completely meshed to the stream
+// (after optimizing it, as this cannot be done globally afterwards), as well as
+// the mesh of the surfaces whose adjacent regions have all been written, and
+// delete it.
+static void StreamMesh3D(GModel *m, std::vector<GRegion *> &regions,
+                         MSH4StreamWriter *stream)
+{
+  bool optimize = (CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
+                   CTX::instance()->mesh.algo3d != ALGO_3D_HXT);
+  for(auto gr : regions) {
+    if(stream->written(gr)) continue;
+    for(std::size_t i = 0; i < gr->getNumMeshElements(); i++)
+      gr->getMeshElement(i)->setVolumePositive();
+    if(optimize && gr->tetrahedra.size()) {
+      for(int i = 0; i < CTX::instance()->mesh.optimize; i++) {
+        optimizeMeshGRegion opt;
+        opt(gr);
+      }
+      for(std::size_t i = 0; i < gr->getNumMeshElements(); i++)
+        gr->getMeshElement(i)->setVolumePositive();
+    }
+    stream->write(gr);
+  }
+
+  // periodic and embedded surfaces are kept until the end
+  std::set<GFace *> keep;
+  for(auto gf : m->getFaces()) {
+    if(gf->getMeshMaster() != gf) {
+      keep.insert(gf);
+      keep.insert(dynamic_cast<GFace *>(gf->getMeshMaster()));
+    }
+  }
+  for(auto gr : m->getRegions()) {
+    std::vector<GFace *> const &ef = gr->embeddedFaces();
+    keep.insert(ef.begin(), ef.end());
+  }
+  for(auto gf : m->getFaces()) {
+    if(stream->written(gf) || keep.count(gf)) continue;
+    std::list<GRegion *> r = gf->regions();
+    if(r.empty()) continue;
+    bool done = true;
+    for(auto gr : r) {
+      if(!stream->written(gr)) {
+        done = false;
+        break;
+      }
+    }
+    if(done) {
+      orientMeshGFace o;
+      o(gf);
+      stream->write(gf);
+    }
+  }
+}
+
+// Mesh the transfinite volumes concurrently: they only depend on the mesh of
+// their bounding surfaces. Their nodes and elements are then renumbered as if
+// they had been meshed sequentially, i.e. in the order of meshGRegion.
+static void MeshTransfiniteVolumes(GModel *m, std::map<GRegion *, int> &meshed)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads3D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads3D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // the frontal algorithm also creates nodes in meshGRegion: keep everything
+  // sequential so that the numbering is not modified
+  if(nthreads < 2 || CTX::instance()->mesh.algo3d == ALGO_3D_FRONTAL) return;
+
+  std::vector<GRegion *> regions;
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+    GRegion *gr = *it;
+    if(gr->isFullyDiscrete()) continue;
+    if(gr->meshAttributes.method != MESH_TRANSFINITE) continue;
+    if(CTX::instance()->mesh.meshOnlyVisible && !gr->getVisibility()) continue;
+    if(CTX::instance()->mesh.meshOnlyEmpty && gr->getNumMeshElements())
+      continue;
+    ExtrudeParams *ep = gr->meshAttributes.extrude;
+    if(ep && ep->mesh.ExtrudeMesh) continue;
+    // QuadTri subdivisions are not thread-safe
+    if(gr->meshAttributes.QuadTri) continue;
+    regions.push_back(gr);
+  }
+  if(regions.size() < 2) return;
+
+  // destroying the meshes also destroys the global mesh caches
+  deMeshGRegion dem;
+  for(std::size_t i = 0; i < regions.size(); i++) dem(regions[i]);
+
+  std::size_t numVertices = m->getMaxVertexNumber();
+  std::size_t numElements = m->getMaxElementNumber();
+  std::vector<int> ok(regions.size(), 0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < regions.size(); i++) {
+    regions[i]->model()->setCurrentMeshEntity(regions[i]);
+    ok[i] = MeshTransfiniteVolume(regions[i]);
+  }
+
+  for(std::size_t i = 0; i < regions.size(); i++) {
+    GRegion *gr = regions[i];
+    for(auto v : gr->mesh_vertices) v->forceNum(++numVertices);
+    // the prisms of 5-sided volumes are created before their hexahedra, and
+    // the other elements types are not mixed
+    for(auto e : gr->prisms) e->forceNum(++numElements);
+    for(auto e : gr->hexahedra) e->forceNum(++numElements);
+    for(auto e : gr->tetrahedra) e->forceNum(++numElements);
+    meshed[gr] = ok[i];
+  }
+}
+
+static void Mesh3D(GModel *m, MSH4StreamWriter *stream = nullptr)
 {
   if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return;
 
@@ -755,9 +870,20 @@ static void Mesh3D(GModel *m)
   // global operation, which can require changing the surface mesh!)
   SubdivideExtrudedMesh(m);
 
-  // then mesh all the non-delaunay regions (front3D with netgen)
+  // then mesh all the non-delaunay regions (front3D with netgen); volumes
+  // that could not be meshed with the transfinite algorithm are meshed with
+  // the Delaunay algorithm
   std::vector<GRegion *> delaunay;
-  std::for_each(m->firstRegion(), m->lastRegion(), meshGRegion(delaunay));
+  std::map<GRegion *, int> transfinite;
+  MeshTransfiniteVolumes(m, transfinite);
+  meshGRegion mr(delaunay);
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+    auto tf = transfinite.find(*it);
+    if(tf == transfinite.end())
+      mr(*it);
+    else if(!tf->second)
+      delaunay.push_back(*it);
+  }
 
   // and finally mesh the delaunay regions (again, this is global; but
   // we mesh each connected part separately for performance and mesh
@@ -778,13 +904,16 @@ static void Mesh3D(GModel *m)
     }
   }
 
+  std::vector<delaunayBoundaryRecovery> recoveries;
+  RecoverDelaunayVolumeBoundaries(connected, recoveries);
+
   for(std::size_t i = 0; i < connected.size(); i++) {
     if(CTX::instance()->abortOnError && Msg::GetErrorCount()) {
       Msg::Warning("Aborted 3D meshing");
       break;
     }
 
-    MeshDelaunayVolume(connected[i]);
+    MeshDelaunayVolume(connected[i], &recoveries[i]);
 
 #if defined(HAVE_DOMHEX) and defined(HAVE_HXT)
     // additional code for experimental hex mesh - will eventually be replaced
@@ -811,12 +940,20 @@ static void Mesh3D(GModel *m)
       }
     }
 #endif
+
+    if(stream) StreamMesh3D(m, connected[i], stream);
   }
 
   MakeHybridHexTetMeshConformalThroughTriHedron(m);
   // ensure that all volume Jacobians are positive
   m->setAllVolumesPositive();
 
+  // stream the extruded and non-delaunay regions
+  if(stream) {
+    std::vector<GRegion *> regions(m->firstRegion(), m->lastRegion());
+    StreamMesh3D(m, regions, stream);
+  }
+
   if(Msg::GetVerbosity() > 98)
     std::for_each(m->firstRegion(), m->lastRegion(),
                   EmbeddedCompatibilityTest());
@@ -826,7 +963,7 @@ static void Mesh3D(GModel *m)
     Msg::StopProgressMeter();
   }
 
-  CheckEmptyMesh(m, 3);
+  CheckEmptyMesh(m, 3, stream);
   double t2 = Cpu(), w2 = TimeOfDay();
   CTX::instance()->mesh.timer[2] = w2 - w1;
   Msg::StatusBar(true, "Done meshing 3D (Wall %gs, CPU %gs)",
@@ -1372,6 +1509,183 @@ void FixPeriodicMesh(GModel *m)
 
 //#include <google/profiler.h>
 
+// Check if the mesh of an entity is empty, while it should not be
+static bool IsMeshMissing(GEntity *ge)
+{
+  if(CTX::instance()->mesh.meshOnlyVisible && !ge->getVisibility())
+    return false;
+  switch(ge->dim()) {
+  case 0: return ge->mesh_vertices.empty();
+  case 1: {
+    GEdge *ed = static_cast<GEdge *>(ge);
+    return !ed->getNumMeshElements() && !ed->degenerate(0) &&
+           ed->meshAttributes.method != MESH_NONE &&
+           ed->geomType() != GEntity::BoundaryLayerCurve;
+  }
+  case 2: {
+    GFace *gf = static_cast<GFace *>(ge);
+    return !gf->getNumMeshElements() && gf->meshAttributes.method != MESH_NONE;
+  }
+  case 3: {
+    GRegion *gr = static_cast<GRegion *>(ge);
+    return !gr->getNumMeshElements() && gr->meshAttributes.method != MESH_NONE;
+  }
+  default: return false;
+  }
+}
+
+// Check if the mesh nodes of a point, a curve or a surface still lie on its
+// geometry
+static bool IsMeshOnGeometry(GEntity *ge, double tol, int nthreads)
+{
+  if(ge->dim() > 2 || !ge->haveParametrization()) return true;
+  std::size_t n = ge->mesh_vertices.size(), off = 0;
+#pragma omp parallel for reduction(+ : off) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    MVertex *v = ge->mesh_vertices[i];
+    GPoint p;
+    double u, w;
+    if(ge->dim() == 0) {
+      GVertex *gv = static_cast<GVertex *>(ge);
+      p = GPoint(gv->x(), gv->y(), gv->z());
+    }
+    else if(ge->dim() == 1 && v->getParameter(0, u)) {
+      p = static_cast<GEdge *>(ge)->point(u);
+    }
+    else if(ge->dim() == 2 && v->getParameter(0, u) && v->getParameter(1, w)) {
+      p = static_cast<GFace *>(ge)->point(u, w);
+    }
+    else
+      continue;
+    if(v->point().distance(SPoint3(p.x(), p.y(), p.z())) > tol) off++;
+  }
+  return off == 0;
+}
+
+// Delete the mesh of the entities that must be remeshed in incremental mesh
+// generation, i.e. the entities whose mesh is missing or outdated, or does not
+// lie on their geometry anymore (e.g. because the geometry has been modified),
+// as well as the entities whose mesh depends on them (the entities that they
+// bound, in which they are embedded, of which they are the periodic master or
+// which are extruded or copied from them)
+static void DeleteOutdatedMeshes(GModel *m)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  double tol = 1.e-6 * CTX::instance()->lc;
+
+  std::vector<GEntity *> entities;
+  m->getEntities(entities);
+  std::set<GEntity *> outdated;
+  for(auto ge : entities) {
+    if(ge->isFullyDiscrete()) continue;
+    if(ge->getMeshOutdated() || IsMeshMissing(ge) ||
+       !IsMeshOnGeometry(ge, tol, nthreads))
+      outdated.insert(ge);
+  }
+
+  for(int dim = 1; dim <= 3; dim++) {
+    bool changed = true;
+    while(changed) { // iterate for chains of periodic entities
+      changed = false;
+      for(auto ge : entities) {
+        if(ge->dim() != dim || ge->isFullyDiscrete() || outdated.count(ge))
+          continue;
+        std::vector<GEntity *> dep;
+        if(ge->getMeshMaster() != ge) dep.push_back(ge->getMeshMaster());
+        ExtrudeParams *ep = nullptr;
+        if(dim == 1) {
+          GEdge *ed = static_cast<GEdge *>(ge);
+          ep = ed->meshAttributes.extrude;
+          if(ed->getBeginVertex()) dep.push_back(ed->getBeginVertex());
+          if(ed->getEndVertex()) dep.push_back(ed->getEndVertex());
+        }
+        else if(dim == 2) {
+          GFace *gf = static_cast<GFace *>(ge);
+          ep = gf->meshAttributes.extrude;
+          dep.insert(dep.end(), gf->edges().begin(), gf->edges().end());
+          dep.insert(dep.end(), gf->embeddedEdges().begin(),
+                     gf->embeddedEdges().end());
+          dep.insert(dep.end(), gf->embeddedVertices().begin(),
+                     gf->embeddedVertices().end());
+        }
+        else {
+          GRegion *gr = static_cast<GRegion *>(ge);
+          ep = gr->meshAttributes.extrude;
+          std::vector<GFace *> faces = gr->faces(); // returned by value
+          dep.insert(dep.end(), faces.begin(), faces.end());
+          dep.insert(dep.end(), gr->embeddedFaces().begin(),
+                     gr->embeddedFaces().end());
+          dep.insert(dep.end(), gr->embeddedEdges().begin(),
+                     gr->embeddedEdges().end());
+          dep.insert(dep.end(), gr->embeddedVertices().begin(),
+                     gr->embeddedVertices().end());
+        }
+        // extruded meshes are built from the mesh of their source entity,
+        // which is of the same dimension for the copied (top) entities
+        if(ep && ep->mesh.ExtrudeMesh) {
+          int sdim = (ep->geo.Mode == COPIED_ENTITY) ? dim : dim - 1;
+          GEntity *src = m->getEntityByTag(sdim, std::abs(ep->geo.Source));
+          if(src) dep.push_back(src);
+        }
+        for(auto d : dep) {
+          if(outdated.count(d)) {
+            outdated.insert(ge);
+            changed = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  // delete the meshes, highest dimensional entities first
+  std::vector<GEntity *> toDelete;
+  for(int dim = 3; dim >= 0; dim--) {
+    for(auto ge : entities) {
+      if(ge->dim() == dim && outdated.count(ge)) toDelete.push_back(ge);
+    }
+  }
+  Msg::Info("Incremental meshing: regenerating the mesh of %lu entit%s "
+            "(out of %lu)",
+            toDelete.size(), toDelete.size() > 1 ? "ies" : "y",
+            entities.size());
+  if(toDelete.size()) m->deleteMesh(toDelete);
+}
+
+// Optimize the 3D mesh of the given regions only: in incremental mesh
+// generation, the mesh of the regions that have not been remeshed is left
+// untouched
+static void OptimizeMeshRegions(GModel *m,
+                                const std::vector<GRegion *> &regions,
+                                const std::string &how)
+{
+  if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return;
+  if(regions.empty()) return;
+
+  if(how == "Netgen")
+    Msg::StatusBar(true, "Optimizing mesh (%s)...", how.c_str());
+  else
+    Msg::StatusBar(true, "Optimizing mesh...");
+  double t1 = Cpu(), w1 = TimeOfDay();
+
+  for(auto gr : regions) {
+    if(how == "Netgen") {
+      optimizeMeshGRegionNetgen opt;
+      opt(gr);
+    }
+    else {
+      optimizeMeshGRegion opt;
+      opt(gr);
+    }
+  }
+  m->setAllVolumesPositive();
+
+  double t2 = Cpu(), w2 = TimeOfDay();
+  Msg::StatusBar(true, "Done optimizing mesh (Wall %gs, CPU %gs)",
+                 w2 - w1, t2 - t1);
+}
+
 void GenerateMesh(GModel *m, int ask)
 {
   // ProfilerStart("gmsh.prof");
@@ -1448,25 +1762,77 @@ void GenerateMesh(GModel *m, int ask)
   // dimension of previous/existing mesh
   int old = m->getMeshStatus(false);
 
-  // 1D mesh
-  if(ask == 1 || (ask > 1 && old < 1)) {
-    std::for_each(m->firstRegion(), m->lastRegion(), deMeshGRegion());
-    std::for_each(m->firstFace(), m->lastFace(), deMeshGFace());
+  // in incremental mode, only mesh the entities whose mesh is missing or has
+  // been deleted because it was outdated
+  int meshOnlyEmpty = CTX::instance()->mesh.meshOnlyEmpty;
+  bool incremental = CTX::instance()->mesh.incremental && ask >= 1 && !qqs;
+  if(incremental && (CTX::instance()->mesh.algoSubdivide ||
+                     CTX::instance()->mesh.order > 1)) {
+    // subdivision and high-order meshing are applied to the whole mesh
+    Msg::Warning("Incremental meshing is not available with mesh subdivision "
+                 "or high-order meshing: ignoring Mesh.Incremental");
+    incremental = false;
+  }
+  int minDim = 0; // lowest dimension of the entities that are remeshed
+  std::vector<GRegion *> remeshedRegions;
+  if(incremental) {
+    DeleteOutdatedMeshes(m);
+    for(GRegion *gr : m->getRegions())
+      if(IsMeshMissing(gr)) remeshedRegions.push_back(gr);
+    CTX::instance()->mesh.meshOnlyEmpty = 1;
     Mesh0D(m);
     Mesh1D(m);
+    if(ask >= 2) Mesh2D(m);
   }
+  else {
+    minDim = ask;
+    // 1D mesh
+    if(ask == 1 || (ask > 1 && old < 1)) {
+      std::for_each(m->firstRegion(), m->lastRegion(), deMeshGRegion());
+      std::for_each(m->firstFace(), m->lastFace(), deMeshGFace());
+      Mesh0D(m);
+      Mesh1D(m);
+      minDim = 0;
+    }
 
-  // 2D mesh
-  if(ask == 2 || (ask > 2 && old < 2)) {
-    std::for_each(m->firstRegion(), m->lastRegion(), deMeshGRegion());
-    Mesh2D(m);
-    // if two passes --> juste fait le ...
-    //    createSizeFieldFromExistingMesh (m, false);
-    // Mesh2D(m);
+    // 2D mesh
+    if(ask == 2 || (ask > 2 && old < 2)) {
+      std::for_each(m->firstRegion(), m->lastRegion(), deMeshGRegion());
+      Mesh2D(m);
+      // if two passes --> juste fait le ...
+      //    createSizeFieldFromExistingMesh (m, false);
+      // Mesh2D(m);
+      minDim = std::min(minDim, 2);
+    }
   }
 
-  // 3D mesh
-  if(ask == 3) { Mesh3D(m); }
+  // 3D mesh, possibly streamed to disk as it is generated
+  MSH4StreamWriter *stream = nullptr;
+  if(ask == 3 && !CTX::instance()->mesh.streamFileName.empty()) {
+    if(CTX::instance()->mesh.optimizeNetgen ||
+       CTX::instance()->mesh.algoSubdivide || CTX::instance()->mesh.order > 1)
+      Msg::Warning("Mesh subdivision, high-order meshing and Netgen "
+                   "optimization are not available when streaming the mesh");
+    stream = new MSH4StreamWriter(m, CTX::instance()->mesh.streamFileName,
+                                  CTX::instance()->mesh.binary,
+                                  CTX::instance()->mesh.saveAll,
+                                  CTX::instance()->mesh.scalingFactor);
+    if(!stream->ok()) {
+      delete stream;
+      stream = nullptr;
+    }
+  }
+  if(ask == 3) { Mesh3D(m, stream); }
+
+  // the mesh of the entities that have been (re)meshed is now up-to-date
+  CTX::instance()->mesh.meshOnlyEmpty = meshOnlyEmpty;
+  if(ask >= 1) {
+    std::vector<GEntity *> entities;
+    m->getEntities(entities);
+    for(auto ge : entities) {
+      if(ge->dim() >= minDim && ge->dim() <= ask) ge->setMeshOutdated(false);
+    }
+  }
 
   // Orient the line and surface meshes so that they match the orientation of
   // the geometrical entities and/or the user orientation constraints
@@ -1475,27 +1841,37 @@ void GenerateMesh(GModel *m, int ask)
   if(m->getMeshStatus() >= 2)
     std::for_each(m->firstFace(), m->lastFace(), orientMeshGFace());
 
-  // Optimize quality of 3D tet mesh
-  if(m->getMeshStatus() == 3 &&
+  // Optimize quality of 3D tet mesh (when streaming, each region has already
+  // been optimized before being written)
+  if(!stream && m->getMeshStatus() == 3 &&
      CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
      CTX::instance()->mesh.algo3d != ALGO_3D_HXT) {
     for(int i = 0; i < std::max(CTX::instance()->mesh.optimize,
                                 CTX::instance()->mesh.optimizeNetgen);
         i++) {
+      if(incremental) {
+        if(CTX::instance()->mesh.optimize > i)
+          OptimizeMeshRegions(m, remeshedRegions, "");
+        if(CTX::instance()->mesh.optimizeNetgen > i)
+          OptimizeMeshRegions(m, remeshedRegions, "Netgen");
+        continue;
+      }
       if(CTX::instance()->mesh.optimize > i) OptimizeMesh(m);
       if(CTX::instance()->mesh.optimizeNetgen > i) OptimizeMesh(m, "Netgen");
     }
   }
 
   // Subdivide into quads or hexas
-  if(m->getMeshStatus() == 2 && CTX::instance()->mesh.algoSubdivide == 1)
+  if(stream)
+    ; // the subdivision is global
+  else if(m->getMeshStatus() == 2 && CTX::instance()->mesh.algoSubdivide == 1)
     RefineMesh(m, CTX::instance()->mesh.secondOrderLinear, true);
   else if(m->getMeshStatus() == 3 && CTX::instance()->mesh.algoSubdivide == 2)
     RefineMesh(m, CTX::instance()->mesh.secondOrderLinear, false, true);
   else if(m->getMeshStatus() >= 2 && CTX::instance()->mesh.algoSubdivide == 3)
     BarycentricRefineMesh(m);
 
-  if(m->getMeshStatus() && CTX::instance()->mesh.order > 1) {
+  if(!stream && m->getMeshStatus() && CTX::instance()->mesh.order > 1) {
     // Create high order elements
     SetOrderN(m, CTX::instance()->mesh.order,
               CTX::instance()->mesh.secondOrderLinear,
@@ -1519,6 +1895,12 @@ void GenerateMesh(GModel *m, int ask)
   // correspondences
   FixPeriodicMesh(m);
 
+  // assemble the streamed mesh file
+  if(stream) {
+    stream->finalize();
+    delete stream;
+  }
+
   Msg::Info("%d nodes %d elements", m->getNumMeshVertices(),
             m->getNumMeshElements());
 
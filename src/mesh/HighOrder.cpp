@@ -396,121 +396,48 @@ inline static bool getMinMaxVert(MVertex *v0, MVertex *v1, MVertex *&vMin,
   return increasing;
 }
 
-// Get new interior vertices for a 1D element
-static void getEdgeVertices(GEdge *ge, MElement *ele,
-                            std::vector<MVertex *> &ve,
-                            edgeContainer &edgeVertices, bool linear,
-                            int nPts = 1)
+// Create the new high-order nodes on the i-th edge of a linear element of
+// entity ge, in the ordering of the edge in the element
+static void createEdgeVertices(GEntity *ge, MElement *ele, int i, bool linear,
+                               int nPts, std::vector<MVertex *> &veEdge)
 {
-  if(!ge->haveParametrization()) linear = true;
-
   std::vector<MVertex *> veOld;
-  ele->getVertices(veOld);
-  MVertex *vMin, *vMax;
-  const bool increasing = getMinMaxVert(veOld[0], veOld[1], vMin, vMax);
-  std::pair<MVertex *, MVertex *> p(vMin, vMax);
-
-  std::vector<MVertex *> veEdge;
-  // Get vertices on geometry if asked
-  bool gotVertOnGeo =
-    linear ? false : getEdgeVerticesOnGeo(ge, veOld[0], veOld[1], veEdge, nPts);
-  // If not on geometry, create from mesh interpolation
-  if(!gotVertOnGeo) interpVerticesInExistingEdge(ge, ele, veEdge, nPts);
-  if(edgeVertices.count(p) == 0) {
-    if(increasing) // Add newly created vertices to list
-      edgeVertices[p].insert(edgeVertices[p].end(), veEdge.begin(),
-                             veEdge.end());
-    else
-      edgeVertices[p].insert(edgeVertices[p].end(), veEdge.rbegin(),
-                             veEdge.rend());
+  ele->getEdgeVertices(i, veOld);
+  if(ge->dim() == 1) {
+    GEdge *ed = static_cast<GEdge *>(ge);
+    if(!ed->haveParametrization()) linear = true;
+    // Get vertices on geometry if asked
+    bool gotVertOnGeo =
+      linear ? false :
+               getEdgeVerticesOnGeo(ed, veOld[0], veOld[1], veEdge, nPts);
+    // If not on geometry, create from mesh interpolation
+    if(!gotVertOnGeo) interpVerticesInExistingEdge(ed, ele, veEdge, nPts);
   }
-  else if(p.first != p.second) {
-    // Vertices already exist and edge is not a degenerated edge
-    Msg::Error(
-      "Mesh edges from different curves share nodes: create a finer mesh "
-      "(curve involved: %d)",
-      ge->tag());
-  }
-  ve.insert(ve.end(), veEdge.begin(), veEdge.end());
-}
-
-// Get new interior vertices for an edge in a 2D element
-static void getEdgeVertices(GFace *gf, MElement *ele,
-                            std::vector<MVertex *> &ve,
-                            edgeContainer &edgeVertices, bool linear,
-                            int nPts = 1)
-{
-  if(!gf->haveParametrization()) linear = true;
-
-  for(int i = 0; i < ele->getNumEdges(); i++) {
-    std::vector<MVertex *> veOld;
-    ele->getEdgeVertices(i, veOld);
-    MVertex *vMin, *vMax;
-    const bool increasing = getMinMaxVert(veOld[0], veOld[1], vMin, vMax);
-    std::pair<MVertex *, MVertex *> p(vMin, vMax);
-    std::vector<MVertex *> veEdge;
-
-    auto eIter = edgeVertices.find(p);
-
-    if(eIter != edgeVertices.end()) { // Vertices already exist
-      std::vector<MVertex *> &eVtcs = eIter->second;
-      if(increasing)
-        veEdge.assign(eVtcs.begin(), eVtcs.end());
-      else
-        veEdge.assign(eVtcs.rbegin(), eVtcs.rend());
-    }
-    else { // Vertices do not exist, create them
-      // Get vertices on geometry if asked
-      bool gotVertOnGeo =
-        linear ? false :
-                 getEdgeVerticesOnGeo(gf, veOld[0], veOld[1], veEdge, nPts);
-      if(!gotVertOnGeo) {
-        // If not on geometry, create from mesh interpolation
-        const MLineN edgeEl(veOld, ele->getPolynomialOrder());
-        interpVerticesInExistingEdge(gf, &edgeEl, veEdge, nPts);
-      }
-
-      std::vector<MVertex *> &eVtcs = edgeVertices[p];
-
-      if(increasing) // Add newly created vertices to list
-        eVtcs.insert(eVtcs.end(), veEdge.begin(), veEdge.end());
-      else
-        eVtcs.insert(eVtcs.end(), veEdge.rbegin(), veEdge.rend());
+  else if(ge->dim() == 2) {
+    GFace *gf = static_cast<GFace *>(ge);
+    if(!gf->haveParametrization()) linear = true;
+    // Get vertices on geometry if asked
+    bool gotVertOnGeo =
+      linear ? false :
+               getEdgeVerticesOnGeo(gf, veOld[0], veOld[1], veEdge, nPts);
+    if(!gotVertOnGeo) {
+      // If not on geometry, create from mesh interpolation
+      const MLineN edgeEl(veOld, ele->getPolynomialOrder());
+      interpVerticesInExistingEdge(gf, &edgeEl, veEdge, nPts);
     }
-    ve.insert(ve.end(), veEdge.begin(), veEdge.end());
+  }
+  else {
+    const MLineN edgeEl(veOld, ele->getPolynomialOrder());
+    interpVerticesInExistingEdge(ge, &edgeEl, veEdge, nPts);
   }
 }
 
-// Get new interior vertices for an edge in a 3D element
-static void getEdgeVertices(GRegion *gr, MElement *ele,
-                            std::vector<MVertex *> &ve,
-                            edgeContainer &edgeVertices, int nPts = 1)
+// Check if the i-th edge of an element is oriented like its key (the pair of
+// nodes sorted by number) in the edge container
+inline static bool isEdgeIncreasing(MElement *ele, int i)
 {
-  for(int i = 0; i < ele->getNumEdges(); i++) {
-    std::vector<MVertex *> veOld;
-    ele->getEdgeVertices(i, veOld);
-    MVertex *vMin, *vMax;
-    const bool increasing = getMinMaxVert(veOld[0], veOld[1], vMin, vMax);
-    std::pair<MVertex *, MVertex *> p(vMin, vMax);
-    std::vector<MVertex *> veEdge;
-    if(edgeVertices.count(p)) { // Vertices already exist
-      if(increasing)
-        veEdge.assign(edgeVertices[p].begin(), edgeVertices[p].end());
-      else
-        veEdge.assign(edgeVertices[p].rbegin(), edgeVertices[p].rend());
-    }
-    else { // Vertices do not exist, create them
-      const MLineN edgeEl(veOld, ele->getPolynomialOrder());
-      interpVerticesInExistingEdge(gr, &edgeEl, veEdge, nPts);
-      if(increasing) // Add newly created vertices to list
-        edgeVertices[p].insert(edgeVertices[p].end(), veEdge.begin(),
-                               veEdge.end());
-      else
-        edgeVertices[p].insert(edgeVertices[p].end(), veEdge.rbegin(),
-                               veEdge.rend());
-    }
-    ve.insert(ve.end(), veEdge.begin(), veEdge.end());
-  }
+  MEdge edge = ele->getEdge(i);
+  return edge.getVertex(0)->getNum() < edge.getVertex(1)->getNum();
 }
 
 // Creation of high-order face vertices
@@ -753,8 +680,7 @@ static void getFaceVerticesOnGeo(GFace *gf,
 
 // Get new interior vertices for a 2D element
 static void getFaceVertices(GFace *gf, MElement *ele,
-                            std::vector<MVertex *> &newVertices,
-                            faceContainer &faceVertices, bool linear,
+                            std::vector<MVertex *> &newVertices, bool linear,
                             int nPts = 1)
 {
   if(!gf->haveParametrization()) linear = true;
@@ -783,10 +709,6 @@ static void getFaceVertices(GFace *gf, MElement *ele,
   else { // ... otherwise, create from mesh interpolation
     interpVerticesInExistingFace(gf, *coefficients, boundaryVertices, vFace);
   }
-
-  MFace face = ele->getFace(0);
-  faceVertices[face].insert(faceVertices[face].end(), vFace.begin(),
-                            vFace.end());
   newVertices.insert(newVertices.end(), vFace.begin(), vFace.end());
 }
 
@@ -855,48 +777,40 @@ static int retrieveFaceBoundaryVertices(int k, int type, int nPts,
   }
 }
 
-// Get new face (excluding edge) vertices for a face of a 3D element
-static void getFaceVertices(GRegion *gr, MElement *ele,
-                            std::vector<MVertex *> &newVertices,
-                            faceContainer &faceVertices, int nPts = 1)
+// Create the new (excluding edge) vertices of the i-th face of a 3D element,
+// given the new vertices on its edges
+static void createFaceVertices(GRegion *gr, MElement *ele, int i,
+                               const std::vector<MVertex *> &vCorner,
+                               const std::vector<MVertex *> &vEdges,
+                               std::vector<MVertex *> &vFace, int nPts = 1)
 {
-  std::vector<MVertex *> vCorner;
-  ele->getVertices(vCorner);
-  // NB: We can get more than corner vertices but we use only corners
-
-  for(int i = 0; i < ele->getNumFaces(); i++) {
-    MFace face = ele->getFace(i);
-    std::vector<MVertex *> vFace;
-    auto fIter = faceVertices.find(face);
-    if(fIter != faceVertices.end()) { // Vertices already exist
-      std::vector<MVertex *> vtcs = fIter->second;
-      int orientation;
-      bool swap;
-      if(fIter->first.computeCorrespondence(face, orientation, swap)) {
-        // Check correspondence and apply permutation if needed
-        if(face.getNumVertices() == 3 && nPts > 1)
-          reorientTrianglePoints(vtcs, orientation, swap);
-        else if(face.getNumVertices() == 4)
-          reorientQuadPoints(vtcs, orientation, swap, nPts - 1);
-      }
-      else
-        Msg::Error(
-          "Error in face lookup for retrieval of high order face nodes");
-      vFace.assign(vtcs.begin(), vtcs.end());
-    }
-    else { // Vertices do not exist, create them by interpolation
-      std::vector<MVertex *> faceBoundaryVertices;
-      int type = retrieveFaceBoundaryVertices(
-        i, ele->getType(), nPts, vCorner, newVertices, faceBoundaryVertices);
-      fullMatrix<double> *coefficients =
-        getInnerVertexPlacement(type, nPts + 1);
-      interpVerticesInExistingFace(gr, *coefficients, faceBoundaryVertices,
-                                   vFace);
-      faceVertices[face].insert(faceVertices[face].end(), vFace.begin(),
-                                vFace.end());
-    }
-    newVertices.insert(newVertices.end(), vFace.begin(), vFace.end());
+  std::vector<MVertex *> faceBoundaryVertices;
+  int type = retrieveFaceBoundaryVertices(i, ele->getType(), nPts, vCorner,
+                                          vEdges, faceBoundaryVertices);
+  fullMatrix<double> *coefficients = getInnerVertexPlacement(type, nPts + 1);
+  interpVerticesInExistingFace(gr, *coefficients, faceBoundaryVertices, vFace);
+}
+
+// Get the existing vertices of the i-th face of a 3D element, reoriented
+// according to the face of the element
+static void getFaceVertices(MElement *ele, int i,
+                            faceContainer::const_iterator fIter,
+                            std::vector<MVertex *> &vFace, int nPts = 1)
+{
+  MFace face = ele->getFace(i);
+  std::vector<MVertex *> vtcs = fIter->second;
+  int orientation;
+  bool swap;
+  if(fIter->first.computeCorrespondence(face, orientation, swap)) {
+    // Check correspondence and apply permutation if needed
+    if(face.getNumVertices() == 3 && nPts > 1)
+      reorientTrianglePoints(vtcs, orientation, swap);
+    else if(face.getNumVertices() == 4)
+      reorientQuadPoints(vtcs, orientation, swap, nPts - 1);
   }
+  else
+    Msg::Error("Error in face lookup for retrieval of high order face nodes");
+  vFace.insert(vFace.end(), vtcs.begin(), vtcs.end());
 }
 
 // Get new interior vertices for a 3D element
@@ -930,266 +844,360 @@ static void getVolumeVertices(GRegion *gr, MElement *ele,
 
 // Creation of high-order elements
 
-static void setHighOrder(GEdge *ge, edgeContainer &edgeVertices, bool linear,
-                         int nbPts = 1)
+// Check if high-order vertices are created on the faces of a 3D element (or in
+// the interior of a 2D element)
+static bool hasFaceVertices(int type, bool incomplete, int nPts)
 {
-  std::vector<MLine *> lines2;
-  for(std::size_t i = 0; i < ge->lines.size(); i++) {
-    MLine *l = ge->lines[i];
-    std::vector<MVertex *> ve;
-    getEdgeVertices(ge, l, ve, edgeVertices, linear, nbPts);
-    if(nbPts == 1)
-      lines2.push_back(
-        new MLine3(l->getVertex(0), l->getVertex(1), ve[0], l->getPartition()));
-    else
-      lines2.push_back(
-        new MLineN(l->getVertex(0), l->getVertex(1), ve, l->getPartition()));
-    delete l;
-  }
-  ge->lines = lines2;
-  ge->deleteVertexArrays();
+  if(incomplete) return false;
+  return (type != TYPE_TRI && type != TYPE_TET) || nPts > 1;
 }
 
-static MTriangle *setHighOrder(MTriangle *t, GFace *gf,
-                               edgeContainer &edgeVertices,
-                               faceContainer &faceVertices, bool linear,
-                               bool incomplete, int nPts)
+// Check if high-order vertices are created in the interior of a 3D element
+static bool hasVolumeVertices(int type, bool incomplete, int nPts)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gf, t, v, edgeVertices, linear, nPts);
-  if(nPts == 1) {
-    return new MTriangle6(t->getVertex(0), t->getVertex(1), t->getVertex(2),
-                          v[0], v[1], v[2], 0, t->getPartition());
-  }
-  else {
-    if(!incomplete) getFaceVertices(gf, t, v, faceVertices, linear, nPts);
-    return new MTriangleN(t->getVertex(0), t->getVertex(1), t->getVertex(2), v,
-                          nPts + 1, 0, t->getPartition());
-  }
+  if(incomplete) return false;
+  return type == TYPE_HEX || nPts > 1;
 }
 
-static MQuadrangle *setHighOrder(MQuadrangle *q, GFace *gf,
-                                 edgeContainer &edgeVertices,
-                                 faceContainer &faceVertices, bool linear,
-                                 bool incomplete, int nPts)
+static MElement *createHighOrderElement(MElement *e,
+                                        const std::vector<MVertex *> &v,
+                                        bool incomplete, int nPts,
+                                        std::size_t num)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gf, q, v, edgeVertices, linear, nPts);
-  if(incomplete) {
-    if(nPts == 1) {
-      return new MQuadrangle8(q->getVertex(0), q->getVertex(1), q->getVertex(2),
-                              q->getVertex(3), v[0], v[1], v[2], v[3], 0,
-                              q->getPartition());
-    }
-    else {
-      return new MQuadrangleN(q->getVertex(0), q->getVertex(1), q->getVertex(2),
-                              q->getVertex(3), v, nPts + 1, 0,
-                              q->getPartition());
-    }
-  }
-  else {
-    getFaceVertices(gf, q, v, faceVertices, linear, nPts);
-    if(nPts == 1) {
-      return new MQuadrangle9(q->getVertex(0), q->getVertex(1), q->getVertex(2),
-                              q->getVertex(3), v[0], v[1], v[2], v[3], v[4], 0,
-                              q->getPartition());
-    }
-    else {
-      return new MQuadrangleN(q->getVertex(0), q->getVertex(1), q->getVertex(2),
-                              q->getVertex(3), v, nPts + 1, 0,
-                              q->getPartition());
-    }
+  int part = e->getPartition();
+  switch(e->getType()) {
+  case TYPE_LIN:
+    if(nPts == 1)
+      return new MLine3(e->getVertex(0), e->getVertex(1), v[0], num, part);
+    else
+      return new MLineN(e->getVertex(0), e->getVertex(1), v, num, part);
+  case TYPE_TRI:
+    if(nPts == 1)
+      return new MTriangle6(e->getVertex(0), e->getVertex(1), e->getVertex(2),
+                            v[0], v[1], v[2], num, part);
+    else
+      return new MTriangleN(e->getVertex(0), e->getVertex(1), e->getVertex(2),
+                            v, nPts + 1, num, part);
+  case TYPE_QUA:
+    if(nPts == 1 && incomplete)
+      return new MQuadrangle8(e->getVertex(0), e->getVertex(1),
+                              e->getVertex(2), e->getVertex(3), v[0], v[1],
+                              v[2], v[3], num, part);
+    else if(nPts == 1)
+      return new MQuadrangle9(e->getVertex(0), e->getVertex(1),
+                              e->getVertex(2), e->getVertex(3), v[0], v[1],
+                              v[2], v[3], v[4], num, part);
+    else
+      return new MQuadrangleN(e->getVertex(0), e->getVertex(1),
+                              e->getVertex(2), e->getVertex(3), v, nPts + 1,
+                              num, part);
+  case TYPE_TET:
+    if(nPts == 1)
+      return new MTetrahedron10(e->getVertex(0), e->getVertex(1),
+                                e->getVertex(2), e->getVertex(3), v[0], v[1],
+                                v[2], v[3], v[4], v[5], num, part);
+    else
+      return new MTetrahedronN(e->getVertex(0), e->getVertex(1),
+                               e->getVertex(2), e->getVertex(3), v, nPts + 1,
+                               num, part);
+  case TYPE_HEX:
+    if(nPts == 1 && incomplete)
+      return new MHexahedron20(
+        e->getVertex(0), e->getVertex(1), e->getVertex(2), e->getVertex(3),
+        e->getVertex(4), e->getVertex(5), e->getVertex(6), e->getVertex(7),
+        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
+        v[11], num, part);
+    else if(nPts == 1)
+      return new MHexahedron27(
+        e->getVertex(0), e->getVertex(1), e->getVertex(2), e->getVertex(3),
+        e->getVertex(4), e->getVertex(5), e->getVertex(6), e->getVertex(7),
+        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
+        v[11], v[12], v[13], v[14], v[15], v[16], v[17], v[18], num, part);
+    else
+      return new MHexahedronN(e->getVertex(0), e->getVertex(1),
+                              e->getVertex(2), e->getVertex(3),
+                              e->getVertex(4), e->getVertex(5),
+                              e->getVertex(6), e->getVertex(7), v, nPts + 1,
+                              num, part);
+  case TYPE_PRI:
+    if(nPts == 1 && incomplete)
+      return new MPrism15(e->getVertex(0), e->getVertex(1), e->getVertex(2),
+                          e->getVertex(3), e->getVertex(4), e->getVertex(5),
+                          v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
+                          num, part);
+    else if(nPts == 1)
+      return new MPrism18(e->getVertex(0), e->getVertex(1), e->getVertex(2),
+                          e->getVertex(3), e->getVertex(4), e->getVertex(5),
+                          v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
+                          v[9], v[10], v[11], num, part);
+    else
+      return new MPrismN(e->getVertex(0), e->getVertex(1), e->getVertex(2),
+                         e->getVertex(3), e->getVertex(4), e->getVertex(5), v,
+                         nPts + 1, num, part);
+  case TYPE_PYR:
+    return new MPyramidN(e->getVertex(0), e->getVertex(1), e->getVertex(2),
+                         e->getVertex(3), e->getVertex(4), v, nPts + 1, num,
+                         part);
+  default: return nullptr;
   }
 }
 
-static void setHighOrder(GFace *gf, edgeContainer &edgeVertices,
-                         faceContainer &faceVertices, bool linear,
-                         bool incomplete, int nPts = 1)
+static void replaceElement(GEntity *ge, std::size_t i, MElement *e)
 {
-  std::vector<MTriangle *> triangles2;
-  for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-    MTriangle *t = gf->triangles[i];
-    MTriangle *tNew =
-      setHighOrder(t, gf, edgeVertices, faceVertices, linear, incomplete, nPts);
-    triangles2.push_back(tNew);
-    delete t;
-  }
-  gf->triangles = triangles2;
-
-  std::vector<MQuadrangle *> quadrangles2;
-  for(std::size_t i = 0; i < gf->quadrangles.size(); i++) {
-    MQuadrangle *q = gf->quadrangles[i];
-    MQuadrangle *qNew =
-      setHighOrder(q, gf, edgeVertices, faceVertices, linear, incomplete, nPts);
-    quadrangles2.push_back(qNew);
-    delete q;
+  switch(e->getType()) {
+  case TYPE_LIN:
+    static_cast<GEdge *>(ge)->lines[i] = static_cast<MLine *>(e);
+    break;
+  case TYPE_TRI:
+    static_cast<GFace *>(ge)->triangles[i] = static_cast<MTriangle *>(e);
+    break;
+  case TYPE_QUA:
+    static_cast<GFace *>(ge)->quadrangles[i] = static_cast<MQuadrangle *>(e);
+    break;
+  case TYPE_TET:
+    static_cast<GRegion *>(ge)->tetrahedra[i] = static_cast<MTetrahedron *>(e);
+    break;
+  case TYPE_HEX:
+    static_cast<GRegion *>(ge)->hexahedra[i] = static_cast<MHexahedron *>(e);
+    break;
+  case TYPE_PRI:
+    static_cast<GRegion *>(ge)->prisms[i] = static_cast<MPrism *>(e);
+    break;
+  case TYPE_PYR:
+    static_cast<GRegion *>(ge)->pyramids[i] = static_cast<MPyramid *>(e);
+    break;
   }
-  gf->quadrangles = quadrangles2;
-  gf->deleteVertexArrays();
 }
 
-static MTetrahedron *setHighOrder(MTetrahedron *t, GRegion *gr,
-                                  edgeContainer &edgeVertices,
-                                  faceContainer &faceVertices, bool incomplete,
-                                  int nPts)
-{
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, t, v, edgeVertices, nPts);
-  if(nPts == 1) {
-    return new MTetrahedron10(t->getVertex(0), t->getVertex(1), t->getVertex(2),
-                              t->getVertex(3), v[0], v[1], v[2], v[3], v[4],
-                              v[5], 0, t->getPartition());
+// Conversion of linear elements of the same dimension into high-order
+// elements, by blocks of elements that can span several entities. When
+// elements are added to the block, the new mesh edges and faces are registered
+// in the edge and face containers, the first element using a new edge or face
+// being in charge of creating its vertices (as in a serial traversal). The
+// vertices and the elements are then created in parallel, and the new vertices
+// are finally numbered in the order in which a serial traversal would have
+// created them: the resulting mesh thus does not depend on the number of
+// threads.
+class highOrderBlock {
+private:
+  GModel *_model;
+  edgeContainer &_edgeVertices;
+  faceContainer &_faceVertices;
+  bool _linear, _incomplete;
+  int _nPts, _nthreads;
+  // the linear elements, their entity and their index in the entity
+  std::vector<MElement *> _elements;
+  std::vector<GEntity *> _entities;
+  std::vector<std::size_t> _indices;
+  // edges (resp. faces) of element k are stored in [_firstEdge[k],
+  // _firstEdge[k + 1]) (resp. [_firstFace[k], _firstFace[k + 1])), with a flag
+  // telling if their vertices are created by the element
+  std::vector<std::size_t> _firstEdge, _firstFace;
+  std::vector<std::vector<MVertex *> *> _edges;
+  std::vector<faceContainer::iterator> _faces;
+  std::vector<char> _edgeCreated, _faceCreated;
+  // new high-order vertices of each element
+  std::vector<std::vector<MVertex *> > _vertices;
+  // the new elements
+  std::vector<MElement *> _newElements;
+  std::size_t _maxElementNum;
+  static const std::size_t _blockSize = 100000;
+  void _createElement(std::size_t k);
+
+public:
+  highOrderBlock(GModel *m, edgeContainer &edgeVertices,
+                 faceContainer &faceVertices, bool linear, bool incomplete,
+                 int nPts, int nthreads)
+    : _model(m), _edgeVertices(edgeVertices), _faceVertices(faceVertices),
+      _linear(linear), _incomplete(incomplete), _nPts(nPts),
+      _nthreads(nthreads), _maxElementNum(0)
+  {
   }
-  else {
-    if(!incomplete) {
-      getFaceVertices(gr, t, v, faceVertices, nPts);
-      getVolumeVertices(gr, t, v, nPts);
-    }
-    return new MTetrahedronN(t->getVertex(0), t->getVertex(1), t->getVertex(2),
-                             t->getVertex(3), v, nPts + 1, 0,
-                             t->getPartition());
+  // add the i-th element of the entity to the block (the block is converted
+  // when it is full)
+  void add(GEntity *ge, MElement *ele, std::size_t i);
+  template <class T> void add(GEntity *ge, std::vector<T *> &elements)
+  {
+    for(std::size_t i = 0; i < elements.size(); i++) add(ge, elements[i], i);
   }
-}
+  // convert all the elements in the block, and clear it
+  void convert();
+};
 
-static MHexahedron *setHighOrder(MHexahedron *h, GRegion *gr,
-                                 edgeContainer &edgeVertices,
-                                 faceContainer &faceVertices, bool incomplete,
-                                 int nPts)
+void highOrderBlock::add(GEntity *ge, MElement *ele, std::size_t i)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, h, v, edgeVertices, nPts);
-  if(incomplete) {
-    if(nPts == 1) {
-      return new MHexahedron20(
-        h->getVertex(0), h->getVertex(1), h->getVertex(2), h->getVertex(3),
-        h->getVertex(4), h->getVertex(5), h->getVertex(6), h->getVertex(7),
-        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
-        v[11], 0, h->getPartition());
-    }
-    else {
-      return new MHexahedronN(h->getVertex(0), h->getVertex(1), h->getVertex(2),
-                              h->getVertex(3), h->getVertex(4), h->getVertex(5),
-                              h->getVertex(6), h->getVertex(7), v, nPts + 1, 0,
-                              h->getPartition());
+  _elements.push_back(ele);
+  _entities.push_back(ge);
+  _indices.push_back(i);
+  _firstEdge.push_back(_edges.size());
+  _firstFace.push_back(_faces.size());
+  for(int j = 0; j < ele->getNumEdges(); j++) {
+    MEdge edge = ele->getEdge(j);
+    MVertex *vMin, *vMax;
+    getMinMaxVert(edge.getVertex(0), edge.getVertex(1), vMin, vMax);
+    auto it = _edgeVertices.insert(
+      std::make_pair(std::make_pair(vMin, vMax), std::vector<MVertex *>()));
+    _edges.push_back(&it.first->second);
+    _edgeCreated.push_back(it.second);
+    if(!it.second && ge->dim() == 1 && vMin != vMax) {
+      // Vertices already exist and edge is not a degenerated edge
+      Msg::Error(
+        "Mesh edges from different curves share nodes: create a finer mesh "
+        "(curve involved: %d)",
+        ge->tag());
     }
   }
-  else {
-    getFaceVertices(gr, h, v, faceVertices, nPts);
-    getVolumeVertices(gr, h, v, nPts);
-    if(nPts == 1) {
-      return new MHexahedron27(
-        h->getVertex(0), h->getVertex(1), h->getVertex(2), h->getVertex(3),
-        h->getVertex(4), h->getVertex(5), h->getVertex(6), h->getVertex(7),
-        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
-        v[11], v[12], v[13], v[14], v[15], v[16], v[17], v[18], 0,
-        h->getPartition());
-    }
-    else {
-      return new MHexahedronN(h->getVertex(0), h->getVertex(1), h->getVertex(2),
-                              h->getVertex(3), h->getVertex(4), h->getVertex(5),
-                              h->getVertex(6), h->getVertex(7), v, nPts + 1, 0,
-                              h->getPartition());
+  if(ge->dim() == 3 && hasFaceVertices(ele->getType(), _incomplete, _nPts)) {
+    for(int j = 0; j < ele->getNumFaces(); j++) {
+      auto it = _faceVertices.insert(
+        std::make_pair(ele->getFace(j), std::vector<MVertex *>()));
+      _faces.push_back(it.first);
+      _faceCreated.push_back(it.second);
     }
   }
+  if(_elements.size() >= _blockSize) convert();
 }
 
-static MPrism *setHighOrder(MPrism *p, GRegion *gr, edgeContainer &edgeVertices,
-                            faceContainer &faceVertices, bool incomplete,
-                            int nPts)
+void highOrderBlock::_createElement(std::size_t k)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, p, v, edgeVertices, nPts);
-  if(incomplete) {
-    if(nPts == 1) {
-      return new MPrism15(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                          p->getVertex(3), p->getVertex(4), p->getVertex(5),
-                          v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
-                          0, p->getPartition());
-    }
-    else {
-      return new MPrismN(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                         p->getVertex(3), p->getVertex(4), p->getVertex(5), v,
-                         nPts + 1, 0, p->getPartition());
+  MElement *ele = _elements[k];
+  MElement *newEle =
+    createHighOrderElement(ele, _vertices[k], _incomplete, _nPts,
+                           _maxElementNum + k + 1);
+  _newElements[k] = newEle;
+  replaceElement(_entities[k], _indices[k], newEle);
+  delete ele;
+}
+
+void highOrderBlock::convert()
+{
+  std::size_t n = _elements.size();
+  if(!n) return;
+  _firstEdge.push_back(_edges.size());
+  _firstFace.push_back(_faces.size());
+  _vertices.resize(n);
+  _newElements.resize(n);
+  std::size_t maxVertexNum = _model->getMaxVertexNumber();
+  _maxElementNum = _model->getMaxElementNumber();
+
+  // create the vertices on the new edges: this is where most of the work is
+  // done for curved meshes, through the projections on the geometry
+#pragma omp parallel for schedule(dynamic, 64) num_threads(_nthreads)
+  for(std::size_t k = 0; k < n; k++) {
+    MElement *ele = _elements[k];
+    GEntity *ge = _entities[k];
+    for(std::size_t j = _firstEdge[k]; j < _firstEdge[k + 1]; j++) {
+      int i = j - _firstEdge[k];
+      // 1D elements always create their own vertices
+      if(!_edgeCreated[j] && ge->dim() != 1) continue;
+      std::vector<MVertex *> veEdge;
+      createEdgeVertices(ge, ele, i, _linear, _nPts, veEdge);
+      if(_edgeCreated[j]) {
+        if(isEdgeIncreasing(ele, i))
+          _edges[j]->assign(veEdge.begin(), veEdge.end());
+        else
+          _edges[j]->assign(veEdge.rbegin(), veEdge.rend());
+      }
+      if(ge->dim() == 1) _vertices[k] = veEdge;
     }
   }
-  else {
-    getFaceVertices(gr, p, v, faceVertices, nPts);
-    if(nPts == 1) {
-      return new MPrism18(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                          p->getVertex(3), p->getVertex(4), p->getVertex(5),
-                          v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
-                          v[9], v[10], v[11], 0, p->getPartition());
+
+  // collect the edge vertices of each element; create the interior vertices
+  // of 2D elements and the vertices on the new faces of 3D elements
+#pragma omp parallel for schedule(dynamic, 64) num_threads(_nthreads)
+  for(std::size_t k = 0; k < n; k++) {
+    MElement *ele = _elements[k];
+    GEntity *ge = _entities[k];
+    std::vector<MVertex *> &v = _vertices[k];
+    if(ge->dim() == 1) {
+      _createElement(k);
+      continue;
     }
-    else {
-      getVolumeVertices(gr, p, v, nPts);
-      return new MPrismN(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                         p->getVertex(3), p->getVertex(4), p->getVertex(5), v,
-                         nPts + 1, 0, p->getPartition());
+    for(std::size_t j = _firstEdge[k]; j < _firstEdge[k + 1]; j++) {
+      const std::vector<MVertex *> &ve = *_edges[j];
+      if(isEdgeIncreasing(ele, j - _firstEdge[k]))
+        v.insert(v.end(), ve.begin(), ve.end());
+      else
+        v.insert(v.end(), ve.rbegin(), ve.rend());
+    }
+    if(ge->dim() == 2) {
+      if(hasFaceVertices(ele->getType(), _incomplete, _nPts))
+        getFaceVertices(static_cast<GFace *>(ge), ele, v, _linear, _nPts);
+      _createElement(k);
+      continue;
+    }
+    if(_firstFace[k] == _firstFace[k + 1]) continue;
+    std::vector<MVertex *> vCorner;
+    ele->getVertices(vCorner);
+    for(std::size_t j = _firstFace[k]; j < _firstFace[k + 1]; j++) {
+      if(!_faceCreated[j]) continue;
+      createFaceVertices(static_cast<GRegion *>(ge), ele, j - _firstFace[k],
+                         vCorner, v, _faces[j]->second, _nPts);
     }
   }
-}
 
-static MPyramid *setHighOrder(MPyramid *p, GRegion *gr,
-                              edgeContainer &edgeVertices,
-                              faceContainer &faceVertices, bool incomplete,
-                              int nPts)
-{
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, p, v, edgeVertices, nPts);
-  if(!incomplete) {
-    getFaceVertices(gr, p, v, faceVertices, nPts);
-    if(nPts > 1) { getVolumeVertices(gr, p, v, nPts); }
+  // collect the face vertices of 3D elements and create their interior
+  // vertices
+#pragma omp parallel for schedule(dynamic, 64) num_threads(_nthreads)
+  for(std::size_t k = 0; k < n; k++) {
+    MElement *ele = _elements[k];
+    GEntity *ge = _entities[k];
+    if(ge->dim() != 3) continue;
+    std::vector<MVertex *> &v = _vertices[k];
+    for(std::size_t j = _firstFace[k]; j < _firstFace[k + 1]; j++) {
+      if(_faceCreated[j])
+        v.insert(v.end(), _faces[j]->second.begin(), _faces[j]->second.end());
+      else
+        getFaceVertices(ele, j - _firstFace[k], _faces[j], v, _nPts);
+    }
+    if(hasVolumeVertices(ele->getType(), _incomplete, _nPts))
+      getVolumeVertices(static_cast<GRegion *>(ge), ele, v, _nPts);
+    _createElement(k);
   }
-  return new MPyramidN(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                       p->getVertex(3), p->getVertex(4), v, nPts + 1, 0,
-                       p->getPartition());
-}
 
-static void setHighOrder(GRegion *gr, edgeContainer &edgeVertices,
-                         faceContainer &faceVertices, bool incomplete,
-                         int nPts = 1)
-{
-  std::vector<MTetrahedron *> tetrahedra2;
-  for(std::size_t i = 0; i < gr->tetrahedra.size(); i++) {
-    MTetrahedron *t = gr->tetrahedra[i];
-    MTetrahedron *tNew =
-      setHighOrder(t, gr, edgeVertices, faceVertices, incomplete, nPts);
-    tetrahedra2.push_back(tNew);
-    delete t;
-  }
-  gr->tetrahedra = tetrahedra2;
-
-  std::vector<MHexahedron *> hexahedra2;
-  for(std::size_t i = 0; i < gr->hexahedra.size(); i++) {
-    MHexahedron *h = gr->hexahedra[i];
-    MHexahedron *hNew =
-      setHighOrder(h, gr, edgeVertices, faceVertices, incomplete, nPts);
-    hexahedra2.push_back(hNew);
-    delete h;
-  }
-  gr->hexahedra = hexahedra2;
-
-  std::vector<MPrism *> prisms2;
-  for(std::size_t i = 0; i < gr->prisms.size(); i++) {
-    MPrism *p = gr->prisms[i];
-    MPrism *pNew =
-      setHighOrder(p, gr, edgeVertices, faceVertices, incomplete, nPts);
-    prisms2.push_back(pNew);
-    delete p;
-  }
-  gr->prisms = prisms2;
-
-  std::vector<MPyramid *> pyramids2;
-  for(std::size_t i = 0; i < gr->pyramids.size(); i++) {
-    MPyramid *p = gr->pyramids[i];
-    MPyramid *pNew =
-      setHighOrder(p, gr, edgeVertices, faceVertices, incomplete, nPts);
-    pyramids2.push_back(pNew);
-    delete p;
+  // number the new vertices in the order of their creation in a serial
+  // traversal: vertices on the edges and faces created by the element, then
+  // vertices in its interior
+  std::size_t num = maxVertexNum;
+  for(std::size_t k = 0; k < n; k++) {
+    MElement *ele = _newElements[k];
+    std::vector<MVertex *> &v = _vertices[k];
+    std::size_t pos = 0;
+    if(ele->getDim() > 1) {
+      for(std::size_t j = _firstEdge[k]; j < _firstEdge[k + 1]; j++) {
+        std::size_t size = _edges[j]->size();
+        if(_edgeCreated[j])
+          for(std::size_t i = pos; i < pos + size; i++) v[i]->forceNum(++num);
+        pos += size;
+      }
+      for(std::size_t j = _firstFace[k]; j < _firstFace[k + 1]; j++) {
+        std::size_t size = _faces[j]->second.size();
+        if(_faceCreated[j])
+          for(std::size_t i = pos; i < pos + size; i++) v[i]->forceNum(++num);
+        pos += size;
+      }
+      if(ele->getDim() == 2 &&
+         hasFaceVertices(ele->getType(), _incomplete, _nPts)) {
+        MFace face = ele->getFace(0);
+        _faceVertices[face].insert(_faceVertices[face].end(), v.begin() + pos,
+                                   v.end());
+      }
+    }
+    for(std::size_t i = pos; i < v.size(); i++) v[i]->forceNum(++num);
   }
-  gr->pyramids = pyramids2;
-
-  gr->deleteVertexArrays();
+  _model->setMaxElementNumber(_maxElementNum + n);
+
+  _elements.clear();
+  _entities.clear();
+  _indices.clear();
+  _firstEdge.clear();
+  _firstFace.clear();
+  _edges.clear();
+  _faces.clear();
+  _edgeCreated.clear();
+  _faceCreated.clear();
+  _vertices.clear();
+  _newElements.clear();
 }
 
 // High-level functions
@@ -1431,6 +1439,17 @@ void SetOrderN(GModel *m, int order, bool linear, bool incomplete,
   edgeContainer edgeVertices;
   faceContainer faceVertices;
 
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // the cache of inner vertex placements is not thread-safe: fill it before
+  // creating the vertices in parallel
+  for(int type = TYPE_TRI; type <= TYPE_HEX; type++)
+    getInnerVertexPlacement(type, nPts + 1);
+
+  highOrderBlock block(m, edgeVertices, faceVertices, linear, incomplete, nPts,
+                       nthreads);
+
   int counter = 0;
   int nTot = m->getNumEdges() + m->getNumFaces() + m->getNumRegions();
   Msg::StartProgressMeter(nTot);
@@ -1442,31 +1461,48 @@ void SetOrderN(GModel *m, int order, bool linear, bool incomplete,
     Msg::Info("Meshing curve %d order %d", (*it)->tag(), order);
     Msg::ProgressMeter(++counter, false, msg);
     if(onlyVisible && !(*it)->getVisibility()) continue;
-    if(getOrder(*it) != order)
-      setHighOrder(*it, edgeVertices, linear, nPts);
-    else
+    if(getOrder(*it) != order) {
+      block.add(*it, (*it)->lines);
+      (*it)->deleteVertexArrays();
+    }
+    else {
+      block.convert();
       setHighOrderFromExistingMesh(*it, edgeVertices);
+    }
   }
+  block.convert();
 
   for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
     Msg::Info("Meshing surface %d order %d", (*it)->tag(), order);
     Msg::ProgressMeter(++counter, false, msg);
     if(onlyVisible && !(*it)->getVisibility()) continue;
-    if(getOrder(*it) != order)
-      setHighOrder(*it, edgeVertices, faceVertices, linear, incomplete, nPts);
-    else
+    if(getOrder(*it) != order) {
+      block.add(*it, (*it)->triangles);
+      block.add(*it, (*it)->quadrangles);
+      (*it)->deleteVertexArrays();
+    }
+    else {
+      block.convert();
       setHighOrderFromExistingMesh(*it, edgeVertices, faceVertices);
+    }
     if((*it)->getColumns() != nullptr) (*it)->getColumns()->clearElementData();
   }
+  block.convert();
 
   for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
     Msg::Info("Meshing volume %d order %d", (*it)->tag(), order);
     Msg::ProgressMeter(++counter, false, msg);
     if(onlyVisible && !(*it)->getVisibility()) continue;
-    if(getOrder(*it) != order)
-      setHighOrder(*it, edgeVertices, faceVertices, incomplete, nPts);
+    if(getOrder(*it) != order) {
+      block.add(*it, (*it)->tetrahedra);
+      block.add(*it, (*it)->hexahedra);
+      block.add(*it, (*it)->prisms);
+      block.add(*it, (*it)->pyramids);
+      (*it)->deleteVertexArrays();
+    }
     if((*it)->getColumns() != nullptr) (*it)->getColumns()->clearElementData();
   }
+  block.convert();
 
   // store nodes in entities
   m->pruneMeshVertexAssociations();
@@ -889,7 +889,10 @@ void meshGEdge::operator()(GEdge *ge)
   if(ge->geomType() == GEntity::BoundaryLayerCurve) return;
   if(ge->meshAttributes.method == MESH_NONE) return;
   if(CTX::instance()->mesh.meshOnlyVisible && !ge->getVisibility()) return;
-  if(CTX::instance()->mesh.meshOnlyEmpty && ge->getNumMeshElements()) return;
+  if(CTX::instance()->mesh.meshOnlyEmpty && ge->getNumMeshElements()) {
+    ge->meshStatistics.status = GEdge::DONE;
+    return;
+  }
 
   // destroy the mesh if it exists
   deMeshGEdge dem;
@@ -3163,7 +3163,10 @@ void meshGFace::operator()(GFace *gf, bool print)
 
   if(gf->meshAttributes.method == MESH_NONE) return;
   if(CTX::instance()->mesh.meshOnlyVisible && !gf->getVisibility()) return;
-  if(CTX::instance()->mesh.meshOnlyEmpty && gf->getNumMeshElements()) return;
+  if(CTX::instance()->mesh.meshOnlyEmpty && gf->getNumMeshElements()) {
+    gf->meshStatistics.status = GFace::DONE;
+    return;
+  }
 
   // destroy the mesh if it exists
   deMeshGFace dem;
@@ -174,6 +174,42 @@ extrudeMesh(GEdge *from, GFace *to, MVertexRTree &pos,
   }
 }
 
+// look up (concurrently) the extruded nodes of the source elements; returns
+// false if one of them cannot be found
+template <class T>
+static bool getCopiedVertices(std::vector<T *> &elements, ExtrudeParams *ep,
+                              GFace *to, MVertexRTree &pos,
+                              std::vector<MVertex *> &verts)
+{
+  if(elements.empty()) return true;
+  std::size_t n = elements[0]->getNumVertices();
+  verts.resize(elements.size() * n);
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  bool ok = true;
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t i = 0; i < elements.size(); i++) {
+    for(std::size_t j = 0; j < n; j++) {
+      MVertex *v = elements[i]->getVertex(j);
+      double x = v->x(), y = v->y(), z = v->z();
+      ep->Extrude(ep->mesh.NbLayer - 1,
+                  ep->mesh.NbElmLayer[ep->mesh.NbLayer - 1], x, y, z);
+      verts[i * n + j] = pos.find(x, y, z);
+      if(!verts[i * n + j]) {
+#pragma omp critical
+        {
+          if(ok)
+            Msg::Error("Could not find extruded node (%.16g, %.16g, %.16g) in "
+                       "surface %d",
+                       x, y, z, to->tag());
+          ok = false;
+        }
+      }
+    }
+  }
+  return ok;
+}
+
 static void copyMesh(GFace *from, GFace *to, MVertexRTree &pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
@@ -185,12 +221,25 @@ static void copyMesh(GFace *from, GFace *to, MVertexRTree &pos)
   std::vector<MVertex *> embedded = from->getEmbeddedMeshVertices();
   mesh_vertices.insert(mesh_vertices.end(), embedded.begin(), embedded.end());
 
-  // create extruded vertices
+  // compute the position of the extruded vertices concurrently
+  std::vector<SPoint3> xyz(mesh_vertices.size());
+  std::vector<char> found(mesh_vertices.size(), 0);
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(static) num_threads(nthreads)
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) {
     MVertex *v = mesh_vertices[i];
     double x = v->x(), y = v->y(), z = v->z();
     ep->Extrude(ep->mesh.NbLayer - 1, ep->mesh.NbElmLayer[ep->mesh.NbLayer - 1],
                 x, y, z);
+    xyz[i] = SPoint3(x, y, z);
+    if(pos.find(x, y, z)) found[i] = 1;
+  }
+
+  // create extruded vertices
+  for(std::size_t i = 0; i < mesh_vertices.size(); i++) {
+    if(found[i]) continue;
+    double x = xyz[i].x(), y = xyz[i].y(), z = xyz[i].z();
     MVertex *newv = pos.find(x, y, z);
     if(!newv) {
       if(to->geomType() != GEntity::DiscreteSurface &&
@@ -238,24 +287,10 @@ static void copyMesh(GFace *from, GFace *to, MVertexRTree &pos)
 #endif
 
   // create triangle elements
-  for(std::size_t i = 0; i < from->triangles.size(); i++) {
-    std::vector<MVertex *> verts;
-    for(int j = 0; j < 3; j++) {
-      MVertex *v = from->triangles[i]->getVertex(j);
-      double x = v->x(), y = v->y(), z = v->z();
-      ep->Extrude(ep->mesh.NbLayer - 1,
-                  ep->mesh.NbElmLayer[ep->mesh.NbLayer - 1], x, y, z);
-      MVertex *tmp = pos.find(x, y, z);
-      if(!tmp) {
-        Msg::Error(
-          "Could not find extruded node (%.16g, %.16g, %.16g) in surface %d", x,
-          y, z, to->tag());
-        return;
-      }
-      verts.push_back(tmp);
-    }
-    addTriangle(verts[0], verts[1], verts[2], to);
-  }
+  std::vector<MVertex *> verts;
+  if(!getCopiedVertices(from->triangles, ep, to, pos, verts)) return;
+  for(std::size_t i = 0; i < from->triangles.size(); i++)
+    addTriangle(verts[3 * i], verts[3 * i + 1], verts[3 * i + 2], to);
 
 #if defined(HAVE_QUADTRI)
   // Add triangles for divided quads for QuadTri. If quadtotri and not part of a
@@ -268,24 +303,10 @@ static void copyMesh(GFace *from, GFace *to, MVertexRTree &pos)
 #endif
 
   // create quadrangle elements if NOT QuadToTri and NOT toroidal
-  for(std::size_t i = 0; i < from->quadrangles.size(); i++) {
-    std::vector<MVertex *> verts;
-    for(int j = 0; j < 4; j++) {
-      MVertex *v = from->quadrangles[i]->getVertex(j);
-      double x = v->x(), y = v->y(), z = v->z();
-      ep->Extrude(ep->mesh.NbLayer - 1,
-                  ep->mesh.NbElmLayer[ep->mesh.NbLayer - 1], x, y, z);
-      MVertex *tmp = pos.find(x, y, z);
-      if(!tmp) {
-        Msg::Error(
-          "Could not find extruded node (%.16g, %.16g, %.16g) in surface %d", x,
-          y, z, to->tag());
-        return;
-      }
-      verts.push_back(tmp);
-    }
-    addQuadrangle(verts[0], verts[1], verts[2], verts[3], to);
-  }
+  if(!getCopiedVertices(from->quadrangles, ep, to, pos, verts)) return;
+  for(std::size_t i = 0; i < from->quadrangles.size(); i++)
+    addQuadrangle(verts[4 * i], verts[4 * i + 1], verts[4 * i + 2],
+                  verts[4 * i + 3], to);
 }
 
 int MeshExtrudedSurface(
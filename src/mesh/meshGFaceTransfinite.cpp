@@ -282,31 +282,82 @@ static void rescaleIrregularTransfinite(int &L, int &Lb, int &H, int &Hb,
   m_vertices = m_vertices_new;
 }
 
-static void _addTriangle(GFace *gf, MVertex *v1, MVertex *v2, MVertex *v3)
+static void _addTriangle(std::vector<MElement *> &e, MVertex *v1, MVertex *v2,
+                         MVertex *v3)
 {
   if(v1 == v2) return;
   if(v1 == v3) return;
   if(v2 == v3) return;
-  gf->triangles.push_back(new MTriangle(v1, v2, v3));
+  e.push_back(new MTriangle(v1, v2, v3));
 }
 
-static void _addQuadrangle(GFace *gf, MVertex *v1, MVertex *v2, MVertex *v3,
-                           MVertex *v4)
+static void _addQuadrangle(std::vector<MElement *> &e, MVertex *v1,
+                           MVertex *v2, MVertex *v3, MVertex *v4)
 {
   if(v1 == v2)
-    _addTriangle(gf, v1, v3, v4);
+    _addTriangle(e, v1, v3, v4);
   else if(v1 == v3)
-    _addTriangle(gf, v1, v2, v4);
+    _addTriangle(e, v1, v2, v4);
   else if(v1 == v4)
-    _addTriangle(gf, v1, v2, v3);
+    _addTriangle(e, v1, v2, v3);
   else if(v2 == v3)
-    _addTriangle(gf, v1, v2, v4);
+    _addTriangle(e, v1, v2, v4);
   else if(v2 == v4)
-    _addTriangle(gf, v1, v2, v3);
+    _addTriangle(e, v1, v2, v3);
   else if(v3 == v4)
-    _addTriangle(gf, v1, v2, v3);
+    _addTriangle(e, v1, v2, v3);
   else
-    gf->quadrangles.push_back(new MQuadrangle(v1, v2, v3, v4));
+    e.push_back(new MQuadrangle(v1, v2, v3, v4));
+}
+
+// add the nodes created in the slabs (i = constant) of a transfinite surface,
+// in the order of a sequential creation
+static void
+addTransfiniteSlabVertices(GFace *gf,
+                           std::vector<std::vector<MVertex *> > &slabs,
+                           std::size_t num, bool renumber)
+{
+  std::size_t n = 0;
+  for(std::size_t i = 0; i < slabs.size(); i++) n += slabs[i].size();
+  gf->mesh_vertices.reserve(gf->mesh_vertices.size() + n);
+  for(std::size_t i = 0; i < slabs.size(); i++) {
+    for(std::size_t l = 0; l < slabs[i].size(); l++) {
+      if(renumber) slabs[i][l]->forceNum(++num);
+      gf->mesh_vertices.push_back(slabs[i][l]);
+    }
+  }
+}
+
+// create the elements in the slabs of cells i0 <= i < i1 of a transfinite
+// surface: the slabs are filled concurrently, and their elements are then
+// added to the surface (and renumbered) in the order of a sequential creation
+template <class F>
+static void createTransfiniteSlabs(GFace *gf, int i0, int i1, int nthreads,
+                                   F createSlab)
+{
+  if(i1 <= i0) return;
+  std::size_t num = gf->model()->getMaxElementNumber();
+  std::vector<std::vector<MElement *> > slabs(i1 - i0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(int i = i0; i < i1; i++) createSlab(i, slabs[i - i0]);
+
+  std::size_t nt = 0, nq = 0;
+  for(std::size_t i = 0; i < slabs.size(); i++) {
+    for(std::size_t l = 0; l < slabs[i].size(); l++) {
+      if(slabs[i][l]->getType() == TYPE_TRI)
+        nt++;
+      else
+        nq++;
+    }
+  }
+  gf->triangles.reserve(gf->triangles.size() + nt);
+  gf->quadrangles.reserve(gf->quadrangles.size() + nq);
+  for(std::size_t i = 0; i < slabs.size(); i++) {
+    for(std::size_t l = 0; l < slabs[i].size(); l++) {
+      if(nthreads > 1) slabs[i][l]->forceNum(++num);
+      gf->addElement(slabs[i][l]);
+    }
+  }
 }
 
 int MeshTransfiniteSurface(GFace *gf)
@@ -543,12 +594,26 @@ int MeshTransfiniteSurface(GFace *gf)
   double UC1 = U[N1], UC2 = U[N2], UC3 = U[N3];
   double VC1 = V[N1], VC2 = V[N2], VC3 = V[N3];
 
-  // create points using transfinite interpolation
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads2D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads2D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  // if the surfaces are already meshed concurrently (see Mesh2D), create the
+  // nodes and the elements of this surface sequentially
+  if(Msg::GetNumThreads() > 1) nthreads = 1;
+
+  // create points using transfinite interpolation; the points are created
+  // concurrently by slabs (i = constant), and are then renumbered in the order
+  // of a sequential creation
+  std::size_t numVertices = gf->model()->getMaxVertexNumber();
+  std::vector<std::vector<MVertex *> > slabVertices(L + 1);
   if(corners.size() == 4) {
     double UC4 = U[N4];
     double VC4 = V[N4];
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
     for(int i = 1; i < L; i++) {
       double u = lengths_i[i] / L_i;
+      if(H > 1) slabVertices[i].reserve(H - 1);
       for(int j = 1; j < H; j++) {
         double v = lengths_j[j] / L_j;
         int iP1 = N1 + i;
@@ -561,7 +626,7 @@ int MeshTransfiniteSurface(GFace *gf)
           TRAN_QUA(V[iP1], V[iP2], V[iP3], V[iP4], VC1, VC2, VC3, VC4, u, v);
         GPoint gp = gf->point(SPoint2(Up, Vp));
         MFaceVertex *newv = new MFaceVertex(gp.x(), gp.y(), gp.z(), gf, Up, Vp);
-        gf->mesh_vertices.push_back(newv);
+        slabVertices[i].push_back(newv);
         tab[i][j] = newv;
       }
     }
@@ -575,8 +640,10 @@ int MeshTransfiniteSurface(GFace *gf)
       for(int j = 0; j <= H; j++) v2.push_back(V[N2 + j]);
     }
 
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
     for(int i = 1; i < L; i++) {
       double u = lengths_i[i] / L_i;
+      if(H > 1) slabVertices[i].reserve(H - 1);
       for(int j = 1; j < H; j++) {
         double v = lengths_j[j] / L_j;
         int iP1 = N1 + i;
@@ -666,11 +733,12 @@ int MeshTransfiniteSurface(GFace *gf)
         }
         GPoint gp = gf->point(SPoint2(Up, Vp));
         MFaceVertex *newv = new MFaceVertex(gp.x(), gp.y(), gp.z(), gf, Up, Vp);
-        gf->mesh_vertices.push_back(newv);
+        slabVertices[i].push_back(newv);
         tab[i][j] = newv;
       }
     }
   }
+  addTransfiniteSlabVertices(gf, slabVertices, numVertices, nthreads > 1);
 
   // should we apply the elliptic smoother?
   int numSmooth = 0;
@@ -746,6 +814,7 @@ int MeshTransfiniteSurface(GFace *gf)
         }
       }
     }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
     for(int i = 1; i < L; i++) {
       for(int j = 1; j < H; j++) {
         GPoint p = gf->point(SPoint2(u[i][j], v[i][j]));
@@ -896,126 +965,137 @@ int MeshTransfiniteSurface(GFace *gf)
   }
 
   // create elements
+  bool recombine =
+    CTX::instance()->mesh.recombineAll || gf->meshAttributes.recombine;
+  int arrangement = gf->meshAttributes.transfiniteArrangement;
   if(corners.size() == 4) {
-    for(int i = 0; i < L; i++) {
-      for(int j = 0; j < H; j++) {
-        MVertex *v1 = tab[i][j];
-        MVertex *v2 = tab[i + 1][j];
-        MVertex *v3 = tab[i + 1][j + 1];
-        MVertex *v4 = tab[i][j + 1];
-        if(CTX::instance()->mesh.recombineAll || gf->meshAttributes.recombine)
-          _addQuadrangle(gf, v1, v2, v3, v4);
-        else if(gf->meshAttributes.transfiniteArrangement == 1 ||
-                (gf->meshAttributes.transfiniteArrangement == 2 &&
-                 ((i % 2 == 0 && j % 2 == 1) || (i % 2 == 1 && j % 2 == 0))) ||
-                (gf->meshAttributes.transfiniteArrangement == -2 &&
-                 ((i % 2 == 0 && j % 2 == 0) || (i % 2 == 1 && j % 2 == 1)))) {
-          //        else if(rand() % 2 == 0){
-          _addTriangle(gf, v1, v2, v3);
-          _addTriangle(gf, v3, v4, v1);
-        }
-        else {
-          _addTriangle(gf, v1, v2, v4);
-          _addTriangle(gf, v4, v2, v3);
-        }
-      }
-    }
-  }
-  else {
-    if(!gf->meshAttributes.transfinite3) {
-      for(int j = 0; j < H; j++) {
-        MVertex *v1 = tab[0][0];
-        MVertex *v2 = tab[1][j];
-        MVertex *v3 = tab[1][j + 1];
-        _addTriangle(gf, v1, v2, v3);
-      }
-      for(int i = 1; i < L; i++) {
+    createTransfiniteSlabs(
+      gf, 0, L, nthreads, [&](int i, std::vector<MElement *> &e) {
+        e.reserve((recombine ? 1 : 2) * H);
         for(int j = 0; j < H; j++) {
           MVertex *v1 = tab[i][j];
           MVertex *v2 = tab[i + 1][j];
           MVertex *v3 = tab[i + 1][j + 1];
           MVertex *v4 = tab[i][j + 1];
-          if(CTX::instance()->mesh.recombineAll || gf->meshAttributes.recombine)
-            _addQuadrangle(gf, v1, v2, v3, v4);
-          else if(gf->meshAttributes.transfiniteArrangement == 1 ||
-                  (gf->meshAttributes.transfiniteArrangement == 2 &&
+          if(recombine)
+            _addQuadrangle(e, v1, v2, v3, v4);
+          else if(arrangement == 1 ||
+                  (arrangement == 2 &&
                    ((i % 2 == 0 && j % 2 == 1) ||
                     (i % 2 == 1 && j % 2 == 0))) ||
-                  (gf->meshAttributes.transfiniteArrangement == -2 &&
+                  (arrangement == -2 &&
                    ((i % 2 == 0 && j % 2 == 0) ||
                     (i % 2 == 1 && j % 2 == 1)))) {
-            _addTriangle(gf, v1, v2, v3);
-            _addTriangle(gf, v3, v4, v1);
+            //        else if(rand() % 2 == 0){
+            _addTriangle(e, v1, v2, v3);
+            _addTriangle(e, v3, v4, v1);
           }
           else {
-            _addTriangle(gf, v1, v2, v4);
-            _addTriangle(gf, v4, v2, v3);
+            _addTriangle(e, v1, v2, v4);
+            _addTriangle(e, v4, v2, v3);
           }
         }
-      }
+      });
+  }
+  else {
+    if(!gf->meshAttributes.transfinite3) {
+      createTransfiniteSlabs(
+        gf, 0, L, nthreads, [&](int i, std::vector<MElement *> &e) {
+          if(i == 0) {
+            e.reserve(H);
+            for(int j = 0; j < H; j++) {
+              MVertex *v1 = tab[0][0];
+              MVertex *v2 = tab[1][j];
+              MVertex *v3 = tab[1][j + 1];
+              _addTriangle(e, v1, v2, v3);
+            }
+            return;
+          }
+          e.reserve((recombine ? 1 : 2) * H);
+          for(int j = 0; j < H; j++) {
+            MVertex *v1 = tab[i][j];
+            MVertex *v2 = tab[i + 1][j];
+            MVertex *v3 = tab[i + 1][j + 1];
+            MVertex *v4 = tab[i][j + 1];
+            if(recombine)
+              _addQuadrangle(e, v1, v2, v3, v4);
+            else if(arrangement == 1 ||
+                    (arrangement == 2 &&
+                     ((i % 2 == 0 && j % 2 == 1) ||
+                      (i % 2 == 1 && j % 2 == 0))) ||
+                    (arrangement == -2 &&
+                     ((i % 2 == 0 && j % 2 == 0) ||
+                      (i % 2 == 1 && j % 2 == 1)))) {
+              _addTriangle(e, v1, v2, v3);
+              _addTriangle(e, v3, v4, v1);
+            }
+            else {
+              _addTriangle(e, v1, v2, v4);
+              _addTriangle(e, v4, v2, v3);
+            }
+          }
+        });
     }
     else {
-      int ni = 0;
-      bool message = true;
-      for(int i = 0; i < L; i++) {
-        for(int j = 0; j <= i; j++) {
-          MVertex *v1 = tab[i][j];
-          MVertex *v2 = tab[i + 1][j];
-          MVertex *v3 = tab[i + 1][j + 1];
-          MVertex *v4 = tab[i][j + 1];
-          MVertex *v5;
-
-          if(CTX::instance()->mesh.recombineAll ||
-             gf->meshAttributes.recombine) {
-            switch(gf->meshAttributes.transfiniteArrangement) {
-            case 1: // Right (right side tria)
-
-              if(i > 0 && j < i) { _addQuadrangle(gf, v1, v2, v3, v4); }
-              if(i == j) { _addTriangle(gf, v1, v2, v3); }
-              break;
-
-            case 2: // AlternateRight (side tria <- ->) == Alternate
-            case -2: // AlternateLeft  (side tria <- ->)
-
-              if(i % 2) {
-                if(i > 0 && j < i) { _addQuadrangle(gf, v1, v2, v3, v4); }
-                if(i == j) { _addTriangle(gf, v1, v2, v3); }
-              }
-              else {
-                if(j == 0) { _addTriangle(gf, v1, v2, v3); }
-                if(i > 0 && j < i) {
+      if(recombine && L > 0 && arrangement != 1 && arrangement != 2 &&
+         arrangement != -2 && arrangement != -1)
+        Msg::Warning("Unknown transfinite arrangement in surface %d",
+                     gf->tag());
+      createTransfiniteSlabs(
+        gf, 0, L, nthreads, [&](int i, std::vector<MElement *> &e) {
+          e.reserve(2 * (i + 1));
+          for(int j = 0; j <= i; j++) {
+            MVertex *v1 = tab[i][j];
+            MVertex *v2 = tab[i + 1][j];
+            MVertex *v3 = tab[i + 1][j + 1];
+            MVertex *v4 = tab[i][j + 1];
+            MVertex *v5;
+            int ni;
+
+            if(recombine) {
+              switch(arrangement) {
+              case 1: // Right (right side tria)
+
+                if(i > 0 && j < i) { _addQuadrangle(e, v1, v2, v3, v4); }
+                if(i == j) { _addTriangle(e, v1, v2, v3); }
+                break;
+
+              case 2: // AlternateRight (side tria <- ->) == Alternate
+              case -2: // AlternateLeft  (side tria <- ->)
+
+                if(i % 2) {
+                  if(i > 0 && j < i) { _addQuadrangle(e, v1, v2, v3, v4); }
+                  if(i == j) { _addTriangle(e, v1, v2, v3); }
+                }
+                else {
+                  if(j == 0) { _addTriangle(e, v1, v2, v3); }
+                  if(i > 0 && j < i) {
+                    v5 = tab[i + 1][j + 2];
+                    _addQuadrangle(e, v1, v3, v5, v4);
+                  }
+                }
+                break;
+
+              case -1: // Left (central tria)
+
+                ni = 2 * (i / 4) + (i % 4 ? 1 : 0);
+                if(i > 0 && j < ni) { _addQuadrangle(e, v1, v2, v3, v4); }
+                if(j == ni) { _addTriangle(e, v1, v2, v3); }
+                if(i > 0 && j >= ni && j < i) {
                   v5 = tab[i + 1][j + 2];
-                  _addQuadrangle(gf, v1, v3, v5, v4);
+                  _addQuadrangle(e, v1, v3, v5, v4);
                 }
-              }
-              break;
-
-            case -1: // Left (central tria)
-
-              ni = 2 * (i / 4) + (i % 4 ? 1 : 0);
-              if(i > 0 && j < ni) { _addQuadrangle(gf, v1, v2, v3, v4); }
-              if(j == ni) { _addTriangle(gf, v1, v2, v3); }
-              if(i > 0 && j >= ni && j < i) {
-                v5 = tab[i + 1][j + 2];
-                _addQuadrangle(gf, v1, v3, v5, v4);
-              }
-              break;
-
-            default:
-              if(message) {
-                message = false;
-                Msg::Warning("Unknown transfinite arrangement in surface %d",
-                             gf->tag());
-              }
-
-            } // switch
-          }
-          else {
-            if(i > 0 && j < i) { _addTriangle(gf, v1, v3, v4); }
-            _addTriangle(gf, v1, v2, v3);
+                break;
+
+              default: break;
+              } // switch
+            }
+            else {
+              if(i > 0 && j < i) { _addTriangle(e, v1, v3, v4); }
+              _addTriangle(e, v1, v2, v3);
+            }
           }
-        }
-      }
+        });
     }
   }
 
@@ -23,6 +23,7 @@
 #include "GEdge.h"
 #include "discreteFace.h"
 #include "discreteEdge.h"
+#include "MPoint.h"
 #include "MLine.h"
 #include "MTriangle.h"
 #include "MTetrahedron.h"
@@ -85,98 +86,211 @@ int splitQuadRecovery::buildPyramids(GModel *gm)
   return npyram;
 }
 
-void MeshDelaunayVolume(std::vector<GRegion *> &regions)
-{
-  if(regions.empty()) return;
+// temporarily set the faces and the embedded entities of the first volume of
+// a group of connected volumes to the ones of the whole group, so that the
+// boundary of the group can be recovered at once
+class delaunayGroupBoundary {
+private:
+  GRegion *_gr;
+  std::vector<GFace *> _faces, _allFaces;
+  std::vector<GEdge *> _oldEmbEdges;
+  std::vector<GVertex *> _oldEmbVertices;
+
+public:
+  delaunayGroupBoundary(std::vector<GRegion *> &regions)
+    : _gr(regions[0]), _faces(regions[0]->faces())
+  {
+    std::set<GFace *, GEntityPtrLessThan> allFacesSet;
+    for(std::size_t i = 0; i < regions.size(); i++) {
+      std::vector<GFace *> const &f = regions[i]->faces();
+      std::vector<GFace *> const &f_e = regions[i]->embeddedFaces();
+      allFacesSet.insert(f.begin(), f.end());
+      allFacesSet.insert(f_e.begin(), f_e.end());
+    }
 
-  if(CTX::instance()->mesh.algo3d == ALGO_3D_HXT) {
-    if(meshGRegionHxt(regions) != 0) { Msg::Error("HXT 3D mesh failed"); }
-    return;
-  }
+    // replace faces with compounds if elements from compound surface meshes
+    // are not reclassified on the original surfaces
+    if(CTX::instance()->mesh.compoundClassify == 0) {
+      std::set<GFace *, GEntityPtrLessThan> comp;
+      for(auto it = allFacesSet.begin(); it != allFacesSet.end(); it++) {
+        GFace *gf = *it;
+        if(!gf->compoundSurface)
+          comp.insert(gf);
+        else if(gf->compoundSurface)
+          comp.insert(gf->compoundSurface);
+      }
+      allFacesSet = comp;
+    }
 
-  if(CTX::instance()->mesh.algo3d != ALGO_3D_RTREE &&
-     CTX::instance()->mesh.algo3d != ALGO_3D_DELAUNAY &&
-     CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
-     CTX::instance()->mesh.algo3d != ALGO_3D_MMG3D)
-    return;
+    _allFaces.insert(_allFaces.end(), allFacesSet.begin(), allFacesSet.end());
+    _gr->set(_allFaces);
 
-  GRegion *gr = regions[0];
-  std::vector<GFace *> faces = gr->faces();
-
-  std::set<GFace *, GEntityPtrLessThan> allFacesSet;
-  for(std::size_t i = 0; i < regions.size(); i++) {
-    std::vector<GFace *> const &f = regions[i]->faces();
-    std::vector<GFace *> const &f_e = regions[i]->embeddedFaces();
-    allFacesSet.insert(f.begin(), f.end());
-    allFacesSet.insert(f_e.begin(), f_e.end());
+    std::set<GEdge *, GEntityPtrLessThan> allEmbEdgesSet;
+    for(std::size_t i = 0; i < regions.size(); i++) {
+      std::vector<GEdge *> const &e = regions[i]->embeddedEdges();
+      allEmbEdgesSet.insert(e.begin(), e.end());
+    }
+    std::vector<GEdge *> allEmbEdges(allEmbEdgesSet.begin(),
+                                     allEmbEdgesSet.end());
+    _oldEmbEdges = _gr->embeddedEdges();
+    _gr->embeddedEdges() = allEmbEdges;
+
+    std::set<GVertex *> allEmbVerticesSet;
+    for(std::size_t i = 0; i < regions.size(); i++) {
+      std::vector<GVertex *> const &e = regions[i]->embeddedVertices();
+      allEmbVerticesSet.insert(e.begin(), e.end());
+    }
+    std::vector<GVertex *> allEmbVertices(allEmbVerticesSet.begin(),
+                                          allEmbVerticesSet.end());
+    _oldEmbVertices = _gr->embeddedVertices();
+    _gr->embeddedVertices() = allEmbVertices;
   }
+  GRegion *region() { return _gr; }
+  void restore(bool recovered)
+  {
+    // sort triangles in all model faces in order to be able to search in
+    // vectors
+    if(recovered) {
+      for(auto itf = _allFaces.begin(); itf != _allFaces.end(); ++itf)
+        std::sort((*itf)->triangles.begin(), (*itf)->triangles.end(),
+                  compareMTriangleLexicographic());
+    }
 
-  // replace faces with compounds if elements from compound surface meshes are
-  // not reclassified on the original surfaces
-  if(CTX::instance()->mesh.compoundClassify == 0) {
-    std::set<GFace *, GEntityPtrLessThan> comp;
-    for(auto it = allFacesSet.begin(); it != allFacesSet.end(); it++) {
-      GFace *gf = *it;
-      if(!gf->compoundSurface)
-        comp.insert(gf);
-      else if(gf->compoundSurface)
-        comp.insert(gf->compoundSurface);
+    // restore set of faces and embedded edges/vertices
+    if(CTX::instance()->mesh.compoundClassify == 0) {
+      std::set<GFace *, GEntityPtrLessThan> comp;
+      for(std::size_t i = 0; i < _faces.size(); i++) {
+        GFace *gf = _faces[i];
+        if(!gf->compoundSurface)
+          comp.insert(gf);
+        else if(gf->compoundSurface)
+          comp.insert(gf->compoundSurface);
+      }
+      std::vector<GFace *> lcomp(comp.begin(), comp.end());
+      _gr->set(lcomp);
     }
-    allFacesSet = comp;
+    else {
+      _gr->set(_faces);
+    }
+    _gr->embeddedEdges() = _oldEmbEdges;
+    _gr->embeddedVertices() = _oldEmbVertices;
   }
+};
 
-  std::vector<GFace *> allFaces(allFacesSet.begin(), allFacesSet.end());
-  gr->set(allFaces);
+static bool isDelaunayVolumeAlgorithm()
+{
+  return CTX::instance()->mesh.algo3d == ALGO_3D_RTREE ||
+         CTX::instance()->mesh.algo3d == ALGO_3D_DELAUNAY ||
+         CTX::instance()->mesh.algo3d == ALGO_3D_INITIAL_ONLY ||
+         CTX::instance()->mesh.algo3d == ALGO_3D_MMG3D;
+}
 
-  std::set<GEdge *, GEntityPtrLessThan> allEmbEdgesSet;
-  for(std::size_t i = 0; i < regions.size(); i++) {
-    std::vector<GEdge *> const &e = regions[i]->embeddedEdges();
-    allEmbEdgesSet.insert(e.begin(), e.end());
-  }
-  std::vector<GEdge *> allEmbEdges(allEmbEdgesSet.begin(),
-                                   allEmbEdgesSet.end());
-  std::vector<GEdge *> oldEmbEdges = gr->embeddedEdges();
-  gr->embeddedEdges() = allEmbEdges;
-
-  std::set<GVertex *> allEmbVerticesSet;
-  for(std::size_t i = 0; i < regions.size(); i++) {
-    std::vector<GVertex *> const &e = regions[i]->embeddedVertices();
-    allEmbVerticesSet.insert(e.begin(), e.end());
+void RecoverDelaunayVolumeBoundaries(
+  std::vector<std::vector<GRegion *> > &connected,
+  std::vector<delaunayBoundaryRecovery> &recoveries)
+{
+  recoveries.clear();
+  recoveries.resize(connected.size());
+  if(!isDelaunayVolumeAlgorithm()) return;
+  // stop after the first failure, as when the groups are meshed one by one
+  if(CTX::instance()->abortOnError) return;
+
+  // groups whose boundary meshes share nodes with another group are left to
+  // MeshDelaunayVolume, as the recovery of their boundaries can modify the
+  // mesh of the same curves and surfaces
+  std::vector<delaunayGroupBoundary *> boundaries(connected.size(), nullptr);
+  std::vector<char> independent(connected.size(), 0);
+  std::map<MVertex *, std::size_t> owner;
+  for(std::size_t i = 0; i < connected.size(); i++) {
+    if(connected[i].empty()) continue;
+    boundaries[i] = new delaunayGroupBoundary(connected[i]);
+    independent[i] = 1;
+    GRegion *gr = boundaries[i]->region();
+    std::vector<MVertex *> verts(gr->mesh_vertices);
+    std::vector<GFace *> const &f = gr->faces();
+    for(auto it = f.begin(); it != f.end(); ++it) {
+      for(std::size_t j = 0; j < (*it)->getNumMeshElements(); j++) {
+        MElement *e = (*it)->getMeshElement(j);
+        for(std::size_t k = 0; k < e->getNumVertices(); k++)
+          verts.push_back(e->getVertex(k));
+      }
+    }
+    std::vector<GEdge *> const &e = gr->embeddedEdges();
+    for(auto it = e.begin(); it != e.end(); ++it) {
+      for(std::size_t j = 0; j < (*it)->lines.size(); j++) {
+        verts.push_back((*it)->lines[j]->getVertex(0));
+        verts.push_back((*it)->lines[j]->getVertex(1));
+      }
+    }
+    std::vector<GVertex *> const &v = gr->embeddedVertices();
+    for(auto it = v.begin(); it != v.end(); ++it) {
+      for(std::size_t j = 0; j < (*it)->points.size(); j++)
+        verts.push_back((*it)->points[j]->getVertex(0));
+    }
+    for(std::size_t j = 0; j < verts.size(); j++) {
+      auto it = owner.insert(std::make_pair(verts[j], i)).first;
+      if(it->second != i) {
+        independent[i] = 0;
+        independent[it->second] = 0;
+      }
+    }
   }
-  std::vector<GVertex *> allEmbVertices(allEmbVerticesSet.begin(),
-                                        allEmbVerticesSet.end());
-  std::vector<GVertex *> oldEmbVertices = gr->embeddedVertices();
-  gr->embeddedVertices() = allEmbVertices;
-
-  splitQuadRecovery sqr;
-  bool success = meshGRegionBoundaryRecovery(gr, &sqr);
-
-  // sort triangles in all model faces in order to be able to search in vectors
-  auto itf = allFaces.begin();
-  while(itf != allFaces.end()) {
-    std::sort((*itf)->triangles.begin(), (*itf)->triangles.end(),
-              compareMTriangleLexicographic());
-    ++itf;
+
+  std::vector<std::size_t> groups;
+  std::vector<GRegion *> regions;
+  std::vector<splitQuadRecovery *> sqr;
+  for(std::size_t i = 0; i < connected.size(); i++) {
+    if(!independent[i]) continue;
+    groups.push_back(i);
+    regions.push_back(boundaries[i]->region());
+    sqr.push_back(&recoveries[i].sqr);
   }
 
-  // restore set of faces and embedded edges/vertices
-  if(CTX::instance()->mesh.compoundClassify == 0) {
-    std::set<GFace *, GEntityPtrLessThan> comp;
-    for(std::size_t i = 0; i < faces.size(); i++) {
-      GFace *gf = faces[i];
-      if(!gf->compoundSurface)
-        comp.insert(gf);
-      else if(gf->compoundSurface)
-        comp.insert(gf->compoundSurface);
+  if(groups.size() > 1) {
+    Msg::Info("Recovering the boundaries of %lu independent volume groups",
+              groups.size());
+    std::vector<char> success;
+    meshGRegionBoundaryRecovery(regions, sqr, success);
+    for(std::size_t i = 0; i < groups.size(); i++) {
+      recoveries[groups[i]].done = true;
+      recoveries[groups[i]].success = success[i];
     }
-    std::vector<GFace *> lcomp(comp.begin(), comp.end());
-    gr->set(lcomp);
+  }
+
+  for(std::size_t i = 0; i < connected.size(); i++) {
+    if(!boundaries[i]) continue;
+    boundaries[i]->restore(recoveries[i].done);
+    delete boundaries[i];
+  }
+}
+
+void MeshDelaunayVolume(std::vector<GRegion *> &regions,
+                        delaunayBoundaryRecovery *recovery)
+{
+  if(regions.empty()) return;
+
+  if(CTX::instance()->mesh.algo3d == ALGO_3D_HXT) {
+    if(meshGRegionHxt(regions) != 0) { Msg::Error("HXT 3D mesh failed"); }
+    return;
+  }
+
+  if(!isDelaunayVolumeAlgorithm()) return;
+
+  GRegion *gr = regions[0];
+
+  splitQuadRecovery localSqr;
+  splitQuadRecovery &sqr = recovery ? recovery->sqr : localSqr;
+  bool success;
+  if(recovery && recovery->done) {
+    // the boundary has already been recovered, concurrently with the ones of
+    // other groups of volumes
+    success = recovery->success;
   }
   else {
-    gr->set(faces);
+    delaunayGroupBoundary boundary(regions);
+    success = meshGRegionBoundaryRecovery(gr, &sqr);
+    boundary.restore(true);
   }
-  gr->embeddedEdges() = oldEmbEdges;
-  gr->embeddedVertices() = oldEmbVertices;
 
   if(!success) return;
 
@@ -57,7 +57,6 @@ public:
   void operator()(GRegion *);
 };
 
-void MeshDelaunayVolume(std::vector<GRegion *> &delaunay);
 bool CreateAnEmptyVolumeMesh(GRegion *gr);
 int MeshTransfiniteVolume(GRegion *gr);
 int SubdivideExtrudedMesh(GModel *m);
@@ -89,6 +88,22 @@ public:
   int buildPyramids(GModel *gm);
 };
 
+// boundary recovery of a group of connected volumes, when it has been
+// performed before the group is meshed
+struct delaunayBoundaryRecovery {
+  bool done, success;
+  splitQuadRecovery sqr;
+  delaunayBoundaryRecovery() : done(false), success(false) {}
+};
+
+// recover concurrently the boundaries of the groups of connected volumes that
+// do not share any node with another group
+void RecoverDelaunayVolumeBoundaries(
+  std::vector<std::vector<GRegion *> > &connected,
+  std::vector<delaunayBoundaryRecovery> &recoveries);
+void MeshDelaunayVolume(std::vector<GRegion *> &delaunay,
+                        delaunayBoundaryRecovery *recovery = nullptr);
+
 // adapt the mesh of a region
 class adaptMeshGRegion {
 public:
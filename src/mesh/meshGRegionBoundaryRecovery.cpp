@@ -6,7 +6,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include "GmshConfig.h"
 #include "meshGRegionBoundaryRecovery.h"
 
@@ -68,6 +74,15 @@ namespace tetgenBR {
   struct brdata {
     GRegion *gr;
     splitQuadRecovery *sqr;
+    // state kept between the initial tetrahedralization and the recovery
+    bool initialized;
+    double t_start, w_start;
+    std::vector<MVertex *> vertices;
+    std::map<MVertex *, SPoint3> coordinates;
+    std::vector<MTetrahedron *> tets;
+    // nodes and elements created by the recovery
+    std::vector<MVertex *> newVertices;
+    std::vector<MElement *> newElements;
   };
 
   // dummy tetgenio class
@@ -140,19 +155,62 @@ namespace tetgenBR {
 #include "tetgenBR.cxx"
 #undef printf
 
-  int tetgenmesh::reconstructmesh(void *p, double tol /* unused */)
+  // segments and subfaces of the surface mesh, as sorted vertex numbers
+  struct brconstraints {
+    std::set<std::pair<int, int> > segments;
+    std::set<std::array<int, 3> > subfaces;
+  };
+
+  // missing segments and subfaces whose neighbourhoods in the initial mesh
+  // overlap, recovered together in a separate mesh (see recoverclusters)
+  struct brcluster {
+    const brconstraints *constraints;
+    // the missing segments (with a null third vertex) and subfaces
+    std::vector<std::array<tetgenmesh::point, 3> > missing;
+    // the tetrahedra of their neighbourhood
+    std::vector<tetgenmesh::tetrahedron *> tets;
+    // the tetrahedra replacing them: 4 vertices and 4 neighbours per
+    // tetrahedron, a neighbour being encoded as 16 times its index plus the
+    // version of the shared face, or -1 outside of the neighbourhood
+    std::vector<tetgenmesh::point> vertices;
+    std::vector<int> neighbors;
+    // the number of recovered segments and subfaces
+    long recovered;
+  };
+
+  static std::pair<int, int> edgekey(int a, int b)
+  {
+    return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+  }
+
+  static std::array<int, 3> facekey(int a, int b, int c)
+  {
+    std::array<int, 3> k = {{a, b, c}};
+    std::sort(k.begin(), k.end());
+    return k;
+  }
+
+  static int clusterroot(std::vector<int> &parent, int a)
   {
-    GRegion *_gr = ((brdata *)p)->gr;
-    splitQuadRecovery *_sqr = ((brdata *)p)->sqr;
+    while(parent[a] != a) a = parent[a] = parent[parent[a]];
+    return a;
+  }
+
+  int tetgenmesh::initialmesh(void *p)
+  {
+    brdata *data = (brdata *)p;
+    GRegion *_gr = data->gr;
+    splitQuadRecovery *_sqr = data->sqr;
 
     char opts[128];
     sprintf(opts, "YpeQT%gp/%g", CTX::instance()->mesh.toleranceInitialDelaunay,
             CTX::instance()->mesh.angleToleranceFacetOverlap);
     b->parse_commandline(opts);
 
-    double t_start = Cpu(), w_start = TimeOfDay();
-    std::vector<MVertex *> _vertices;
-    std::map<int, MVertex *> _extras;
+    data->initialized = true;
+    data->t_start = Cpu();
+    data->w_start = TimeOfDay();
+    std::vector<MVertex *> &_vertices = data->vertices;
     // Get the set of vertices from GRegion.
     {
       std::set<MVertex *, MVertexPtrLessThan> all;
@@ -213,19 +271,32 @@ namespace tetgenBR {
 
     // Store all coordinates of the vertices as these will be pertubated in
     // function delaunayTriangulation
-    std::map<MVertex *, SPoint3> originalCoordinates;
+    std::map<MVertex *, SPoint3> &originalCoordinates = data->coordinates;
     for(std::size_t i = 0; i < _vertices.size(); i++) {
       MVertex *v = _vertices[i];
       originalCoordinates[v] = v->point();
     }
 
-    std::vector<MTetrahedron *> tets;
-
-    delaunayMeshIn3D(_vertices,
-                     tets); // will add 8 MVertices at the end of _vertices
+    // will add 8 MVertices at the end of _vertices
+    delaunayMeshIn3D(_vertices, data->tets);
     if(Msg::GetErrorCount()) return 0;
 
     Msg::Debug("Points have been tetrahedralized");
+    return 1;
+  }
+
+  int tetgenmesh::reconstructmesh(void *p, double tol /* unused */)
+  {
+    brdata *data = (brdata *)p;
+    if(!data->initialized && !initialmesh(p)) return 0;
+
+    GRegion *_gr = data->gr;
+    splitQuadRecovery *_sqr = data->sqr;
+    double t_start = data->t_start, w_start = data->w_start;
+    std::vector<MVertex *> &_vertices = data->vertices;
+    std::map<MVertex *, SPoint3> &originalCoordinates = data->coordinates;
+    std::vector<MTetrahedron *> &tets = data->tets;
+    std::map<int, MVertex *> _extras;
 
     {
       point pointloop;
@@ -655,7 +726,17 @@ namespace tetgenBR {
 
       clock_t t;
       Msg::Info(" - Recovering boundary");
+      recoverclusters();
       recoverboundary(t);
+      for(int i = 0; i < brpasscount; i++) {
+        if(!brpassrecovered[i] && !brpasssteiner[i]) continue;
+        Msg::Info("   %s: %ld recovered, %ld Steiner point%s %s "
+                  "(Wall %gs)",
+                  brpassname[i], brpassrecovered[i],
+                  std::abs(brpasssteiner[i]),
+                  std::abs(brpasssteiner[i]) == 1 ? "" : "s",
+                  brpasssteiner[i] < 0 ? "removed" : "added", brpasstime[i]);
+      }
 
       carveholes();
 
@@ -767,9 +848,11 @@ namespace tetgenBR {
                   MEdgeVertex *v = new MEdgeVertex(pointloop[0], pointloop[1],
                                                    pointloop[2], ge, 0);
                   double uu = 0;
-                  if(reparamMeshVertexOnEdge(v, ge, uu)) {
-                    v->setParameter(0, uu);
-                  }
+                  bool ok;
+                  // the projection on built-in curves is not thread-safe
+#pragma omp critical(boundaryRecoveryReparam)
+                  ok = reparamMeshVertexOnEdge(v, ge, uu);
+                  if(ok) { v->setParameter(0, uu); }
                   v->setIndex(pointmark(pointloop));
                   _gr->mesh_vertices.push_back(v);
                   _extras[pointmark(pointloop) - in->firstnumber] = v;
@@ -789,7 +872,10 @@ namespace tetgenBR {
                       MFaceVertex *v = new MFaceVertex(
                         pointloop[0], pointloop[1], pointloop[2], gf, 0, 0);
                       SPoint2 param;
-                      if(reparamMeshVertexOnFace(v, gf, param)) {
+                      bool ok;
+#pragma omp critical(boundaryRecoveryReparam)
+                      ok = reparamMeshVertexOnFace(v, gf, param);
+                      if(ok) {
                         v->setParameter(0, param.x());
                         v->setParameter(1, param.y());
                       }
@@ -832,7 +918,10 @@ namespace tetgenBR {
                   MFaceVertex *v = new MFaceVertex(pointloop[0], pointloop[1],
                                                    pointloop[2], gf, 0, 0);
                   SPoint2 param;
-                  if(reparamMeshVertexOnFace(v, gf, param)) {
+                  bool ok;
+#pragma omp critical(boundaryRecoveryReparam)
+                  ok = reparamMeshVertexOnFace(v, gf, param);
+                  if(ok) {
                     v->setParameter(0, param.x());
                     v->setParameter(1, param.y());
                   }
@@ -865,6 +954,8 @@ namespace tetgenBR {
         if(!_extras.empty())
           Msg::Info(" - Added %d Steiner point%s", _extras.size(),
                     (_extras.size() > 1) ? "s" : "");
+        for(auto it = _extras.begin(); it != _extras.end(); ++it)
+          data->newVertices.push_back(it->second);
 
         if(l_edges.size() > 0) {
           // There are Steiner points on segments!
@@ -904,6 +995,7 @@ namespace tetgenBR {
                     _vertices[idx2];
                   MLine *t = new MLine(v1, v2);
                   ge->lines.push_back(t);
+                  data->newElements.push_back(t);
                 }
                 segloop.sh = shellfacetraverse(subsegs);
               }
@@ -961,6 +1053,7 @@ namespace tetgenBR {
                     _vertices[idx3];
                   MTriangle *t = new MTriangle(v1, v2, v3);
                   gf->triangles.push_back(t);
+                  data->newElements.push_back(t);
                 }
                 subloop.sh = shellfacetraverse(subfaces);
               }
@@ -997,6 +1090,7 @@ namespace tetgenBR {
             idx4 >= (int)_vertices.size() ? _extras[idx4] : _vertices[idx4];
           MTetrahedron *t = new MTetrahedron(v1, v2, v3, v4);
           _gr->tetrahedra.push_back(t);
+          data->newElements.push_back(t);
           tetloop.tet = tetrahedrontraverse();
         }
       } // mesh output
@@ -1019,6 +1113,482 @@ namespace tetgenBR {
       return 1;
     }
 
+  // Collect the tetrahedra (but not the hull tetrahedra) containing 'pt'.
+  void tetgenmesh::getpointstar(point pt, std::vector<tetrahedron *> &star)
+  {
+    triface t;
+    star.clear();
+    decode(point2tet(pt), t);
+    if(t.tet == nullptr || isdeadtet(t) || ishulltet(t)) return;
+    star.push_back(t.tet);
+    for(std::size_t k = 0; k < star.size(); k++) {
+      for(int i = 0; i < 4; i++) {
+        // the face opposite to the vertex 4 + i does not contain 'pt'
+        if((point)star[k][4 + i] == pt) continue;
+        decode(star[k][i], t);
+        if(t.tet == nullptr || ishulltet(t)) continue;
+        if(std::find(star.begin(), star.end(), t.tet) == star.end())
+          star.push_back(t.tet);
+      }
+    }
+  }
+
+  // Recover the missing segments and subfaces of a cluster by flips, in this
+  // (new) mesh, made of a copy of the tetrahedra of their neighbourhood. The
+  // faces on the boundary of the neighbourhood are hull faces and their edges
+  // are segments, so that they are never flipped: the new tetrahedra can then
+  // replace the old ones in the original mesh.
+  void tetgenmesh::recovercluster(void *p)
+  {
+    brcluster *c = (brcluster *)p;
+    const brconstraints *cons = c->constraints;
+    std::vector<triface> tets(c->tets.size());
+    std::unordered_map<tetrahedron *, int> index;
+    std::map<point, point> pts;
+    triface t, n, h, f1, f2;
+    face s;
+    point q;
+    int t1ver;
+
+    c->recovered = 0;
+    initializepools();
+
+    // Copy the vertices and the tetrahedra. The copied vertices keep their
+    //   number and point to their original (vertices have the same layout in
+    //   both meshes).
+    for(std::size_t k = 0; k < tets.size(); k++) index[c->tets[k]] = k;
+    for(std::size_t k = 0; k < tets.size(); k++) {
+      maketetrahedron(&tets[k]);
+      for(int j = 0; j < 4; j++) {
+        point pt = (point)c->tets[k][4 + j];
+        auto it = pts.find(pt);
+        if(it == pts.end()) {
+          makepoint(&q, pointtype(pt));
+          for(int i = 0; i < 3; i++) q[i] = pt[i];
+          setpointmark(q, pointmark(pt));
+          setpoint2ppt(q, pt);
+          pts[pt] = q;
+        }
+        else {
+          q = it->second;
+        }
+        tets[k].tet[4 + j] = (tetrahedron)q;
+      }
+    }
+    for(std::size_t k = 0; k < tets.size(); k++) {
+      for(int i = 0; i < 4; i++) {
+        decode(c->tets[k][i], n);
+        auto it = index.find(n.tet);
+        if(it != index.end())
+          tets[k].tet[i] = encode2(tets[it->second].tet, n.ver);
+      }
+    }
+
+    // Create the hull tets on the boundary of the neighbourhood, as in
+    //   reconstructmesh().
+    for(std::size_t k = 0; k < tets.size(); k++) {
+      t = tets[k];
+      for(t.ver = 0; t.ver < 4; t.ver++) {
+        if(t.tet[t.ver] != nullptr) continue;
+        maketetrahedron(&h);
+        setvertices(h, dest(t), org(t), apex(t), dummypoint);
+        bond(t, h);
+        for(int j = 0; j < 3; j++) {
+          fsym(h, f2);
+          while(1) {
+            if(f2.tet == nullptr) break;
+            esymself(f2);
+            if(apex(f2) == dummypoint) break;
+            fsymself(f2);
+          }
+          if(f2.tet != nullptr) {
+            esym(h, f1);
+            bond(f1, f2);
+          }
+          enextself(h);
+        }
+      }
+      for(int j = 0; j < 4; j++)
+        setpoint2tet((point)tets[k].tet[4 + j], encode(tets[k]));
+    }
+    recenttet = tets[0];
+
+    // The edges on the boundary of the neighbourhood, and the segments which
+    //   are already in the mesh, are segments.
+    checksubsegflag = 1;
+    for(std::size_t k = 0; k < tets.size(); k++) {
+      t.tet = tets[k].tet;
+      for(int e = 0; e < 6; e++) {
+        t.ver = edge2ver[e];
+        if(issubseg(t)) continue;
+        point pa = org(t), pb = dest(t);
+        bool bnd = false;
+        for(int i = 0; i < 4 && !bnd; i++) {
+          // the face opposite to the vertex 4 + i contains the edge
+          if((point)t.tet[4 + i] == pa || (point)t.tet[4 + i] == pb) continue;
+          decode(t.tet[i], n);
+          bnd = ishulltet(n);
+        }
+        if(!bnd &&
+           !cons->segments.count(edgekey(pointmark(pa), pointmark(pb))))
+          continue;
+        makeshellface(subsegs, &s);
+        setshvertices(s, pa, pb, nullptr);
+        sstbond1(s, t);
+        n = t;
+        do {
+          tssbond1(n, s);
+          fnextself(n);
+        } while(n.tet != t.tet);
+      }
+    }
+
+    std::vector<std::array<point, 3> > segs, subs, miss;
+    for(std::size_t i = 0; i < c->missing.size(); i++) {
+      const std::array<point, 3> &v = c->missing[i];
+      std::array<point, 3> w = {{pts[v[0]], pts[v[1]], nullptr}};
+      if(v[2]) {
+        w[2] = pts[v[2]];
+        subs.push_back(w);
+      }
+      else {
+        segs.push_back(w);
+      }
+    }
+
+    // Recover the missing segments by flips, increasing the flip link level
+    //   as long as some are recovered, then with a full search.
+    for(int fullsearch = 0; fullsearch < 2; fullsearch++) {
+      autofliplinklevel = 1;
+      for(int nit = 0; !segs.empty() && nit < (fullsearch ? 1 : 3);) {
+        miss.clear();
+        for(std::size_t i = 0; i < segs.size(); i++) {
+          point pa = segs[i][0], pb = segs[i][1];
+          if(!recoveredgebyflips(pa, pb, nullptr, &t, fullsearch) &&
+             !recoveredgebyflips(pb, pa, nullptr, &t, fullsearch)) {
+            miss.push_back(segs[i]);
+            continue;
+          }
+          makeshellface(subsegs, &s);
+          setshvertices(s, org(t), dest(t), nullptr);
+          sstbond1(s, t);
+          n = t;
+          do {
+            tssbond1(n, s);
+            fnextself(n);
+          } while(n.tet != t.tet);
+          c->recovered++;
+        }
+        nit = (miss.size() < segs.size()) ? 0 : nit + 1;
+        segs.swap(miss);
+        autofliplinklevel += b->fliplinklevelinc;
+      }
+    }
+
+    // Then recover the missing subfaces whose edges exist, the subfaces which
+    //   are already in the mesh being protected.
+    checksubfaceflag = 1;
+    tetrahedrons->traversalinit();
+    t.tet = tetrahedrontraverse();
+    while(t.tet != nullptr) {
+      for(t.ver = 0; t.ver < 4; t.ver++) {
+        if(issubface(t) ||
+           !cons->subfaces.count(facekey(
+             pointmark(org(t)), pointmark(dest(t)), pointmark(apex(t)))))
+          continue;
+        makeshellface(subfaces, &s);
+        setshvertices(s, org(t), dest(t), apex(t));
+        tsbond(t, s);
+        fsym(t, n);
+        sesymself(s);
+        tsbond(n, s);
+      }
+      t.tet = tetrahedrontraverse();
+    }
+    autofliplinklevel = 1;
+    for(int nit = 0; !subs.empty() && nit < 3;) {
+      miss.clear();
+      for(std::size_t i = 0; i < subs.size(); i++) {
+        bool edges = true;
+        for(int j = 0; j < 3 && edges; j++) {
+          point2tetorg(subs[i][j], t);
+          finddirection(&t, subs[i][(j + 1) % 3]);
+          edges = (dest(t) == subs[i][(j + 1) % 3]);
+        }
+        if(!edges || !recoverfacebyflips(subs[i][0], subs[i][1], subs[i][2],
+                                         nullptr, &t)) {
+          miss.push_back(subs[i]);
+          continue;
+        }
+        makeshellface(subfaces, &s);
+        setshvertices(s, org(t), dest(t), apex(t));
+        tsbond(t, s);
+        fsymself(t);
+        sesymself(s);
+        tsbond(t, s);
+        c->recovered++;
+      }
+      nit = (miss.size() < subs.size()) ? 0 : nit + 1;
+      subs.swap(miss);
+      autofliplinklevel += b->fliplinklevelinc;
+    }
+    if(!c->recovered) return;
+
+    // Save the new tetrahedra, with the original vertices.
+    index.clear();
+    tetrahedrons->traversalinit();
+    t.tet = tetrahedrontraverse();
+    while(t.tet != nullptr) {
+      int k = index.size();
+      index[t.tet] = k;
+      t.tet = tetrahedrontraverse();
+    }
+    c->vertices.resize(4 * index.size());
+    c->neighbors.resize(4 * index.size());
+    for(auto it = index.begin(); it != index.end(); ++it) {
+      for(int i = 0; i < 4; i++) {
+        c->vertices[4 * it->second + i] = point2ppt((point)it->first[4 + i]);
+        decode(it->first[i], n);
+        c->neighbors[4 * it->second + i] =
+          ishulltet(n) ? -1 : 16 * index[n.tet] + n.ver;
+      }
+    }
+  }
+
+  // Recover the missing segments and subfaces by flips, in clusters whose
+  // neighbourhoods do not overlap, concurrently. The new tetrahedra are then
+  // put back into the mesh one cluster after the other, so that the result
+  // does not depend on the number of threads. What could not be recovered is
+  // left to recoverboundary().
+  long tetgenmesh::recoverclusters()
+  {
+    REAL tpass = walltime();
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+    // Get all the segments and subfaces.
+    brconstraints cons;
+    std::vector<std::array<point, 3> > all;
+    face s;
+    s.shver = 0;
+    subsegs->traversalinit();
+    s.sh = shellfacetraverse(subsegs);
+    while(s.sh != nullptr) {
+      std::array<point, 3> v = {{sorg(s), sdest(s), nullptr}};
+      cons.segments.insert(edgekey(pointmark(v[0]), pointmark(v[1])));
+      all.push_back(v);
+      s.sh = shellfacetraverse(subsegs);
+    }
+    subfaces->traversalinit();
+    s.sh = shellfacetraverse(subfaces);
+    while(s.sh != nullptr) {
+      std::array<point, 3> v = {{sorg(s), sdest(s), sapex(s)}};
+      cons.subfaces.insert(
+        facekey(pointmark(v[0]), pointmark(v[1]), pointmark(v[2])));
+      all.push_back(v);
+      s.sh = shellfacetraverse(subfaces);
+    }
+
+    // Find the missing ones: they are not in a tetrahedron containing their
+    //   first vertex.
+    std::vector<char> missing(all.size(), 0);
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
+    for(std::size_t i = 0; i < all.size(); i++) {
+      std::vector<tetrahedron *> star;
+      getpointstar(all[i][0], star);
+      if(star.empty()) continue;
+      int nv = all[i][2] ? 2 : 1;
+      missing[i] = 1;
+      for(std::size_t k = 0; k < star.size() && missing[i]; k++) {
+        int found = 0;
+        for(int j = 4; j < 8; j++) {
+          point pt = (point)star[k][j];
+          if(pt == all[i][1] || (all[i][2] && pt == all[i][2])) found++;
+        }
+        if(found == nv) missing[i] = 0;
+      }
+    }
+    std::vector<std::size_t> ents;
+    for(std::size_t i = 0; i < all.size(); i++)
+      if(missing[i]) ents.push_back(i);
+    if(ents.empty()) return 0;
+
+    // The neighbourhood of a missing segment or subface is made of the
+    //   tetrahedra around its vertices, of the tetrahedra connected to them
+    //   through faces it intersects, and of all the tetrahedra around the
+    //   edges of these, so that the faces and edges it intersects can be
+    //   flipped.
+    std::vector<std::vector<tetrahedron *> > regions(ents.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t e = 0; e < ents.size(); e++) {
+      const std::array<point, 3> &v = all[ents[e]];
+      int nv = v[2] ? 3 : 2;
+      std::vector<tetrahedron *> &r = regions[e], star;
+      std::unordered_set<tetrahedron *> in;
+      triface t, n;
+      point f[3];
+      int t1ver;
+      for(int j = 0; j < nv; j++) {
+        getpointstar(v[j], star);
+        if(star.empty()) {
+          r.clear();
+          break;
+        }
+        for(std::size_t k = 0; k < star.size(); k++)
+          if(in.insert(star[k]).second) r.push_back(star[k]);
+      }
+      if(r.empty()) continue;
+      for(std::size_t k = 0; k < r.size(); k++) {
+        for(int i = 0; i < 4; i++) {
+          decode(r[k][i], n);
+          if(n.tet == nullptr || ishulltet(n) || in.count(n.tet)) continue;
+          // the face opposite to the vertex 4 + i
+          for(int j = 0, l = 0; j < 4; j++)
+            if(j != i) f[l++] = (point)r[k][4 + j];
+          int inter;
+          if(nv == 3) {
+            inter = tri_tri_inter(f[0], f[1], f[2], v[0], v[1], v[2]);
+          }
+          else {
+            inter = tri_edge_inter_tail(f[0], f[1], f[2], v[0], v[1],
+                                        orient3d(f[0], f[1], f[2], v[0]),
+                                        orient3d(f[0], f[1], f[2], v[1]));
+          }
+          if(inter != (int)DISJOINT) {
+            in.insert(n.tet);
+            r.push_back(n.tet);
+          }
+        }
+      }
+      std::size_t nr = r.size();
+      for(std::size_t k = 0; k < nr; k++) {
+        t.tet = r[k];
+        for(int j = 0; j < 6; j++) {
+          t.ver = edge2ver[j];
+          n = t;
+          do {
+            if(!ishulltet(n) && in.insert(n.tet).second) r.push_back(n.tet);
+            fnextself(n);
+          } while(n.tet != t.tet);
+        }
+      }
+    }
+
+    // Group the missing segments and subfaces whose neighbourhoods overlap.
+    std::vector<int> parent(ents.size());
+    for(std::size_t e = 0; e < ents.size(); e++) parent[e] = e;
+    std::unordered_map<tetrahedron *, int> owner;
+    for(std::size_t e = 0; e < ents.size(); e++) {
+      for(std::size_t k = 0; k < regions[e].size(); k++) {
+        auto it = owner.insert(std::make_pair(regions[e][k], (int)e));
+        if(it.second) continue;
+        int a = clusterroot(parent, e), b = clusterroot(parent, it.first->second);
+        if(a != b) parent[std::max(a, b)] = std::min(a, b);
+      }
+    }
+    std::vector<brcluster> clusters;
+    std::vector<int> cluster(ents.size(), -1);
+    std::unordered_set<tetrahedron *> added;
+    for(std::size_t e = 0; e < ents.size(); e++) {
+      if(regions[e].empty()) continue;
+      int r = clusterroot(parent, e);
+      if(cluster[r] < 0) {
+        cluster[r] = clusters.size();
+        clusters.push_back(brcluster());
+        clusters.back().constraints = &cons;
+        clusters.back().recovered = 0;
+      }
+      brcluster &c = clusters[cluster[r]];
+      c.missing.push_back(all[ents[e]]);
+      for(std::size_t k = 0; k < regions[e].size(); k++)
+        if(added.insert(regions[e][k]).second) c.tets.push_back(regions[e][k]);
+    }
+    Msg::Info(" - Recovering %d missing segments and subfaces in %d "
+              "clusters", (int)ents.size(), (int)clusters.size());
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = 0; i < clusters.size(); i++) {
+      tetgenio cin;
+      tetgenbehavior cb(*b);
+      // the neighbourhoods are small
+      cb.vertexperblock = cb.shellfaceperblock = 256;
+      cb.tetrahedraperblock = 1024;
+      tetgenmesh m;
+      m.in = &cin;
+      m.b = &cb;
+      try {
+        m.recovercluster((void *)&clusters[i]);
+      } catch(int) {
+        // leave the whole cluster to recoverboundary()
+        clusters[i].recovered = 0;
+      }
+    }
+
+    // Replace the tetrahedra of the neighbourhoods, one cluster after the
+    //   other: the neighbours of the faces on the boundary of a neighbourhood
+    //   are found from its old tetrahedra, as they may have been replaced.
+    long recovered = 0;
+    triface t, n;
+    for(std::size_t i = 0; i < clusters.size(); i++) {
+      brcluster &c = clusters[i];
+      if(!c.recovered) continue;
+      std::unordered_set<tetrahedron *> old(c.tets.begin(), c.tets.end());
+      std::map<std::array<int, 3>, triface> bnd;
+      for(std::size_t k = 0; k < c.tets.size(); k++) {
+        t.tet = c.tets[k];
+        for(t.ver = 0; t.ver < 4; t.ver++) {
+          fsym(t, n);
+          if(old.count(n.tet)) continue;
+          bnd[facekey(pointmark(org(t)), pointmark(dest(t)),
+                      pointmark(apex(t)))] = n;
+        }
+      }
+      std::size_t nt = c.vertices.size() / 4, nb = 0;
+      for(std::size_t k = 0; k < nt; k++) {
+        for(int f = 0; f < 4; f++) {
+          if(c.neighbors[4 * k + f] >= 0) continue;
+          std::array<int, 3> key;
+          for(int j = 0, l = 0; j < 4; j++)
+            if(j != f) key[l++] = pointmark(c.vertices[4 * k + j]);
+          if(bnd.count(facekey(key[0], key[1], key[2]))) nb++;
+        }
+      }
+      // this should never happen, but keep the old tetrahedra if the new ones
+      // do not have the same boundary
+      if(nb != bnd.size()) continue;
+      for(std::size_t k = 0; k < c.tets.size(); k++)
+        tetrahedrondealloc(c.tets[k]);
+      std::vector<triface> tets(nt);
+      for(std::size_t k = 0; k < nt; k++) {
+        maketetrahedron(&tets[k]);
+        for(int j = 0; j < 4; j++)
+          tets[k].tet[4 + j] = (tetrahedron)c.vertices[4 * k + j];
+      }
+      for(std::size_t k = 0; k < nt; k++) {
+        for(int f = 0; f < 4; f++) {
+          int nbr = c.neighbors[4 * k + f];
+          if(nbr >= 0) {
+            tets[k].tet[f] = encode2(tets[nbr / 16].tet, nbr % 16);
+            continue;
+          }
+          t = tets[k];
+          t.ver = f;
+          n = bnd[facekey(pointmark(org(t)), pointmark(dest(t)),
+                          pointmark(apex(t)))];
+          for(int j = 0; j < 3 && org(n) != dest(t); j++) enextself(n);
+          bond(t, n);
+        }
+        for(int j = 0; j < 4; j++)
+          setpoint2tet((point)tets[k].tet[4 + j], encode(tets[k]));
+      }
+      recenttet = tets[0];
+      recovered += c.recovered;
+    }
+
+    addrecoverypass("segments and subfaces in clusters", recovered, 0l, tpass);
+    return recovered;
+  }
+
     // Dump the input surface mesh.
     // 'mfilename' is a filename without suffix.
     void tetgenmesh::outsurfacemesh(const char *mfilename)
@@ -1214,141 +1784,219 @@ namespace tetgenBR {
 
   } // namespace tetgenBR
 
-  bool meshGRegionBoundaryRecovery(GRegion *gr, splitQuadRecovery *sqr)
+  static void reportBoundaryRecoveryError(GRegion *gr, int err)
   {
-    bool ret = false;
-    try {
-      tetgenBR::tetgenmesh *m = new tetgenBR::tetgenmesh();
-      m->in = new tetgenBR::tetgenio();
-      m->b = new tetgenBR::tetgenbehavior();
-      tetgenBR::brdata data = {gr, sqr};
-      ret = m->reconstructmesh((void *)&data, 0.);
-      delete m->in;
-      delete m->b;
-      delete m;
-    } catch(int err) {
-      if(err == 1) {
-        Msg::Error("Out of memory in boundary mesh recovery");
-        ret = false;
-      }
-      else if(err == 3) {
-        std::map<int, MVertex *> all;
-        std::vector<GFace *> f = gr->faces();
-        for(auto it = f.begin(); it != f.end(); ++it) {
-          GFace *gf = *it;
-          for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-            for(int j = 0; j < 3; j++) {
-              MVertex *v = gf->triangles[i]->getVertex(j);
-              all[v->getIndex()] = v;
-            }
-          }
-        }
-        std::vector<GEdge *> const &e = gr->embeddedEdges();
-        for(auto it = e.begin(); it != e.end(); ++it) {
-          GEdge *ge = *it;
-          for(std::size_t i = 0; i < ge->lines.size(); i++) {
-            for(int j = 0; j < 2; j++) {
-              MVertex *v = ge->lines[i]->getVertex(j);
-              all[v->getIndex()] = v;
-            }
+    if(err == 1) {
+      Msg::Error("Out of memory in boundary mesh recovery");
+      return;
+    }
+    else if(err != 3) {
+      Msg::Error("Could not recover boundary mesh: error %d", err);
+      return;
+    }
+#pragma omp critical(boundaryRecoveryError)
+    {
+      std::map<int, MVertex *> all;
+      std::vector<GFace *> f = gr->faces();
+      for(auto it = f.begin(); it != f.end(); ++it) {
+        GFace *gf = *it;
+        for(std::size_t i = 0; i < gf->triangles.size(); i++) {
+          for(int j = 0; j < 3; j++) {
+            MVertex *v = gf->triangles[i]->getVertex(j);
+            all[v->getIndex()] = v;
           }
         }
-        std::vector<GVertex *> const &v = gr->embeddedVertices();
-        for(auto it = v.begin(); it != v.end(); ++it) {
-          GVertex *gv = *it;
-          for(std::size_t i = 0; i < gv->points.size(); i++) {
-            MVertex *v = gv->points[i]->getVertex(0);
+      }
+      std::vector<GEdge *> const &e = gr->embeddedEdges();
+      for(auto it = e.begin(); it != e.end(); ++it) {
+        GEdge *ge = *it;
+        for(std::size_t i = 0; i < ge->lines.size(); i++) {
+          for(int j = 0; j < 2; j++) {
+            MVertex *v = ge->lines[i]->getVertex(j);
             all[v->getIndex()] = v;
           }
         }
-        for(std::size_t i = 0; i < gr->mesh_vertices.size(); i++) {
-          MVertex *v = gr->mesh_vertices[i];
+      }
+      std::vector<GVertex *> const &v = gr->embeddedVertices();
+      for(auto it = v.begin(); it != v.end(); ++it) {
+        GVertex *gv = *it;
+        for(std::size_t i = 0; i < gv->points.size(); i++) {
+          MVertex *v = gv->points[i]->getVertex(0);
           all[v->getIndex()] = v;
         }
-        std::string what;
-        bool pnt = true;
-        switch(tetgenBR::sevent.e_type) {
-        case 1: what = "segment-segment intersection"; break;
-        case 2: what = "segment-facet intersection"; break;
-        case 3: what = "facet-facet intersection"; break;
-        case 4:
-          what = "overlapping segments";
-          pnt = false;
-          break;
-        case 5:
-          what = "segment in facet";
-          pnt = false;
-          break;
-        case 6:
-          what = "overlapping facets";
-          pnt = false;
-          break;
-        case 7: what = "vertex in segment"; break;
-        case 8: what = "vertex in facet"; break;
-        default: what = "unknown"; break;
-        }
-        int vtags[2][3] = {
-          {tetgenBR::sevent.f_vertices1[0], tetgenBR::sevent.f_vertices1[1],
-           tetgenBR::sevent.f_vertices1[2]},
-          {tetgenBR::sevent.f_vertices2[0], tetgenBR::sevent.f_vertices2[1],
-           tetgenBR::sevent.f_vertices2[2]}};
-        int ftags[2] = {tetgenBR::sevent.f_marker1, tetgenBR::sevent.f_marker2};
-        int etags[2] = {tetgenBR::sevent.s_marker1, tetgenBR::sevent.s_marker2};
-        std::ostringstream pb;
-        std::vector<double> x, y, z, val;
-        for(int f = 0; f < 2; f++) {
-          if(ftags[f] > 0) {
-            GFace *gf = gr->model()->getFaceByTag(ftags[f]);
-            if(gf) {
-              gr->model()->addLastMeshEntityError(gf);
-              pb << " surface " << ftags[f];
-            }
-          }
-          if(etags[f] > 0) {
-            GEdge *ge = gr->model()->getEdgeByTag(etags[f]);
-            if(ge) {
-              gr->model()->addLastMeshEntityError(ge);
-              pb << " curve " << etags[f];
-            }
+      }
+      for(std::size_t i = 0; i < gr->mesh_vertices.size(); i++) {
+        MVertex *v = gr->mesh_vertices[i];
+        all[v->getIndex()] = v;
+      }
+      std::string what;
+      bool pnt = true;
+      switch(tetgenBR::sevent.e_type) {
+      case 1: what = "segment-segment intersection"; break;
+      case 2: what = "segment-facet intersection"; break;
+      case 3: what = "facet-facet intersection"; break;
+      case 4:
+        what = "overlapping segments";
+        pnt = false;
+        break;
+      case 5:
+        what = "segment in facet";
+        pnt = false;
+        break;
+      case 6:
+        what = "overlapping facets";
+        pnt = false;
+        break;
+      case 7: what = "vertex in segment"; break;
+      case 8: what = "vertex in facet"; break;
+      default: what = "unknown"; break;
+      }
+      int vtags[2][3] = {
+        {tetgenBR::sevent.f_vertices1[0], tetgenBR::sevent.f_vertices1[1],
+         tetgenBR::sevent.f_vertices1[2]},
+        {tetgenBR::sevent.f_vertices2[0], tetgenBR::sevent.f_vertices2[1],
+         tetgenBR::sevent.f_vertices2[2]}};
+      int ftags[2] = {tetgenBR::sevent.f_marker1, tetgenBR::sevent.f_marker2};
+      int etags[2] = {tetgenBR::sevent.s_marker1, tetgenBR::sevent.s_marker2};
+      std::ostringstream pb;
+      std::vector<double> x, y, z, val;
+      for(int f = 0; f < 2; f++) {
+        if(ftags[f] > 0) {
+          GFace *gf = gr->model()->getFaceByTag(ftags[f]);
+          if(gf) {
+            gr->model()->addLastMeshEntityError(gf);
+            pb << " surface " << ftags[f];
           }
-          for(int i = 0; i < 3; i++) {
-            MVertex *v = all[vtags[f][i]];
-            if(v) {
-              gr->model()->addLastMeshVertexError(v);
-              x.push_back(v->x());
-              y.push_back(v->y());
-              z.push_back(v->z());
-              val.push_back(f);
-            }
+        }
+        if(etags[f] > 0) {
+          GEdge *ge = gr->model()->getEdgeByTag(etags[f]);
+          if(ge) {
+            gr->model()->addLastMeshEntityError(ge);
+            pb << " curve " << etags[f];
           }
         }
-        if(pnt) {
-          double px = tetgenBR::sevent.int_point[0];
-          double py = tetgenBR::sevent.int_point[1];
-          double pz = tetgenBR::sevent.int_point[2];
-          pb << ", intersection (" << px << "," << py << "," << pz << ")";
-          x.push_back(px);
-          y.push_back(py);
-          z.push_back(pz);
-          val.push_back(3.);
+        for(int i = 0; i < 3; i++) {
+          MVertex *v = all[vtags[f][i]];
+          if(v) {
+            gr->model()->addLastMeshVertexError(v);
+            x.push_back(v->x());
+            y.push_back(v->y());
+            z.push_back(v->z());
+            val.push_back(f);
+          }
         }
-        Msg::Error("Invalid boundary mesh (%s) on%s", what.c_str(),
-                   pb.str().c_str());
+      }
+      if(pnt) {
+        double px = tetgenBR::sevent.int_point[0];
+        double py = tetgenBR::sevent.int_point[1];
+        double pz = tetgenBR::sevent.int_point[2];
+        pb << ", intersection (" << px << "," << py << "," << pz << ")";
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        val.push_back(3.);
+      }
+      Msg::Error("Invalid boundary mesh (%s) on%s", what.c_str(),
+                 pb.str().c_str());
 #if defined(HAVE_POST)
-        new PView("Boundary mesh issue", x, y, z, val);
+      new PView("Boundary mesh issue", x, y, z, val);
 #if defined(HAVE_FLTK)
-        if(FlGui::available()) FlGui::instance()->updateViews(true, true);
+      if(FlGui::available() && Msg::GetThreadNum() == 0) {
+        FlGui::instance()->updateViews(true, true);
         drawContext::global()->draw();
+      }
 #endif
 #endif
-        ret = false;
+    }
+  }
+
+  static tetgenBR::tetgenmesh *newBoundaryRecoveryMesh()
+  {
+    tetgenBR::tetgenmesh *m = new tetgenBR::tetgenmesh();
+    m->in = new tetgenBR::tetgenio();
+    m->b = new tetgenBR::tetgenbehavior();
+    return m;
+  }
+
+  static void deleteBoundaryRecoveryMesh(tetgenBR::tetgenmesh *m)
+  {
+    delete m->in;
+    delete m->b;
+    delete m;
+  }
+
+  bool meshGRegionBoundaryRecovery(GRegion *gr, splitQuadRecovery *sqr)
+  {
+    bool ret = false;
+    tetgenBR::tetgenmesh *m = newBoundaryRecoveryMesh();
+    try {
+      tetgenBR::brdata data = {gr, sqr, false};
+      ret = m->reconstructmesh((void *)&data, 0.);
+    } catch(int err) {
+      reportBoundaryRecoveryError(gr, err);
+      ret = false;
+    }
+    deleteBoundaryRecoveryMesh(m);
+    return ret;
+  }
+
+  void meshGRegionBoundaryRecovery(std::vector<GRegion *> &regions,
+                                   std::vector<splitQuadRecovery *> &sqr,
+                                   std::vector<char> &success)
+  {
+    std::size_t n = regions.size();
+    success.assign(n, 0);
+    std::vector<tetgenBR::tetgenmesh *> meshes(n);
+    std::vector<tetgenBR::brdata> data(n);
+    std::vector<char> initialized(n, 0);
+
+    // compute the initial tetrahedralizations one after the other, as they
+    // perturb the nodes with rand() and reset the filters of the predicates
+    double maxx = 0., maxy = 0., maxz = 0.;
+    for(std::size_t i = 0; i < n; i++) {
+      meshes[i] = newBoundaryRecoveryMesh();
+      data[i].gr = regions[i];
+      data[i].sqr = sqr[i];
+      data[i].initialized = false;
+      try {
+        initialized[i] = meshes[i]->initialmesh((void *)&data[i]);
+      } catch(int err) {
+        reportBoundaryRecoveryError(regions[i], err);
       }
-      else {
-        Msg::Error("Could not recover boundary mesh: error %d", err);
-        ret = false;
+      for(auto it = data[i].coordinates.begin();
+          it != data[i].coordinates.end(); ++it) {
+        maxx = std::max(maxx, std::abs(it->second.x()));
+        maxy = std::max(maxy, std::abs(it->second.y()));
+        maxz = std::max(maxz, std::abs(it->second.z()));
       }
     }
-    return ret;
+
+    // then recover the missing segments and facets in all the volumes
+    // concurrently, with filters valid for all of them
+    robustPredicates::exactinit(maxx, maxy, maxz);
+    std::size_t vertexNum = GModel::current()->getMaxVertexNumber();
+    std::size_t elementNum = GModel::current()->getMaxElementNumber();
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = 0; i < n; i++) {
+      if(!initialized[i]) continue;
+      try {
+        success[i] = meshes[i]->reconstructmesh((void *)&data[i], 0.);
+      } catch(int err) {
+        reportBoundaryRecoveryError(regions[i], err);
+      }
+    }
+
+    // number the new nodes and elements as if the volumes had been processed
+    // one after the other
+    for(std::size_t i = 0; i < n; i++) {
+      for(std::size_t j = 0; j < data[i].newVertices.size(); j++)
+        data[i].newVertices[j]->forceNum(++vertexNum);
+      for(std::size_t j = 0; j < data[i].newElements.size(); j++)
+        data[i].newElements[j]->forceNum(++elementNum);
+      deleteBoundaryRecoveryMesh(meshes[i]);
+    }
   }
 
 #else
@@ -1358,4 +2006,11 @@ bool meshGRegionBoundaryRecovery(GRegion *gr, splitQuadRecovery *sqr)
   return false;
 }
 
+void meshGRegionBoundaryRecovery(std::vector<GRegion *> &regions,
+                                 std::vector<splitQuadRecovery *> &sqr,
+                                 std::vector<char> &success)
+{
+  success.assign(regions.size(), 0);
+}
+
 #endif
@@ -6,9 +6,17 @@
 #ifndef MESH_GREGION_BOUNDARY_RECOVERY_H
 #define MESH_GREGION_BOUNDARY_RECOVERY_H
 
+#include <vector>
+
 class GRegion;
 class splitQuadRecovery;
 
 bool meshGRegionBoundaryRecovery(GRegion *gr, splitQuadRecovery *sqr = nullptr);
 
+// recover the boundaries of several volumes concurrently; the boundary meshes
+// of the volumes should not share any node
+void meshGRegionBoundaryRecovery(std::vector<GRegion *> &regions,
+                                 std::vector<splitQuadRecovery *> &sqr,
+                                 std::vector<char> &success);
+
 #endif
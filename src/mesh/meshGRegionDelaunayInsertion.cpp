@@ -364,8 +364,11 @@ static bool verifyShell(MVertex *v, MTet4 *t, std::vector<faceXtet> &shell)
   return (NBAD_AFTER < NBAD_BEFORE);
 }
 
+// if part is >= 0, the cavity is not allowed to grow outside of the given
+// part: in that case the function returns -2
 int makeCavityStarShaped(std::vector<faceXtet> &shell,
-                         std::vector<MTet4 *> &cavity, MVertex *v)
+                         std::vector<MTet4 *> &cavity, MVertex *v,
+                         int part = -1)
 {
   std::vector<faceXtet> wrong;
   for(auto it = shell.begin(); it != shell.end(); ++it) {
@@ -380,9 +383,12 @@ int makeCavityStarShaped(std::vector<faceXtet> &shell,
   while(!wrong.empty()) {
     faceXtet &fxt = *(wrong.begin());
     if(std::find(shell.begin(), shell.end(), fxt) != shell.end()) {
-      if(fxt.t1->getNeigh(fxt.i1) &&
-         fxt.t1->getNeigh(fxt.i1)->onWhat() == fxt.t1->onWhat() &&
-         verifyShell(v, fxt.t1->getNeigh(fxt.i1), shell)) {
+      MTet4 *neigh = fxt.t1->getNeigh(fxt.i1);
+      // check the part of the neighbor before accessing its data, as it might
+      // be modified concurrently by the refinement of another part
+      if(neigh && part >= 0 && neigh->getPart() != part) return -2;
+      if(neigh && neigh->onWhat() == fxt.t1->onWhat() &&
+         verifyShell(v, neigh, shell)) {
         extendCavity(shell, cavity, fxt);
       }
       else if(verifyShell(v, fxt.t1, shell)) {
@@ -431,6 +437,51 @@ void findCavity(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
   }
 }
 
+// same as findCavity, but give up (and leave the tets unchanged) as soon as the
+// cavity reaches a tet that does not belong to the part of t; the part of a
+// tet is always checked before accessing its data, so that this can be called
+// while the other parts are being refined
+static bool findCavityInPart(std::vector<faceXtet> &shell,
+                             std::vector<MTet4 *> &cavity, const double *p,
+                             MTet4 *t)
+{
+  int part = t->getPart();
+  t->setDeleted(true);
+  cavity.push_back(t);
+  for(std::size_t k = 0; k < cavity.size(); k++) {
+    for(int i = 0; i < 4; i++) {
+      MTet4 *const neighbour = cavity[k]->getNeigh(i);
+      if(!neighbour) { shell.push_back(faceXtet(cavity[k], i)); }
+      else if(neighbour->getPart() != part) {
+        for(auto c : cavity) c->setDeleted(false);
+        return false;
+      }
+      else if(!neighbour->isDeleted()) {
+        if(neighbour->inCircumSphere(p) &&
+           (neighbour->onWhat() == cavity[k]->onWhat())) {
+          neighbour->setDeleted(true);
+          cavity.push_back(neighbour);
+        }
+        else {
+          shell.push_back(faceXtet(cavity[k], i));
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// check that the tets on both sides of the shell belong to the given part
+static bool isShellInPart(const std::vector<faceXtet> &shell, int part)
+{
+  for(auto &f : shell) {
+    if(f.t1->getPart() != part) return false;
+    MTet4 *otherSide = f.t1->getNeigh(f.i1);
+    if(otherSide && otherSide->getPart() != part) return false;
+  }
+  return true;
+}
+
 #ifdef PRINT_TETS
 
 static void printTets(const char *fn, std::list<MTet4 *> &cavity,
@@ -456,17 +507,21 @@ static void printTets(const char *fn, std::list<MTet4 *> &cavity,
 
 #endif
 
-bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
-                   MVertex *v, double lc1, double lc2,
-                   std::vector<double> &vSizes, std::vector<double> &vSizesBGM,
-                   MTet4 *t, MTet4Factory &myFactory,
-                   std::set<MTet4 *, compareTet4Ptr> &allTets,
-                   const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+// create the tets connecting the shell to v and store them in new_tets
+// (without inserting them in the set of all tets, so that this can be called
+// concurrently on cavities that do not touch each other)
+static bool
+insertVertexInCavity(std::vector<faceXtet> &shell,
+                     std::vector<MTet4 *> &cavity, MVertex *v, double lc1,
+                     double lc2, std::vector<double> &vSizes,
+                     std::vector<double> &vSizesBGM, MTet4 *t,
+                     MTet4Factory &myFactory, std::vector<MTet4 *> &new_tets,
+                     const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
 {
   std::vector<MTet4 *> new_cavity;
   new_cavity.reserve(shell.size());
 
-  std::vector<MTet4 *> new_tets;
+  new_tets.clear();
   new_tets.reserve(shell.size());
 
   auto it = shell.begin();
@@ -477,6 +532,7 @@ bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
       new MTetrahedron(it->getVertex(0), it->getVertex(1), it->getVertex(2), v);
     MTet4 *t4 = myFactory.Create(tr, vSizes, vSizesBGM, lc1, lc2);
     t4->setOnWhat(t->onWhat());
+    t4->setPart(t->getPart());
 
     double const lc = Extend2dMeshIn3dVolumes() ? std::min(lc1, lc2) : lc2;
     if(distance(it->v[0], v) < lc * .05 || distance(it->v[1], v) < lc * .05 ||
@@ -499,13 +555,11 @@ bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
     else {
       connectTets(new_cavity.begin(), new_cavity.end(), &allEmbeddedFaces);
     }
-
-    allTets.insert(new_tets.begin(), new_tets.end());
-
     return true;
   }
   else /* one point is too close */ {
     for(std::size_t i = 0; i < shell.size(); i++) myFactory.Free(new_tets[i]);
+    new_tets.clear();
     auto ittet = cavity.begin();
     auto ittete = cavity.end();
     while(ittet != ittete) {
@@ -516,6 +570,21 @@ bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
   }
 }
 
+bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
+                   MVertex *v, double lc1, double lc2,
+                   std::vector<double> &vSizes, std::vector<double> &vSizesBGM,
+                   MTet4 *t, MTet4Factory &myFactory,
+                   std::set<MTet4 *, compareTet4Ptr> &allTets,
+                   const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+{
+  std::vector<MTet4 *> new_tets;
+  if(!insertVertexInCavity(shell, cavity, v, lc1, lc2, vSizes, vSizesBGM, t,
+                           myFactory, new_tets, allEmbeddedFaces))
+    return false;
+  allTets.insert(new_tets.begin(), new_tets.end());
+  return true;
+}
+
 static void setLcs(MTriangle *t,
                    std::map<MVertex *, double, MVertexPtrLessThan> &vSizes,
                    std::set<MVertex *, MVertexPtrLessThan> &bndVertices)
@@ -873,6 +942,246 @@ void adaptMeshGRegion::operator()(GRegion *gr)
   }
 }
 
+// Parallel mesh optimization: the tets are split in parts using the cells of a
+// regular grid, whose size only depends on the mesh (so that the result is the
+// same for any number of threads larger than one; with a single thread, the
+// original sequential algorithm is used). Local mesh modifications that only
+// touch the tets of a single part are applied concurrently, part by part and in
+// a fixed order; this is done a first time, and then a second time with the
+// grid shifted by half a cell. The modifications that straddle both grids are
+// finally applied sequentially.
+
+struct tetPartGrid {
+  int n;
+  double min[3], h[3];
+  int numParts() const { return (n + 1) * (n + 1) * (n + 1); }
+};
+
+static bool getTetPartGrid(std::vector<MTet4 *> &tets, int nthreads,
+                           tetPartGrid &grid)
+{
+  // aim for about 20000 tets per part
+  grid.n = std::min(32, (int)std::cbrt(tets.size() / 20000.));
+  if(grid.n < 2) return false;
+  double xmin = 1e200, ymin = 1e200, zmin = 1e200;
+  double xmax = -1e200, ymax = -1e200, zmax = -1e200;
+#pragma omp parallel for schedule(static) num_threads(nthreads)               \
+  reduction(min : xmin, ymin, zmin) reduction(max : xmax, ymax, zmax)
+  for(std::size_t i = 0; i < tets.size(); i++) {
+    for(int j = 0; j < 4; j++) {
+      MVertex *v = tets[i]->tet()->getVertex(j);
+      xmin = std::min(xmin, v->x());
+      ymin = std::min(ymin, v->y());
+      zmin = std::min(zmin, v->z());
+      xmax = std::max(xmax, v->x());
+      ymax = std::max(ymax, v->y());
+      zmax = std::max(zmax, v->z());
+    }
+  }
+  grid.min[0] = xmin;
+  grid.min[1] = ymin;
+  grid.min[2] = zmin;
+  grid.h[0] = (xmax - xmin) / grid.n;
+  grid.h[1] = (ymax - ymin) / grid.n;
+  grid.h[2] = (zmax - zmin) / grid.n;
+  for(int d = 0; d < 3; d++)
+    if(grid.h[d] <= 0.) grid.h[d] = 1.;
+  return true;
+}
+
+static void setTetParts(std::vector<MTet4 *> &tets, const tetPartGrid &grid,
+                        double shift, int nthreads)
+{
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t i = 0; i < tets.size(); i++) {
+    if(tets[i]->isDeleted()) continue;
+    MTetrahedron *t = tets[i]->tet();
+    int part = 0;
+    for(int d = 0; d < 3; d++) {
+      double c = 0.25 * (t->getVertex(0)->point()[d] +
+                         t->getVertex(1)->point()[d] +
+                         t->getVertex(2)->point()[d] +
+                         t->getVertex(3)->point()[d]);
+      int k = (int)((c - grid.min[d]) / grid.h[d] + shift);
+      k = std::max(0, std::min(grid.n, k));
+      part = part * (grid.n + 1) + k;
+    }
+    tets[i]->setPart(part);
+  }
+}
+
+// check if all the tets containing v1 (and v2, if given) that can be reached
+// from t, as well as their neighbors, belong to the part of t; the part of a
+// tet is always checked before accessing its data, so that this can be called
+// while the other parts are being modified
+static bool isCavityInPart(MTet4 *t, MVertex *v1, MVertex *v2)
+{
+  std::vector<MTet4 *> cavity(1, t);
+  for(std::size_t i = 0; i < cavity.size(); i++) {
+    for(int j = 0; j < 4; j++) {
+      MTet4 *neigh = cavity[i]->getNeigh(j);
+      if(!neigh) continue;
+      if(neigh->getPart() != t->getPart()) return false;
+      if(neigh->isDeleted()) return false;
+      if(std::find(cavity.begin(), cavity.end(), neigh) != cavity.end())
+        continue;
+      bool has1 = false, has2 = !v2;
+      for(int k = 0; k < 4; k++) {
+        MVertex *v = neigh->tet()->getVertex(k);
+        if(v == v1) has1 = true;
+        if(v == v2) has2 = true;
+      }
+      if(has1 && has2) {
+        if(cavity.size() > 1000) return false;
+        cavity.push_back(neigh);
+      }
+    }
+  }
+  return true;
+}
+
+static void getPartBuckets(std::vector<MTet4 *> &tets,
+                           std::vector<char> &pending, int numParts,
+                           std::vector<std::vector<std::size_t> > &buckets)
+{
+  buckets.clear();
+  buckets.resize(numParts);
+  for(std::size_t i = 0; i < pending.size(); i++) {
+    if(!pending[i]) continue;
+    if(tets[i]->isDeleted())
+      pending[i] = 0;
+    else
+      buckets[tets[i]->getPart()].push_back(i);
+  }
+}
+
+static bool
+swapTetEdges(std::vector<MTet4 *> &newTets, MTet4 *t,
+             const qmTetrahedron::Measures &qm,
+             const std::set<MEdge, MEdgeLessThan> &allEmbeddedEdges,
+             const std::set<MFace, MFaceLessThan> &allEmbeddedFaces,
+             bool inPart, bool &done)
+{
+  done = true;
+  for(int i = 0; i < 6; i++) {
+    MEdge ed = t->tet()->getEdge(i);
+    if(allEmbeddedEdges.find(ed) != allEmbeddedEdges.end()) continue;
+    if(inPart && !isCavityInPart(t, ed.getVertex(0), ed.getVertex(1))) {
+      done = false;
+      return false;
+    }
+    std::size_t first = newTets.size();
+    if(edgeSwap(newTets, t, i, qm, allEmbeddedFaces)) {
+      for(std::size_t j = first; j < newTets.size(); j++)
+        newTets[j]->setPart(t->getPart());
+      return true;
+    }
+  }
+  return false;
+}
+
+// apply edge swaps on the tets for which pending is set, and return the number
+// of swaps; kept is set for the tets that still exist after their own swap
+// attempt (which is where the sequential loop in optimizeMesh computes its
+// statistics). The new tets are numbered in a deterministic order, so that
+// the result is the same for any number of threads larger than one.
+static int swapEdgesInParts(
+  std::vector<MTet4 *> &allTets, std::vector<char> &pending,
+  std::vector<char> &kept, std::vector<MTet4 *> &newTets,
+  const qmTetrahedron::Measures &qm,
+  const std::set<MEdge, MEdgeLessThan> &allEmbeddedEdges,
+  const std::set<MFace, MFaceLessThan> &allEmbeddedFaces,
+  const tetPartGrid &grid, int nthreads)
+{
+  std::size_t firstNew = newTets.size();
+  std::size_t num = GModel::current()->getMaxElementNumber();
+  int nbESwap = 0;
+  for(int pass = 0; pass < 2; pass++) {
+    setTetParts(allTets, grid, 0.5 * pass, nthreads);
+    setTetParts(newTets, grid, 0.5 * pass, nthreads);
+    std::vector<std::vector<std::size_t> > buckets;
+    getPartBuckets(allTets, pending, grid.numParts(), buckets);
+    std::vector<std::vector<MTet4 *> > partNewTets(buckets.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)              \
+  reduction(+ : nbESwap)
+    for(int p = 0; p < (int)buckets.size(); p++) {
+      for(auto i : buckets[p]) {
+        if(allTets[i]->isDeleted()) {
+          pending[i] = 0;
+          continue;
+        }
+        bool done;
+        if(swapTetEdges(partNewTets[p], allTets[i], qm, allEmbeddedEdges,
+                        allEmbeddedFaces, true, done))
+          nbESwap++;
+        else if(done)
+          kept[i] = 1;
+        if(done) pending[i] = 0;
+      }
+    }
+    for(auto &tets : partNewTets)
+      newTets.insert(newTets.end(), tets.begin(), tets.end());
+  }
+  for(std::size_t i = 0; i < pending.size(); i++) {
+    if(!pending[i] || allTets[i]->isDeleted()) continue;
+    bool done;
+    if(swapTetEdges(newTets, allTets[i], qm, allEmbeddedEdges,
+                    allEmbeddedFaces, false, done))
+      nbESwap++;
+    else
+      kept[i] = 1;
+  }
+  // the new tets took their numbers in the order in which the threads created
+  // them
+  for(std::size_t i = firstNew; i < newTets.size(); i++)
+    newTets[i]->tet()->forceNum(++num);
+  return nbESwap;
+}
+
+// relocate the nodes of the tets for which pending is set (pending stores a
+// bit per node) and whose quality is below qMin, and return the number of
+// relocations
+static int smoothVerticesInParts(std::vector<MTet4 *> &allTets,
+                                 std::vector<char> &pending, double qMin,
+                                 const qmTetrahedron::Measures &qm,
+                                 const tetPartGrid &grid, int nthreads)
+{
+  int nbReloc = 0;
+  for(int pass = 0; pass < 3; pass++) {
+    std::vector<std::vector<std::size_t> > buckets;
+    if(pass < 2) {
+      setTetParts(allTets, grid, 0.5 * pass, nthreads);
+      getPartBuckets(allTets, pending, grid.numParts(), buckets);
+    }
+    else {
+      buckets.resize(1);
+      for(std::size_t i = 0; i < pending.size(); i++)
+        if(pending[i]) buckets[0].push_back(i);
+    }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)              \
+  reduction(+ : nbReloc) if(pass < 2)
+    for(int p = 0; p < (int)buckets.size(); p++) {
+      for(auto i : buckets[p]) {
+        MTet4 *t = allTets[i];
+        if(t->isDeleted() || t->getQuality() >= qMin) {
+          pending[i] = 0;
+          continue;
+        }
+        for(int j = 0; j < 4; j++) {
+          if(!(pending[i] & (1 << j))) continue;
+          MVertex *v = t->tet()->getVertex(j);
+          if(pass < 2 && v->onWhat()->dim() == 3 &&
+             !isCavityInPart(t, v, nullptr))
+            continue;
+          if(smoothVertex(t, j, qm)) nbReloc++;
+          pending[i] &= ~(1 << j);
+        }
+      }
+    }
+  }
+  return nbReloc;
+}
+
 void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
 {
   double qMin = CTX::instance()->mesh.optimizeThreshold;
@@ -947,13 +1256,48 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
 
   std::set<MTetrahedron*> to_delete;
 
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  tetPartGrid grid;
+  bool inParallel = nthreads > 1 && getTetPartGrid(allTets, nthreads, grid);
+
   while(1) {
     std::vector<MTet4 *> newTets;
 
     illegals.clear();
     for(int i = 0; i < nbRanges; i++) quality_ranges[i] = 0;
 
+    std::vector<char> kept;
+    if(inParallel) {
+      std::vector<char> pending(allTets.size(), 0);
+      kept.resize(allTets.size(), 0);
+      for(std::size_t i = 0; i < allTets.size(); i++) {
+        if(allTets[i]->isDeleted()) continue;
+        if(allTets[i]->getQuality() < qMin)
+          pending[i] = 1;
+        else
+          kept[i] = 1;
+      }
+      nbESwap += swapEdgesInParts(allTets, pending, kept, newTets, qm,
+                                  allEmbeddedEdges, allEmbeddedFaces, grid,
+                                  nthreads);
+    }
+
     for(auto it = allTets.begin(); it != allTets.end(); ++it) {
+      if(inParallel) {
+        // the swaps have already been performed: only compute the statistics,
+        // for the tets that were kept by their own swap attempt
+        if(kept[it - allTets.begin()]) {
+          double qq = (*it)->getQuality();
+          if(qq < sliverLimit) illegals.push_back(*it);
+          for(int i = 0; i < nbRanges; i++) {
+            double low = (double)i / nbRanges;
+            double high = (double)(i + 1) / nbRanges;
+            if(qq >= low && qq < high) quality_ranges[i]++;
+          }
+        }
+        continue;
+      }
       if(!(*it)->isDeleted()) {
         double qq = (*it)->getQuality();
         if(qq < qMin) {
@@ -990,7 +1334,18 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
     }
 
     // relocate vertices
-    if(gr->hexahedra.empty() && gr->prisms.empty() && gr->pyramids.empty()) {
+    if(gr->hexahedra.empty() && gr->prisms.empty() && gr->pyramids.empty() &&
+       inParallel) {
+      std::vector<char> pending(allTets.size(), 0);
+      for(std::size_t i = 0; i < allTets.size(); i++) {
+        if(!allTets[i]->isDeleted() && allTets[i]->getQuality() < qMin)
+          pending[i] = 0xf;
+      }
+      nbReloc +=
+        smoothVerticesInParts(allTets, pending, qMin, qm, grid, nthreads);
+    }
+    else if(gr->hexahedra.empty() && gr->prisms.empty() &&
+            gr->pyramids.empty()) {
       for(auto it = allTets.begin(); it != allTets.end(); ++it) {
         if(!(*it)->isDeleted()) {
           double qq = (*it)->getQuality();
@@ -1214,6 +1569,194 @@ static void _deleteUnusedVertices(GRegion *gr)
                            allverts.end());
 }
 
+// Parallel refinement: the tets are split in parts using the cells of a regular
+// grid, as for the parallel mesh optimization, and the tets that are too large
+// are refined concurrently, part by part, as long as the cavity of the new node
+// (and the tets on the other side of its shell) stays inside the part. The
+// grid is shifted by half a cell at each round, so that the nodes that could
+// not be inserted because their cavity straddled two parts can be inserted in
+// the next round. Returns the number of nodes created in the round. The parts
+// only depend on the mesh, so that the result is the same for any number of
+// threads larger than one; it differs from the result of the sequential
+// worst-first refinement, which is used with a single thread.
+static int refineInParts(MTet4Factory &myFactory, std::vector<double> &vSizes,
+                         std::vector<double> &vSizesBGM, int &NUM,
+                         double worstTetRadiusTarget, int maxIter, int round,
+                         edgeContainerB &allEmbeddedEdges,
+                         const std::set<MFace, MFaceLessThan> &allEmbeddedFaces,
+                         int nthreads, int &ITER, int &NB_CORRECTION_OF_CAVITY,
+                         int &COUNT_MISS_1, int &COUNT_MISS_2)
+{
+  std::set<MTet4 *, compareTet4Ptr> &allTets = myFactory.getAllTets();
+
+  // candidate tets, from the worst one to the best one
+  std::vector<MTet4 *> tets, candidates;
+  tets.reserve(allTets.size());
+  for(auto t : allTets) {
+    if(t->isDeleted()) continue;
+    tets.push_back(t);
+    if(t->getRadius() >= worstTetRadiusTarget) candidates.push_back(t);
+  }
+  if(maxIter > 0 && ITER + (int)candidates.size() > maxIter)
+    candidates.resize(std::max(0, maxIter - ITER));
+  if(candidates.empty()) return 0;
+
+  tetPartGrid grid;
+  if(!getTetPartGrid(tets, nthreads, grid)) return 0;
+  setTetParts(tets, grid, 0.5 * (round % 2), nthreads);
+  std::vector<std::vector<std::size_t> > buckets(grid.numParts());
+  for(std::size_t i = 0; i < candidates.size(); i++)
+    buckets[candidates[i]->getPart()].push_back(i);
+
+  GModel *m = GModel::current();
+  std::size_t vertexNum = m->getMaxVertexNumber();
+  std::size_t elementNum = m->getMaxElementNumber();
+
+  // the node created for the i-th candidate temporarily gets index NUM + i, so
+  // that the sizes can be stored concurrently
+  vSizes.resize(NUM + candidates.size());
+  vSizesBGM.resize(NUM + candidates.size());
+  std::vector<MVertex *> newVertices(candidates.size(), nullptr);
+  std::vector<char> failed(candidates.size(), 0);
+  std::vector<std::vector<MTet4 *> > partNewTets(buckets.size());
+  int nbIter = 0, nbCorrected = 0, nbMiss1 = 0, nbMiss2 = 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)              \
+  reduction(+ : nbIter, nbCorrected, nbMiss1, nbMiss2)
+  for(int p = 0; p < (int)buckets.size(); p++) {
+    std::vector<faceXtet> shell;
+    std::vector<MTet4 *> cavity, newTets;
+    for(auto i : buckets[p]) {
+      MTet4 *worst = candidates[i];
+      if(worst->isDeleted()) continue;
+      MTetrahedron *base = worst->tet();
+      double pa[3] = {base->getVertex(0)->x(), base->getVertex(0)->y(),
+                      base->getVertex(0)->z()};
+      double pb[3] = {base->getVertex(1)->x(), base->getVertex(1)->y(),
+                      base->getVertex(1)->z()};
+      double pc[3] = {base->getVertex(2)->x(), base->getVertex(2)->y(),
+                      base->getVertex(2)->z()};
+      double pd[3] = {base->getVertex(3)->x(), base->getVertex(3)->y(),
+                      base->getVertex(3)->z()};
+      double center[3], uvw[3];
+      tetcircumcenter(pa, pb, pc, pd, center, nullptr, nullptr, nullptr);
+
+      shell.clear();
+      cavity.clear();
+      // postpone to the next round if the cavity is not inside the part
+      if(!findCavityInPart(shell, cavity, center, worst)) continue;
+
+      bool found = false;
+      for(auto c : cavity) {
+        c->tet()->xyz2uvw(center, uvw);
+        if(c->tet()->isInside(uvw[0], uvw[1], uvw[2])) {
+          worst = c;
+          found = true;
+          break;
+        }
+      }
+      if(found && (!allEmbeddedEdges.empty() || !allEmbeddedFaces.empty())) {
+        found =
+          isCavityCompatibleWithEmbeddedEdges(cavity, shell,
+                                              allEmbeddedEdges) &&
+          isCavityCompatibleWithEmbeddedFace(cavity, shell, allEmbeddedFaces);
+      }
+      if(!found) {
+        for(auto c : cavity) c->setDeleted(false);
+        failed[i] = 1;
+        nbMiss2++;
+        nbIter++;
+        continue;
+      }
+
+      MVertex *v =
+        new MVertex(center[0], center[1], center[2], worst->onWhat());
+      v->setIndex(NUM + i);
+      bool correctCavity = false;
+      int k;
+      while((k = makeCavityStarShaped(shell, cavity, v, p)) == 1)
+        correctCavity = true;
+      if(k == -2 || (k == 0 && !isShellInPart(shell, p))) {
+        for(auto c : cavity) c->setDeleted(false);
+        delete v;
+        continue;
+      }
+      nbIter++;
+
+      bool incompatible = false;
+      if(correctCavity && k == 0) {
+        nbCorrected++;
+        if(!isCavityCompatibleWithEmbeddedEdges(cavity, shell,
+                                                allEmbeddedEdges) ||
+           !isCavityCompatibleWithEmbeddedFace(cavity, shell,
+                                               allEmbeddedFaces))
+          incompatible = true;
+      }
+      double lc1 = (1 - uvw[0] - uvw[1] - uvw[2]) *
+                     vSizes[worst->tet()->getVertex(0)->getIndex()] +
+                   uvw[0] * vSizes[worst->tet()->getVertex(1)->getIndex()] +
+                   uvw[1] * vSizes[worst->tet()->getVertex(2)->getIndex()] +
+                   uvw[2] * vSizes[worst->tet()->getVertex(3)->getIndex()];
+      double lc2 =
+        BGM_MeshSize(worst->onWhat(), 0, 0, center[0], center[1], center[2]);
+
+      if(incompatible || k != 0 ||
+         !insertVertexInCavity(shell, cavity, v, lc1, lc2, vSizes, vSizesBGM,
+                               worst, myFactory, newTets, allEmbeddedFaces)) {
+        for(auto c : cavity) c->setDeleted(false);
+        delete v;
+        failed[i] = 1;
+        nbMiss1++;
+      }
+      else {
+        vSizes[NUM + i] = lc1;
+        vSizesBGM[NUM + i] = lc2;
+        newVertices[i] = v;
+        partNewTets[p].insert(partNewTets[p].end(), newTets.begin(),
+                              newTets.end());
+      }
+    }
+  }
+
+  // the new nodes and tets took their numbers in the order in which the
+  // threads created them: renumber them in the order of the candidates and of
+  // the parts (before inserting the tets in allTets, which is sorted by
+  // number for tets with the same radius)
+  for(auto v : newVertices)
+    if(v) v->forceNum(++vertexNum);
+  for(auto &t : partNewTets)
+    for(auto t4 : t) t4->tet()->forceNum(++elementNum);
+
+  for(auto &t : partNewTets) allTets.insert(t.begin(), t.end());
+
+  // do not try again to refine the tets for which the insertion failed
+  for(std::size_t i = 0; i < candidates.size(); i++) {
+    if(!failed[i]) continue;
+    auto it = allTets.find(candidates[i]);
+    if(it != allTets.end()) myFactory.changeTetRadius(it, 0.);
+  }
+
+  // renumber the new nodes contiguously, in the order of the candidates
+  int created = 0;
+  for(std::size_t i = 0; i < candidates.size(); i++) {
+    MVertex *v = newVertices[i];
+    if(!v) continue;
+    vSizes[NUM] = vSizes[v->getIndex()];
+    vSizesBGM[NUM] = vSizesBGM[v->getIndex()];
+    v->setIndex(NUM++);
+    v->onWhat()->mesh_vertices.push_back(v);
+    created++;
+  }
+  vSizes.resize(NUM);
+  vSizesBGM.resize(NUM);
+
+  ITER += nbIter;
+  NB_CORRECTION_OF_CAVITY += nbCorrected;
+  COUNT_MISS_1 += nbMiss1;
+  COUNT_MISS_2 += nbMiss2;
+  return created;
+}
+
 void insertVerticesInRegion(GRegion *gr, int maxIter,
                             double worstTetRadiusTarget, bool _classify,
                             splitQuadRecovery *sqr)
@@ -1380,6 +1923,12 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
 
   double t1 = TimeOfDay();
 
+  // refine in parallel as soon as the mesh is large enough to be split in
+  // parts, and as long as it is worth it
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  int nextParallelIter = 0, round = 0;
+
   // main loop in Delaunay inserstion starts here
 
   while(1) {
@@ -1389,6 +1938,24 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
       break;
     }
 
+    if(nthreads > 1 && ITER >= nextParallelIter) {
+      int n = refineInParts(myFactory, vSizes, vSizesBGM, NUM,
+                            worstTetRadiusTarget, maxIter, round++,
+                            allEmbeddedEdges, allEmbeddedFaces, nthreads, ITER,
+                            NB_CORRECTION_OF_CAVITY, COUNT_MISS_1,
+                            COUNT_MISS_2);
+      REALCOUNT += n;
+      if(n) {
+        Msg::Info("It. %d - %d nodes created - %d nodes created in parallel "
+                  "(nodes removed %d %d)",
+                  ITER, REALCOUNT, n, COUNT_MISS_1, COUNT_MISS_2);
+        if(allTets.size() > 7 * vSizes.size())
+          memoryCleanup(myFactory, allTets);
+      }
+      if(n < 1000) nextParallelIter = ITER + 10000;
+      continue;
+    }
+
     MTet4 *worst = *allTets.begin();
 
     if(worst->isDeleted()) {
@@ -48,6 +48,7 @@ class MTet4 {
 
 private:
   bool deleted;
+  int part; // spatial part (used by the parallel mesh optimization)
   double circum_radius;
   MTetrahedron *base;
   MTet4 *neigh[4];
@@ -56,17 +57,18 @@ private:
 public:
   static int radiusNorm; // 2 is euclidian norm, -1 is infinite norm
   ~MTet4() {}
-  MTet4() : deleted(false), circum_radius(0.0), base(nullptr), gr(nullptr)
+  MTet4()
+    : deleted(false), part(0), circum_radius(0.0), base(nullptr), gr(nullptr)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
   }
   MTet4(MTetrahedron *t, double qual)
-    : deleted(false), circum_radius(qual), base(t), gr(nullptr)
+    : deleted(false), part(0), circum_radius(qual), base(t), gr(nullptr)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
   }
   MTet4(MTetrahedron *t, const qmTetrahedron::Measures &qm)
-    : deleted(false), base(t), gr(nullptr)
+    : deleted(false), part(0), base(t), gr(nullptr)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
     double vol;
@@ -160,6 +162,8 @@ public:
   GRegion *onWhat() const { return gr; }
   void setOnWhat(GRegion *g) { gr = g; }
   bool isDeleted() const { return deleted; }
+  int getPart() const { return part; }
+  void setPart(int p) { part = p; }
   void forceRadius(double r) { circum_radius = r; }
   double getRadius() const { return circum_radius; }
   double getQuality() const { return circum_radius; }
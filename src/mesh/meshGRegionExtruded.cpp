@@ -151,6 +151,51 @@ static int getExtrudedVertices(MElement *ele, ExtrudeParams *ep, int j, int k,
   return verts.size();
 }
 
+// create the elements extruded from the source elements, by batches of source
+// elements: the extruded nodes of a batch are looked up concurrently (the
+// rtree is not modified anymore at this stage), and the elements are then
+// created sequentially, in the same order as if everything was sequential
+template <class T>
+static void
+createExtrudedElements(std::vector<T *> &elements, ExtrudeParams *ep,
+                       GRegion *to, MVertexRTree &pos,
+                       void (*create)(std::vector<MVertex *> &, GRegion *,
+                                      MElement *))
+{
+  std::vector<std::pair<int, int> > layers;
+  for(int j = 0; j < ep->mesh.NbLayer; j++)
+    for(int k = 0; k < ep->mesh.NbElmLayer[j]; k++)
+      layers.push_back(std::make_pair(j, k));
+  if(elements.empty() || layers.empty()) return;
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  std::size_t nl = layers.size();
+  std::size_t batch = std::max((std::size_t)1, (std::size_t)100000 / nl);
+  std::vector<std::vector<MVertex *> > verts;
+  for(std::size_t start = 0; start < elements.size(); start += batch) {
+    std::size_t end = std::min(elements.size(), start + batch);
+    verts.resize((end - start) * nl);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for(std::size_t i = start; i < end; i++) {
+      for(std::size_t l = 0; l < nl; l++) {
+        std::vector<MVertex *> &v = verts[(i - start) * nl + l];
+        v.clear();
+        getExtrudedVertices(elements[i], ep, layers[l].first,
+                            layers[l].second, pos, v);
+      }
+    }
+    for(std::size_t i = start; i < end; i++) {
+      std::size_t n = 2 * elements[i]->getNumVertices();
+      for(std::size_t l = 0; l < nl; l++) {
+        std::vector<MVertex *> &v = verts[(i - start) * nl + l];
+        if(v.size() == n) create(v, to, elements[i]);
+      }
+    }
+  }
+}
+
 static void extrudeMesh(GFace *from, GRegion *to, MVertexRTree &pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
@@ -178,23 +223,37 @@ static void extrudeMesh(GFace *from, GRegion *to, MVertexRTree &pos)
   }
   mesh_vertices.insert(mesh_vertices.end(), seam.begin(), seam.end());
 
-  // create extruded vertices
+  // create extruded vertices: compute their coordinates and check if they
+  // already exist on the boundary concurrently, then create the missing ones
+  // sequentially (two source nodes could be extruded to the same position)
+  std::vector<std::pair<int, int> > layers;
+  for(int j = 0; j < ep->mesh.NbLayer; j++) {
+    for(int k = 0; k < ep->mesh.NbElmLayer[j]; k++) {
+      if(j != ep->mesh.NbLayer - 1 || k != ep->mesh.NbElmLayer[j] - 1)
+        layers.push_back(std::make_pair(j, k));
+    }
+  }
+  std::size_t nl = layers.size();
+  std::vector<SPoint3> xyz(mesh_vertices.size() * nl);
+  std::vector<char> missing(xyz.size(), 0);
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(static) num_threads(nthreads)
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) {
     MVertex *v = mesh_vertices[i];
-    for(int j = 0; j < ep->mesh.NbLayer; j++) {
-      for(int k = 0; k < ep->mesh.NbElmLayer[j]; k++) {
-        double x = v->x(), y = v->y(), z = v->z();
-        ep->Extrude(j, k + 1, x, y, z);
-        if(j != ep->mesh.NbLayer - 1 || k != ep->mesh.NbElmLayer[j] - 1) {
-          if(!pos.find(x, y, z)) {
-            MVertex *newv = new MVertex(x, y, z, to);
-            to->mesh_vertices.push_back(newv);
-            pos.insert(newv);
-          }
-        }
-      }
+    for(std::size_t l = 0; l < nl; l++) {
+      double x = v->x(), y = v->y(), z = v->z();
+      ep->Extrude(layers[l].first, layers[l].second + 1, x, y, z);
+      xyz[i * nl + l] = SPoint3(x, y, z);
+      if(!pos.find(x, y, z)) missing[i * nl + l] = 1;
     }
   }
+  for(std::size_t i = 0; i < xyz.size(); i++) {
+    if(!missing[i] || pos.find(xyz[i].x(), xyz[i].y(), xyz[i].z())) continue;
+    MVertex *newv = new MVertex(xyz[i].x(), xyz[i].y(), xyz[i].z(), to);
+    to->mesh_vertices.push_back(newv);
+    pos.insert(newv);
+  }
 
 #if defined(HAVE_QUADTRI)
   if(ep && ep->mesh.ExtrudeMesh && ep->mesh.QuadToTri && ep->mesh.Recombine) {
@@ -206,31 +265,13 @@ static void extrudeMesh(GFace *from, GRegion *to, MVertexRTree &pos)
   // create elements (note that it would be faster to access the *interior*
   // nodes by direct indexing, but it's just simpler to query everything by
   // position)
-  for(std::size_t i = 0; i < from->triangles.size(); i++) {
-    for(int j = 0; j < ep->mesh.NbLayer; j++) {
-      for(int k = 0; k < ep->mesh.NbElmLayer[j]; k++) {
-        std::vector<MVertex *> verts;
-        if(getExtrudedVertices(from->triangles[i], ep, j, k, pos, verts) == 6) {
-          createPriPyrTet(verts, to, from->triangles[i]);
-        }
-      }
-    }
-  }
+  createExtrudedElements(from->triangles, ep, to, pos, createPriPyrTet);
 
   if(from->quadrangles.size() && !ep->mesh.Recombine) {
     Msg::Error("Cannot extrude quadrangles without Recombine");
   }
   else {
-    for(std::size_t i = 0; i < from->quadrangles.size(); i++) {
-      for(int j = 0; j < ep->mesh.NbLayer; j++) {
-        for(int k = 0; k < ep->mesh.NbElmLayer[j]; k++) {
-          std::vector<MVertex *> verts;
-          if(getExtrudedVertices(from->quadrangles[i], ep, j, k, pos, verts) ==
-             8)
-            createHexPri(verts, to, from->quadrangles[i]);
-        }
-      }
-    }
+    createExtrudedElements(from->quadrangles, ep, to, pos, createHexPri);
   }
 }
 
@@ -264,6 +305,7 @@ void meshGRegionExtruded::operator()(GRegion *gr)
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
   if(!ep || !ep->mesh.ExtrudeMesh || ep->geo.Mode != EXTRUDED_ENTITY) return;
+  if(CTX::instance()->mesh.meshOnlyEmpty && gr->getNumMeshElements()) return;
 
   Msg::Info("Meshing volume %d (Extruded)", gr->tag());
 
@@ -5,6 +5,8 @@
 
 #include <map>
 #include <set>
+#include <atomic>
+#include <climits>
 #include <stdexcept>
 
 #include "GmshConfig.h"
@@ -186,7 +188,6 @@ static HXTStatus getAllCurves(std::vector<GRegion *> &regions,
 }
 
 static HXTStatus Hxt2Gmsh(std::vector<GRegion *> &regions, HXTMesh *m,
-                          std::map<MVertex *, uint32_t> &v2c,
                           std::vector<MVertex *> &c2v)
 {
   Msg::Debug("Start Hxt2Gmsh");
@@ -286,121 +287,121 @@ static HXTStatus Hxt2Gmsh(std::vector<GRegion *> &regions, HXTMesh *m,
   HXT_CHECK( hxtAlignedFree(&m->triangles.node) );
   HXT_CHECK( hxtAlignedFree(&m->triangles.color) );
 
-#if 0 // this seems to be buggy (cf. e.g. #2575)
-// #if defined(_OPENMP)
+  const std::size_t nR = regions.size(), nV = m->vertices.num;
+  const std::size_t numTets = m->tetrahedra.num;
+  GModel *model = GModel::current();
   int nthreads = getNumThreads();
-  if(nthreads > 1) {
-    const uint32_t nR = regions.size();
-    const uint32_t nV = m->vertices.num;
-
-    size_t* ht_all, *ht_tot; // histograms for tets
-    HXT_CHECK( hxtCalloc(&ht_all, nR * (nthreads + 1), sizeof(size_t)) );
-    uint32_t* hp_all, *hp_tot; // histograms for points
-    HXT_CHECK( hxtCalloc(&hp_all, nR * (nthreads + 1) * 3 + (size_t) nV * nthreads,
-                         sizeof(uint32_t)) );
-    uint32_t* vR_all = hp_all + nR * (nthreads + 1); // color per point and per thread
+  // the tetrahedra are created with explicit tags (which should fit in an int)
+  if(model->getMaxElementNumber() + numTets > (std::size_t)INT_MAX)
+    nthreads = 1;
 
-    #pragma omp parallel num_threads(nthreads)
-    {
-      #pragma omp single
-      {
-        nthreads = omp_get_num_threads(); /* the real number of threads */
-        ht_tot = ht_all + nR * nthreads;
-        hp_tot = hp_all + nR * nthreads;
+  if(nthreads > 1) {
+    // Parallel version, creating the same nodes and tetrahedra (with the same
+    // tags, and in the same order in each region) as the sequential one. A new
+    // node is created by the first tetrahedron referencing it: first[pt] is the
+    // smallest 4 * tet + j such that node j of tet is pt.
+    std::vector<std::atomic<uint64_t> > first(nV);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for(std::size_t pt = 0; pt < nV; pt++)
+      first[pt].store(UINT64_MAX, std::memory_order_relaxed);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for(std::size_t i = 0; i < numTets; i++) {
+      if(m->tetrahedra.color[i] >= nR) continue;
+      for(int j = 0; j < 4; j++) {
+        const uint32_t pt = m->tetrahedra.node[4 * i + j];
+        if(c2v[pt]) continue;
+        const uint64_t key = 4 * i + j;
+        uint64_t current = first[pt].load(std::memory_order_relaxed);
+        while(key < current && !first[pt].compare_exchange_weak(
+                                 current, key, std::memory_order_relaxed)) {
+        }
       }
+    }
 
-      int threadID = omp_get_thread_num();
-      size_t* ht_this = ht_all + nR * threadID;
-      uint32_t* hp_this = hp_all + nR * threadID;
-      uint32_t* vR_this = vR_all + nV * threadID;
-
-      // count the number of tetrahedra in each region in parallel
-      #pragma omp for schedule(static)
-      for(size_t i = 0; i < m->tetrahedra.num; i++) {
-        uint32_t c = m->tetrahedra.color[i];
+    // count the tetrahedra and the new nodes in each region, for contiguous
+    // ranges of tetrahedra
+    std::vector<std::size_t> numTetsPerRange(nthreads * nR, 0);
+    std::vector<std::size_t> numNodesPerRange(nthreads * nR, 0);
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for(int t = 0; t < nthreads; t++) {
+      const std::size_t begin = (numTets * t) / nthreads;
+      const std::size_t end = (numTets * (t + 1)) / nthreads;
+      for(std::size_t i = begin; i < end; i++) {
+        const uint32_t c = m->tetrahedra.color[i];
         if(c >= nR) continue;
-
-        ht_this[c]++;
-        uint32_t *nodes = &m->tetrahedra.node[4 * i];
+        numTetsPerRange[t * nR + c]++;
         for(int j = 0; j < 4; j++) {
-          uint32_t pt = nodes[j];
-          if(!c2v[pt])
-            vR_this[pt] = c + 1;
+          const uint32_t pt = m->tetrahedra.node[4 * i + j];
+          if(first[pt].load(std::memory_order_relaxed) == 4 * i + j)
+            numNodesPerRange[t * nR + c]++;
         }
       }
+    }
 
-      #pragma omp for schedule(static)
-      for(uint32_t pt = 0; pt < nV; pt++) {
-        if(c2v[pt]) continue;
-
-        uint32_t color = 0;
-        for(int thrd = 0; thrd < nthreads; thrd++) {
-          if(vR_all[thrd * nV + pt]) {
-            color = vR_all[thrd * nV + pt];
-            break;
-          }
-        }
-        color--;
-  #ifdef DEBUG
-        if(color >= nR)
-          exit(HXT_ERROR_MSG(HXT_STATUS_ERROR, "no volume or color for pt %u", pt));
-  #endif
-        vR_all[pt] = color;
-        hp_this[color]++;
+    // turn the counts into positions in the regions and into tags
+    std::vector<std::size_t> tetTag(nthreads + 1, model->getMaxElementNumber());
+    std::vector<std::size_t> nodeTag(nthreads + 1, model->getMaxVertexNumber());
+    for(int t = 1; t <= nthreads; t++) {
+      tetTag[t] = tetTag[t - 1];
+      nodeTag[t] = nodeTag[t - 1];
+      for(std::size_t c = 0; c < nR; c++) {
+        tetTag[t] += numTetsPerRange[(t - 1) * nR + c];
+        nodeTag[t] += numNodesPerRange[(t - 1) * nR + c];
       }
-
-      #pragma omp for
-      for(uint32_t c2 = 0; c2 < 2 * nR; c2++) { // parallelism x 2 :p
-        uint32_t c = c2 >> 1;
-        if(c2 & 1) {
-          size_t sumt = 0;
-          for(int j = 0; j < nthreads + 1; j++) {
-            size_t tsumt = ht_all[j * nR + c] + sumt;
-            ht_all[j * nR + c] = sumt;
-            sumt = tsumt;
-          }
-          regions[c]->tetrahedra.resize(ht_tot[c], nullptr);
-        }
-        else {
-          uint32_t sump = 0;
-          for(int j = 0; j < nthreads + 1; j++) {
-            uint32_t tsump = hp_all[j * nR + c] + sump;
-            hp_all[j * nR + c] = sump;
-            sump = tsump;
-          }
-          regions[c]->mesh_vertices.resize(hp_tot[c], nullptr);
-        }
+    }
+    model->setMaxElementNumber(tetTag[nthreads]);
+    model->setMaxVertexNumber(nodeTag[nthreads]);
+    for(std::size_t c = 0; c < nR; c++) {
+      std::size_t tets = regions[c]->tetrahedra.size();
+      std::size_t nodes = regions[c]->mesh_vertices.size();
+      for(int t = 0; t < nthreads; t++) {
+        std::swap(tets, numTetsPerRange[t * nR + c]);
+        std::swap(nodes, numNodesPerRange[t * nR + c]);
+        tets += numTetsPerRange[t * nR + c];
+        nodes += numNodesPerRange[t * nR + c];
       }
-
-      #pragma omp for schedule(static)
-      for(uint32_t pt = 0; pt < nV; pt++) {
-        if(c2v[pt]) continue;
-
-        uint32_t c = vR_all[pt];
+      regions[c]->tetrahedra.resize(tets, nullptr);
+      regions[c]->mesh_vertices.resize(nodes, nullptr);
+    }
+    // create the nodes, then the tetrahedra
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for(int t = 0; t < nthreads; t++) {
+      const std::size_t begin = (numTets * t) / nthreads;
+      const std::size_t end = (numTets * (t + 1)) / nthreads;
+      std::size_t *nodePos = &numNodesPerRange[t * nR];
+      std::size_t tag = nodeTag[t];
+      for(std::size_t i = begin; i < end; i++) {
+        const uint32_t c = m->tetrahedra.color[i];
+        if(c >= nR) continue;
         GRegion *gr = regions[c];
-        double *x = &m->vertices.coord[4 * pt];
-        c2v[pt] = new MVertex(x[0], x[1], x[2], gr);
-        gr->mesh_vertices[hp_this[c]++] = c2v[pt];
+        for(int j = 0; j < 4; j++) {
+          const uint32_t pt = m->tetrahedra.node[4 * i + j];
+          if(first[pt].load(std::memory_order_relaxed) != 4 * i + j) continue;
+          double *x = &m->vertices.coord[4 * pt];
+          MVertex *v = new MVertex(x[0], x[1], x[2], gr, ++tag);
+          v->setIndex(0);
+          gr->mesh_vertices[nodePos[c]++] = v;
+          c2v[pt] = v;
+        }
       }
-
-
-      #pragma omp for schedule(static)
-      for(size_t i = 0; i < m->tetrahedra.num; i++) {
-        uint32_t c = m->tetrahedra.color[i];
+    }
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for(int t = 0; t < nthreads; t++) {
+      const std::size_t begin = (numTets * t) / nthreads;
+      const std::size_t end = (numTets * (t + 1)) / nthreads;
+      std::size_t *tetPos = &numTetsPerRange[t * nR];
+      std::size_t tag = tetTag[t];
+      for(std::size_t i = begin; i < end; i++) {
+        const uint32_t c = m->tetrahedra.color[i];
         if(c >= nR) continue;
-
-        uint32_t *nodes = &m->tetrahedra.node[4 * i];
-        regions[c]->tetrahedra[ht_this[c]++] = new MTetrahedron
-          (c2v[nodes[0]], c2v[nodes[1]], c2v[nodes[2]], c2v[nodes[3]]);
+        const uint32_t *nodes = &m->tetrahedra.node[4 * i];
+        regions[c]->tetrahedra[tetPos[c]++] =
+          new MTetrahedron(c2v[nodes[0]], c2v[nodes[1]], c2v[nodes[2]],
+                           c2v[nodes[3]], ++tag);
       }
     }
-
-    HXT_CHECK( hxtFree(&ht_all) );
-    HXT_CHECK( hxtFree(&hp_all) );
   }
-  else
-#endif
-  {
+  else {
     std::vector<std::size_t> numtet(regions.size(), 0);
     for(std::size_t i = 0; i < m->tetrahedra.num; i++) {
       uint16_t c = m->tetrahedra.color[i];
@@ -440,87 +441,163 @@ static HXTStatus Hxt2Gmsh(std::vector<GRegion *> &regions, HXTMesh *m,
   return HXT_STATUS_OK;
 }
 
-HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
-                   std::map<MVertex *, uint32_t> &v2c,
-                   std::vector<MVertex *> &c2v)
+// Split the elements of the given entities in chunks of consecutive elements,
+// to fill the HXT arrays in parallel: a chunk contains the elements [begin,
+// end) of entities[entity], the first one being stored at position index in
+// the HXT arrays
+struct hxtChunk {
+  std::size_t entity, begin, end;
+  uint64_t index;
+};
+
+template <class T>
+static void getHxtChunks(const std::vector<T *> &entities,
+                         const std::vector<uint64_t> &offsets,
+                         std::vector<hxtChunk> &chunks)
+{
+  const std::size_t chunkSize = 4096;
+  for(std::size_t j = 0; j < entities.size(); j++) {
+    const std::size_t n = offsets[j + 1] - offsets[j];
+    for(std::size_t b = 0; b < n; b += chunkSize) {
+      hxtChunk c = {j, b, std::min(b + chunkSize, n), offsets[j] + b};
+      chunks.push_back(c);
+    }
+  }
+}
+
+// Fill the HXT mesh with the boundary mesh of the regions. The nodes are
+// stored in the HXT mesh sorted by tag, and c2v[i] is the node stored at index
+// i. The conversion is done in parallel, by temporarily stamping each node
+// with its index in the HXT mesh (the original indices are restored at the
+// end).
+static HXTStatus gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
+                          std::vector<MVertex *> &c2v)
 {
-  std::set<MVertex *, MVertexPtrLessThan> all;
   std::vector<GFace *> surfaces;
   std::vector<GEdge *> curves;
   std::vector<GVertex *> points;
-  std::map<MVertex *, double> vlc;
 
   HXT_CHECK(getAllSurfaces(regions, m, surfaces));
   HXT_CHECK(getAllCurves(regions, surfaces, m, curves));
 
-  uint64_t index = 0, ntri = 0, nedg = 0, npts = 0;
-
   // embedded points in volumes (all other embedded points will be in the
   // curve/surface meshes already)
+  uint64_t npts = 0;
   for(GRegion *gr : regions) {
     for(GVertex *gv : gr->embeddedVertices()) {
       points.push_back(gv);
       npts += gv->points.size();
-      for(std::size_t i = 0; i < gv->points.size(); i++) {
-        MVertex *v = gv->points[i]->getVertex(0);
-        all.insert(v);
-        if(gv->prescribedMeshSizeAtVertex() != MAX_LC)
-          vlc[v] = gv->prescribedMeshSizeAtVertex();
-      }
     }
   }
 
-  for(std::size_t j = 0; j < curves.size(); j++) {
-    GEdge *ge = curves[j];
-    nedg += ge->lines.size();
-    for(std::size_t i = 0; i < ge->lines.size(); i++) {
-      all.insert(ge->lines[i]->getVertex(0));
-      all.insert(ge->lines[i]->getVertex(1));
+  std::vector<uint64_t> lineOffsets(curves.size() + 1, 0);
+  for(std::size_t j = 0; j < curves.size(); j++)
+    lineOffsets[j + 1] = lineOffsets[j] + curves[j]->lines.size();
+  std::vector<uint64_t> triangleOffsets(surfaces.size() + 1, 0);
+  for(std::size_t j = 0; j < surfaces.size(); j++)
+    triangleOffsets[j + 1] = triangleOffsets[j] + surfaces[j]->triangles.size();
+  const uint64_t nedg = lineOffsets.back(), ntri = triangleOffsets.back();
+  std::vector<hxtChunk> lineChunks, triangleChunks;
+  getHxtChunks(curves, lineOffsets, lineChunks);
+  getHxtChunks(surfaces, triangleOffsets, triangleChunks);
+
+  const int nthreads = getNumThreads();
+
+  // register the nodes by tag
+  std::size_t maxNum = 0;
+  for(GVertex *gv : points) {
+    for(std::size_t i = 0; i < gv->points.size(); i++)
+      maxNum = std::max(maxNum, gv->points[i]->getVertex(0)->getNum());
+  }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(max:maxNum)
+  for(std::size_t k = 0; k < lineChunks.size(); k++) {
+    const hxtChunk &c = lineChunks[k];
+    for(std::size_t i = c.begin; i < c.end; i++) {
+      MLine *l = curves[c.entity]->lines[i];
+      for(int j = 0; j < 2; j++)
+        maxNum = std::max(maxNum, l->getVertex(j)->getNum());
+    }
+  }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(max:maxNum)
+  for(std::size_t k = 0; k < triangleChunks.size(); k++) {
+    const hxtChunk &c = triangleChunks[k];
+    for(std::size_t i = c.begin; i < c.end; i++) {
+      MTriangle *t = surfaces[c.entity]->triangles[i];
+      for(int j = 0; j < 3; j++)
+        maxNum = std::max(maxNum, t->getVertex(j)->getNum());
     }
   }
 
-  for(std::size_t j = 0; j < surfaces.size(); j++) {
-    GFace *gf = surfaces[j];
-    ntri += gf->triangles.size();
-    for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-      all.insert(gf->triangles[i]->getVertex(0));
-      all.insert(gf->triangles[i]->getVertex(1));
-      all.insert(gf->triangles[i]->getVertex(2));
+  std::vector<MVertex *> byNum(maxNum + 1, nullptr);
+  for(GVertex *gv : points) {
+    for(std::size_t i = 0; i < gv->points.size(); i++) {
+      MVertex *v = gv->points[i]->getVertex(0);
+      byNum[v->getNum()] = v;
+    }
+  }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t k = 0; k < lineChunks.size(); k++) {
+    const hxtChunk &c = lineChunks[k];
+    for(std::size_t i = c.begin; i < c.end; i++) {
+      MLine *l = curves[c.entity]->lines[i];
+      for(int j = 0; j < 2; j++) {
+        MVertex *v = l->getVertex(j);
+#pragma omp atomic write
+        byNum[v->getNum()] = v;
+      }
+    }
+  }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t k = 0; k < triangleChunks.size(); k++) {
+    const hxtChunk &c = triangleChunks[k];
+    for(std::size_t i = c.begin; i < c.end; i++) {
+      MTriangle *t = surfaces[c.entity]->triangles[i];
+      for(int j = 0; j < 3; j++) {
+        MVertex *v = t->getVertex(j);
+#pragma omp atomic write
+        byNum[v->getNum()] = v;
+      }
     }
   }
 
-  m->vertices.num = m->vertices.size = all.size();
+  c2v.clear();
+  for(std::size_t i = 0; i < byNum.size(); i++)
+    if(byNum[i]) c2v.push_back(byNum[i]);
+  std::vector<MVertex *>().swap(byNum);
+
+  m->vertices.num = m->vertices.size = c2v.size();
   HXT_CHECK(
     hxtAlignedMalloc(&m->vertices.coord, 4 * m->vertices.num * sizeof(double)));
 
-  std::size_t count = 0;
-  c2v.resize(all.size());
-  for(MVertex *v : all) {
-    m->vertices.coord[4 * count + 0] = v->x();
-    m->vertices.coord[4 * count + 1] = v->y();
-    m->vertices.coord[4 * count + 2] = v->z();
-    m->vertices.coord[4 * count + 3] = 0;
-    if(CTX::instance()
-         ->mesh.lcFromPoints) { // size on embedded points in volume
-      auto it = vlc.find(v);
-      if(it != vlc.end()) m->vertices.coord[4 * count + 3] = it->second;
-    }
-    v2c[v] = count;
-    c2v[count++] = v;
+  std::vector<long int> indices(c2v.size());
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t i = 0; i < c2v.size(); i++) {
+    MVertex *v = c2v[i];
+    indices[i] = v->getIndex();
+    v->setIndex(i);
+    m->vertices.coord[4 * i + 0] = v->x();
+    m->vertices.coord[4 * i + 1] = v->y();
+    m->vertices.coord[4 * i + 2] = v->z();
+    m->vertices.coord[4 * i + 3] = 0;
   }
-  all.clear();
 
   m->points.num = m->points.size = npts;
   HXT_CHECK(
     hxtAlignedMalloc(&m->points.node, (m->points.num) * sizeof(uint32_t)));
   HXT_CHECK(
     hxtAlignedMalloc(&m->points.color, (m->points.num) * sizeof(uint32_t)));
-  index = 0;
+  uint64_t index = 0;
   for(std::size_t j = 0; j < points.size(); j++) {
     GVertex *gv = points[j];
     for(std::size_t i = 0; i < gv->points.size(); i++) {
-      m->points.node[index] = v2c[gv->points[i]->getVertex(0)];
+      MVertex *v = gv->points[i]->getVertex(0);
+      m->points.node[index] = v->getIndex();
       m->points.color[index] = gv->tag();
+      // size on embedded points in volume
+      if(CTX::instance()->mesh.lcFromPoints &&
+         gv->prescribedMeshSizeAtVertex() != MAX_LC)
+        m->vertices.coord[4 * v->getIndex() + 3] =
+          gv->prescribedMeshSizeAtVertex();
       index++;
     }
   }
@@ -530,14 +607,15 @@ HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
     hxtAlignedMalloc(&m->lines.node, (m->lines.num) * 2 * sizeof(uint32_t)));
   HXT_CHECK(
     hxtAlignedMalloc(&m->lines.color, (m->lines.num) * sizeof(uint32_t)));
-  index = 0;
-  for(std::size_t j = 0; j < curves.size(); j++) {
-    GEdge *ge = curves[j];
-    for(std::size_t i = 0; i < ge->lines.size(); i++) {
-      m->lines.node[2 * index + 0] = v2c[ge->lines[i]->getVertex(0)];
-      m->lines.node[2 * index + 1] = v2c[ge->lines[i]->getVertex(1)];
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t k = 0; k < lineChunks.size(); k++) {
+    const hxtChunk &c = lineChunks[k];
+    GEdge *ge = curves[c.entity];
+    uint64_t index = c.index;
+    for(std::size_t i = c.begin; i < c.end; i++, index++) {
+      m->lines.node[2 * index + 0] = ge->lines[i]->getVertex(0)->getIndex();
+      m->lines.node[2 * index + 1] = ge->lines[i]->getVertex(1)->getIndex();
       m->lines.color[index] = ge->tag();
-      index++;
     }
   }
 
@@ -546,17 +624,32 @@ HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
                              (m->triangles.num) * 3 * sizeof(uint32_t)));
   HXT_CHECK(hxtAlignedMalloc(&m->triangles.color,
                              (m->triangles.num) * sizeof(uint32_t)));
-  index = 0;
-  for(std::size_t j = 0; j < surfaces.size(); j++) {
-    GFace *gf = surfaces[j];
-    for(std::size_t i = 0; i < gf->triangles.size(); i++) {
-      m->triangles.node[3 * index + 0] = v2c[gf->triangles[i]->getVertex(0)];
-      m->triangles.node[3 * index + 1] = v2c[gf->triangles[i]->getVertex(1)];
-      m->triangles.node[3 * index + 2] = v2c[gf->triangles[i]->getVertex(2)];
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t k = 0; k < triangleChunks.size(); k++) {
+    const hxtChunk &c = triangleChunks[k];
+    GFace *gf = surfaces[c.entity];
+    uint64_t index = c.index;
+    for(std::size_t i = c.begin; i < c.end; i++, index++) {
+      MTriangle *t = gf->triangles[i];
+      m->triangles.node[3 * index + 0] = t->getVertex(0)->getIndex();
+      m->triangles.node[3 * index + 1] = t->getVertex(1)->getIndex();
+      m->triangles.node[3 * index + 2] = t->getVertex(2)->getIndex();
       m->triangles.color[index] = gf->tag();
-      index++;
     }
   }
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t i = 0; i < c2v.size(); i++) c2v[i]->setIndex(indices[i]);
+
+  return HXT_STATUS_OK;
+}
+
+HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
+                   std::map<MVertex *, uint32_t> &v2c,
+                   std::vector<MVertex *> &c2v)
+{
+  HXT_CHECK(gmsh2Hxt(regions, m, c2v));
+  for(std::size_t i = 0; i < c2v.size(); i++) v2c[c2v[i]] = i;
   return HXT_STATUS_OK;
 }
 
@@ -567,9 +660,10 @@ static HXTStatus _meshGRegionHxt(std::vector<GRegion *> &regions)
   HXTMesh *mesh;
   HXT_CHECK(hxtMeshCreate(&mesh));
 
-  std::map<MVertex *, uint32_t> v2c;
+  double w1 = TimeOfDay();
   std::vector<MVertex *> c2v;
-  Gmsh2Hxt(regions, mesh, v2c, c2v);
+  HXT_CHECK(gmsh2Hxt(regions, mesh, c2v));
+  double w2 = TimeOfDay();
 
   int nthreads = getNumThreads();
 
@@ -601,8 +695,12 @@ static HXTStatus _meshGRegionHxt(std::vector<GRegion *> &regions)
 
   HXT_CHECK(hxtTetMesh(mesh, &options));
 
-  HXT_CHECK(Hxt2Gmsh(regions, mesh, v2c, c2v));
+  double w3 = TimeOfDay();
+  HXT_CHECK(Hxt2Gmsh(regions, mesh, c2v));
   HXT_CHECK(hxtMeshDelete(&mesh));
+  double w4 = TimeOfDay();
+  Msg::Info("Mesh conversion to HXT: Wall %gs, from HXT: Wall %gs", w2 - w1,
+            w4 - w3);
   return HXT_STATUS_OK;
 }
 
@@ -293,6 +293,37 @@ public:
   }
 };
 
+// create the elements in the slabs of cells i0 <= i < i1 of a transfinite
+// volume: the slabs are filled concurrently, and their elements are then
+// added to the volume (and renumbered) in the order of a sequential creation
+template <class F>
+static void createTransfiniteSlabs(GRegion *gr, int i0, int i1, int nthreads,
+                                   F createSlab)
+{
+  if(i1 <= i0) return;
+  std::size_t num = gr->model()->getMaxElementNumber();
+  std::vector<std::vector<MElement *> > slabs(i1 - i0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(int i = i0; i < i1; i++) createSlab(i, slabs[i - i0]);
+
+  std::size_t n[3] = {0, 0, 0};
+  for(std::size_t i = 0; i < slabs.size(); i++) {
+    for(std::size_t l = 0; l < slabs[i].size(); l++) {
+      int type = slabs[i][l]->getType();
+      n[(type == TYPE_TET) ? 0 : (type == TYPE_HEX) ? 1 : 2]++;
+    }
+  }
+  gr->tetrahedra.reserve(gr->tetrahedra.size() + n[0]);
+  gr->hexahedra.reserve(gr->hexahedra.size() + n[1]);
+  gr->prisms.reserve(gr->prisms.size() + n[2]);
+  for(std::size_t i = 0; i < slabs.size(); i++) {
+    for(std::size_t l = 0; l < slabs[i].size(); l++) {
+      if(nthreads > 1) slabs[i][l]->forceNum(++num);
+      gr->addElement(slabs[i][l]);
+    }
+  }
+}
+
 void findTransfiniteCorners(GRegion *gr, std::vector<MVertex *> &corners)
 {
   if(gr->meshAttributes.corners.size()) {
@@ -439,8 +470,23 @@ int MeshTransfiniteVolume(GRegion *gr)
     for(int j = 0; j < N_j; j++) { tab[i][j].resize(N_k); }
   }
 
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads3D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads3D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  // if the volumes are already meshed concurrently (see Mesh3D), create the
+  // nodes and the elements of this volume sequentially
+  if(Msg::GetNumThreads() > 1) nthreads = 1;
+
+  // the nodes are created concurrently by slabs (i = constant), and are then
+  // renumbered in the order of a sequential creation
+  std::size_t numVertices = gr->model()->getMaxVertexNumber();
+  std::vector<std::vector<MVertex *> > slabVertices(N_i);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
   for(int i = 0; i < N_i; i++) {
     double u = lengths_i[i] / L_i;
+    if(i && i != N_i - 1 && N_j > 2 && N_k > 2)
+      slabVertices[i].reserve((N_j - 2) * (N_k - 2));
 
     for(int j = 0; j < N_j; j++) {
       double v = lengths_j[j] / L_j;
@@ -479,7 +525,7 @@ int MeshTransfiniteVolume(GRegion *gr)
           MVertex *newv = transfiniteHex(
             gr, f0, f1, f2, f3, f4, f5, c0, c1, c2, c3, c4, c5, c6, c7, c8, c9,
             c10, c11, s0, s1, s2, s3, s4, s5, s6, s7, u, v, w);
-          gr->mesh_vertices.push_back(newv);
+          slabVertices[i].push_back(newv);
           tab[i][j][k] = newv;
         }
         else if(!i) {
@@ -504,6 +550,16 @@ int MeshTransfiniteVolume(GRegion *gr)
     }
   }
 
+  std::size_t nv = 0;
+  for(int i = 0; i < N_i; i++) nv += slabVertices[i].size();
+  gr->mesh_vertices.reserve(gr->mesh_vertices.size() + nv);
+  for(int i = 0; i < N_i; i++) {
+    for(std::size_t l = 0; l < slabVertices[i].size(); l++) {
+      if(nthreads > 1) slabVertices[i][l]->forceNum(++numVertices);
+      gr->mesh_vertices.push_back(slabVertices[i][l]);
+    }
+  }
+
 #if defined(HAVE_QUADTRI)
   // for QuadTri, get external boundary diagonals for element subdivision
   // purposes
@@ -520,11 +576,11 @@ int MeshTransfiniteVolume(GRegion *gr)
   // create elements
 
   if(faces.size() == 6) {
-    for(int i = 0; i < N_i - 1; i++) {
-      for(int j = 0; j < N_j - 1; j++) {
-        for(int k = 0; k < N_k - 1; k++) {
 #if defined(HAVE_QUADTRI)
-          if(gr->meshAttributes.QuadTri) {
+    if(gr->meshAttributes.QuadTri) {
+      for(int i = 0; i < N_i - 1; i++) {
+        for(int j = 0; j < N_j - 1; j++) {
+          for(int k = 0; k < N_k - 1; k++) {
             // create vertex array
             std::vector<MVertex *> verts;
             verts.resize(8);
@@ -550,73 +606,78 @@ int MeshTransfiniteVolume(GRegion *gr)
               gr->hexahedra.push_back(
                 new MHexahedron(verts[0], verts[1], verts[2], verts[3],
                                 verts[4], verts[5], verts[6], verts[7]));
-            // continue, skipping the rest which is for non-divided elements
-            continue;
-          }
-#endif
-          if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
-             orientedFaces[2].recombined() && orientedFaces[3].recombined() &&
-             orientedFaces[4].recombined() && orientedFaces[5].recombined()) {
-            gr->hexahedra.push_back(CREATE_HEX);
-          }
-          else if(!orientedFaces[0].recombined() &&
-                  orientedFaces[1].recombined() &&
-                  !orientedFaces[2].recombined() &&
-                  orientedFaces[3].recombined() &&
-                  orientedFaces[4].recombined() &&
-                  orientedFaces[5].recombined()) {
-            gr->prisms.push_back(new MPrism(
-              tab[i][j][k], tab[i + 1][j][k], tab[i][j][k + 1],
-              tab[i][j + 1][k], tab[i + 1][j + 1][k], tab[i][j + 1][k + 1]));
-            gr->prisms.push_back(
-              new MPrism(tab[i + 1][j][k + 1], tab[i][j][k + 1],
-                         tab[i + 1][j][k], tab[i + 1][j + 1][k + 1],
-                         tab[i][j + 1][k + 1], tab[i + 1][j + 1][k]));
-          }
-          else if(orientedFaces[0].recombined() &&
-                  !orientedFaces[1].recombined() &&
-                  orientedFaces[2].recombined() &&
-                  !orientedFaces[3].recombined() &&
-                  orientedFaces[4].recombined() &&
-                  orientedFaces[5].recombined()) {
-            gr->prisms.push_back(new MPrism(
-              tab[i + 1][j][k], tab[i + 1][j + 1][k], tab[i + 1][j][k + 1],
-              tab[i][j][k], tab[i][j + 1][k], tab[i][j][k + 1]));
-            gr->prisms.push_back(
-              new MPrism(tab[i + 1][j + 1][k + 1], tab[i + 1][j][k + 1],
-                         tab[i + 1][j + 1][k], tab[i][j + 1][k + 1],
-                         tab[i][j][k + 1], tab[i][j + 1][k]));
-          }
-          else if(orientedFaces[0].recombined() &&
-                  orientedFaces[1].recombined() &&
-                  orientedFaces[2].recombined() &&
-                  orientedFaces[3].recombined() &&
-                  !orientedFaces[4].recombined() &&
-                  !orientedFaces[5].recombined()) {
-            gr->prisms.push_back(CREATE_PRISM_1);
-            gr->prisms.push_back(CREATE_PRISM_2);
-          }
-          else if(!orientedFaces[0].recombined() &&
-                  !orientedFaces[1].recombined() &&
-                  !orientedFaces[2].recombined() &&
-                  !orientedFaces[3].recombined() &&
-                  !orientedFaces[4].recombined() &&
-                  !orientedFaces[5].recombined()) {
-            gr->tetrahedra.push_back(CREATE_SIM_1);
-            gr->tetrahedra.push_back(CREATE_SIM_2);
-            gr->tetrahedra.push_back(CREATE_SIM_3);
-            gr->tetrahedra.push_back(CREATE_SIM_4);
-            gr->tetrahedra.push_back(CREATE_SIM_5);
-            gr->tetrahedra.push_back(CREATE_SIM_6);
-          }
-          else {
-            Msg::Error("Wrong surface recombination in transfinite volume %d",
-                       gr->tag());
-            return 0;
           }
         }
       }
+      return 1;
     }
+#endif
+    int type = -1;
+    if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
+       orientedFaces[2].recombined() && orientedFaces[3].recombined() &&
+       orientedFaces[4].recombined() && orientedFaces[5].recombined())
+      type = 0;
+    else if(!orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
+            !orientedFaces[2].recombined() && orientedFaces[3].recombined() &&
+            orientedFaces[4].recombined() && orientedFaces[5].recombined())
+      type = 1;
+    else if(orientedFaces[0].recombined() && !orientedFaces[1].recombined() &&
+            orientedFaces[2].recombined() && !orientedFaces[3].recombined() &&
+            orientedFaces[4].recombined() && orientedFaces[5].recombined())
+      type = 2;
+    else if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
+            orientedFaces[2].recombined() && orientedFaces[3].recombined() &&
+            !orientedFaces[4].recombined() && !orientedFaces[5].recombined())
+      type = 3;
+    else if(!orientedFaces[0].recombined() && !orientedFaces[1].recombined() &&
+            !orientedFaces[2].recombined() && !orientedFaces[3].recombined() &&
+            !orientedFaces[4].recombined() && !orientedFaces[5].recombined())
+      type = 4;
+    else {
+      Msg::Error("Wrong surface recombination in transfinite volume %d",
+                 gr->tag());
+      return 0;
+    }
+    int n = (type == 0) ? 1 : (type == 4) ? 6 : 2;
+    createTransfiniteSlabs(
+      gr, 0, N_i - 1, nthreads, [&](int i, std::vector<MElement *> &e) {
+        e.reserve(n * (N_j - 1) * (N_k - 1));
+        for(int j = 0; j < N_j - 1; j++) {
+          for(int k = 0; k < N_k - 1; k++) {
+            if(type == 0) { e.push_back(CREATE_HEX); }
+            else if(type == 1) {
+              e.push_back(new MPrism(
+                tab[i][j][k], tab[i + 1][j][k], tab[i][j][k + 1],
+                tab[i][j + 1][k], tab[i + 1][j + 1][k], tab[i][j + 1][k + 1]));
+              e.push_back(
+                new MPrism(tab[i + 1][j][k + 1], tab[i][j][k + 1],
+                           tab[i + 1][j][k], tab[i + 1][j + 1][k + 1],
+                           tab[i][j + 1][k + 1], tab[i + 1][j + 1][k]));
+            }
+            else if(type == 2) {
+              e.push_back(new MPrism(
+                tab[i + 1][j][k], tab[i + 1][j + 1][k], tab[i + 1][j][k + 1],
+                tab[i][j][k], tab[i][j + 1][k], tab[i][j][k + 1]));
+              e.push_back(
+                new MPrism(tab[i + 1][j + 1][k + 1], tab[i + 1][j][k + 1],
+                           tab[i + 1][j + 1][k], tab[i][j + 1][k + 1],
+                           tab[i][j][k + 1], tab[i][j + 1][k]));
+            }
+            else if(type == 3) {
+              e.push_back(CREATE_PRISM_1);
+              e.push_back(CREATE_PRISM_2);
+            }
+            else {
+              e.push_back(CREATE_SIM_1);
+              e.push_back(CREATE_SIM_2);
+              e.push_back(CREATE_SIM_3);
+              e.push_back(CREATE_SIM_4);
+              e.push_back(CREATE_SIM_5);
+              e.push_back(CREATE_SIM_6);
+            }
+          }
+        }
+      });
   }
   else if(faces.size() == 5) {
     bool standard_algo = true;
@@ -628,10 +689,10 @@ int MeshTransfiniteVolume(GRegion *gr)
       }
     }
     if(standard_algo) {
-      for(int j = 0; j < N_j - 1; j++) {
-        for(int k = 0; k < N_k - 1; k++) {
 #if defined(HAVE_QUADTRI)
-          if(gr->meshAttributes.QuadTri) {
+      if(gr->meshAttributes.QuadTri) {
+        for(int j = 0; j < N_j - 1; j++) {
+          for(int k = 0; k < N_k - 1; k++) {
             std::vector<MVertex *> verts;
             verts.resize(6);
             verts[0] = tab[0][j][k];
@@ -650,46 +711,11 @@ int MeshTransfiniteVolume(GRegion *gr)
             else
               gr->prisms.push_back(new MPrism(verts[0], verts[1], verts[2],
                                               verts[3], verts[4], verts[5]));
-            // continue, skipping the rest which is for non-divided elements
-            continue;
-          }
-#endif
-          if((orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
-              orientedFaces[2].recombined() && orientedFaces[4].recombined() &&
-              orientedFaces[5].recombined()) ||
-             (orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
-              orientedFaces[2].recombined() && !orientedFaces[4].recombined() &&
-              !orientedFaces[5].recombined())) {
-            gr->prisms.push_back(new MPrism(
-              tab[0][j][k], tab[1][j][k], tab[1][j + 1][k], tab[0][j][k + 1],
-              tab[1][j][k + 1], tab[1][j + 1][k + 1]));
-          }
-          else if(!orientedFaces[0].recombined() &&
-                  !orientedFaces[1].recombined() &&
-                  !orientedFaces[2].recombined() &&
-                  !orientedFaces[4].recombined() &&
-                  !orientedFaces[5].recombined()) {
-            gr->tetrahedra.push_back(new MTetrahedron(
-              tab[0][j][k], tab[1][j][k], tab[1][j + 1][k], tab[0][j][k + 1]));
-            gr->tetrahedra.push_back(
-              new MTetrahedron(tab[1][j][k], tab[1][j + 1][k], tab[0][j][k + 1],
-                               tab[1][j][k + 1]));
-            gr->tetrahedra.push_back(
-              new MTetrahedron(tab[0][j][k + 1], tab[1][j + 1][k + 1],
-                               tab[1][j][k + 1], tab[1][j + 1][k]));
-          }
-          else {
-            Msg::Error("Wrong surface recombination in transfinite volume %d",
-                       gr->tag());
-            return 0;
           }
         }
-      }
-      for(int i = 1; i < N_i - 1; i++) {
-        for(int j = 0; j < N_j - 1; j++) {
-          for(int k = 0; k < N_k - 1; k++) {
-#if defined(HAVE_QUADTRI)
-            if(gr->meshAttributes.QuadTri) {
+        for(int i = 1; i < N_i - 1; i++) {
+          for(int j = 0; j < N_j - 1; j++) {
+            for(int k = 0; k < N_k - 1; k++) {
               // create vertex array
               std::vector<MVertex *> verts;
               verts.resize(8);
@@ -713,96 +739,127 @@ int MeshTransfiniteVolume(GRegion *gr)
                 gr->hexahedra.push_back(
                   new MHexahedron(verts[0], verts[1], verts[2], verts[3],
                                   verts[4], verts[5], verts[6], verts[7]));
-              // continue, skipping the rest which is for non-divided elements
-              continue;
             }
+          }
+        }
+        return 1;
+      }
 #endif
-            if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
-               orientedFaces[2].recombined() && orientedFaces[4].recombined() &&
-               orientedFaces[5].recombined()) {
-              gr->hexahedra.push_back(CREATE_HEX);
-            }
-            else if(orientedFaces[0].recombined() &&
-                    orientedFaces[1].recombined() &&
-                    orientedFaces[2].recombined() &&
-                    !orientedFaces[4].recombined() &&
-                    !orientedFaces[5].recombined()) {
-              gr->prisms.push_back(CREATE_PRISM_1);
-              gr->prisms.push_back(CREATE_PRISM_2);
-            }
-            else if(!orientedFaces[0].recombined() &&
-                    !orientedFaces[1].recombined() &&
-                    !orientedFaces[2].recombined() &&
-                    !orientedFaces[4].recombined() &&
-                    !orientedFaces[5].recombined()) {
-              gr->tetrahedra.push_back(CREATE_SIM_1);
-              gr->tetrahedra.push_back(CREATE_SIM_2);
-              gr->tetrahedra.push_back(CREATE_SIM_3);
-              gr->tetrahedra.push_back(CREATE_SIM_4);
-              gr->tetrahedra.push_back(CREATE_SIM_5);
-              gr->tetrahedra.push_back(CREATE_SIM_6);
+      int type = -1;
+      if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
+         orientedFaces[2].recombined() && orientedFaces[4].recombined() &&
+         orientedFaces[5].recombined())
+        type = 0;
+      else if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
+              orientedFaces[2].recombined() && !orientedFaces[4].recombined() &&
+              !orientedFaces[5].recombined())
+        type = 1;
+      else if(!orientedFaces[0].recombined() &&
+              !orientedFaces[1].recombined() &&
+              !orientedFaces[2].recombined() &&
+              !orientedFaces[4].recombined() && !orientedFaces[5].recombined())
+        type = 2;
+      else {
+        Msg::Error("Wrong surface recombination in transfinite volume %d",
+                   gr->tag());
+        return 0;
+      }
+      // the first slab is degenerate (along s0, s4)
+      createTransfiniteSlabs(
+        gr, 0, N_i - 1, nthreads, [&](int i, std::vector<MElement *> &e) {
+          if(i == 0) {
+            e.reserve((type == 2 ? 3 : 1) * (N_j - 1) * (N_k - 1));
+            for(int j = 0; j < N_j - 1; j++) {
+              for(int k = 0; k < N_k - 1; k++) {
+                if(type != 2) {
+                  e.push_back(new MPrism(
+                    tab[0][j][k], tab[1][j][k], tab[1][j + 1][k],
+                    tab[0][j][k + 1], tab[1][j][k + 1], tab[1][j + 1][k + 1]));
+                }
+                else {
+                  e.push_back(
+                    new MTetrahedron(tab[0][j][k], tab[1][j][k],
+                                     tab[1][j + 1][k], tab[0][j][k + 1]));
+                  e.push_back(
+                    new MTetrahedron(tab[1][j][k], tab[1][j + 1][k],
+                                     tab[0][j][k + 1], tab[1][j][k + 1]));
+                  e.push_back(
+                    new MTetrahedron(tab[0][j][k + 1], tab[1][j + 1][k + 1],
+                                     tab[1][j][k + 1], tab[1][j + 1][k]));
+                }
+              }
             }
-            else {
-              Msg::Error("Wrong surface recombination in transfinite volume %d",
-                         gr->tag());
-              return 0;
+            return;
+          }
+          int n = (type == 0) ? 1 : (type == 1) ? 2 : 6;
+          e.reserve(n * (N_j - 1) * (N_k - 1));
+          for(int j = 0; j < N_j - 1; j++) {
+            for(int k = 0; k < N_k - 1; k++) {
+              if(type == 0) { e.push_back(CREATE_HEX); }
+              else if(type == 1) {
+                e.push_back(CREATE_PRISM_1);
+                e.push_back(CREATE_PRISM_2);
+              }
+              else {
+                e.push_back(CREATE_SIM_1);
+                e.push_back(CREATE_SIM_2);
+                e.push_back(CREATE_SIM_3);
+                e.push_back(CREATE_SIM_4);
+                e.push_back(CREATE_SIM_5);
+                e.push_back(CREATE_SIM_6);
+              }
             }
           }
-        }
-      }
+        });
     }
     else { // if surfaces meshed with specific algo for 3-sided surfaces
-      for(int i = 0; i < N_i - 1; i++) {
-        int j = i;
-        for(int k = 0; k < N_k - 1; k++) {
-          if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
-             orientedFaces[2].recombined()) {
-            gr->prisms.push_back(CREATE_PRISM_4);
-          }
-          else if(!orientedFaces[0].recombined() &&
-                  !orientedFaces[1].recombined() &&
-                  !orientedFaces[2].recombined() &&
-                  !orientedFaces[4].recombined() &&
-                  !orientedFaces[5].recombined()) {
-            gr->tetrahedra.push_back(CREATE_SIM_10);
-            gr->tetrahedra.push_back(CREATE_SIM_11);
-            gr->tetrahedra.push_back(CREATE_SIM_12);
-          }
-          else {
-            Msg::Error("Wrong surface recombination in transfinite volume %d",
-                       gr->tag());
-            return 0;
-          }
-        }
+      bool prisms;
+      if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
+         orientedFaces[2].recombined())
+        prisms = true;
+      else if(!orientedFaces[0].recombined() &&
+              !orientedFaces[1].recombined() &&
+              !orientedFaces[2].recombined() &&
+              !orientedFaces[4].recombined() && !orientedFaces[5].recombined())
+        prisms = false;
+      else {
+        Msg::Error("Wrong surface recombination in transfinite volume %d",
+                   gr->tag());
+        return 0;
       }
-      for(int i = 1; i < N_i - 1; i++) {
-        for(int j = 0; j < i; j++) {
+      createTransfiniteSlabs(
+        gr, 0, N_i - 1, nthreads, [&](int i, std::vector<MElement *> &e) {
+          int j = i;
+          e.reserve((prisms ? 1 : 3) * (N_k - 1));
           for(int k = 0; k < N_k - 1; k++) {
-            if(orientedFaces[0].recombined() && orientedFaces[1].recombined() &&
-               orientedFaces[2].recombined()) {
-              gr->prisms.push_back(CREATE_PRISM_3);
-              gr->prisms.push_back(CREATE_PRISM_4);
-            }
-            else if(!orientedFaces[0].recombined() &&
-                    !orientedFaces[1].recombined() &&
-                    !orientedFaces[2].recombined() &&
-                    !orientedFaces[4].recombined() &&
-                    !orientedFaces[5].recombined()) {
-              gr->tetrahedra.push_back(CREATE_SIM_7);
-              gr->tetrahedra.push_back(CREATE_SIM_8);
-              gr->tetrahedra.push_back(CREATE_SIM_9);
-              gr->tetrahedra.push_back(CREATE_SIM_10);
-              gr->tetrahedra.push_back(CREATE_SIM_11);
-              gr->tetrahedra.push_back(CREATE_SIM_12);
-            }
+            if(prisms) { e.push_back(CREATE_PRISM_4); }
             else {
-              Msg::Error("Wrong surface recombination in transfinite volume %d",
-                         gr->tag());
-              return 0;
+              e.push_back(CREATE_SIM_10);
+              e.push_back(CREATE_SIM_11);
+              e.push_back(CREATE_SIM_12);
             }
           }
-        }
-      }
+        });
+      createTransfiniteSlabs(
+        gr, 1, N_i - 1, nthreads, [&](int i, std::vector<MElement *> &e) {
+          e.reserve((prisms ? 2 : 6) * i * (N_k - 1));
+          for(int j = 0; j < i; j++) {
+            for(int k = 0; k < N_k - 1; k++) {
+              if(prisms) {
+                e.push_back(CREATE_PRISM_3);
+                e.push_back(CREATE_PRISM_4);
+              }
+              else {
+                e.push_back(CREATE_SIM_7);
+                e.push_back(CREATE_SIM_8);
+                e.push_back(CREATE_SIM_9);
+                e.push_back(CREATE_SIM_10);
+                e.push_back(CREATE_SIM_11);
+                e.push_back(CREATE_SIM_12);
+              }
+            }
+          }
+        });
     }
   }
 
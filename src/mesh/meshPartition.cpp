@@ -203,21 +203,37 @@ public:
   {
     for(std::size_t i = 0; i < _vertex.size(); i++) _vertex[i] = -1;
   }
-  std::vector<std::set<MElement *, MElementPtrLessThan> >
-  getBoundaryElements(idx_t size = 0)
+  // Return the elements of dimension _dim having a neighbor in another
+  // partition, grouped by partition and sorted by element number
+  std::vector<std::vector<MElement *> > getBoundaryElements(idx_t size = 0)
   {
-    std::vector<std::set<MElement *, MElementPtrLessThan> > elements(
-      (size ? size : _nparts), std::set<MElement *, MElementPtrLessThan>());
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+    std::vector<char> boundary(_ne, 0);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
     for(std::size_t i = 0; i < _ne; i++) {
+      if(_element[i]->getDim() != _dim) continue;
       for(idx_t j = _xadj[i]; j < _xadj[i + 1]; j++) {
         if(_partition[i] != _partition[_adjncy[j]]) {
-          if(_element[i]->getDim() == _dim) {
-            elements[_partition[i]].insert(_element[i]);
-          }
+          boundary[i] = 1;
+          break;
         }
       }
     }
 
+    std::vector<std::vector<MElement *> > elements(size ? size : _nparts);
+    for(std::size_t i = 0; i < _ne; i++) {
+      if(boundary[i]) elements[_partition[i]].push_back(_element[i]);
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = 0; i < elements.size(); i++) {
+      std::vector<MElement *> &e = elements[i];
+      std::sort(e.begin(), e.end(), MElementPtrLessThan());
+      e.erase(std::unique(e.begin(), e.end(), MElementPtrEqual()), e.end());
+    }
+
     return elements;
   }
   std::vector<GEntity *> createGhostEntities()
@@ -367,7 +383,8 @@ public:
        CTX::instance()->mesh.partitionTetWeight == 1 &&
        CTX::instance()->mesh.partitionPyrWeight == 1 &&
        CTX::instance()->mesh.partitionPriWeight == 1 &&
-       CTX::instance()->mesh.partitionHexWeight == 1)
+       CTX::instance()->mesh.partitionHexWeight == 1 &&
+       !CTX::instance()->mesh.partitionOrderWeight)
       return;
 
     _vwgt = new idx_t[_ne];
@@ -416,6 +433,16 @@ public:
         }
       }
     }
+    if(CTX::instance()->mesh.partitionOrderWeight) {
+      // high-order elements are more expensive: scale their weight by the
+      // number of nodes per direction to the power of their dimension
+      for(std::size_t i = 0; i < _ne; i++) {
+        if(!_element[i]) continue;
+        const int nodesPerDirection = _element[i]->getPolynomialOrder() + 1;
+        for(int d = 0; d < _element[i]->getDim(); d++)
+          _vwgt[i] *= nodesPerDirection;
+      }
+    }
   }
 };
 
@@ -586,9 +613,115 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
   return 0;
 }
 
-// Partition a graph created by makeGraph using Metis library. Returns: 0 =
-// success, 1 = error, 2 = exception thrown.
-static int partitionGraph(Graph &graph, bool verbose)
+// Partition the graph (xadj, adjncy, vwgt) with ne vertices in nparts parts
+// using Metis. Returns: 0 = success, 1 = error.
+static int metisPartGraph(idx_t *metisOptions, idx_t ne, idx_t *xadj,
+                          idx_t *adjncy, idx_t *vwgt, idx_t nparts,
+                          idx_t *epart, idx_t &objval)
+{
+  idx_t ncon = 1;
+  int metisError = 0;
+  if(metisOptions[METIS_OPTION_PTYPE] == METIS_PTYPE_KWAY) {
+    metisError =
+      METIS_PartGraphKway(&ne, &ncon, xadj, adjncy, vwgt, nullptr, nullptr,
+                          &nparts, nullptr, nullptr, metisOptions, &objval,
+                          epart);
+  }
+  else {
+    metisError =
+      METIS_PartGraphRecursive(&ne, &ncon, xadj, adjncy, vwgt, nullptr, nullptr,
+                               &nparts, nullptr, nullptr, metisOptions,
+                               &objval, epart);
+  }
+
+  switch(metisError) {
+  case METIS_OK: return 0;
+  case METIS_ERROR_INPUT: Msg::Error("METIS input error"); return 1;
+  case METIS_ERROR_MEMORY: Msg::Error("METIS memory error"); return 1;
+  case METIS_ERROR:
+  default: Msg::Error("METIS error"); return 1;
+  }
+}
+
+// Partition the elements of each part of a partition of the graph into
+// nparts sub-parts: the elements of part q are assigned to parts q * nparts,
+// ..., (q + 1) * nparts - 1, so that the numbering of the final parts reflects
+// the hierarchy. Returns: 0 = success, 1 = error.
+static int subPartitionGraph(Graph &graph, idx_t *metisOptions,
+                             std::vector<idx_t> &epart, idx_t numPart,
+                             idx_t nparts, idx_t &objval)
+{
+  std::vector<std::vector<idx_t> > parts(numPart);
+  for(std::size_t i = 0; i < graph.ne(); i++) parts[epart[i]].push_back(i);
+
+  std::vector<idx_t> local(graph.ne(), -1);
+  objval = 0;
+  // METIS is not thread-safe with the bundled GKlib, so the parts are
+  // partitioned one after the other
+  for(idx_t q = 0; q < numPart; q++) {
+    const std::vector<idx_t> &elements = parts[q];
+    const idx_t ne = elements.size();
+    if(ne <= nparts) {
+      for(idx_t i = 0; i < ne; i++) epart[elements[i]] = q * nparts + i;
+      continue;
+    }
+    for(idx_t i = 0; i < ne; i++) local[elements[i]] = i;
+
+    // extract the subgraph of the part
+    std::vector<idx_t> xadj(ne + 1, 0), adjncy, vwgt;
+    for(idx_t i = 0; i < ne; i++) {
+      const idx_t j = elements[i];
+      for(idx_t k = graph.xadj(j); k < graph.xadj(j + 1); k++) {
+        if(epart[graph.adjncy(k)] == q)
+          adjncy.push_back(local[graph.adjncy(k)]);
+      }
+      xadj[i + 1] = adjncy.size();
+      if(graph.vwgt()) vwgt.push_back(graph.vwgt()[j]);
+    }
+    if(adjncy.empty()) adjncy.push_back(0);
+
+    std::vector<idx_t> subpart(ne);
+    idx_t subobjval = 0;
+    if(metisPartGraph(metisOptions, ne, &xadj[0], &adjncy[0],
+                      vwgt.empty() ? nullptr : &vwgt[0], nparts, &subpart[0],
+                      subobjval))
+      return 1;
+    objval += subobjval;
+    for(idx_t i = 0; i < ne; i++) epart[elements[i]] = q * nparts + subpart[i];
+  }
+  return 0;
+}
+
+// Parse the number of partitions at each level of a hierarchical partitioning
+// (Mesh.PartitionHierarchy), or return a single level with numPart partitions.
+static std::vector<int> getPartitionHierarchy(int numPart)
+{
+  std::string str = CTX::instance()->mesh.partitionHierarchy;
+  std::replace(str.begin(), str.end(), ',', ' ');
+  std::istringstream sstream(str);
+  std::vector<int> levels;
+  int n, product = 1;
+  while(sstream >> n) {
+    if(n < 1) {
+      Msg::Error("Invalid number of partitions %d in partition hierarchy", n);
+      return std::vector<int>(1, numPart);
+    }
+    levels.push_back(n);
+    product *= n;
+  }
+  if(levels.size() < 2) return std::vector<int>(1, numPart);
+  if(product != numPart)
+    Msg::Warning("Partition hierarchy '%s' leads to %d partitions instead of "
+                 "%d", CTX::instance()->mesh.partitionHierarchy.c_str(),
+                 product, numPart);
+  return levels;
+}
+
+// Partition a graph created by makeGraph using Metis library, hierarchically
+// if several levels are given (the product of which should be graph.nparts()).
+// Returns: 0 = success, 1 = error, 2 = exception thrown.
+static int partitionGraph(Graph &graph, bool verbose,
+                          const std::vector<int> &levels = std::vector<int>())
 {
 #ifdef HAVE_METIS
   std::stringstream opt;
@@ -597,6 +730,12 @@ static int partitionGraph(Graph &graph, bool verbose)
     METIS_SetDefaultOptions(metisOptions);
 
     opt << "npart:" << graph.nparts();
+    if(levels.size() > 1) {
+      opt << " (";
+      for(std::size_t i = 0; i < levels.size(); i++)
+        opt << (i ? "x" : "") << levels[i];
+      opt << ")";
+    }
 
     opt << ", sizeof(idx_t):" << 8 * sizeof(idx_t);
 
@@ -690,31 +829,26 @@ static int partitionGraph(Graph &graph, bool verbose)
 
     idx_t objval;
     std::vector<idx_t> epart(graph.ne());
-    idx_t ne = graph.ne();
-    idx_t numPart = graph.nparts();
-    idx_t ncon = 1;
+    idx_t numPart = levels.size() > 1 ? levels[0] : graph.nparts();
     graph.fillDefaultWeights();
-
-    int metisError = 0;
     graph.createDualGraph(false);
 
-    if(metisOptions[METIS_OPTION_PTYPE] == METIS_PTYPE_KWAY) {
-      metisError = METIS_PartGraphKway(
-        &ne, &ncon, graph.xadj(), graph.adjncy(), graph.vwgt(), nullptr,
-        nullptr, &numPart, nullptr, nullptr, metisOptions, &objval, &epart[0]);
-    }
-    else {
-      metisError = METIS_PartGraphRecursive(
-        &ne, &ncon, graph.xadj(), graph.adjncy(), graph.vwgt(), nullptr,
-        nullptr, &numPart, nullptr, nullptr, metisOptions, &objval, &epart[0]);
-    }
+    if(metisPartGraph(metisOptions, graph.ne(), graph.xadj(), graph.adjncy(),
+                      graph.vwgt(), numPart, &epart[0], objval))
+      return 1;
+    if(verbose && levels.size() > 1)
+      Msg::Info("Level 1: %d partitions, %d edge-cuts", numPart, objval);
 
-    switch(metisError) {
-    case METIS_OK: break;
-    case METIS_ERROR_INPUT: Msg::Error("METIS input error"); return 1;
-    case METIS_ERROR_MEMORY: Msg::Error("METIS memory error"); return 1;
-    case METIS_ERROR:
-    default: Msg::Error("METIS error"); return 1;
+    for(std::size_t l = 1; l < levels.size(); l++) {
+      idx_t subobjval;
+      if(subPartitionGraph(graph, metisOptions, epart, numPart, levels[l],
+                           subobjval))
+        return 1;
+      numPart *= levels[l];
+      objval += subobjval;
+      if(verbose)
+        Msg::Info("Level %d: %d partitions, %d additional edge-cuts", l + 1,
+                  numPart, subobjval);
     }
 
     // Check and correct the topology
@@ -744,15 +878,31 @@ static int partitionGraph(Graph &graph, bool verbose)
   return 0;
 }
 
-template <class ENTITY, class ITERATOR>
+template <class ENTITY, class ELEMENT>
 static void
 assignElementsToEntities(GModel *model, hashmapelementpart &elmToPartition,
-                         std::vector<ENTITY *> &newEntities, ITERATOR it_beg,
-                         ITERATOR it_end, int &elementaryNumber)
+                         std::vector<ENTITY *> &newEntities,
+                         const std::vector<ELEMENT *> &elements,
+                         int &elementaryNumber)
 {
-  for(ITERATOR it = it_beg; it != it_end; ++it) {
-    int partition = elmToPartition[(*it)] - 1;
+  if(elements.empty()) return;
 
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // look up the partition of the elements in parallel
+  std::vector<int> part(elements.size());
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t i = 0; i < elements.size(); i++) {
+    auto it = elmToPartition.find(elements[i]);
+    part[i] = (it != elmToPartition.end()) ? it->second - 1 : 0;
+  }
+
+  // create the new entities in the order in which the partitions appear, and
+  // group the elements by partition (counting sort, preserving their order)
+  std::vector<std::size_t> offset(newEntities.size() + 1, 0);
+  for(std::size_t i = 0; i < elements.size(); i++) {
+    int partition = part[i];
     if(!newEntities[partition]) {
       std::vector<int> partitions;
       partitions.push_back(partition + 1);
@@ -760,8 +910,20 @@ assignElementsToEntities(GModel *model, hashmapelementpart &elmToPartition,
       model->add(de);
       newEntities[partition] = de;
     }
+    offset[partition + 1]++;
+  }
+  for(std::size_t i = 0; i < newEntities.size(); i++)
+    offset[i + 1] += offset[i];
+  std::vector<ELEMENT *> sorted(elements.size());
+  std::vector<std::size_t> pos(offset.begin(), offset.end() - 1);
+  for(std::size_t i = 0; i < elements.size(); i++)
+    sorted[pos[part[i]]++] = elements[i];
 
-    newEntities[partition]->addElement(*it);
+  // add the elements to each new entity in parallel
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < newEntities.size(); i++) {
+    for(std::size_t j = offset[i]; j < offset[i + 1]; j++)
+      newEntities[i]->addElement(sorted[j]);
   }
 }
 
@@ -829,14 +991,17 @@ static void assignMeshVertices(GModel *model)
   }
 }
 
-static void fillConnectedElements(
-  std::vector<std::set<MElement *, MElementPtrLessThan> > &connectedElements,
-  Graph &graph)
+static void
+fillConnectedElements(std::vector<std::vector<MElement *> > &connectedElements,
+                      Graph &graph)
 {
   if(graph.ne() < 2) return;
 
   std::stack<idx_t> elementStack;
-  std::set<MElement *, MElementPtrLessThan> elements;
+  std::vector<MElement *> elements;
+  // component in which each element was last added
+  std::vector<std::size_t> visited(graph.ne(), 0);
+  std::size_t component = 0;
   idx_t startElement = 0;
   bool stop = true;
   std::size_t size = 0;
@@ -845,12 +1010,15 @@ static void fillConnectedElements(
   do {
     // Inititalization
     elementStack.push(startElement);
-    elements.insert(graph.element(startElement));
+    component++;
 
     while(elementStack.size() != 0) {
       idx_t top = elementStack.top();
       elementStack.pop();
-      elements.insert(graph.element(top));
+      if(visited[top] != component) {
+        visited[top] = component;
+        elements.push_back(graph.element(top));
+      }
 
       for(idx_t i = graph.xadj(top); i < graph.xadj(top + 1); i++) {
         if(graph.adjncy(i) != 0) {
@@ -859,6 +1027,10 @@ static void fillConnectedElements(
         }
       }
     }
+    std::sort(elements.begin(), elements.end(), MElementPtrLessThan());
+    elements.erase(
+      std::unique(elements.begin(), elements.end(), MElementPtrEqual()),
+      elements.end());
     connectedElements.push_back(elements);
     size += elements.size();
     elements.clear();
@@ -990,8 +1162,7 @@ divideNonConnectedEntities(GModel *model, int dim,
           continue;
         }
 
-        std::vector<std::set<MElement *, MElementPtrLessThan> >
-          connectedElements;
+        std::vector<std::vector<MElement *> > connectedElements;
         fillConnectedElements(connectedElements, graph);
 
         if(connectedElements.size() > 1) {
@@ -1090,8 +1261,7 @@ divideNonConnectedEntities(GModel *model, int dim,
           continue;
         }
 
-        std::vector<std::set<MElement *, MElementPtrLessThan> >
-          connectedElements;
+        std::vector<std::vector<MElement *> > connectedElements;
         fillConnectedElements(connectedElements, graph);
 
         if(connectedElements.size() > 1) {
@@ -1196,8 +1366,7 @@ divideNonConnectedEntities(GModel *model, int dim,
           continue;
         }
 
-        std::vector<std::set<MElement *, MElementPtrLessThan> >
-          connectedElements;
+        std::vector<std::vector<MElement *> > connectedElements;
         fillConnectedElements(connectedElements, graph);
 
         if(connectedElements.size() > 1) {
@@ -1249,8 +1418,7 @@ static void createNewEntities(GModel *model, hashmapelementpart &elmToPartition)
                                                nullptr);
 
     assignElementsToEntities(model, elmToPartition, newVertices,
-                             (*it)->points.begin(), (*it)->points.end(),
-                             elementaryNumber);
+                             (*it)->points, elementaryNumber);
 
     for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
       if(newVertices[i]) {
@@ -1268,8 +1436,7 @@ static void createNewEntities(GModel *model, hashmapelementpart &elmToPartition)
     std::vector<partitionEdge *> newEdges(model->getNumPartitions(), nullptr);
 
     assignElementsToEntities(model, elmToPartition, newEdges,
-                             (*it)->lines.begin(), (*it)->lines.end(),
-                             elementaryNumber);
+                             (*it)->lines, elementaryNumber);
 
     for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
       if(newEdges[i]) {
@@ -1287,11 +1454,9 @@ static void createNewEntities(GModel *model, hashmapelementpart &elmToPartition)
     std::vector<partitionFace *> newFaces(model->getNumPartitions(), nullptr);
 
     assignElementsToEntities(model, elmToPartition, newFaces,
-                             (*it)->triangles.begin(), (*it)->triangles.end(),
-                             elementaryNumber);
+                             (*it)->triangles, elementaryNumber);
     assignElementsToEntities(model, elmToPartition, newFaces,
-                             (*it)->quadrangles.begin(),
-                             (*it)->quadrangles.end(), elementaryNumber);
+                             (*it)->quadrangles, elementaryNumber);
 
     std::list<GRegion *> BRepRegions = (*it)->regions();
     for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
@@ -1312,20 +1477,15 @@ static void createNewEntities(GModel *model, hashmapelementpart &elmToPartition)
                                               nullptr);
 
     assignElementsToEntities(model, elmToPartition, newRegions,
-                             (*it)->tetrahedra.begin(), (*it)->tetrahedra.end(),
-                             elementaryNumber);
+                             (*it)->tetrahedra, elementaryNumber);
     assignElementsToEntities(model, elmToPartition, newRegions,
-                             (*it)->hexahedra.begin(), (*it)->hexahedra.end(),
-                             elementaryNumber);
+                             (*it)->hexahedra, elementaryNumber);
     assignElementsToEntities(model, elmToPartition, newRegions,
-                             (*it)->prisms.begin(), (*it)->prisms.end(),
-                             elementaryNumber);
+                             (*it)->prisms, elementaryNumber);
     assignElementsToEntities(model, elmToPartition, newRegions,
-                             (*it)->pyramids.begin(), (*it)->pyramids.end(),
-                             elementaryNumber);
+                             (*it)->pyramids, elementaryNumber);
     assignElementsToEntities(model, elmToPartition, newRegions,
-                             (*it)->trihedra.begin(), (*it)->trihedra.end(),
-                             elementaryNumber);
+                             (*it)->trihedra, elementaryNumber);
 
     for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
       if(newRegions[i]) {
@@ -1355,6 +1515,7 @@ static void createNewEntities(GModel *model, hashmapelementpart &elmToPartition)
 static void fillElementToEntity(GModel *model, hashmapelement &elmToEntity,
                                 int dim)
 {
+  elmToEntity.reserve(model->getNumMeshElements(dim));
   // Loop over volumes
   if(dim < 0 || dim == 3) {
     for(auto it = model->firstRegion(); it != model->lastRegion(); ++it) {
@@ -1795,12 +1956,62 @@ static void assignNewEntityBRep(Graph &graph, hashmapelement &elementToEntity)
   }
 }
 
+static void getElementFaces(MElement *e, std::vector<MFace> &faces)
+{
+  for(int i = 0; i < e->getNumFaces(); i++) faces.push_back(e->getFace(i));
+}
+
+static void getElementEdges(MElement *e, std::vector<MEdge> &edges)
+{
+  for(int i = 0; i < e->getNumEdges(); i++) edges.push_back(e->getEdge(i));
+}
+
+static void getElementPrimaryVertices(MElement *e,
+                                      std::vector<MVertex *> &vertices)
+{
+  for(std::size_t i = 0; i < e->getNumPrimaryVertices(); i++)
+    vertices.push_back(e->getVertex(i));
+}
+
+// Fill the map from the faces, edges or nodes of the boundary elements of each
+// group to these elements and the partitions of their group. The keys are
+// computed in parallel, and inserted in the same order as in a sequential
+// traversal (the iteration order of the map determines the numbering of the
+// partition entities).
+template <class MAP, class KEY>
+static void
+fillBoundaryMap(MAP &map,
+                const std::vector<std::vector<MElement *> > &boundaryElements,
+                const std::vector<std::vector<int> > &partitions,
+                void (*getKeys)(MElement *, std::vector<KEY> &))
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  std::vector<std::pair<std::size_t, MElement *> > elements;
+  for(std::size_t i = 0; i < boundaryElements.size(); i++) {
+    for(std::size_t j = 0; j < boundaryElements[i].size(); j++)
+      elements.push_back(std::make_pair(i, boundaryElements[i][j]));
+  }
+
+  std::vector<std::vector<KEY> > keys(elements.size());
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t i = 0; i < elements.size(); i++)
+    getKeys(elements[i].second, keys[i]);
+
+  for(std::size_t i = 0; i < elements.size(); i++) {
+    for(std::size_t j = 0; j < keys[i].size(); j++)
+      map[keys[i][j]].push_back(
+        std::make_pair(elements[i].second, partitions[elements[i].first]));
+  }
+}
+
 // Create the new entities between each partitions (sigma and bndSigma).
-static void createPartitionTopology(
-  GModel *model,
-  const std::vector<std::set<MElement *, MElementPtrLessThan> >
-    &boundaryElements,
-  Graph &meshGraph)
+static void
+createPartitionTopology(GModel *model,
+                        const std::vector<std::vector<MElement *> >
+                          &boundaryElements,
+                        Graph &meshGraph)
 {
   int meshDim = model->getMeshDim();
   hashmapelement elementToEntity;
@@ -1821,18 +2032,15 @@ static void createPartitionTopology(
   std::set<GEdge *, GEntityPtrLessThan> edges = model->getEdges();
   std::set<GVertex *, GEntityPtrLessThan> vertices = model->getVertices();
 
+  std::vector<std::vector<int> > partitionOfBoundary;
+  for(std::size_t i = 0; i < model->getNumPartitions(); i++)
+    partitionOfBoundary.push_back(std::vector<int>(1, i + 1));
+
   if(meshDim >= 3) {
     Msg::Info(" - Creating partition surfaces");
 
-    for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
-      for(auto it = boundaryElements[i].begin();
-          it != boundaryElements[i].end(); ++it) {
-        for(int j = 0; j < (*it)->getNumFaces(); j++) {
-          faceToElement[(*it)->getFace(j)].push_back(
-            std::make_pair(*it, std::vector<int>(1, i + 1)));
-        }
-      }
-    }
+    fillBoundaryMap(faceToElement, boundaryElements, partitionOfBoundary,
+                    getElementFaces);
     int numFaceEntity = model->getMaxElementaryNumber(2);
     for(auto it = faceToElement.begin(); it != faceToElement.end(); ++it) {
       MFace f = it->first;
@@ -1869,15 +2077,8 @@ static void createPartitionTopology(
     Msg::Info(" - Creating partition curves");
 
     if(meshDim == 2) {
-      for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
-        for(auto it = boundaryElements[i].begin();
-            it != boundaryElements[i].end(); ++it) {
-          for(int j = 0; j < (*it)->getNumEdges(); j++) {
-            edgeToElement[(*it)->getEdge(j)].push_back(
-              std::make_pair(*it, std::vector<int>(1, i + 1)));
-          }
-        }
-      }
+      fillBoundaryMap(edgeToElement, boundaryElements, partitionOfBoundary,
+                      getElementEdges);
     }
     else {
       Graph subGraph(model);
@@ -1886,13 +2087,12 @@ static void createPartitionTopology(
       std::vector<idx_t> part(subGraph.ne());
       int partIndex = 0;
 
-      std::map<idx_t, std::vector<int> > mapOfPartitions;
+      std::vector<std::vector<int> > mapOfPartitions;
       idx_t mapOfPartitionsTag = 0;
       for(auto it = model->firstFace(); it != model->lastFace(); ++it) {
         if((*it)->geomType() == GEntity::PartitionSurface) {
-          std::vector<int> partitions =
-            static_cast<partitionFace *>(*it)->getPartitions();
-          mapOfPartitions.insert(std::make_pair(mapOfPartitionsTag, partitions));
+          mapOfPartitions.push_back(
+            static_cast<partitionFace *>(*it)->getPartitions());
           // Must absolutely be in the same order as in the makeGraph function
           for(auto itElm = (*it)->triangles.begin();
               itElm != (*it)->triangles.end(); ++itElm)
@@ -1905,18 +2105,10 @@ static void createPartitionTopology(
       }
       subGraph.partition(part);
 
-      std::vector<std::set<MElement *, MElementPtrLessThan> >
-        subBoundaryElements = subGraph.getBoundaryElements(mapOfPartitionsTag);
-
-      for(idx_t i = 0; i < mapOfPartitionsTag; i++) {
-        for(auto it = subBoundaryElements[i].begin();
-            it != subBoundaryElements[i].end(); ++it) {
-          for(int j = 0; j < (*it)->getNumEdges(); j++) {
-            edgeToElement[(*it)->getEdge(j)].push_back(
-              std::make_pair(*it, mapOfPartitions[i]));
-          }
-        }
-      }
+      std::vector<std::vector<MElement *> > subBoundaryElements =
+        subGraph.getBoundaryElements(mapOfPartitionsTag);
+      fillBoundaryMap(edgeToElement, subBoundaryElements, mapOfPartitions,
+                      getElementEdges);
     }
 
     int numEdgeEntity = model->getMaxElementaryNumber(1);
@@ -1955,15 +2147,8 @@ static void createPartitionTopology(
   if(meshDim >= 1) {
     Msg::Info(" - Creating partition points");
     if(meshDim == 1) {
-      for(std::size_t i = 0; i < model->getNumPartitions(); i++) {
-        for(auto it = boundaryElements[i].begin();
-            it != boundaryElements[i].end(); ++it) {
-          for(std::size_t j = 0; j < (*it)->getNumPrimaryVertices(); j++) {
-            vertexToElement[(*it)->getVertex(j)].push_back(
-              std::make_pair(*it, std::vector<int>(1, i + 1)));
-          }
-        }
-      }
+      fillBoundaryMap(vertexToElement, boundaryElements, partitionOfBoundary,
+                      getElementPrimaryVertices);
     }
     else {
       Graph subGraph(model);
@@ -1972,13 +2157,12 @@ static void createPartitionTopology(
       std::vector<idx_t> part(subGraph.ne());
       int partIndex = 0;
 
-      std::map<idx_t, std::vector<int> > mapOfPartitions;
+      std::vector<std::vector<int> > mapOfPartitions;
       idx_t mapOfPartitionsTag = 0;
       for(auto it = model->firstEdge(); it != model->lastEdge(); ++it) {
         if((*it)->geomType() == GEntity::PartitionCurve) {
-          std::vector<int> partitions =
-            static_cast<partitionEdge *>(*it)->getPartitions();
-          mapOfPartitions.insert(std::make_pair(mapOfPartitionsTag, partitions));
+          mapOfPartitions.push_back(
+            static_cast<partitionEdge *>(*it)->getPartitions());
           // Must absolutely be in the same order as in the makeGraph function
           for(auto itElm = (*it)->lines.begin(); itElm != (*it)->lines.end();
               ++itElm)
@@ -1988,18 +2172,10 @@ static void createPartitionTopology(
       }
       subGraph.partition(part);
 
-      std::vector<std::set<MElement *, MElementPtrLessThan> >
-        subBoundaryElements = subGraph.getBoundaryElements(mapOfPartitionsTag);
-
-      for(idx_t i = 0; i < mapOfPartitionsTag; i++) {
-        for(auto it = subBoundaryElements[i].begin();
-            it != subBoundaryElements[i].end(); ++it) {
-          for(std::size_t j = 0; j < (*it)->getNumPrimaryVertices(); j++) {
-            vertexToElement[(*it)->getVertex(j)].push_back(
-              std::make_pair(*it, mapOfPartitions[i]));
-          }
-        }
-      }
+      std::vector<std::vector<MElement *> > subBoundaryElements =
+        subGraph.getBoundaryElements(mapOfPartitionsTag);
+      fillBoundaryMap(vertexToElement, subBoundaryElements, mapOfPartitions,
+                      getElementPrimaryVertices);
     }
     int numVertexEntity = model->getMaxElementaryNumber(0);
     for(auto it = vertexToElement.begin(); it != vertexToElement.end(); ++it) {
@@ -2269,16 +2445,31 @@ int PartitionMesh(GModel *model, int numPart)
   Msg::StatusBar(true, "Partitioning mesh...");
   double t1 = Cpu(), w1 = TimeOfDay();
 
+  // wall time spent in each phase, for the timing breakdown
+  std::vector<std::pair<std::string, double> > timings;
+  double w = w1;
+
+  std::vector<int> levels = getPartitionHierarchy(numPart);
+  if(levels.size() > 1) {
+    numPart = 1;
+    for(std::size_t i = 0; i < levels.size(); i++) numPart *= levels[i];
+  }
+
   Graph graph(model);
   if(makeGraph(model, graph, -1)) return 1;
   graph.nparts(numPart);
-  if(partitionGraph(graph, true)) return 1;
+  timings.push_back(std::make_pair("graph", TimeOfDay() - w));
+  w = TimeOfDay();
+  if(partitionGraph(graph, true, levels)) return 1;
+  timings.push_back(std::make_pair("METIS", TimeOfDay() - w));
+  w = TimeOfDay();
 
   std::vector<std::size_t> elmCount[TYPE_MAX_NUM + 1];
   for(int i = 0; i < TYPE_MAX_NUM + 1; i++) { elmCount[i].resize(numPart, 0); }
 
   // Assign partitions to elements
   hashmapelementpart elmToPartition;
+  elmToPartition.reserve(graph.ne());
   for(std::size_t i = 0; i < graph.ne(); i++) {
     if(graph.element(i)) {
       if(graph.nparts() > 1) {
@@ -2296,9 +2487,20 @@ int PartitionMesh(GModel *model, int numPart)
     }
   }
   model->setNumPartitions(graph.nparts());
+  if(levels.size() > 1) {
+    // store the hierarchy, so that it is saved in MSH files along with the
+    // partitions: partition p (p = 1, 2, ...) belongs to the (p - 1) / (n_2 *
+    // ... * n_L)-th part of the first level, etc.
+    std::ostringstream sstream;
+    for(std::size_t i = 0; i < levels.size(); i++)
+      sstream << (i ? " " : "") << levels[i];
+    model->getAttributes()["PartitionHierarchy"] =
+      std::vector<std::string>(1, sstream.str());
+  }
 
   createNewEntities(model, elmToPartition);
   elmToPartition.clear();
+  timings.push_back(std::make_pair("entities", TimeOfDay() - w));
 
   double t2 = Cpu(), w2 = TimeOfDay();
   Msg::StatusBar(true, "Done partitioning mesh (Wall %gs, CPU %gs)", w2 - w1,
@@ -2323,17 +2525,22 @@ int PartitionMesh(GModel *model, int numPart)
 
   if(CTX::instance()->mesh.partitionCreateTopology) {
     Msg::StatusBar(true, "Creating partition topology...");
-    std::vector<std::set<MElement *, MElementPtrLessThan> > boundaryElements =
+    std::vector<std::vector<MElement *> > boundaryElements =
       graph.getBoundaryElements();
     createPartitionTopology(model, boundaryElements, graph);
     boundaryElements.clear();
     double t3 = Cpu(), w3 = TimeOfDay();
     Msg::StatusBar(true, "Done creating partition topology (Wall %gs, CPU %gs)",
                    w3 - w2, t3 - t2);
+    timings.push_back(std::make_pair("topology", w3 - w2));
   }
 
+  w = TimeOfDay();
   assignPhysicals(model);
+  timings.push_back(std::make_pair("physicals", TimeOfDay() - w));
+  w = TimeOfDay();
   assignMeshVertices(model);
+  timings.push_back(std::make_pair("nodes", TimeOfDay() - w));
 
   if(CTX::instance()->mesh.partitionCreateGhostCells) {
     double t4 = Cpu(), w4 = TimeOfDay();
@@ -2344,8 +2551,15 @@ int PartitionMesh(GModel *model, int numPart)
     double t5 = Cpu(), w5 = TimeOfDay();
     Msg::StatusBar(true, "Done creating ghost cells (Wall %gs, CPU %gs)",
                    w5 - w4, t5 - t4);
+    timings.push_back(std::make_pair("ghost cells", w5 - w4));
   }
 
+  std::ostringstream sstream;
+  for(std::size_t i = 0; i < timings.size(); i++)
+    sstream << (i ? ", " : "") << timings[i].first << " " << timings[i].second
+            << "s";
+  Msg::Info(" - Wall time per phase: %s", sstream.str().c_str());
+
   return 0;
 }
 
@@ -2509,6 +2723,7 @@ int UnpartitionMesh(GModel *model)
   }
 
   model->setNumPartitions(0);
+  model->getAttributes().erase("PartitionHierarchy");
 
   std::map<std::pair<int, int>, std::string> physicalNames =
     model->getPhysicalNames();
@@ -2582,7 +2797,7 @@ int PartitionUsingThisSplit(GModel *model,
 
   if(CTX::instance()->mesh.partitionCreateTopology) {
     Msg::StatusBar(true, "Creating partition topology...");
-    std::vector<std::set<MElement *, MElementPtrLessThan> > boundaryElements =
+    std::vector<std::vector<MElement *> > boundaryElements =
       graph.getBoundaryElements();
     createPartitionTopology(model, boundaryElements, graph);
     boundaryElements.clear();
@@ -4,6 +4,8 @@
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <limits>
+#include <map>
+#include <set>
 #include "qualityMeasuresJacobian.h"
 #include "FuncSpaceData.h"
 #include "MElement.h"
@@ -12,6 +14,7 @@
 #include "JacobianBasis.h"
 #include "Numeric.h"
 #include "fullMatrix.h"
+#include "Context.h"
 
 // For regression tests:
 #include "GModel.h"
@@ -237,6 +240,22 @@ static bool _getQualityFunctionSpace(MElement *el, FuncSpaceData &fsGrad,
   return true;
 }
 
+// Check if the bounds of the Jacobian determinant given by the Bezier
+// coefficients (minB, maxB) are sharp enough with respect to its values at the
+// corners (minL, maxL)
+static bool _jacobianBoundsOk(double minL, double maxL, double minB,
+                              double maxB)
+{
+  double tol = std::max(std::abs(minL), std::abs(maxL)) * 1e-3;
+  return (minL <= 0 || minB > 0) && (maxL >= 0 || maxB < 0) &&
+         minL - minB < tol && maxB - maxL < tol;
+  // NB: First condition implies minL and minB both positive or both negative
+}
+
+// Number of elements whose Jacobian determinant is computed at once by the
+// batched functions
+static const int _jacobianBlockSize = 256;
+
 namespace jacobianBasedQuality {
 
   void minMaxJacobianDeterminant(MElement *el, double &min, double &max,
@@ -369,6 +388,151 @@ namespace jacobianBasedQuality {
     return _getMinAndDeleteDomains(domains);
   }
 
+  void minMaxJacobianDeterminant(const std::vector<MElement *> &elements,
+                                 std::vector<double> &min,
+                                 std::vector<double> &max,
+                                 const fullMatrix<double> *normals)
+  {
+    min.resize(elements.size());
+    max.resize(elements.size());
+
+    // Group elements by type
+    std::map<int, std::vector<std::size_t> > groups;
+    for(std::size_t i = 0; i < elements.size(); ++i)
+      groups[elements[i]->getTypeForMSH()].push_back(i);
+
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+    for(auto it = groups.begin(); it != groups.end(); ++it) {
+      const std::vector<std::size_t> &group = it->second;
+      MElement *el0 = elements[group[0]];
+      const JacobianBasis *jfs = el0->getJacobianFuncSpace();
+      if(!jfs) {
+        Msg::Warning("Jacobian function space not implemented for %s",
+                     el0->getName().c_str());
+        for(std::size_t i = 0; i < group.size(); ++i) {
+          min[group[i]] = 99;
+          max[group[i]] = -99;
+        }
+        continue;
+      }
+      const FuncSpaceData fsData = jfs->getFuncSpaceData();
+      const int numNodes = el0->getNumVertices();
+      const int numBlocks =
+        (group.size() + _jacobianBlockSize - 1) / _jacobianBlockSize;
+
+#pragma omp parallel num_threads(nthreads)
+      {
+#pragma omp for schedule(dynamic)
+        for(int iB = 0; iB < numBlocks; ++iB) {
+          const std::size_t first = (std::size_t)iB * _jacobianBlockSize;
+          const int numEl =
+            std::min((std::size_t)_jacobianBlockSize, group.size() - first);
+
+          // Sample the Jacobian determinant of all the elements of the block
+          fullMatrix<double> nodesX(numNodes, numEl);
+          fullMatrix<double> nodesY(numNodes, numEl);
+          fullMatrix<double> nodesZ(numNodes, numEl);
+          for(int iEl = 0; iEl < numEl; ++iEl) {
+            MElement *el = elements[group[first + iEl]];
+            for(int i = 0; i < numNodes; ++i) {
+              const MVertex *v = el->getShapeFunctionNode(i);
+              nodesX(i, iEl) = v->x();
+              nodesY(i, iEl) = v->y();
+              nodesZ(i, iEl) = v->z();
+            }
+          }
+          fullMatrix<double> coeffLag(jfs->getNumSamplingPnts(), numEl);
+          jfs->getSignedJacobian(nodesX, nodesY, nodesZ, coeffLag, normals);
+
+          // Convert into Bezier coeff (one column per element)
+          bezierCoeff bez(fsData, coeffLag);
+
+          // Keep the initial bounds if they are sharp enough, otherwise refine
+          for(int iEl = 0; iEl < numEl; ++iEl) {
+            const std::size_t idx = group[first + iEl];
+            double minL = bez.getCornerCoeff(0, iEl), maxL = minL;
+            for(int i = 1; i < bez.getNumCornerCoeff(); i++) {
+              minL = std::min(minL, bez.getCornerCoeff(i, iEl));
+              maxL = std::max(maxL, bez.getCornerCoeff(i, iEl));
+            }
+            double minB = bez(0, iEl), maxB = minB;
+            for(int i = 1; i < bez.getNumCoeff(); i++) {
+              minB = std::min(minB, bez(i, iEl));
+              maxB = std::max(maxB, bez(i, iEl));
+            }
+            if(_jacobianBoundsOk(minL, maxL, minB, maxB)) {
+              min[idx] = minB;
+              max[idx] = maxB;
+            }
+            else
+              minMaxJacobianDeterminant(elements[idx], min[idx], max[idx],
+                                        normals);
+          }
+        }
+        bezierCoeff::releasePools();
+      }
+    }
+  }
+
+  static void _minMeasure(const std::vector<MElement *> &elements,
+                          std::vector<double> &measure, bool knownValid,
+                          bool reversedOk, const fullMatrix<double> *normals,
+                          bool icn)
+  {
+    measure.assign(elements.size(), 0.);
+
+    // Computation of the measure should never be performed to invalid elements
+    // (for which the measure is 0)
+    std::vector<double> jmin, jmax;
+    if(!knownValid) minMaxJacobianDeterminant(elements, jmin, jmax, normals);
+
+    // Create the Bezier raisers (which are built on demand) before computing
+    // the measures concurrently
+    std::set<int> types;
+    for(std::size_t i = 0; i < elements.size(); ++i) {
+      if(!types.insert(elements[i]->getTypeForMSH()).second) continue;
+      FuncSpaceData jacMatSpace, jacDetSpace;
+      if(_getQualityFunctionSpace(elements[i], jacMatSpace, jacDetSpace)) {
+        BasisFactory::getBezierBasis(jacMatSpace)->getRaiser();
+        BasisFactory::getBezierBasis(jacDetSpace)->getRaiser();
+      }
+    }
+
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+#pragma omp parallel num_threads(nthreads)
+    {
+#pragma omp for schedule(dynamic, 64)
+      for(std::size_t i = 0; i < elements.size(); ++i) {
+        if(!knownValid && ((jmin[i] <= 0 && jmax[i] >= 0) ||
+                           (jmax[i] < 0 && !reversedOk)))
+          continue;
+        if(icn)
+          measure[i] = minICNMeasure(elements[i], true, reversedOk, normals);
+        else
+          measure[i] = minIGEMeasure(elements[i], true, reversedOk, normals);
+      }
+      bezierCoeff::releasePools();
+    }
+  }
+
+  void minIGEMeasure(const std::vector<MElement *> &elements,
+                     std::vector<double> &ige, bool knownValid,
+                     bool reversedOk, const fullMatrix<double> *normals)
+  {
+    _minMeasure(elements, ige, knownValid, reversedOk, normals, false);
+  }
+
+  void minICNMeasure(const std::vector<MElement *> &elements,
+                     std::vector<double> &icn, bool knownValid,
+                     bool reversedOk, const fullMatrix<double> *normals)
+  {
+    _minMeasure(elements, icn, knownValid, reversedOk, normals, true);
+  }
+
   void sampleJacobianDeterminant(MElement *el, int deg, double &min,
                                  double &max, const fullMatrix<double> *normals)
   {
@@ -509,10 +673,7 @@ namespace jacobianBasedQuality {
 
   bool _coeffDataJac::boundsOk(double minL, double maxL) const
   {
-    double tol = std::max(std::abs(minL), std::abs(maxL)) * 1e-3;
-    return (minL <= 0 || _minB > 0) && (maxL >= 0 || _maxB < 0) &&
-           minL - _minB < tol && _maxB - maxL < tol;
-    // NB: First condition implies minL and minB both positive or both negative
+    return _jacobianBoundsOk(minL, maxL, _minB, _maxB);
   }
 
   void _coeffDataJac::getSubCoeff(std::vector<_coeffData *> &v) const
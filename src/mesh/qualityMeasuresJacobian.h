@@ -27,6 +27,25 @@ namespace jacobianBasedQuality {
                        bool reversedOk = false,
                        const fullMatrix<double> *normals = nullptr,
                        bool debug = false);
+
+  // Batched versions of the above functions, for large sets of elements: the
+  // elements are grouped by type, the Bezier coefficients of the Jacobian
+  // determinant are computed for blocks of elements at once with dense matrix
+  // products, and the blocks are processed concurrently. Only the elements
+  // whose initial bounds are not sharp enough are refined one by one.
+  void minMaxJacobianDeterminant(const std::vector<MElement *> &elements,
+                                 std::vector<double> &min,
+                                 std::vector<double> &max,
+                                 const fullMatrix<double> *normals = nullptr);
+  void minIGEMeasure(const std::vector<MElement *> &elements,
+                     std::vector<double> &ige, bool knownValid = false,
+                     bool reversedOk = false,
+                     const fullMatrix<double> *normals = nullptr);
+  void minICNMeasure(const std::vector<MElement *> &elements,
+                     std::vector<double> &icn, bool knownValid = false,
+                     bool reversedOk = false,
+                     const fullMatrix<double> *normals = nullptr);
+
   void sampleJacobianDeterminant(MElement *el, int order, double &min,
                                  double &max,
                                  const fullMatrix<double> *normals = nullptr);
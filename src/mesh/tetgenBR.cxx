@@ -677,6 +677,10 @@ void tetgenmesh::inittables()
   int soffset, toffset;
   int i, j;
 
+  // The tables are shared by all meshes. Only fill them once, so that the
+  //   meshes created concurrently by recoverclusters() never write to them.
+  static int initialized = 0;
+  if (initialized) return;
 
   // i = t1.ver; j = t2.ver;
   for (i = 0; i < 12; i++) {
@@ -749,6 +753,8 @@ void tetgenmesh::inittables()
       stpivottbl[i][j] = (i & 3) + (((i & 12) + toffset) % 12);
     }
   }
+
+  initialized = 1;
 }
 
 
@@ -14931,6 +14937,29 @@ int tetgenmesh::suppresssteinerpoints()
 //                                                                           //
 ///////////////////////////////////////////////////////////////////////////////
 
+// walltime()    Return the wall clock time in seconds (the passes may run
+//   concurrently in several threads, which share the CPU time).
+
+static REAL walltime()
+{
+  return std::chrono::duration<REAL>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void tetgenmesh::addrecoverypass(const char *name, long recovered,
+                                 long steiner, REAL &tstart)
+{
+  REAL tend = walltime();
+  if (brpasscount < 8) {
+    brpassname[brpasscount] = name;
+    brpassrecovered[brpasscount] = recovered;
+    brpasssteiner[brpasscount] = steiner;
+    brpasstime[brpasscount] = tend - tstart;
+    brpasscount++;
+  }
+  tstart = tend;
+}
+
 void tetgenmesh::recoverboundary(clock_t& tv)
 {
   arraypool *misseglist, *misshlist;
@@ -14944,6 +14973,8 @@ void tetgenmesh::recoverboundary(clock_t& tv)
 
   // Counters.
   long bak_segref_count, bak_facref_count, bak_volref_count;
+  long bak_missing, bak_steiner;
+  REAL tpass = walltime();
 
   if (!b->quiet) {
     printf("Recovering boundaries...\n");
@@ -15018,9 +15049,12 @@ void tetgenmesh::recoverboundary(clock_t& tv)
     printf("  %ld (%ld) segments are recovered (missing).\n",
            subsegs->items - misseglist->objects, misseglist->objects);
   }
+  addrecoverypass("segments by flips", subsegs->items - misseglist->objects,
+                  0l, tpass);
 
   if (misseglist->objects > 0) {
     // Second, trying to recover segments by doing more flips (fullsearch).
+    bak_missing = misseglist->objects;
     while (misseglist->objects > 0) {
       ms = misseglist->objects;
       for (i = 0; i < misseglist->objects; i++) {
@@ -15042,11 +15076,15 @@ void tetgenmesh::recoverboundary(clock_t& tv)
       printf("  %ld (%ld) segments are recovered (missing).\n",
              subsegs->items - misseglist->objects, misseglist->objects);
     }
+    addrecoverypass("segments by full search flips",
+                    bak_missing - misseglist->objects, 0l, tpass);
   }
 
   if (misseglist->objects > 0) {
     // Third, trying to recover segments by doing more flips (fullsearch)
     //   and adding Steiner points in the volume.
+    bak_missing = misseglist->objects;
+    bak_steiner = st_volref_count;
     while (misseglist->objects > 0) {
       ms = misseglist->objects;
       for (i = 0; i < misseglist->objects; i++) {
@@ -15067,12 +15105,17 @@ void tetgenmesh::recoverboundary(clock_t& tv)
     if (b->verbose) {
       printf("  Added %ld Steiner points in volume.\n", st_volref_count);
     }
+    addrecoverypass("segments with Steiner points in volume",
+                    bak_missing - misseglist->objects,
+                    st_volref_count - bak_steiner, tpass);
   }
 
   if (misseglist->objects > 0) {
     // Last, trying to recover segments by doing more flips (fullsearch),
     //   and adding Steiner points in the volume, and splitting segments.
     long bak_inpoly_count = st_volref_count; //st_inpoly_count;
+    bak_missing = misseglist->objects;
+    bak_steiner = st_segref_count + st_volref_count;
     for (i = 0; i < misseglist->objects; i++) {
       subsegstack->newindex((void **) &paryseg);
       *paryseg = * (face *) fastlookup(misseglist, i);
@@ -15088,6 +15131,9 @@ void tetgenmesh::recoverboundary(clock_t& tv)
                st_volref_count - bak_inpoly_count);
       }
     }
+    addrecoverypass("segments with Steiner points on segments",
+                    bak_missing - misseglist->objects,
+                    st_segref_count + st_volref_count - bak_steiner, tpass);
   }
 
 
@@ -15095,6 +15141,7 @@ void tetgenmesh::recoverboundary(clock_t& tv)
     // Try to remove the Steiner points added in segments.
     bak_segref_count = st_segref_count;
     bak_volref_count = st_volref_count;
+    bak_steiner = bdrysteinerptlist->objects;
     for (i = 0; i < subvertstack->objects; i++) {
       // Get the Steiner point.
       parypt = (point *) fastlookup(subvertstack, i);
@@ -15119,6 +15166,9 @@ void tetgenmesh::recoverboundary(clock_t& tv)
         }
       }
     }
+    addrecoverypass("removal of Steiner points on segments", 0l,
+                    -(subvertstack->objects -
+                      (bdrysteinerptlist->objects - bak_steiner)), tpass);
     subvertstack->restart();
   }
 
@@ -15191,9 +15241,13 @@ void tetgenmesh::recoverboundary(clock_t& tv)
     printf("  %ld (%ld) subfaces are recovered (missing).\n",
            subfaces->items - misshlist->objects, misshlist->objects);
   }
+  addrecoverypass("subfaces by flips", subfaces->items - misshlist->objects,
+                  0l, tpass);
 
   if (misshlist->objects > 0) {
     // There are missing subfaces. Add Steiner points.
+    bak_missing = misshlist->objects;
+    bak_steiner = st_facref_count;
     for (i = 0; i < misshlist->objects; i++) {
       subfacstack->newindex((void **) &parysh);
       *parysh = * (face *) fastlookup(misshlist, i);
@@ -15205,12 +15259,15 @@ void tetgenmesh::recoverboundary(clock_t& tv)
     if (b->verbose) {
       printf("  Added %ld Steiner points in facets.\n", st_facref_count);
     }
+    addrecoverypass("subfaces with Steiner points", bak_missing,
+                    st_facref_count - bak_steiner, tpass);
   }
 
 
   if (st_facref_count > 0) {
     // Try to remove the Steiner points added in facets.
     bak_facref_count = st_facref_count;
+    bak_steiner = bdrysteinerptlist->objects;
     for (i = 0; i < subvertstack->objects; i++) {
       // Get the Steiner point.
       parypt = (point *) fastlookup(subvertstack, i);
@@ -15227,6 +15284,9 @@ void tetgenmesh::recoverboundary(clock_t& tv)
                bak_facref_count - st_facref_count);
       }
     }
+    addrecoverypass("removal of Steiner points in facets", 0l,
+                    -(subvertstack->objects -
+                      (bdrysteinerptlist->objects - bak_steiner)), tpass);
     subvertstack->restart();
   }
 
@@ -831,6 +831,14 @@ public:
   long flip31count, flip22count;
   unsigned long totalworkmemory; // Total memory used by working arrays.
 
+  // Statistics of the passes of the boundary recovery: number of recovered
+  //   segments or subfaces, number of added (or removed, if negative) Steiner
+  //   points and wall clock time of each pass.
+  int brpasscount;
+  const char *brpassname[8];
+  long brpassrecovered[8], brpasssteiner[8];
+  REAL brpasstime[8];
+
   ///////////////////////////////////////////////////////////////////////////////
   //                                                                           //
   // Mesh manipulation primitives //
@@ -1312,6 +1320,8 @@ public:
   int suppresssteinerpoints();
 
   void recoverboundary(clock_t &);
+  void addrecoverypass(const char *name, long recovered, long steiner,
+                       REAL &tstart);
 
   ///////////////////////////////////////////////////////////////////////////////
   //                                                                           //
@@ -1321,9 +1331,13 @@ public:
 
   void carveholes();
 
-  // Comment: These three functions are implemented directly in:
+  // Comment: These functions are implemented directly in:
   // src/mesh/meshGRegionBoundaryRecovery.cpp
+  int initialmesh(void *);
   int reconstructmesh(void *, double tol);
+  void getpointstar(point, std::vector<tetrahedron *> &);
+  void recovercluster(void *);
+  long recoverclusters();
   void outsurfacemesh(const char *mfilename);
   void outmesh2medit(const char *mfilename);
 
@@ -1423,6 +1437,7 @@ public:
     flip23count = flip32count = flip44count = flip41count = 0l;
     flip22count = flip31count = 0l;
     totalworkmemory = 0l;
+    brpasscount = 0;
 
   } // tetgenmesh()
 
@@ -1526,15 +1541,12 @@ public:
   int s_marker2; // Tag of the 2nd segment.
   int f_vertices2[3];
   REAL int_point[3];
-  selfint_event()
-  {
-    e_type = 0;
-    f_marker1 = f_marker2 = 0;
-    s_marker1 = s_marker2 = 0;
-  }
 };
 
+// one (zero-initialized) copy per thread, as boundaries are recovered
+// concurrently in independent volumes
 static selfint_event sevent;
+#pragma omp threadprivate(sevent)
 
 inline void terminatetetgen(tetgenmesh *m, int x)
 {
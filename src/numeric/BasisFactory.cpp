@@ -11,20 +11,109 @@
 #include "miniBasis.h"
 #include "CondNumBasis.h"
 #include "JacobianBasis.h"
-#include <map>
+#include <atomic>
 #include <cstddef>
 
-std::map<int, nodalBasis *> BasisFactory::fs;
-std::map<int, CondNumBasis *> BasisFactory::cs;
-std::map<FuncSpaceData, JacobianBasis *> BasisFactory::js;
-std::map<FuncSpaceData, bezierBasis *> BasisFactory::bs;
-std::map<FuncSpaceData, GradientBasis *> BasisFactory::gs;
+namespace {
+  // one bucket per element type, so that nodal bases are directly indexed by
+  // their tag
+  const std::size_t basisCacheSize = MSH_MAX_NUM + 1;
+
+  inline std::size_t basisCacheHash(int tag) { return (std::size_t)tag; }
+
+  inline std::size_t basisCacheHash(const FuncSpaceData &data)
+  {
+    std::size_t h = (std::size_t)data.getType();
+    h = 31 * h + (std::size_t)data.getSpaceOrder();
+    h = 31 * h + (std::size_t)data.getNij();
+    h = 31 * h + (std::size_t)data.getNk();
+    h = 31 * h + (std::size_t)data.getPyramidalSpace();
+    return h;
+  }
+} // namespace
+
+// Fixed-size hash table whose buckets are insert-only singly linked lists with
+// an atomic head. A node is fully constructed before being published with a
+// release compare-and-swap, and is never modified afterwards: lookups thus
+// only need an acquire load of the bucket head. If two threads build the same
+// basis concurrently, the first one published is kept and the other one is
+// deleted.
+template <class Key, class T> class BasisCache {
+private:
+  struct node {
+    Key key;
+    T *value;
+    node *next;
+  };
+  std::atomic<node *> _buckets[basisCacheSize];
+  std::atomic<node *> &_bucket(const Key &key)
+  {
+    return _buckets[basisCacheHash(key) % basisCacheSize];
+  }
+  static node *_find(node *n, const Key &key)
+  {
+    for(; n; n = n->next) {
+      if(n->key == key) return n;
+    }
+    return nullptr;
+  }
+
+public:
+  BasisCache()
+  {
+    for(std::size_t i = 0; i < basisCacheSize; i++)
+      _buckets[i].store(nullptr, std::memory_order_relaxed);
+  }
+  T *find(const Key &key)
+  {
+    node *n = _find(_bucket(key).load(std::memory_order_acquire), key);
+    return n ? n->value : nullptr;
+  }
+  // insert 'value' for 'key' and return it, or return the value inserted
+  // concurrently by another thread (in which case 'value' is deleted)
+  T *insert(const Key &key, T *value)
+  {
+    std::atomic<node *> &bucket = _bucket(key);
+    node *head = bucket.load(std::memory_order_acquire);
+    node *n = new node{key, value, head};
+    while(true) {
+      node *found = _find(head, key);
+      if(found) {
+        delete n->value;
+        delete n;
+        return found->value;
+      }
+      n->next = head;
+      if(bucket.compare_exchange_weak(head, n, std::memory_order_release,
+                                      std::memory_order_acquire))
+        return value;
+    }
+  }
+  void clear()
+  {
+    for(std::size_t i = 0; i < basisCacheSize; i++) {
+      node *n = _buckets[i].exchange(nullptr);
+      while(n) {
+        node *next = n->next;
+        delete n->value;
+        delete n;
+        n = next;
+      }
+    }
+  }
+};
+
+BasisCache<int, nodalBasis> BasisFactory::fs;
+BasisCache<int, CondNumBasis> BasisFactory::cs;
+BasisCache<FuncSpaceData, JacobianBasis> BasisFactory::js;
+BasisCache<FuncSpaceData, bezierBasis> BasisFactory::bs;
+BasisCache<FuncSpaceData, GradientBasis> BasisFactory::gs;
 
 const nodalBasis *BasisFactory::getNodalBasis(int tag)
 {
   // If the Basis has already been built, return it.
-  auto it = fs.find(tag);
-  if(it != fs.end()) { return it->second; }
+  nodalBasis *cached = fs.find(tag);
+  if(cached) return cached;
   // Get the parent type to see which kind of basis
   // we want to create
   nodalBasis *F = nullptr;
@@ -49,26 +138,17 @@ const nodalBasis *BasisFactory::getNodalBasis(int tag)
     }
   }
 
-  std::pair<std::map<int, nodalBasis *>::const_iterator, bool> inserted;
-#pragma omp critical(getNodalBasis)
-  {
-    inserted = fs.insert(std::make_pair(tag, F));
-    if(!inserted.second) delete F;
-  }
-
-  return inserted.first->second;
+  return fs.insert(tag, F);
 }
 
 const JacobianBasis *BasisFactory::getJacobianBasis(int tag, FuncSpaceData fsd)
 {
   FuncSpaceData data = fsd.getForNonSerendipitySpace();
 
-  auto it = js.find(data);
-  if(it != js.end()) return it->second;
+  JacobianBasis *J = js.find(data);
+  if(J) return J;
 
-  JacobianBasis *J = new JacobianBasis(tag, data);
-  js.insert(std::make_pair(data, J));
-  return J;
+  return js.insert(data, new JacobianBasis(tag, data));
 }
 
 const JacobianBasis *BasisFactory::getJacobianBasis(int tag, int order)
@@ -94,24 +174,20 @@ const JacobianBasis *BasisFactory::getJacobianBasis(int tag)
 
 const CondNumBasis *BasisFactory::getCondNumBasis(int tag, int cnOrder)
 {
-  auto it = cs.find(tag);
-  if(it != cs.end()) return it->second;
+  CondNumBasis *M = cs.find(tag);
+  if(M) return M;
 
-  CondNumBasis *M = new CondNumBasis(tag, cnOrder);
-  cs.insert(std::make_pair(tag, M));
-  return M;
+  return cs.insert(tag, new CondNumBasis(tag, cnOrder));
 }
 
 const GradientBasis *BasisFactory::getGradientBasis(int tag, FuncSpaceData fsd)
 {
   FuncSpaceData data = fsd.getForNonSerendipitySpace();
 
-  auto it = gs.find(data);
-  if(it != gs.end()) return it->second;
+  GradientBasis *G = gs.find(data);
+  if(G) return G;
 
-  GradientBasis *G = new GradientBasis(tag, data);
-  gs.insert(std::make_pair(data, G));
-  return G;
+  return gs.insert(data, new GradientBasis(tag, data));
 }
 
 const GradientBasis *BasisFactory::getGradientBasis(int tag, int order)
@@ -129,12 +205,10 @@ const bezierBasis *BasisFactory::getBezierBasis(FuncSpaceData fsd)
 {
   FuncSpaceData data = fsd.getForNonSerendipitySpace();
 
-  auto it = bs.find(data);
-  if(it != bs.end()) return it->second;
+  bezierBasis *B = bs.find(data);
+  if(B) return B;
 
-  bezierBasis *B = new bezierBasis(data);
-  bs.insert(std::make_pair(data, B));
-  return B;
+  return bs.insert(data, new bezierBasis(data));
 }
 
 const bezierBasis *BasisFactory::getBezierBasis(int parentType, int order)
@@ -149,38 +223,9 @@ const bezierBasis *BasisFactory::getBezierBasis(int tag)
 
 void BasisFactory::clearAll()
 {
-  auto itF = fs.begin();
-  while(itF != fs.end()) {
-    delete itF->second;
-    itF++;
-  }
   fs.clear();
-
-  auto itJ = js.begin();
-  while(itJ != js.end()) {
-    delete itJ->second;
-    itJ++;
-  }
   js.clear();
-
-  auto itC = cs.begin();
-  while(itC != cs.end()) {
-    delete itC->second;
-    itC++;
-  }
   cs.clear();
-
-  auto itG = gs.begin();
-  while(itG != gs.end()) {
-    delete itG->second;
-    itG++;
-  }
   gs.clear();
-
-  auto itB = bs.begin();
-  while(itB != bs.end()) {
-    delete itB->second;
-    itB++;
-  }
   bs.clear();
 }
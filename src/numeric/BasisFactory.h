@@ -6,21 +6,24 @@
 #ifndef BASISFACTORY_H
 #define BASISFACTORY_H
 
-#include <map>
 class nodalBasis;
 class GradientBasis;
 class bezierBasis;
 class CondNumBasis;
 class JacobianBasis;
 class FuncSpaceData;
+template <class Key, class T> class BasisCache;
 
 class BasisFactory {
 private:
-  static std::map<int, nodalBasis *> fs;
-  static std::map<int, CondNumBasis *> cs;
-  static std::map<FuncSpaceData, JacobianBasis *> js;
-  static std::map<FuncSpaceData, bezierBasis *> bs;
-  static std::map<FuncSpaceData, GradientBasis *> gs;
+  // The caches are insert-only and lock-free for lookups: once a basis has
+  // been constructed, it can be retrieved concurrently by any number of
+  // threads without synchronization. clearAll() is not thread-safe.
+  static BasisCache<int, nodalBasis> fs;
+  static BasisCache<int, CondNumBasis> cs;
+  static BasisCache<FuncSpaceData, JacobianBasis> js;
+  static BasisCache<FuncSpaceData, bezierBasis> bs;
+  static BasisCache<FuncSpaceData, GradientBasis> gs;
 
 public:
   // Caution: the returned pointer can be NULL
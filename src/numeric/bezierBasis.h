@@ -133,13 +133,12 @@ private:
   double *_data; // pointer on the first element
   bool _ownData; // to know if data should be freed when object is deleted
 
-  static bezierCoeffMemoryPool *_pool0;
-  static bezierCoeffMemoryPool *_pool1;
-  static fullMatrix<double> _sub;
-  // FIXME: not thread safe. We shoud use one pool and one _sub per thread.
-  //        The best would be to give the pool to the constructor.
-  //        (the pools should be created and deleted e.g. by the plugin
-  //        AnalyseMeshQuality)
+  // The pools and the subdivision workspace are thread local, so that
+  // different threads can compute Bezier coefficients concurrently; usePools()
+  // and releasePools() only affect the calling thread.
+  static thread_local bezierCoeffMemoryPool *_pool0;
+  static thread_local bezierCoeffMemoryPool *_pool1;
+  static thread_local fullMatrix<double> _sub;
 
 public:
   bezierCoeff(){};
@@ -246,6 +246,13 @@ PView *GMSH_AnalyseMeshQualityPlugin::execute(PView *v)
   return view;
 }
 
+// number of elements passed at once to the batched quality functions, so that
+// the progress can still be reported regularly
+static std::size_t progressSlice(std::size_t num)
+{
+  return std::max((std::size_t)4096, num / 100);
+}
+
 void GMSH_AnalyseMeshQualityPlugin::_computeMinMaxJandValidity(int dim)
 {
   if(_computedJac[dim - 1]) return;
@@ -300,17 +307,26 @@ void GMSH_AnalyseMeshQualityPlugin::_computeMinMaxJandValidity(int dim)
     MsgProgressStatus progress(num);
 
     _data.reserve(_data.size() + num);
-    for(unsigned i = 0; i < num; ++i) {
-      MElement *el = entity->getMeshElement(i);
-      double min, max;
-      jacobianBasedQuality::minMaxJacobianDeterminant(el, min, max, normals);
-      _data.push_back(data_elementMinMax(el, min, max));
-      if(min < 0 && max < 0) ++cntInverted;
-      progress.next();
+    const std::size_t slice = progressSlice(num);
+    std::vector<MElement *> elements;
+    std::vector<double> min, max;
+    for(std::size_t begin = 0; begin < num; begin += slice) {
+      std::size_t end = std::min((std::size_t)num, begin + slice);
+      elements.clear();
+      for(std::size_t i = begin; i < end; ++i)
+        elements.push_back(entity->getMeshElement(i));
+      jacobianBasedQuality::minMaxJacobianDeterminant(elements, min, max,
+                                                      normals);
+      for(std::size_t i = 0; i < elements.size(); ++i) {
+        MElement *el = elements[i];
+        _data.push_back(data_elementMinMax(el, min[i], max[i]));
+        if(min[i] < 0 && max[i] < 0) ++cntInverted;
+        progress.next();
 
 #if defined(HAVE_VISUDEV)
-      _computePointwiseQuantities(el, normals);
+        _computePointwiseQuantities(el, normals);
 #endif
+      }
     }
     if(normals) delete normals;
   }
@@ -326,16 +342,31 @@ void GMSH_AnalyseMeshQualityPlugin::_computeMinIGE(int dim)
 {
   if(_computedIGE[dim - 1]) return;
 
-  MsgProgressStatus progress(_data.size());
-
+  std::vector<std::size_t> indices;
+  std::vector<MElement *> elements;
   for(std::size_t i = 0; i < _data.size(); ++i) {
     MElement *const el = _data[i].element();
     if(el->getDim() != dim) continue;
     if(_data[i].minJ() <= 0 && _data[i].maxJ() >= 0) { _data[i].setMinS(0); }
     else {
-      _data[i].setMinS(jacobianBasedQuality::minIGEMeasure(el, true));
+      indices.push_back(i);
+      elements.push_back(el);
+    }
+  }
+
+  MsgProgressStatus progress(elements.size());
+
+  const std::size_t slice = progressSlice(elements.size());
+  std::vector<MElement *> part;
+  std::vector<double> values;
+  for(std::size_t begin = 0; begin < elements.size(); begin += slice) {
+    std::size_t end = std::min(elements.size(), begin + slice);
+    part.assign(elements.begin() + begin, elements.begin() + end);
+    jacobianBasedQuality::minIGEMeasure(part, values, true);
+    for(std::size_t i = begin; i < end; ++i) {
+      _data[indices[i]].setMinS(values[i - begin]);
+      progress.next();
     }
-    progress.next();
   }
 
   _computedIGE[dim - 1] = true;
@@ -345,16 +376,31 @@ void GMSH_AnalyseMeshQualityPlugin::_computeMinICN(int dim)
 {
   if(_computedICN[dim - 1]) return;
 
-  MsgProgressStatus progress(_data.size());
-
+  std::vector<std::size_t> indices;
+  std::vector<MElement *> elements;
   for(std::size_t i = 0; i < _data.size(); ++i) {
     MElement *const el = _data[i].element();
     if(el->getDim() != dim) continue;
     if(_data[i].minJ() <= 0 && _data[i].maxJ() >= 0) { _data[i].setMinI(0); }
     else {
-      _data[i].setMinI(jacobianBasedQuality::minICNMeasure(el, true));
+      indices.push_back(i);
+      elements.push_back(el);
+    }
+  }
+
+  MsgProgressStatus progress(elements.size());
+
+  const std::size_t slice = progressSlice(elements.size());
+  std::vector<MElement *> part;
+  std::vector<double> values;
+  for(std::size_t begin = 0; begin < elements.size(); begin += slice) {
+    std::size_t end = std::min(elements.size(), begin + slice);
+    part.assign(elements.begin() + begin, elements.begin() + end);
+    jacobianBasedQuality::minICNMeasure(part, values, true);
+    for(std::size_t i = begin; i < end; ++i) {
+      _data[indices[i]].setMinI(values[i - begin]);
+      progress.next();
     }
-    progress.next();
   }
 
   _computedICN[dim - 1] = true;
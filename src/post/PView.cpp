@@ -33,6 +33,7 @@ void PView::_init(int tag)
   _aliasOf = -1;
   _eye = SPoint3(0., 0., 0.);
   va_points = va_lines = va_triangles = va_vectors = va_ellipses = nullptr;
+  for(int i = 0; i < 5; i++) va_kept[i] = nullptr;
   normals = nullptr;
 
   for(std::size_t i = 0; i < list.size(); i++) {
@@ -179,6 +180,7 @@ void PView::addStep(GModel *model,
 PView::~PView()
 {
   deleteVertexArrays();
+  deleteKeptVertexArrays();
   if(normals) delete normals;
   if(_options) delete _options;
 
@@ -221,6 +223,26 @@ void PView::deleteVertexArrays()
   va_ellipses = nullptr;
 }
 
+void PView::keepVertexArrays()
+{
+  VertexArray **va[5] = {&va_points, &va_lines, &va_triangles, &va_vectors,
+                         &va_ellipses};
+  for(int i = 0; i < 5; i++) {
+    if(!*va[i]) continue;
+    if(va_kept[i]) delete va_kept[i];
+    va_kept[i] = *va[i];
+    *va[i] = nullptr;
+  }
+}
+
+void PView::deleteKeptVertexArrays()
+{
+  for(int i = 0; i < 5; i++) {
+    if(va_kept[i]) delete va_kept[i];
+    va_kept[i] = nullptr;
+  }
+}
+
 void PView::setOptions(PViewOptions *val)
 {
   // deep copy options
@@ -393,6 +415,8 @@ double PView::getMemoryInMb()
   if(va_triangles) mem += va_triangles->getMemoryInMb();
   if(va_vectors) mem += va_vectors->getMemoryInMb();
   if(va_ellipses) mem += va_ellipses->getMemoryInMb();
+  for(int i = 0; i < 5; i++)
+    if(va_kept[i]) mem += va_kept[i]->getMemoryInMb();
   mem += getData()->getMemoryInMb();
   return mem;
 }
@@ -157,12 +157,23 @@ public:
   // vertex arrays to draw the elements efficiently
   VertexArray *va_points, *va_lines, *va_triangles, *va_vectors, *va_ellipses;
 
+  // vertex arrays of a remote view, kept aside (by type, see
+  // fillVertexArrayChunk) while the new ones are being received: the arrays
+  // that did not change are not sent again
+  VertexArray *va_kept[5];
+  void keepVertexArrays();
+  void deleteKeptVertexArrays();
+
   // fill the vertex arrays, given the current option and data
   bool fillVertexArrays();
 
   // fill a vertex array using a raw stream of bytes
   static void fillVertexArray(onelab::localNetworkClient *remote, int length,
                               const char *data, int swap);
+  // fill a vertex array using a chunk of the streaming protocol (see
+  // VertexArray.h); returns true when a vertex array has been completed
+  static bool fillVertexArrayChunk(onelab::localNetworkClient *remote,
+                                   int length, const char *data, int swap);
 
   // smoothed normals
   smooth_normals *normals;
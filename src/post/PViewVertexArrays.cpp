@@ -5,6 +5,9 @@
 
 #include <string.h>
 #include <algorithm>
+#include <map>
+#include <stdint.h>
+#include "GmshConfig.h"
 #include "GmshMessage.h"
 #include "GmshDefines.h"
 #include "onelab.h"
@@ -25,6 +28,10 @@
 #include "StringUtils.h"
 #include "fullMatrix.h"
 
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
 static void saturate(int nb, double **val, double vmin, double vmax, int i0 = 0,
                      int i1 = 1, int i2 = 2, int i3 = 3, int i4 = 4, int i5 = 5,
                      int i6 = 6, int i7 = 7)
@@ -1548,6 +1555,10 @@ public:
       return false;
     if(!opt->visible || opt->type != PViewOptions::Plot3D) return false;
 
+    // the arrays of a remote view that did not change are not sent again:
+    // keep them aside until the new ones are received
+    if(data->isRemote()) p->keepVertexArrays();
+
     p->deleteVertexArrays();
 
     if(data->isRemote()) {
@@ -1616,21 +1627,11 @@ bool PView::fillVertexArrays()
   return init(this);
 }
 
-void PView::fillVertexArray(onelab::localNetworkClient *remote, int length,
-                            const char *bytes, int swap)
+static PView *getRemoteView(onelab::localNetworkClient *remote,
+                            const std::string &name, int tag, double min,
+                            double max, int numSteps, double time,
+                            SBoundingBox3d &bbox)
 {
-  std::string name;
-  int tag, type, numSteps;
-  double min, max, time, xmin, ymin, zmin, xmax, ymax, zmax;
-  if(!VertexArray::decodeHeader(length, bytes, swap, name, tag, type, min, max,
-                                numSteps, time, xmin, ymin, zmin, xmax, ymax,
-                                zmax))
-    return;
-
-  Msg::Debug("Filling vertex array (type %d) in view tag %d", type, tag);
-
-  SBoundingBox3d bbox(xmin, ymin, zmin, xmax, ymax, zmax);
-
   PView *p = PView::getViewByTag(tag);
   if(!p) {
     Msg::Info("View tag %d does not exist: creating new view", tag);
@@ -1651,36 +1652,221 @@ void PView::fillVertexArray(onelab::localNetworkClient *remote, int length,
   }
   // not perfect (does not take transformations into account)
   p->getOptions()->tmpBBox = bbox;
+  return p;
+}
 
+static VertexArray **getRemoteVertexArray(PView *p, int type)
+{
+  switch(type) {
+  case 1: return &p->va_points;
+  case 2: return &p->va_lines;
+  case 3: return &p->va_triangles;
+  case 4: return &p->va_vectors;
+  case 5: return &p->va_ellipses;
+  default: Msg::Error("Cannot fill vertex array of type %d", type);
+  }
+  return nullptr;
+}
+
+static int getRemoteNumVerticesPerElement(int type)
+{
   switch(type) {
-  case 1:
-    if(p->va_points) delete p->va_points;
-    p->va_points = new VertexArray(1, 100);
-    p->va_points->fromChar(length, bytes, swap);
-    break;
   case 2:
-    if(p->va_lines) delete p->va_lines;
-    p->va_lines = new VertexArray(2, 100);
-    p->va_lines->fromChar(length, bytes, swap);
-    break;
-  case 3:
-    if(p->va_triangles) delete p->va_triangles;
-    p->va_triangles = new VertexArray(3, 100);
-    p->va_triangles->fromChar(length, bytes, swap);
-    break;
-  case 4:
-    if(p->va_vectors) delete p->va_vectors;
-    p->va_vectors = new VertexArray(2, 100);
-    p->va_vectors->fromChar(length, bytes, swap);
-    break;
-  case 5:
-    if(p->va_ellipses) delete p->va_ellipses;
-    p->va_ellipses = new VertexArray(4, 100);
-    p->va_ellipses->fromChar(length, bytes, swap);
-    break;
-  default: Msg::Error("Cannot fill vertex array of type %d", type); return;
+  case 4: return 2;
+  case 3: return 3;
+  case 5: return 4;
+  default: return 1;
   }
+}
+
+void PView::fillVertexArray(onelab::localNetworkClient *remote, int length,
+                            const char *bytes, int swap)
+{
+  std::string name;
+  int tag, type, numSteps;
+  double min, max, time, xmin, ymin, zmin, xmax, ymax, zmax;
+  if(!VertexArray::decodeHeader(length, bytes, swap, name, tag, type, min, max,
+                                numSteps, time, xmin, ymin, zmin, xmax, ymax,
+                                zmax))
+    return;
+
+  Msg::Debug("Filling vertex array (type %d) in view tag %d", type, tag);
+
+  SBoundingBox3d bbox(xmin, ymin, zmin, xmax, ymax, zmax);
+  PView *p =
+    getRemoteView(remote, name, tag, min, max, numSteps, time, bbox);
+
+  VertexArray **va = getRemoteVertexArray(p, type);
+  if(!va) return;
+  if(*va) delete *va;
+  if(p->va_kept[type - 1]) delete p->va_kept[type - 1];
+  p->va_kept[type - 1] = nullptr;
+  *va = new VertexArray(getRemoteNumVerticesPerElement(type), 100);
+  (*va)->fromChar(length, bytes, swap);
+
+  p->setChanged(false);
+  p->getData()->setDirty(false);
+}
+
+// vertex arrays being received in chunks, indexed by view tag and array type
+struct remoteVertexArray {
+  VertexArray *va;
+  std::string name;
+  int numSteps;
+  double min, max, time;
+  SBoundingBox3d bbox;
+  std::size_t bytes[3];
+  int changed[3];
+};
+
+static std::map<std::pair<int, int>, remoteVertexArray> remoteVertexArrays;
+
+bool PView::fillVertexArrayChunk(onelab::localNetworkClient *remote,
+                                 int length, const char *bytes, int swap)
+{
+  int is = sizeof(int), ls = sizeof(int64_t);
+  if(length < 3 * is) {
+    Msg::Error("Too few bytes in vertex array chunk: %d", length);
+    return false;
+  }
+  if(swap) {
+    Msg::Error("Should swap bytes in vertex array--not implemented yet");
+    return false;
+  }
+
+  int kind, tag, type;
+  int index = 0;
+  memcpy(&kind, &bytes[index], is); index += is;
+  memcpy(&tag, &bytes[index], is); index += is;
+  memcpy(&type, &bytes[index], is); index += is;
+  std::pair<int, int> key(tag, type);
+
+  if(kind == VertexArray::CHUNK_BEGIN) {
+    if(length < 3 * is + 3 * (ls + is)) {
+      Msg::Error("Too few bytes in vertex array chunk: %d", length);
+      return false;
+    }
+    auto it = remoteVertexArrays.find(key);
+    if(it != remoteVertexArrays.end()) {
+      delete it->second.va;
+      remoteVertexArrays.erase(it);
+    }
+    remoteVertexArray r;
+    for(int i = 0; i < 3; i++) {
+      int64_t n;
+      memcpy(&n, &bytes[index], ls); index += ls;
+      memcpy(&r.changed[i], &bytes[index], is); index += is;
+      r.bytes[i] = n;
+    }
+    int num, t;
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    if(!VertexArray::decodeHeader(length - index, &bytes[index], swap, r.name,
+                                  num, t, r.min, r.max, r.numSteps, r.time,
+                                  xmin, ymin, zmin, xmax, ymax, zmax))
+      return false;
+    r.bbox = SBoundingBox3d(xmin, ymin, zmin, xmax, ymax, zmax);
+    r.va = new VertexArray(getRemoteNumVerticesPerElement(type), 0);
+    for(int i = 0; i < 3; i++) {
+      if(r.changed[i] && !r.va->resizeRawBytes(i, r.bytes[i])) {
+        Msg::Error("Wrong size of vertex array: %lu bytes", r.bytes[i]);
+        delete r.va;
+        return false;
+      }
+    }
+    remoteVertexArrays[key] = r;
+    return false;
+  }
+
+  auto it = remoteVertexArrays.find(key);
+  if(it == remoteVertexArrays.end()) {
+    Msg::Error("Unexpected chunk for vertex array (type %d) in view tag %d",
+               type, tag);
+    return false;
+  }
+  remoteVertexArray &r = it->second;
+
+  if(kind == VertexArray::CHUNK_DATA) {
+    if(length < 6 * is + ls) {
+      Msg::Error("Too few bytes in vertex array chunk: %d", length);
+      return false;
+    }
+    int section, raw, compressed;
+    int64_t offset;
+    memcpy(&section, &bytes[index], is); index += is;
+    memcpy(&offset, &bytes[index], ls); index += ls;
+    memcpy(&raw, &bytes[index], is); index += is;
+    memcpy(&compressed, &bytes[index], is); index += is;
+    if(section < 0 || section > 2 || !r.changed[section] || offset < 0 ||
+       raw < 0 || offset + raw > (int64_t)r.bytes[section] ||
+       (!compressed && length - index != raw)) {
+      Msg::Error("Wrong chunk for vertex array (type %d) in view tag %d",
+                 type, tag);
+      return false;
+    }
+    char *dst = r.va->getRawBytes(section) + offset;
+    if(!compressed) {
+      memcpy(dst, &bytes[index], raw);
+      return false;
+    }
+#if defined(HAVE_LIBZ)
+    uLongf dstLen = raw;
+    if(uncompress((Bytef *)dst, &dstLen, (const Bytef *)&bytes[index],
+                  length - index) != Z_OK ||
+       (int)dstLen != raw)
+      Msg::Error("Could not uncompress vertex array chunk");
+#else
+    Msg::Error("Gmsh must be compiled with zlib to receive compressed vertex "
+               "arrays");
+#endif
+    return false;
+  }
+
+  if(kind != VertexArray::CHUNK_END) {
+    Msg::Error("Unknown vertex array chunk %d", kind);
+    return false;
+  }
+
+  Msg::Debug("Filling vertex array (type %d) in view tag %d", type, tag);
+
+  VertexArray *va = r.va;
+  remoteVertexArray rc = r;
+  remoteVertexArrays.erase(it);
+
+  PView *p = getRemoteView(remote, rc.name, tag, rc.min, rc.max, rc.numSteps,
+                           rc.time, rc.bbox);
+  VertexArray **cur = getRemoteVertexArray(p, type);
+  if(!cur) {
+    delete va;
+    return false;
+  }
+
+  // reuse the arrays that did not change since they were last sent, from the
+  // arrays kept aside when the view was recomputed (or from the current ones,
+  // if the arrays are sent again without being recomputed)
+  VertexArray *old = p->va_kept[type - 1] ? p->va_kept[type - 1] : *cur;
+  for(int i = 0; i < 3; i++) {
+    if(rc.changed[i]) continue;
+    if(!old || old->getNumRawBytes(i) != rc.bytes[i]) {
+      Msg::Info("Vertex array (type %d) in view tag %d is out of sync: "
+                "requesting all the vertex arrays", type, tag);
+      delete va;
+      // the message body is not used, but must not be empty
+      int request[2] = {tag, type};
+      GmshServer *server = remote->getGmshServer();
+      if(server)
+        server->SendMessage(GmshSocket::GMSH_VERTEX_ARRAY_CHUNK,
+                            sizeof(request), request);
+      return false;
+    }
+    va->swapRawBytes(i, old);
+  }
+
+  if(*cur) delete *cur;
+  *cur = va;
+  if(p->va_kept[type - 1]) delete p->va_kept[type - 1];
+  p->va_kept[type - 1] = nullptr;
 
   p->setChanged(false);
   p->getData()->setDirty(false);
+  return true;
 }
@@ -86,6 +86,7 @@ public:
     GMSH_CLIENT_CHANGED = 34,
     GMSH_PARAMETER_WITHOUT_CHOICES = 35,
     GMSH_PARAMETER_QUERY_WITHOUT_CHOICES = 36,
+    GMSH_VERTEX_ARRAY_CHUNK = 37,
     GMSH_OPTION_1 = 100,
     GMSH_OPTION_2 = 101,
     GMSH_OPTION_3 = 102,
@@ -118,6 +119,8 @@ protected:
   // receive some data over the socket
   int _receiveData(void *buffer, int bytes)
   {
+    // recv() would wait for data even if nothing is requested
+    if(bytes <= 0) return 0;
     char *buf = (char *)buffer;
     long int sofar = 0;
     long int remaining = bytes;
@@ -191,6 +194,17 @@ public:
     // send body
     _sendData(msg, length);
   }
+  // send a message made of several parts, without copying them
+  void SendMessage(int type, int num, const void *const *msg,
+                   const int *length)
+  {
+    int total = 0;
+    for(int i = 0; i < num; i++) total += length[i];
+    _sendData(&type, sizeof(int));
+    _sendData(&total, sizeof(int));
+    for(int i = 0; i < num; i++)
+      if(length[i]) _sendData(msg[i], length[i]);
+  }
   void SendString(int type, const char *str)
   {
     SendMessage(type, (int)strlen(str), str);